@@ -0,0 +1,492 @@
+/**
+ * @file backend.c
+ * @brief C Backend Implementation for SenseCAP Indicator D1
+ *
+ * This module provides the backend logic for the SenseCAP Indicator D1 firmware.
+ * It only uses core_hal.h, so the PC simulator links this same file.
+ */
+
+#include "backend.h"
+#include "publish_scheduler.h"
+#include "payload_codec.h"
+#include "state_store.h"
+#include "state_persist.h"
+#include "level_history.h"
+#include "mqtt_router.h"
+#include "core_hal.h"
+#include "core_config.h"
+#include "dlog.h"
+#include <string.h>
+
+static const char *TAG = "BACKEND";
+
+#define LIGHT_STATE_TOPIC "sensecap/indicator/light/state"
+#define WATER_LEVEL_TOPIC "sensecap/indicator/water/level"
+// One level per named tank: sensecap/indicator/water/<name>/level
+#define TANK_PREFIX       "sensecap/indicator/water/"
+#define TANK_SUFFIX       "/level"
+#define TANK_LEVEL_TOPIC  TANK_PREFIX "+" TANK_SUFFIX
+
+_Static_assert(BACKEND_TANK_MAX == STATE_TANK_MAX, "one state slot per tank");
+
+static publish_topic_id_t light_state_topic = -1;
+
+// Tank names from CONFIG_WATER_TANKS, in order; tank 0 also takes the
+// unnamed WATER_LEVEL_TOPIC
+static char tank_names[BACKEND_TANK_MAX][BACKEND_TANK_NAME_MAX];
+static uint8_t tank_name_len[BACKEND_TANK_MAX];
+static size_t tank_count = 1;
+
+// External C callbacks - these are implemented in the UI layer.
+// The backend can run on any task, so it only uses the thread-safe variants.
+extern void ui_update_tank_level_async(int tank, int level);
+extern void ui_update_bright_state_async(int state);
+extern void ui_update_relax_state_async(int state);
+
+/**
+ * @brief Build the combined light state message
+ *
+ * Both lights go in one message, so a change that flips both (bright on
+ * forcing relax off) is published once, with consistent values.
+ */
+static int build_light_state(uint8_t *buf, size_t size)
+{
+    backend_state_t s;
+    state_store_snapshot(&s);
+
+    const payload_light_state_t state = {
+        .bright = s.bright,
+        .relax = s.relax,
+    };
+#if CONFIG_PAYLOAD_LIGHT_STATE_BINARY
+    return payload_encode_light_state(PAYLOAD_FORMAT_BINARY, &state, buf, size);
+#else
+    return payload_encode_light_state(PAYLOAD_FORMAT_JSON, &state, buf, size);
+#endif
+}
+
+/**
+ * @brief State subscriber: mirror changed fields into the UI
+ */
+static void on_state_ui(uint32_t changed, const backend_state_t *state, void *ctx)
+{
+    (void)ctx;
+    if (changed & STATE_FIELD_BRIGHT) ui_update_bright_state_async(state->bright);
+    if (changed & STATE_FIELD_RELAX) ui_update_relax_state_async(state->relax);
+    for (size_t i = 0; i < tank_count; i++) {
+        if (changed & STATE_FIELD_TANK(i)) ui_update_tank_level_async((int)i, state->water_level[i]);
+    }
+}
+
+/**
+ * @brief State subscriber: schedule a light state publish
+ */
+static void on_state_publish(uint32_t changed, const backend_state_t *state, void *ctx)
+{
+    (void)changed;
+    (void)state;
+    (void)ctx;
+    publish_scheduler_request(light_state_topic);
+}
+
+/**
+ * @brief Transition: one light on forces the other off (mutual exclusion)
+ */
+typedef struct {
+    uint32_t field;
+    uint8_t value;
+    bool toggle;        /**< Invert the current value instead of setting it */
+} light_transition_t;
+
+static void apply_light(backend_state_t *draft, void *ctx)
+{
+    const light_transition_t *t = ctx;
+    uint8_t current = t->field == STATE_FIELD_BRIGHT ? draft->bright : draft->relax;
+    uint8_t on = t->toggle ? !current : (t->value ? 1 : 0);
+
+    if (t->field == STATE_FIELD_BRIGHT) {
+        draft->bright = on;
+        if (on) draft->relax = 0;
+    } else {
+        draft->relax = on;
+        if (on) draft->bright = 0;
+    }
+}
+
+/** Applied level reports remembered per tank, for the late copies */
+#define TANK_RECENT_REPORTS     4
+
+/**
+ * @brief Level report applied to a tank
+ */
+typedef struct {
+    int64_t time_us;        /**< 0 if none yet */
+    uint8_t level;
+    uint8_t sources;        /**< Bit per backend_source_t that delivered it, or is past it */
+} tank_report_t;
+
+/**
+ * @brief Latest applied reports of a tank, oldest at next
+ *
+ * Only touched by transitions, so the writer lock orders reports racing
+ * in from the MQTT, local link and co-processor tasks.
+ */
+typedef struct {
+    tank_report_t recent[TANK_RECENT_REPORTS];
+    size_t next;
+} tank_reports_t;
+
+static tank_reports_t tank_reports[BACKEND_TANK_MAX];
+static volatile uint32_t duplicate_count = 0;    /**< Written in transitions */
+
+typedef struct {
+    size_t tank;
+    uint8_t level;
+    backend_source_t source;
+    int64_t now_us;
+    bool duplicate;         /**< Out: dropped */
+} tank_transition_t;
+
+/**
+ * @brief Mark the reports up to index i (0: oldest) as passed by a path
+ *
+ * Each path delivers a sensor's reports in order, so once it carried a
+ * report, it will not carry an older one any more.
+ */
+static void tank_reports_pass(tank_reports_t *r, size_t i, uint8_t bit)
+{
+    for (size_t j = 0; j <= i; j++) {
+        r->recent[(r->next + j) % TANK_RECENT_REPORTS].sources |= bit;
+    }
+}
+
+static void apply_water_level(backend_state_t *draft, void *ctx)
+{
+    tank_transition_t *t = ctx;
+    tank_reports_t *r = &tank_reports[t->tank];
+    uint8_t bit = (uint8_t)(1u << t->source);
+
+    // A copy of an applied report: the oldest one within the window with
+    // the same level that this path has not delivered yet. If newer ones
+    // were applied meanwhile, applying the copy would go back in time.
+    for (size_t i = 0; i < TANK_RECENT_REPORTS; i++) {
+        tank_report_t *e = &r->recent[(r->next + i) % TANK_RECENT_REPORTS];
+        if (e->time_us == 0 || (e->sources & bit) || e->level != t->level ||
+            t->now_us - e->time_us >= (int64_t)CONFIG_LEVEL_DEDUP_MS * 1000) {
+            continue;
+        }
+        tank_reports_pass(r, i, bit);
+        t->duplicate = true;
+        duplicate_count++;
+        return;
+    }
+    tank_reports_pass(r, TANK_RECENT_REPORTS - 1, bit);
+    r->recent[r->next] = (tank_report_t){ t->now_us, t->level, bit };
+    r->next = (r->next + 1) % TANK_RECENT_REPORTS;
+
+    draft->water_level[t->tank] = t->level;
+    // Only stored along with a level change; the diff ignores it
+    draft->water_level_time = core_hal_wall_time();
+}
+
+/**
+ * @brief Split CONFIG_WATER_TANKS ("north,south,...") into tank names
+ *
+ * Names that are empty, too long, or would not fit a topic level are
+ * skipped; an empty list leaves the single unnamed main tank.
+ */
+static void tanks_parse(const char *list)
+{
+    size_t count = 0;
+    const char *p = list;
+
+    while (*p && count < BACKEND_TANK_MAX) {
+        const char *end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        if (len == 0 || len >= BACKEND_TANK_NAME_MAX || memchr(p, '/', len) ||
+            memchr(p, '+', len) || memchr(p, '#', len)) {
+            CORE_LOGW(TAG, "Tank name \"%.*s\" skipped", (int)len, p);
+        } else {
+            memcpy(tank_names[count], p, len);
+            tank_names[count][len] = '\0';
+            tank_name_len[count] = (uint8_t)len;
+            count++;
+        }
+        if (!end) break;
+        p = end + 1;
+    }
+    tank_count = count > 0 ? count : 1;
+}
+
+static void tank_update_from_payload(size_t tank, const char *data, size_t len)
+{
+    payload_water_level_t level;
+
+#if CONFIG_PAYLOAD_WATER_LEVEL_BINARY
+    if (payload_detect_format((const uint8_t *)data, len) != PAYLOAD_FORMAT_BINARY) {
+        CORE_LOGW(TAG, "Non-binary water level payload ignored");
+        return;
+    }
+#endif
+    if (payload_decode_water_level((const uint8_t *)data, len, &level)) {
+        backend_update_tank_level(tank, level.level);
+    } else {
+        CORE_LOGW(TAG, "Unparsable water level payload (%u bytes)", (unsigned)len);
+    }
+}
+
+/**
+ * @brief Route handler for the water level topic of the main tank
+ */
+static void on_water_level(const char *topic, size_t topic_len,
+                           const char *data, size_t len, void *ctx)
+{
+    (void)topic;
+    (void)topic_len;
+    (void)ctx;
+    tank_update_from_payload(0, data, len);
+}
+
+/**
+ * @brief Route handler for the per-tank topics
+ *
+ * The router has matched the prefix and suffix; the level in between is
+ * the tank name. At most BACKEND_TANK_MAX short compares per message.
+ */
+static void on_tank_level(const char *topic, size_t topic_len,
+                          const char *data, size_t len, void *ctx)
+{
+    (void)ctx;
+    const size_t skip = sizeof(TANK_PREFIX) - 1;
+    const size_t suffix = sizeof(TANK_SUFFIX) - 1;
+    if (topic_len < skip + suffix) return;
+    const size_t name_len = topic_len - skip - suffix;
+    const char *name = topic + skip;
+
+    for (size_t i = 0; i < tank_count; i++) {
+        if (tank_name_len[i] == name_len && memcmp(tank_names[i], name, name_len) == 0) {
+            tank_update_from_payload(i, data, len);
+            return;
+        }
+    }
+    CORE_LOGD(TAG, "Level of unknown tank %.*s ignored", (int)name_len, name);
+}
+
+/**
+ * @brief Initialize the backend
+ *
+ * Must be called once, after the HAL storage is ready (nvs_flash_init() on
+ * the device), before ui_init() and the MQTT client start, and before using
+ * any other backend functions. It registers the subscribed topics with the
+ * router. The saved state and the level history are restored here, and the
+ * state is queued for the UI, so the first frame already shows it.
+ */
+void backend_init(void)
+{
+    backend_state_t initial = {
+        .version = 0,
+        .bright = 0,
+        .relax = 0,
+        .water_level_time = 0,
+    };
+    // Default 50%
+    memset(initial.water_level, 50, sizeof(initial.water_level));
+    tanks_parse(CONFIG_WATER_TANKS);
+    state_persist_load(&initial);
+    state_store_init(&initial);
+    level_history_init();
+
+    // Applied by the LVGL task before it renders the first frame
+    ui_update_bright_state_async(initial.bright);
+    ui_update_relax_state_async(initial.relax);
+    for (size_t i = 0; i < tank_count; i++) {
+        ui_update_tank_level_async((int)i, initial.water_level[i]);
+    }
+
+    // Retained so a subscriber joining later sees the current state at once
+    const publish_topic_config_t light_state_config = {
+        .topic = LIGHT_STATE_TOPIC,
+        .build = build_light_state,
+        .qos = 1,
+        .retain = true,
+        .coalesce_ms = CONFIG_PUBLISH_COALESCE_MS,
+    };
+    light_state_topic = publish_scheduler_register(&light_state_config);
+
+    if (!mqtt_router_add(WATER_LEVEL_TOPIC, on_water_level, NULL)) {
+        CORE_LOGE(TAG, "Cannot route %s", WATER_LEVEL_TOPIC);
+    }
+    // One wildcard route for all tanks, whatever their number
+    if (tank_names[0][0] != '\0' && !mqtt_router_add(TANK_LEVEL_TOPIC, on_tank_level, NULL)) {
+        CORE_LOGE(TAG, "Cannot route %s", TANK_LEVEL_TOPIC);
+    }
+
+    state_store_subscribe(STATE_FIELD_ALL, on_state_ui, NULL);
+    state_store_subscribe(STATE_FIELD_BRIGHT | STATE_FIELD_RELAX, on_state_publish, NULL);
+    state_persist_start();
+    DLOGI(BACKEND, "Initialized");
+}
+
+/**
+ * @brief Set the bright light state
+ *
+ * @param state 0 for off, 1 for on
+ */
+void backend_set_bright(uint8_t state)
+{
+    // Bright on turns relax off in the same transition
+    light_transition_t t = { STATE_FIELD_BRIGHT, state, false };
+    uint32_t changed = state_store_update(apply_light, &t);
+    DLOGI(BACKEND, "Bright state set to: %d (changed 0x%x)", state, (unsigned)changed);
+}
+
+/**
+ * @brief Set the relax light state
+ *
+ * @param state 0 for off, 1 for on
+ */
+void backend_set_relax(uint8_t state)
+{
+    // Relax on turns bright off in the same transition
+    light_transition_t t = { STATE_FIELD_RELAX, state, false };
+    uint32_t changed = state_store_update(apply_light, &t);
+    DLOGI(BACKEND, "Relax state set to: %d (changed 0x%x)", state, (unsigned)changed);
+}
+
+/**
+ * @brief Toggle the bright light state
+ */
+void backend_toggle_bright(void)
+{
+    // Read and flip inside one transition, so concurrent writers cannot race it
+    light_transition_t t = { STATE_FIELD_BRIGHT, 0, true };
+    state_store_update(apply_light, &t);
+}
+
+/**
+ * @brief Toggle the relax light state
+ */
+void backend_toggle_relax(void)
+{
+    light_transition_t t = { STATE_FIELD_RELAX, 0, true };
+    state_store_update(apply_light, &t);
+}
+
+/**
+ * @brief Get the current bright state
+ *
+ * @return 0 if off, 1 if on
+ */
+uint8_t backend_get_bright_state(void)
+{
+    backend_state_t s;
+    state_store_snapshot(&s);
+    return s.bright;
+}
+
+/**
+ * @brief Get the current relax state
+ *
+ * @return 0 if off, 1 if on
+ */
+uint8_t backend_get_relax_state(void)
+{
+    backend_state_t s;
+    state_store_snapshot(&s);
+    return s.relax;
+}
+
+/**
+ * @brief Update water level from MQTT subscription
+ *
+ * @param level Water level percentage (0-100)
+ */
+void backend_update_water_level(uint8_t level)
+{
+    backend_update_tank_level(0, level);
+}
+
+/**
+ * @brief Update the level of one tank
+ *
+ * @param tank Index into the configured tanks
+ * @param level Water level percentage (0-100)
+ */
+void backend_update_tank_level(size_t tank, uint8_t level)
+{
+    backend_update_tank_level_from(BACKEND_SOURCE_MQTT, tank, level);
+}
+
+bool backend_update_tank_level_from(backend_source_t source, size_t tank, uint8_t level)
+{
+    if (tank >= tank_count) return false;
+    // Clamp level to 0-100
+    if (level > 100) {
+        level = 100;
+    }
+    // The UI follows through the state subscriber, only if it changed
+    tank_transition_t t = { tank, level, source, core_hal_time_us(), false };
+    state_store_update(apply_water_level, &t);
+    if (t.duplicate) return false;
+    // Every sample of the main tank goes into the history, even if the
+    // level is unchanged
+    if (tank == 0) {
+        level_history_add(core_hal_wall_time(), level);
+    }
+    return true;
+}
+
+uint32_t backend_get_duplicate_count(void)
+{
+    return duplicate_count;
+}
+
+/**
+ * @brief Get current water level
+ *
+ * @return Water level percentage (0-100)
+ */
+uint8_t backend_get_water_level(void)
+{
+    backend_state_t s;
+    state_store_snapshot(&s);
+    return s.water_level[0];
+}
+
+size_t backend_get_tank_count(void)
+{
+    return tank_count;
+}
+
+const char *backend_get_tank_name(size_t tank)
+{
+    return tank < tank_count ? tank_names[tank] : "";
+}
+
+/**
+ * @brief Connect to WiFi (placeholder - actual WiFi managed in main)
+ *
+ * @param ssid WiFi SSID
+ * @param password WiFi password
+ */
+void backend_wifi_connect(const char* ssid, const char* password)
+{
+    // WiFi connection is handled by ESP-IDF in main.c
+    // This is a placeholder for any backend-side WiFi logic
+    (void)ssid;
+    (void)password;
+    DLOGI(BACKEND, "WiFi connect placeholder called");
+}
+
+/**
+ * @brief Connect to MQTT broker (placeholder - actual MQTT managed in main)
+ *
+ * @param broker_url MQTT broker URL
+ */
+void backend_mqtt_connect(const char* broker_url)
+{
+    // MQTT connection is handled by ESP-IDF in main.c
+    // This is a placeholder for any backend-side MQTT logic
+    (void)broker_url;
+    DLOGI(BACKEND, "MQTT connect placeholder called");
+}
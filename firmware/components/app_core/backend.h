@@ -0,0 +1,156 @@
+/**
+ * @file backend.h
+ * @brief C Backend for SenseCAP Indicator D1
+ *
+ * This module provides the backend logic for the SenseCAP Indicator D1 firmware.
+ * It handles:
+ * - Light state management
+ * - MQTT message processing
+ * - Business logic
+ *
+ * Part of the app_core component, shared by the firmware and the PC
+ * simulator; platform services come from core_hal.h.
+ */
+
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Water tanks in CONFIG_WATER_TANKS, at most */
+#define BACKEND_TANK_MAX        8
+/** Longest tank name, with the terminator */
+#define BACKEND_TANK_NAME_MAX   16
+
+/** Path a received value came in on */
+typedef enum {
+    BACKEND_SOURCE_MQTT,    /**< The broker, the authoritative channel */
+    BACKEND_SOURCE_LOCAL,   /**< The local link, peer to peer on the LAN */
+    BACKEND_SOURCE_COPRO,   /**< Sensors on the RP2040 co-processor, over UART */
+} backend_source_t;
+
+/**
+ * @brief Initialize the backend
+ *
+ * Must be called once before using any other backend functions.
+ */
+void backend_init(void);
+
+/**
+ * @brief Set the bright light state
+ *
+ * @param state 0 for off, 1 for on
+ */
+void backend_set_bright(uint8_t state);
+
+/**
+ * @brief Set the relax light state
+ *
+ * @param state 0 for off, 1 for on
+ */
+void backend_set_relax(uint8_t state);
+
+/**
+ * @brief Toggle the bright light state
+ */
+void backend_toggle_bright(void);
+
+/**
+ * @brief Toggle the relax light state
+ */
+void backend_toggle_relax(void);
+
+/**
+ * @brief Get the current bright state
+ *
+ * @return 0 if off, 1 if on
+ */
+uint8_t backend_get_bright_state(void);
+
+/**
+ * @brief Get the current relax state
+ *
+ * @return 0 if off, 1 if on
+ */
+uint8_t backend_get_relax_state(void);
+
+/**
+ * @brief Update water level from MQTT
+ *
+ * @param level Water level percentage (0-100) of the main tank
+ */
+void backend_update_water_level(uint8_t level);
+
+/**
+ * @brief Update the level of one tank
+ *
+ * @param tank Index into the configured tanks; out of range is ignored
+ * @param level Water level percentage (0-100)
+ */
+void backend_update_tank_level(size_t tank, uint8_t level);
+
+/**
+ * @brief Update the level of one tank, as received on a path
+ *
+ * A sensor may report on several paths, each delivering its reports in
+ * order. A report is dropped as a copy, and makes no history sample, if
+ * it matches the level of a report applied within CONFIG_LEVEL_DEDUP_MS
+ * that its path has not delivered yet. A late copy of an older report
+ * is dropped too, rather than taking the tank back to that level.
+ * Repeats on one path are samples of their own.
+ *
+ * @param source Path it came in on; backend_update_tank_level() is MQTT
+ * @param tank Index into the configured tanks; out of range is ignored
+ * @param level Water level percentage (0-100)
+ * @return false if ignored or dropped as a duplicate
+ */
+bool backend_update_tank_level_from(backend_source_t source, size_t tank, uint8_t level);
+
+/**
+ * @brief Level reports dropped as duplicates since boot
+ */
+uint32_t backend_get_duplicate_count(void);
+
+/**
+ * @brief Get current water level
+ *
+ * @return Water level percentage (0-100) of the main tank
+ */
+uint8_t backend_get_water_level(void);
+
+/**
+ * @brief Number of tanks: the names in CONFIG_WATER_TANKS, at least 1
+ */
+size_t backend_get_tank_count(void);
+
+/**
+ * @brief Name of a tank, "" for the unnamed main tank
+ */
+const char *backend_get_tank_name(size_t tank);
+
+/**
+ * @brief Connect to WiFi (placeholder - actual WiFi managed in main)
+ *
+ * @param ssid WiFi SSID
+ * @param password WiFi password
+ */
+void backend_wifi_connect(const char* ssid, const char* password);
+
+/**
+ * @brief Connect to MQTT broker (placeholder - actual MQTT managed in main)
+ *
+ * @param broker_url MQTT broker URL
+ */
+void backend_mqtt_connect(const char* broker_url);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BACKEND_H */
@@ -0,0 +1,45 @@
+/**
+ * @file core_config.h
+ * @brief Build options of the application core
+ *
+ * On the device these come from menuconfig (main/Kconfig.projbuild). Other
+ * builds get the Kconfig defaults below, and may override any of them with
+ * -D on the compiler command line.
+ */
+
+#ifndef CORE_CONFIG_H
+#define CORE_CONFIG_H
+
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#else
+
+#ifndef CONFIG_PUBLISH_COALESCE_MS
+#define CONFIG_PUBLISH_COALESCE_MS          150
+#endif
+#ifndef CONFIG_MQTT_OUTBOX_LIMIT_BYTES
+#define CONFIG_MQTT_OUTBOX_LIMIT_BYTES      4096
+#endif
+#ifndef CONFIG_MQTT_ROUTER_MAX_PAYLOAD
+#define CONFIG_MQTT_ROUTER_MAX_PAYLOAD      1024
+#endif
+#ifndef CONFIG_STATE_PERSIST_LIGHT_DELAY_S
+#define CONFIG_STATE_PERSIST_LIGHT_DELAY_S  5
+#endif
+#ifndef CONFIG_STATE_PERSIST_LEVEL_DELAY_S
+#define CONFIG_STATE_PERSIST_LEVEL_DELAY_S  300
+#endif
+#ifndef CONFIG_WATER_TANKS
+#define CONFIG_WATER_TANKS                  ""
+#endif
+#ifndef CONFIG_LEVEL_HISTORY_FLUSH_MIN
+#define CONFIG_LEVEL_HISTORY_FLUSH_MIN      10
+#endif
+#ifndef CONFIG_LEVEL_DEDUP_MS
+#define CONFIG_LEVEL_DEDUP_MS               1000
+#endif
+// Payload formats default to JSON: CONFIG_PAYLOAD_*_BINARY left undefined
+
+#endif // ESP_PLATFORM
+
+#endif // CORE_CONFIG_H
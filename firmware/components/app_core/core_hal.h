@@ -0,0 +1,145 @@
+/**
+ * @file core_hal.h
+ * @brief Platform services used by the application core
+ *
+ * The core (backend, state store, publish scheduler, persistence, level
+ * history, MQTT router) only reaches the platform through these functions, so the
+ * firmware and the PC simulator run the same code. The firmware implements
+ * them in core_hal_esp.c, the simulator in simulator/src/core_hal_host.c.
+ *
+ * The MQTT transport is not a function here: the platform hands the
+ * publish scheduler a publish_sink_t once it has a client, and feeds
+ * received chunks to mqtt_router_dispatch().
+ */
+
+#ifndef CORE_HAL_H
+#define CORE_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_log.h"
+#define CORE_LOGE(tag, fmt, ...) ESP_LOGE(tag, fmt, ##__VA_ARGS__)
+#define CORE_LOGW(tag, fmt, ...) ESP_LOGW(tag, fmt, ##__VA_ARGS__)
+#define CORE_LOGI(tag, fmt, ...) ESP_LOGI(tag, fmt, ##__VA_ARGS__)
+#define CORE_LOGD(tag, fmt, ...) ESP_LOGD(tag, fmt, ##__VA_ARGS__)
+#else
+#include <stdio.h>
+#define CORE_LOGE(tag, fmt, ...) fprintf(stderr, "E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define CORE_LOGW(tag, fmt, ...) fprintf(stderr, "W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define CORE_LOGI(tag, fmt, ...) fprintf(stderr, "I %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define CORE_LOGD(tag, fmt, ...) do { } while (0)
+#endif
+
+// ============================================================================
+// Clock
+// ============================================================================
+
+/**
+ * @brief Monotonic time since boot in microseconds
+ */
+int64_t core_hal_time_us(void);
+
+/**
+ * @brief Wall clock time in seconds since the epoch, 0 if unknown
+ */
+int64_t core_hal_wall_time(void);
+
+// ============================================================================
+// Locks
+// ============================================================================
+
+typedef struct core_hal_lock core_hal_lock_t;
+
+/**
+ * @brief Create a non-recursive mutex; never fails (aborts on no memory)
+ */
+core_hal_lock_t *core_hal_lock_create(void);
+void core_hal_lock_take(core_hal_lock_t *lock);
+void core_hal_lock_give(core_hal_lock_t *lock);
+
+// ============================================================================
+// One-shot timers
+// ============================================================================
+
+typedef struct core_hal_timer core_hal_timer_t;
+typedef void (*core_hal_timer_cb_t)(void *arg);
+
+/**
+ * @brief Create a one-shot timer
+ *
+ * Callbacks of all timers run one at a time in a single platform context
+ * (the esp_timer task on the device), never on the caller's task.
+ *
+ * @return NULL on failure
+ */
+core_hal_timer_t *core_hal_timer_create(const char *name, core_hal_timer_cb_t cb, void *arg);
+
+/**
+ * @brief Create a one-shot timer whose callback may block
+ *
+ * For storage writes and flash erases. The callback runs on a low-priority
+ * worker (the "core_bg" task on the device) instead of the timer context,
+ * so it does not hold up the other timers. Background callbacks run one at
+ * a time, and a firing that is still queued when the timer is stopped or
+ * re-armed runs anyway.
+ *
+ * @return NULL on failure
+ */
+core_hal_timer_t *core_hal_timer_create_background(const char *name, core_hal_timer_cb_t cb, void *arg);
+
+/**
+ * @brief Arm the timer to fire once after delay_us
+ *
+ * @return false if the timer is already armed; it keeps its deadline
+ */
+bool core_hal_timer_start_once(core_hal_timer_t *timer, uint64_t delay_us);
+
+/**
+ * @brief Disarm the timer; harmless if it is not armed
+ */
+void core_hal_timer_stop(core_hal_timer_t *timer);
+
+// ============================================================================
+// Storage
+// ============================================================================
+
+/**
+ * @brief Read a blob saved under key
+ *
+ * @param[in,out] len Buffer size in, stored size out
+ * @return false if nothing is stored or it does not fit
+ */
+bool core_hal_storage_load(const char *key, void *buf, size_t *len);
+
+/**
+ * @brief Save a blob under key, durable when this returns true
+ */
+bool core_hal_storage_save(const char *key, const void *buf, size_t len);
+
+// ============================================================================
+// Log region
+// ============================================================================
+
+// A raw area with flash semantics for append-only logs: the "storage"
+// partition on the device. Erasing sets a whole sector to 0xFF; writes can
+// only clear bits, so every byte is written once between erases. Offsets
+// are relative to the start of the region.
+
+/**
+ * @brief Size and erase unit of the region
+ *
+ * @return false if the platform has no log region
+ */
+bool core_hal_region_info(size_t *size, size_t *sector_size);
+bool core_hal_region_read(size_t offset, void *buf, size_t len);
+bool core_hal_region_write(size_t offset, const void *buf, size_t len);
+
+/**
+ * @brief Erase the sector starting at offset (a multiple of sector_size)
+ */
+bool core_hal_region_erase(size_t offset);
+
+#endif // CORE_HAL_H
@@ -0,0 +1,243 @@
+/**
+ * @file core_hal_esp.c
+ * @brief core_hal.h on ESP-IDF: esp_timer, FreeRTOS mutexes and tasks, NVS and a partition
+ */
+
+#include "core_hal.h"
+#include <stdlib.h>
+#include <time.h>
+#include "esp_timer.h"
+#include "nvs.h"
+#include "esp_partition.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+static const char *TAG = "CORE_HAL";
+
+// All core blobs share one namespace; "backend" predates the HAL
+#define STORAGE_NAMESPACE "backend"
+#define REGION_PARTITION "storage"
+
+// Background timer callbacks; below every application task
+#define BG_TIMERS_MAX       4
+#define BG_TASK_STACK       4096
+#define BG_TASK_PRIO        1
+
+// Before SNTP sets the clock, time() counts from 1970 at boot
+#define WALL_TIME_VALID_AFTER 1600000000
+
+int64_t core_hal_time_us(void)
+{
+    return esp_timer_get_time();
+}
+
+int64_t core_hal_wall_time(void)
+{
+    time_t now = time(NULL);
+    return now >= WALL_TIME_VALID_AFTER ? (int64_t)now : 0;
+}
+
+// ============================================================================
+// Locks
+// ============================================================================
+
+// The handle is the lock; the struct type only exists for type safety
+core_hal_lock_t *core_hal_lock_create(void)
+{
+    SemaphoreHandle_t mutex = xSemaphoreCreateMutex();
+    configASSERT(mutex);
+    return (core_hal_lock_t *)mutex;
+}
+
+void core_hal_lock_take(core_hal_lock_t *lock)
+{
+    xSemaphoreTake((SemaphoreHandle_t)lock, portMAX_DELAY);
+}
+
+void core_hal_lock_give(core_hal_lock_t *lock)
+{
+    xSemaphoreGive((SemaphoreHandle_t)lock);
+}
+
+// ============================================================================
+// Timers
+// ============================================================================
+
+core_hal_timer_t *core_hal_timer_create(const char *name, core_hal_timer_cb_t cb, void *arg)
+{
+    esp_timer_handle_t timer;
+    const esp_timer_create_args_t args = {
+        .callback = cb,
+        .arg = arg,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = name,
+    };
+    if (esp_timer_create(&args, &timer) != ESP_OK) {
+        return NULL;
+    }
+    return (core_hal_timer_t *)timer;
+}
+
+bool core_hal_timer_start_once(core_hal_timer_t *timer, uint64_t delay_us)
+{
+    return esp_timer_start_once((esp_timer_handle_t)timer, delay_us) == ESP_OK;
+}
+
+void core_hal_timer_stop(core_hal_timer_t *timer)
+{
+    esp_timer_stop((esp_timer_handle_t)timer);
+}
+
+// A background timer is a plain timer whose callback only sets its bit in
+// the worker's notification value; bits of timers that fire again before
+// the worker gets to them merge into one call
+typedef struct {
+    core_hal_timer_cb_t cb;
+    void *arg;
+} bg_timer_t;
+
+static bg_timer_t bg_timers[BG_TIMERS_MAX];
+static size_t bg_timer_count = 0;
+static TaskHandle_t bg_task = NULL;
+
+static void bg_timer_fired(void *arg)
+{
+    xTaskNotify(bg_task, 1u << (uint32_t)(uintptr_t)arg, eSetBits);
+}
+
+static void bg_task_fn(void *arg)
+{
+    (void)arg;
+    for (;;) {
+        uint32_t pending = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &pending, portMAX_DELAY);
+        while (pending) {
+            int i = __builtin_ctz(pending);
+            pending &= pending - 1;
+            bg_timers[i].cb(bg_timers[i].arg);
+        }
+    }
+}
+
+// Called at init, from one task
+core_hal_timer_t *core_hal_timer_create_background(const char *name, core_hal_timer_cb_t cb, void *arg)
+{
+    if (bg_timer_count >= BG_TIMERS_MAX) {
+        ESP_LOGE(TAG, "No background timer left for %s", name);
+        return NULL;
+    }
+    // Core 0, away from the LVGL task
+    if (bg_task == NULL &&
+        xTaskCreatePinnedToCore(bg_task_fn, "core_bg", BG_TASK_STACK, NULL, BG_TASK_PRIO, &bg_task, 0) != pdPASS) {
+        bg_task = NULL;
+        return NULL;
+    }
+
+    size_t index = bg_timer_count;
+    core_hal_timer_t *timer = core_hal_timer_create(name, bg_timer_fired, (void *)(uintptr_t)index);
+    if (timer == NULL) {
+        return NULL;
+    }
+    bg_timers[index] = (bg_timer_t){ .cb = cb, .arg = arg };
+    bg_timer_count++;
+    return timer;
+}
+
+// ============================================================================
+// Storage
+// ============================================================================
+
+bool core_hal_storage_load(const char *key, void *buf, size_t *len)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(STORAGE_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return false;
+    }
+    esp_err_t err = nvs_get_blob(nvs, key, buf, len);
+    nvs_close(nvs);
+
+    if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+        ESP_LOGW(TAG, "Reading %s failed: %s", key, esp_err_to_name(err));
+    }
+    return err == ESP_OK;
+}
+
+bool core_hal_storage_save(const char *key, const void *buf, size_t len)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(STORAGE_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, key, buf, len);
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Writing %s failed: %s", key, esp_err_to_name(err));
+    }
+    return err == ESP_OK;
+}
+
+// ============================================================================
+// Log region
+// ============================================================================
+
+static const esp_partition_t *region_partition(void)
+{
+    static const esp_partition_t *part = NULL;
+    static bool searched = false;
+
+    if (!searched) {
+        part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, REGION_PARTITION);
+        searched = true;
+        if (part == NULL) {
+            ESP_LOGW(TAG, "No %s partition, logs are kept in RAM only", REGION_PARTITION);
+        }
+    }
+    return part;
+}
+
+bool core_hal_region_info(size_t *size, size_t *sector_size)
+{
+    const esp_partition_t *part = region_partition();
+    if (part == NULL) {
+        return false;
+    }
+    *size = part->size;
+    *sector_size = part->erase_size;
+    return true;
+}
+
+bool core_hal_region_read(size_t offset, void *buf, size_t len)
+{
+    const esp_partition_t *part = region_partition();
+    return part != NULL && esp_partition_read(part, offset, buf, len) == ESP_OK;
+}
+
+bool core_hal_region_write(size_t offset, const void *buf, size_t len)
+{
+    const esp_partition_t *part = region_partition();
+    if (part == NULL) {
+        return false;
+    }
+    esp_err_t err = esp_partition_write(part, offset, buf, len);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Writing %s at 0x%x failed: %s", REGION_PARTITION, (unsigned)offset, esp_err_to_name(err));
+    }
+    return err == ESP_OK;
+}
+
+bool core_hal_region_erase(size_t offset)
+{
+    const esp_partition_t *part = region_partition();
+    if (part == NULL) {
+        return false;
+    }
+    esp_err_t err = esp_partition_erase_range(part, offset, part->erase_size);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Erasing %s at 0x%x failed: %s", REGION_PARTITION, (unsigned)offset, esp_err_to_name(err));
+    }
+    return err == ESP_OK;
+}
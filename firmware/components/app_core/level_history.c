@@ -0,0 +1,403 @@
+/**
+ * @file level_history.c
+ * @brief Min/max bucket rings of the water level, with a flash log
+ *
+ * Every sample goes straight into the bucket of its time in all three
+ * rings, so reading a view is a copy of LEVEL_HISTORY_POINTS buckets. The
+ * log holds closed minute buckets (min, max and the last level), which is
+ * all it takes to rebuild the coarser rings on replay.
+ *
+ * Log layout: the region is a ring of sectors written front to back. Each
+ * sector starts with a header record carrying its sequence number; the
+ * sector after the newest one holds the oldest data and is erased when
+ * the writer reaches it. A record that does not check out (torn by a
+ * power cut) is skipped on replay.
+ */
+
+#include "level_history.h"
+#include <string.h>
+#include <inttypes.h>
+#include "core_hal.h"
+#include "core_config.h"
+
+static const char *TAG = "HISTORY";
+
+#define LOG_MAGIC_0         'L'
+#define LOG_MAGIC_1         'H'
+#define LOG_VERSION         1
+#define LOG_READ_RECORDS    32
+
+// One minute bucket, or the sector header at the start of each sector
+typedef struct __attribute__((packed)) {
+    uint32_t time;          /**< Start of the minute; header: sector sequence number */
+    uint8_t min;            /**< Header: LOG_MAGIC_0 */
+    uint8_t max;            /**< Header: LOG_MAGIC_1 */
+    uint8_t last;           /**< Header: LOG_VERSION */
+    uint8_t check;          /**< CRC-8 of the bytes before */
+} log_record_t;
+
+typedef struct {
+    uint32_t width_s;
+    int64_t head;           /**< Number (time / width_s) of the newest bucket, -1 when empty */
+    level_history_point_t slot[LEVEL_HISTORY_POINTS];   /**< Bucket n in slot[n % POINTS] */
+} history_ring_t;
+
+static history_ring_t rings[LEVEL_HISTORY_VIEWS] = {
+    [LEVEL_HISTORY_HOUR] = { .width_s = 60, .head = -1 },
+    [LEVEL_HISTORY_DAY] = { .width_s = 24 * 60, .head = -1 },
+    [LEVEL_HISTORY_WEEK] = { .width_s = 168 * 60, .head = -1 },
+};
+// Last level within each minute bucket, LEVEL_HISTORY_NONE if it got no
+// sample of its own (it only carries the level on and is not logged)
+static uint8_t minute_last[LEVEL_HISTORY_POINTS];
+
+static uint8_t last_level = LEVEL_HISTORY_NONE;
+static int64_t last_time = 0;
+static core_hal_lock_t *lock = NULL;
+static level_history_stats_t stats;
+
+// Log writer state, owned by the background timer after init
+static core_hal_timer_t *flush_timer = NULL;
+static int64_t logged_minute = -1;      // Newest minute bucket in the log; under lock
+static size_t region_size = 0;          // 0: no log
+static size_t sector_size = 0;
+static size_t write_pos = 0;            // Offset of the next record
+static uint32_t sector_seq = 0;         // Sequence number of the sector at write_pos
+
+static uint8_t crc8(const uint8_t *data, size_t len)
+{
+    uint8_t crc = 0;
+    while (len--) {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++) {
+            crc = crc & 0x80 ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void record_seal(log_record_t *rec)
+{
+    rec->check = crc8((const uint8_t *)rec, sizeof(*rec) - 1);
+}
+
+static bool record_valid(const log_record_t *rec)
+{
+    return rec->check == crc8((const uint8_t *)rec, sizeof(*rec) - 1);
+}
+
+static bool record_erased(const log_record_t *rec)
+{
+    static const log_record_t erased = { 0xFFFFFFFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    return memcmp(rec, &erased, sizeof(*rec)) == 0;
+}
+
+static bool header_valid(const log_record_t *rec)
+{
+    return record_valid(rec) && rec->min == LOG_MAGIC_0 && rec->max == LOG_MAGIC_1 &&
+           rec->last == LOG_VERSION;
+}
+
+// ============================================================================
+// Rings
+// ============================================================================
+
+/**
+ * @brief Move the head of a ring forward to bucket n
+ *
+ * The buckets in between get the level carried on from before; at most
+ * one ring's worth is touched, however long the gap.
+ */
+static void ring_advance(history_ring_t *ring, int64_t n, uint8_t carry, uint8_t *last)
+{
+    if (n <= ring->head) return;
+
+    int64_t first = ring->head < 0 || n - ring->head > LEVEL_HISTORY_POINTS
+                    ? n - LEVEL_HISTORY_POINTS + 1
+                    : ring->head + 1;
+    if (first < 0) first = 0;
+    for (int64_t i = first; i <= n; i++) {
+        size_t s = (size_t)(i % LEVEL_HISTORY_POINTS);
+        if (carry == LEVEL_HISTORY_NONE) {
+            ring->slot[s] = (level_history_point_t){ LEVEL_HISTORY_NONE, 0 };
+        } else {
+            ring->slot[s] = (level_history_point_t){ carry, carry };
+        }
+        if (last) last[s] = LEVEL_HISTORY_NONE;
+    }
+    ring->head = n;
+}
+
+/**
+ * @brief Fold a level range observed at time into every ring; lock held
+ *
+ * @return false if the time is older than all rings
+ */
+static bool history_merge(int64_t time, uint8_t min, uint8_t max, uint8_t last)
+{
+    bool recorded = false;
+
+    if (time <= 0) return false;
+    for (size_t v = 0; v < LEVEL_HISTORY_VIEWS; v++) {
+        history_ring_t *ring = &rings[v];
+        int64_t n = time / ring->width_s;
+
+        ring_advance(ring, n, last_level, v == LEVEL_HISTORY_HOUR ? minute_last : NULL);
+        if (n <= ring->head - LEVEL_HISTORY_POINTS) continue;
+
+        size_t s = (size_t)(n % LEVEL_HISTORY_POINTS);
+        level_history_point_t *p = &ring->slot[s];
+        if (p->min == LEVEL_HISTORY_NONE) {
+            p->min = min;
+            p->max = max;
+        } else {
+            if (min < p->min) p->min = min;
+            if (max > p->max) p->max = max;
+        }
+        // A late sample only stands for the end of a minute that had none
+        if (v == LEVEL_HISTORY_HOUR && (n == ring->head || minute_last[s] == LEVEL_HISTORY_NONE)) {
+            minute_last[s] = last;
+        }
+        recorded = true;
+    }
+
+    if (recorded && time >= last_time) {
+        last_time = time;
+        last_level = last;
+    }
+    return recorded;
+}
+
+// ============================================================================
+// Log
+// ============================================================================
+
+static bool log_append(const log_record_t *rec)
+{
+    if (write_pos % sector_size == 0) {
+        // Entering a sector: it holds the oldest data
+        log_record_t header = {
+            .time = sector_seq + 1,
+            .min = LOG_MAGIC_0,
+            .max = LOG_MAGIC_1,
+            .last = LOG_VERSION,
+        };
+        record_seal(&header);
+        if (!core_hal_region_erase(write_pos) ||
+            !core_hal_region_write(write_pos, &header, sizeof(header))) {
+            stats.log_errors++;
+            return false;
+        }
+        sector_seq++;
+        write_pos += sizeof(header);
+    }
+
+    if (!core_hal_region_write(write_pos, rec, sizeof(*rec))) {
+        // Skip the slot: it may be partly written and cannot be rewritten
+        stats.log_errors++;
+        write_pos += sizeof(*rec);
+        if (write_pos == region_size) write_pos = 0;
+        return false;
+    }
+    write_pos += sizeof(*rec);
+    if (write_pos == region_size) write_pos = 0;
+    return true;
+}
+
+/**
+ * @brief Replay one sector
+ *
+ * @return Offset of its first erased record, sector_size if it is full
+ */
+static size_t log_replay_sector(size_t base)
+{
+    log_record_t recs[LOG_READ_RECORDS];
+
+    for (size_t off = sizeof(log_record_t); off < sector_size; off += sizeof(recs)) {
+        size_t len = sector_size - off < sizeof(recs) ? sector_size - off : sizeof(recs);
+        if (!core_hal_region_read(base + off, recs, len)) return off;
+
+        for (size_t i = 0; i < len / sizeof(log_record_t); i++) {
+            const log_record_t *rec = &recs[i];
+            if (record_erased(rec)) return off + i * sizeof(log_record_t);
+            if (!record_valid(rec)) continue;
+
+            core_hal_lock_take(lock);
+            history_merge(rec->time, rec->min, rec->max, rec->last);
+            int64_t minute = rec->time / 60;
+            if (minute > logged_minute) logged_minute = minute;
+            core_hal_lock_give(lock);
+            stats.replayed++;
+        }
+    }
+    return sector_size;
+}
+
+static void log_open(void)
+{
+    if (!core_hal_region_info(&region_size, &sector_size) || sector_size < 2 * sizeof(log_record_t) ||
+        region_size < 2 * sector_size) {
+        region_size = 0;
+        return;
+    }
+    region_size -= region_size % sector_size;
+
+    size_t sectors = region_size / sector_size;
+    size_t newest = 0;
+    bool found = false;
+    log_record_t header;
+
+    for (size_t s = 0; s < sectors; s++) {
+        if (core_hal_region_read(s * sector_size, &header, sizeof(header)) && header_valid(&header) &&
+            (!found || header.time > sector_seq)) {
+            newest = s;
+            sector_seq = header.time;
+            found = true;
+        }
+    }
+
+    write_pos = 0;
+    if (found) {
+        // Oldest first: the sector after the newest one, around the ring
+        for (size_t i = 1; i <= sectors; i++) {
+            size_t s = (newest + i) % sectors;
+            if (!core_hal_region_read(s * sector_size, &header, sizeof(header)) || !header_valid(&header)) {
+                continue;
+            }
+            size_t end = log_replay_sector(s * sector_size);
+            if (s == newest) {
+                write_pos = (s * sector_size + end) % region_size;
+            }
+        }
+    }
+    stats.log_capacity = (uint32_t)((sectors - 1) * (sector_size / sizeof(log_record_t) - 1));
+}
+
+static void flush_timer_cb(void *arg)
+{
+    (void)arg;
+    log_record_t recs[LEVEL_HISTORY_POINTS];
+    size_t count = 0;
+    bool pending = false;
+
+    core_hal_lock_take(lock);
+    const history_ring_t *ring = &rings[LEVEL_HISTORY_HOUR];
+    // The current minute may still get samples
+    int64_t closed = core_hal_wall_time() / 60 - 1;
+    if (closed > ring->head) closed = ring->head;
+
+    int64_t first = logged_minute + 1;
+    if (first <= ring->head - LEVEL_HISTORY_POINTS) first = ring->head - LEVEL_HISTORY_POINTS + 1;
+    for (int64_t n = first; n <= closed; n++) {
+        size_t s = (size_t)(n % LEVEL_HISTORY_POINTS);
+        if (minute_last[s] == LEVEL_HISTORY_NONE) continue;
+        recs[count] = (log_record_t){
+            .time = (uint32_t)(n * 60),
+            .min = ring->slot[s].min,
+            .max = ring->slot[s].max,
+            .last = minute_last[s],
+        };
+        record_seal(&recs[count]);
+        count++;
+    }
+    if (closed > logged_minute) logged_minute = closed;
+    pending = ring->head > logged_minute && minute_last[ring->head % LEVEL_HISTORY_POINTS] != LEVEL_HISTORY_NONE;
+    core_hal_lock_give(lock);
+
+    // Flash writes outside the lock; this context is the only writer
+    for (size_t i = 0; i < count; i++) {
+        if (log_append(&recs[i])) stats.logged++;
+    }
+    if (pending) {
+        core_hal_timer_start_once(flush_timer, (uint64_t)CONFIG_LEVEL_HISTORY_FLUSH_MIN * 60 * 1000000);
+    }
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+void level_history_init(void)
+{
+    lock = core_hal_lock_create();
+    log_open();
+
+    if (region_size == 0) {
+        CORE_LOGW(TAG, "No log region, history starts empty after every boot");
+        return;
+    }
+    flush_timer = core_hal_timer_create_background("history", flush_timer_cb, NULL);
+    if (flush_timer == NULL) {
+        CORE_LOGE(TAG, "No timer, history will not be logged");
+    }
+    CORE_LOGI(TAG, "Replayed %" PRIu32 " minutes, log keeps %" PRIu32, stats.replayed, stats.log_capacity);
+}
+
+void level_history_add(int64_t time, uint8_t level)
+{
+    if (lock == NULL) return;
+
+    core_hal_lock_take(lock);
+    bool recorded = history_merge(time, level, level, level);
+    if (recorded) {
+        stats.samples++;
+    } else {
+        stats.dropped++;
+    }
+    core_hal_lock_give(lock);
+
+    if (recorded && flush_timer != NULL) {
+        // Keeps the deadline when armed, so a stream of samples is flushed too
+        core_hal_timer_start_once(flush_timer, (uint64_t)CONFIG_LEVEL_HISTORY_FLUSH_MIN * 60 * 1000000);
+    }
+}
+
+size_t level_history_read(level_history_view_t view, level_history_point_t out[LEVEL_HISTORY_POINTS])
+{
+    history_ring_t ring;
+    uint8_t carry;
+    int64_t now = core_hal_wall_time();
+
+    if (lock == NULL || view >= LEVEL_HISTORY_VIEWS) {
+        memset(out, 0, LEVEL_HISTORY_POINTS * sizeof(*out));
+        for (size_t i = 0; i < LEVEL_HISTORY_POINTS; i++) out[i].min = LEVEL_HISTORY_NONE;
+        return 0;
+    }
+    core_hal_lock_take(lock);
+    ring = rings[view];
+    carry = last_level;
+    core_hal_lock_give(lock);
+
+    // Up to now, on the copy: reading never changes the rings
+    if (now > 0 && ring.head >= 0) {
+        ring_advance(&ring, now / ring.width_s, carry, NULL);
+    }
+
+    size_t filled = 0;
+    for (size_t i = 0; i < LEVEL_HISTORY_POINTS; i++) {
+        int64_t n = ring.head - (LEVEL_HISTORY_POINTS - 1) + (int64_t)i;
+        if (ring.head < 0 || n < 0) {
+            out[i] = (level_history_point_t){ LEVEL_HISTORY_NONE, 0 };
+        } else {
+            out[i] = ring.slot[n % LEVEL_HISTORY_POINTS];
+        }
+        if (out[i].min != LEVEL_HISTORY_NONE) filled++;
+    }
+    return filled;
+}
+
+uint32_t level_history_bucket_s(level_history_view_t view)
+{
+    return view < LEVEL_HISTORY_VIEWS ? rings[view].width_s : 0;
+}
+
+void level_history_get_stats(level_history_stats_t *out)
+{
+    if (lock == NULL) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    core_hal_lock_take(lock);
+    *out = stats;
+    core_hal_lock_give(lock);
+}
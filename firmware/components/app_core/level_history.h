@@ -0,0 +1,97 @@
+/**
+ * @file level_history.h
+ * @brief Water level time series for the history chart
+ *
+ * Samples are folded into min/max buckets as they arrive, at three levels
+ * of detail, each a ring of LEVEL_HISTORY_POINTS buckets: 1 minute (the
+ * last hour), 24 minutes (the last day) and 168 minutes (the last week).
+ * A view is one ring copied out as it is, so drawing a week takes exactly
+ * as many points as drawing an hour, however many samples came in. The
+ * memory is fixed; nothing is allocated.
+ *
+ * The level is a state, not an event: a bucket without samples holds the
+ * level of the one before it. Buckets are numbered on the wall clock, so
+ * samples are only recorded once it is set.
+ *
+ * Minute buckets are appended to a log in the HAL log region (the storage
+ * partition on the device) every LEVEL_HISTORY_FLUSH_MIN minutes, from a
+ * HAL background timer. The log is replayed at init, so the chart survives a
+ * reboot; when the region is full, its oldest sector is erased.
+ */
+
+#ifndef LEVEL_HISTORY_H
+#define LEVEL_HISTORY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Buckets per view */
+#define LEVEL_HISTORY_POINTS    60
+
+/** min of a bucket without any data (max is 0 then) */
+#define LEVEL_HISTORY_NONE      0xFF
+
+typedef enum {
+    LEVEL_HISTORY_HOUR,     /**< 1 minute buckets */
+    LEVEL_HISTORY_DAY,      /**< 24 minute buckets */
+    LEVEL_HISTORY_WEEK,     /**< 168 minute buckets */
+    LEVEL_HISTORY_VIEWS
+} level_history_view_t;
+
+typedef struct {
+    uint8_t min;            /**< Lowest level in the bucket, LEVEL_HISTORY_NONE if empty */
+    uint8_t max;            /**< Highest level in the bucket */
+} level_history_point_t;
+
+typedef struct {
+    uint32_t samples;       /**< Levels recorded since boot */
+    uint32_t dropped;       /**< Levels not recorded: wall clock unset or too old */
+    uint32_t replayed;      /**< Minute buckets restored from the log at init */
+    uint32_t logged;        /**< Minute buckets appended to the log since boot */
+    uint32_t log_errors;    /**< Failed region writes or erases */
+    uint32_t log_capacity;  /**< Minute buckets the log keeps, 0 without a log region */
+} level_history_stats_t;
+
+/**
+ * @brief Replay the log and start the deferred log writer
+ *
+ * Call once, before level_history_add(); the HAL timers must be usable.
+ */
+void level_history_init(void);
+
+/**
+ * @brief Record a level at wall clock time (seconds since the epoch)
+ *
+ * Safe from any task. Levels older than the newest hour bucket still
+ * update the coarser buckets they fall into.
+ */
+void level_history_add(int64_t time, uint8_t level);
+
+/**
+ * @brief Copy a view, oldest bucket first
+ *
+ * The last point is the bucket holding the current wall clock time (the
+ * newest recorded one while the clock is unset). Safe from any task; the
+ * cost does not depend on the view.
+ *
+ * @return Number of points with data
+ */
+size_t level_history_read(level_history_view_t view, level_history_point_t out[LEVEL_HISTORY_POINTS]);
+
+/**
+ * @brief Bucket width of a view in seconds
+ */
+uint32_t level_history_bucket_s(level_history_view_t view);
+
+void level_history_get_stats(level_history_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEVEL_HISTORY_H */
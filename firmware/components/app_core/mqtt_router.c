@@ -0,0 +1,309 @@
+#include "mqtt_router.h"
+#include <stdbool.h>
+#include <string.h>
+#include "core_hal.h"
+#include "core_config.h"
+
+static const char *TAG = "MQTT_ROUTER";
+
+// Exact-topic hash table; a power of two comfortably above MAX_ROUTES
+#define EXACT_SLOTS         32
+#define EMPTY_SLOT          0xFF
+
+// Level hash values a compiled filter can hold besides real hashes
+#define LEVEL_ANY           0x00000000u   // '+'
+#define LEVEL_REST          0x00000001u   // '#'
+
+typedef struct {
+    const char *filter;
+    mqtt_route_handler_t handler;
+    void *ctx;
+    bool wildcard;
+    uint8_t level_count;
+    uint32_t levels[MQTT_ROUTER_MAX_LEVELS];
+    uint32_t hash;                  // Whole-filter hash (exact routes)
+} mqtt_route_t;
+
+static mqtt_route_t routes[MQTT_ROUTER_MAX_ROUTES];
+static size_t route_count = 0;
+
+static uint8_t exact_table[EXACT_SLOTS];
+static bool exact_table_ready = false;
+// Wildcard routes, by index into routes[]
+static uint8_t wildcard_routes[MQTT_ROUTER_MAX_ROUTES];
+static size_t wildcard_count = 0;
+
+// Reassembly of fragmented messages
+static char rx_buf[CONFIG_MQTT_ROUTER_MAX_PAYLOAD];
+static uint32_t rx_matches = 0;     // Bit per route, resolved on the first chunk
+static size_t rx_total = 0;
+static size_t rx_received = 0;
+static bool rx_active = false;
+static char rx_topic[MQTT_ROUTER_MAX_TOPIC_LEN];
+static size_t rx_topic_len = 0;
+
+// ==================== Hashing ====================
+
+#define FNV_OFFSET  2166136261u
+#define FNV_PRIME   16777619u
+
+// Level hashes are kept clear of the two marker values
+static inline uint32_t level_hash_finish(uint32_t h)
+{
+    return h <= LEVEL_REST ? h + 2 : h;
+}
+
+typedef struct {
+    uint32_t hash;
+    uint8_t level_count;            // MAX_LEVELS + 1 if the topic is deeper
+    uint32_t levels[MQTT_ROUTER_MAX_LEVELS];
+} topic_key_t;
+
+// One pass: hash of the whole topic and of each level
+static void topic_key(const char *topic, size_t len, topic_key_t *key)
+{
+    uint32_t h = FNV_OFFSET;
+    uint32_t lh = FNV_OFFSET;
+    uint8_t n = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        uint8_t c = (uint8_t)topic[i];
+        h = (h ^ c) * FNV_PRIME;
+        if (c == '/') {
+            if (n < MQTT_ROUTER_MAX_LEVELS) key->levels[n] = level_hash_finish(lh);
+            n++;
+            lh = FNV_OFFSET;
+        } else {
+            lh = (lh ^ c) * FNV_PRIME;
+        }
+    }
+    if (n < MQTT_ROUTER_MAX_LEVELS) key->levels[n] = level_hash_finish(lh);
+    n++;
+
+    key->hash = h;
+    key->level_count = n > MQTT_ROUTER_MAX_LEVELS ? MQTT_ROUTER_MAX_LEVELS + 1 : n;
+}
+
+// ==================== Registration ====================
+
+static void exact_table_insert(size_t index)
+{
+    if (!exact_table_ready) {
+        memset(exact_table, EMPTY_SLOT, sizeof(exact_table));
+        exact_table_ready = true;
+    }
+    uint32_t slot = routes[index].hash & (EXACT_SLOTS - 1);
+    while (exact_table[slot] != EMPTY_SLOT) {
+        slot = (slot + 1) & (EXACT_SLOTS - 1);
+    }
+    exact_table[slot] = (uint8_t)index;
+}
+
+bool mqtt_router_add(const char *filter, mqtt_route_handler_t handler, void *ctx)
+{
+    if (filter == NULL || handler == NULL || filter[0] == '\0') return false;
+    if (route_count >= MQTT_ROUTER_MAX_ROUTES) return false;
+
+    size_t len = strlen(filter);
+    if (len >= MQTT_ROUTER_MAX_TOPIC_LEN) return false;
+
+    mqtt_route_t *r = &routes[route_count];
+    topic_key_t key;
+    topic_key(filter, len, &key);
+    if (key.level_count > MQTT_ROUTER_MAX_LEVELS) return false;
+
+    // Replace wildcard levels by their markers; '#' must be the last level
+    bool wildcard = false;
+    const char *level = filter;
+    for (uint8_t i = 0; i < key.level_count; i++) {
+        const char *end = strchr(level, '/');
+        size_t level_len = end ? (size_t)(end - level) : strlen(level);
+        if (level_len == 1 && level[0] == '+') {
+            key.levels[i] = LEVEL_ANY;
+            wildcard = true;
+        } else if (level_len == 1 && level[0] == '#') {
+            if (i != key.level_count - 1) return false;
+            key.levels[i] = LEVEL_REST;
+            wildcard = true;
+        } else if (memchr(level, '+', level_len) || memchr(level, '#', level_len)) {
+            return false;
+        }
+        level = end ? end + 1 : level + level_len;
+    }
+
+    r->filter = filter;
+    r->handler = handler;
+    r->ctx = ctx;
+    r->wildcard = wildcard;
+    r->level_count = key.level_count;
+    memcpy(r->levels, key.levels, sizeof(r->levels));
+    r->hash = key.hash;
+
+    if (wildcard) {
+        wildcard_routes[wildcard_count++] = (uint8_t)route_count;
+    } else {
+        exact_table_insert(route_count);
+    }
+    route_count++;
+
+    CORE_LOGD(TAG, "Route %u: %s", (unsigned)(route_count - 1), filter);
+    return true;
+}
+
+size_t mqtt_router_get_count(void)
+{
+    return route_count;
+}
+
+const char *mqtt_router_get_filter(size_t index)
+{
+    return index < route_count ? routes[index].filter : NULL;
+}
+
+// ==================== Matching ====================
+
+static bool wildcard_match(const mqtt_route_t *r, const topic_key_t *key)
+{
+    for (uint8_t i = 0; i < r->level_count; i++) {
+        if (r->levels[i] == LEVEL_REST) {
+            // "a/#" also matches "a" itself
+            return true;
+        }
+        if (i >= key->level_count) {
+            return false;
+        }
+        if (r->levels[i] != LEVEL_ANY && r->levels[i] != key->levels[i]) {
+            return false;
+        }
+    }
+    return r->level_count == key->level_count;
+}
+
+// Confirms a hash match of a wildcard filter on the text, level by level
+static bool wildcard_confirm(const char *filter, const char *topic, size_t len)
+{
+    const char *t = topic;
+    const char *t_stop = topic + len;
+
+    for (;;) {
+        const char *f_end = strchr(filter, '/');
+        size_t f_len = f_end ? (size_t)(f_end - filter) : strlen(filter);
+        if (f_len == 1 && filter[0] == '#') {
+            return true;
+        }
+        const char *t_end = memchr(t, '/', (size_t)(t_stop - t));
+        size_t t_len = t_end ? (size_t)(t_end - t) : (size_t)(t_stop - t);
+        bool any = f_len == 1 && filter[0] == '+';
+        if (!any && (f_len != t_len || memcmp(filter, t, f_len) != 0)) {
+            return false;
+        }
+        if (f_end == NULL) {
+            return t_end == NULL;
+        }
+        if (t_end == NULL) {
+            // "a/#" also matches "a" itself
+            return strcmp(f_end + 1, "#") == 0;
+        }
+        filter = f_end + 1;
+        t = t_end + 1;
+    }
+}
+
+// Bit set of routes matching the topic. Hashes only select candidates;
+// every hit is confirmed on the text so collisions cannot misroute.
+static uint32_t match_routes(const char *topic, size_t len)
+{
+    uint32_t matches = 0;
+    topic_key_t key;
+    topic_key(topic, len, &key);
+
+    if (exact_table_ready) {
+        uint32_t slot = key.hash & (EXACT_SLOTS - 1);
+        while (exact_table[slot] != EMPTY_SLOT) {
+            const mqtt_route_t *r = &routes[exact_table[slot]];
+            if (r->hash == key.hash && strncmp(r->filter, topic, len) == 0 && r->filter[len] == '\0') {
+                matches |= 1u << exact_table[slot];
+            }
+            slot = (slot + 1) & (EXACT_SLOTS - 1);
+        }
+    }
+
+    // MQTT: topics starting with '$' are not matched by leading wildcards
+    bool system_topic = len > 0 && topic[0] == '$';
+    for (size_t i = 0; i < wildcard_count; i++) {
+        const mqtt_route_t *r = &routes[wildcard_routes[i]];
+        if (system_topic && (r->levels[0] == LEVEL_ANY || r->levels[0] == LEVEL_REST)) continue;
+        if (wildcard_match(r, &key) && wildcard_confirm(r->filter, topic, len)) {
+            matches |= 1u << wildcard_routes[i];
+        }
+    }
+    return matches;
+}
+
+static int call_handlers(uint32_t matches, const char *topic, size_t topic_len,
+                         const char *data, size_t len)
+{
+    int called = 0;
+    while (matches) {
+        int i = __builtin_ctz(matches);
+        matches &= matches - 1;
+        routes[i].handler(topic, topic_len, data, len, routes[i].ctx);
+        called++;
+    }
+    return called;
+}
+
+// ==================== Dispatch ====================
+
+int mqtt_router_dispatch(const char *topic, size_t topic_len,
+                         const char *data, size_t data_len,
+                         size_t offset, size_t total_len)
+{
+    if (offset == 0) {
+        if (rx_active) {
+            CORE_LOGW(TAG, "Incomplete message dropped (%u/%u bytes)",
+                      (unsigned)rx_received, (unsigned)rx_total);
+            rx_active = false;
+        }
+        if (topic == NULL || topic_len == 0) return 0;
+
+        uint32_t matches = match_routes(topic, topic_len);
+        if (matches == 0) {
+            CORE_LOGD(TAG, "No route for %.*s", (int)topic_len, topic);
+            return 0;
+        }
+
+        // Common case: the whole message is in this chunk, no copy
+        if (data_len >= total_len) {
+            return call_handlers(matches, topic, topic_len, data, data_len);
+        }
+
+        if (total_len > sizeof(rx_buf) || topic_len > sizeof(rx_topic)) {
+            CORE_LOGW(TAG, "%.*s: %u byte message exceeds buffer, dropped",
+                      (int)topic_len, topic, (unsigned)total_len);
+            return 0;
+        }
+        memcpy(rx_topic, topic, topic_len);
+        rx_topic_len = topic_len;
+        rx_matches = matches;
+        rx_total = total_len;
+        rx_received = 0;
+        rx_active = true;
+    } else if (!rx_active || offset != rx_received) {
+        // Continuation of a message nobody wants, or out of sequence
+        rx_active = false;
+        return 0;
+    }
+
+    if (data_len > rx_total - rx_received) {
+        rx_active = false;
+        return 0;
+    }
+    memcpy(rx_buf + rx_received, data, data_len);
+    rx_received += data_len;
+
+    if (rx_received < rx_total) return 0;
+
+    rx_active = false;
+    return call_handlers(rx_matches, rx_topic, rx_topic_len, rx_buf, rx_total);
+}
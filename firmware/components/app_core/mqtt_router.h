@@ -0,0 +1,40 @@
+#ifndef MQTT_ROUTER_H
+#define MQTT_ROUTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Table-driven MQTT topic router.
+//
+// Routes are registered once at startup with an MQTT topic filter, which
+// may use the '+' (one level) and '#' (remaining levels) wildcards. Filters
+// are precompiled into per-level hashes, so dispatching a message costs one
+// pass over its topic plus integer compares, however many routes exist.
+// Messages split over several MQTT_EVENT_DATA events are reassembled into a
+// preallocated buffer; single-chunk messages are passed through untouched.
+
+#define MQTT_ROUTER_MAX_ROUTES      16
+#define MQTT_ROUTER_MAX_LEVELS      8
+#define MQTT_ROUTER_MAX_TOPIC_LEN   128
+
+// Payload is not NUL-terminated and only valid during the call
+typedef void (*mqtt_route_handler_t)(const char *topic, size_t topic_len,
+                                     const char *data, size_t len, void *ctx);
+
+// Register a handler for a topic filter. The filter string must outlive the
+// router (a literal). Not thread-safe; call before the client starts.
+// Returns false if the filter is malformed or too long, or the table is full.
+bool mqtt_router_add(const char *filter, mqtt_route_handler_t handler, void *ctx);
+
+// Feed one MQTT_EVENT_DATA chunk. topic is only present on the first chunk
+// (offset 0) of a message. Returns the number of handlers called.
+int mqtt_router_dispatch(const char *topic, size_t topic_len,
+                         const char *data, size_t data_len,
+                         size_t offset, size_t total_len);
+
+// Registered filters, e.g. to subscribe after (re)connecting
+size_t mqtt_router_get_count(void);
+const char *mqtt_router_get_filter(size_t index);
+
+#endif // MQTT_ROUTER_H
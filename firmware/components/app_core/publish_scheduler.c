@@ -0,0 +1,140 @@
+/**
+ * @file publish_scheduler.c
+ * @brief Coalescing MQTT publish scheduler implementation
+ *
+ * Each topic owns a one-shot HAL timer. The first request of a burst arms
+ * it; later requests only count as coalesced. All building and enqueueing
+ * runs in the timer context (the esp_timer task on the device), so
+ * publishes are serialised and never block the caller (typically the LVGL
+ * task).
+ */
+
+#include "publish_scheduler.h"
+#include <stdatomic.h>
+#include <string.h>
+#include "core_hal.h"
+#include "core_config.h"
+
+static const char *TAG = "PUBLISH";
+
+// Retry delay while the outbox is over its limit or the enqueue failed
+#define PUBLISH_RETRY_MS 1000
+
+#define PUBLISH_PAYLOAD_MAX 128
+
+typedef struct {
+    publish_topic_config_t config;
+    core_hal_timer_t *timer;
+    atomic_bool pending;
+} publish_topic_t;
+
+static publish_topic_t topics[PUBLISH_SCHEDULER_MAX_TOPICS];
+static size_t topic_count = 0;
+static const publish_sink_t *volatile sink = NULL;
+
+static atomic_uint_fast32_t stat_requested;
+static atomic_uint_fast32_t stat_sent;
+static atomic_uint_fast32_t stat_coalesced;
+static atomic_uint_fast32_t stat_dropped;
+
+static void publish_retry_later(publish_topic_t *t)
+{
+    atomic_fetch_add(&stat_dropped, 1);
+    atomic_store(&t->pending, true);
+    core_hal_timer_start_once(t->timer, PUBLISH_RETRY_MS * 1000ULL);
+}
+
+/**
+ * @brief Window expired: publish the topic's current state
+ */
+static void publish_flush_cb(void *arg)
+{
+    publish_topic_t *t = arg;
+    const publish_sink_t *s = sink;
+
+    if (s == NULL) {
+        // Stays pending; published when the sink is attached
+        return;
+    }
+
+    if (s->outbox_size && s->outbox_size() > CONFIG_MQTT_OUTBOX_LIMIT_BYTES) {
+        CORE_LOGD(TAG, "%s: outbox over limit, retrying", t->config.topic);
+        publish_retry_later(t);
+        return;
+    }
+
+    // Clear first: a change made while building re-arms the window
+    atomic_store(&t->pending, false);
+
+    uint8_t payload[PUBLISH_PAYLOAD_MAX];
+    int len = t->config.build(payload, sizeof(payload));
+    if (len < 0) {
+        CORE_LOGW(TAG, "%s: payload not built, not published", t->config.topic);
+        return;
+    }
+
+    if (s->enqueue(t->config.topic, payload, (size_t)len, t->config.qos, t->config.retain) < 0) {
+        publish_retry_later(t);
+        return;
+    }
+    atomic_fetch_add(&stat_sent, 1);
+}
+
+publish_topic_id_t publish_scheduler_register(const publish_topic_config_t *config)
+{
+    if (topic_count >= PUBLISH_SCHEDULER_MAX_TOPICS || config->build == NULL) {
+        return -1;
+    }
+
+    publish_topic_t *t = &topics[topic_count];
+    t->config = *config;
+    atomic_init(&t->pending, false);
+
+    t->timer = core_hal_timer_create("publish", publish_flush_cb, t);
+    if (t->timer == NULL) {
+        return -1;
+    }
+    return (publish_topic_id_t)topic_count++;
+}
+
+void publish_scheduler_set_policy(publish_topic_id_t id, uint8_t qos, bool retain)
+{
+    if (id < 0 || (size_t)id >= topic_count) return;
+
+    topics[id].config.qos = qos > 2 ? 2 : qos;
+    topics[id].config.retain = retain;
+}
+
+void publish_scheduler_request(publish_topic_id_t id)
+{
+    if (id < 0 || (size_t)id >= topic_count) return;
+
+    publish_topic_t *t = &topics[id];
+    atomic_fetch_add(&stat_requested, 1);
+    if (atomic_exchange(&t->pending, true)) {
+        // A message is already scheduled; it will carry this change too
+        atomic_fetch_add(&stat_coalesced, 1);
+        return;
+    }
+    core_hal_timer_start_once(t->timer, t->config.coalesce_ms * 1000ULL);
+}
+
+void publish_scheduler_set_sink(const publish_sink_t *new_sink)
+{
+    sink = new_sink;
+
+    for (size_t i = 0; i < topic_count; i++) {
+        if (atomic_load(&topics[i].pending)) {
+            // Fails harmlessly if the window timer is still running
+            core_hal_timer_start_once(topics[i].timer, 0);
+        }
+    }
+}
+
+void publish_scheduler_get_stats(publish_scheduler_stats_t *out)
+{
+    out->requested = atomic_load(&stat_requested);
+    out->sent = atomic_load(&stat_sent);
+    out->coalesced = atomic_load(&stat_coalesced);
+    out->dropped = atomic_load(&stat_dropped);
+}
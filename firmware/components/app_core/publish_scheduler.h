@@ -0,0 +1,93 @@
+/**
+ * @file publish_scheduler.h
+ * @brief Coalescing MQTT publish scheduler for backend state topics
+ *
+ * State changes do not publish directly. They mark their topic pending, and
+ * once the topic's coalescing window has passed the scheduler builds a single
+ * message from the current state and hands it to the MQTT outbox. A burst of
+ * changes, e.g. bright on forcing relax off, or fast tapping, turns into one
+ * message carrying the final state.
+ */
+
+#ifndef PUBLISH_SCHEDULER_H
+#define PUBLISH_SCHEDULER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PUBLISH_SCHEDULER_MAX_TOPICS 4
+
+typedef int publish_topic_id_t;
+
+/**
+ * @brief Build the payload of a topic from the current state
+ *
+ * Payloads may be binary; the returned length is what gets published.
+ *
+ * @return Payload length, or a negative value to skip this publish
+ */
+typedef int (*publish_build_fn_t)(uint8_t *buf, size_t size);
+
+/**
+ * @brief Topic registration; the strings must outlive the scheduler
+ */
+typedef struct {
+    const char *topic;
+    publish_build_fn_t build;
+    uint8_t qos;            /**< 0, 1 or 2 */
+    bool retain;
+    uint32_t coalesce_ms;   /**< Window collecting changes before a publish */
+} publish_topic_config_t;
+
+/**
+ * @brief Transport used by the scheduler, normally the MQTT manager
+ *
+ * enqueue must not block; it returns the message id or a negative value.
+ * outbox_size returns the bytes currently held in the client outbox.
+ */
+typedef struct {
+    int (*enqueue)(const char *topic, const uint8_t *payload, size_t len, int qos, bool retain);
+    int (*outbox_size)(void);
+} publish_sink_t;
+
+typedef struct {
+    uint32_t requested;     /**< Calls to publish_scheduler_request() */
+    uint32_t sent;          /**< Messages handed to the outbox */
+    uint32_t coalesced;     /**< Requests absorbed into an already pending message */
+    uint32_t dropped;       /**< Publish attempts refused (outbox full or enqueue failed) */
+} publish_scheduler_stats_t;
+
+/**
+ * @brief Register a topic
+ *
+ * @return Topic id, or -1 if the table is full
+ */
+publish_topic_id_t publish_scheduler_register(const publish_topic_config_t *config);
+
+/**
+ * @brief Change the QoS / retain policy of a registered topic
+ */
+void publish_scheduler_set_policy(publish_topic_id_t id, uint8_t qos, bool retain);
+
+/**
+ * @brief Mark a topic's state as changed; safe from any task
+ */
+void publish_scheduler_request(publish_topic_id_t id);
+
+/**
+ * @brief Attach the transport; pending topics are published right away
+ */
+void publish_scheduler_set_sink(const publish_sink_t *sink);
+
+void publish_scheduler_get_stats(publish_scheduler_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PUBLISH_SCHEDULER_H */
@@ -0,0 +1,204 @@
+/**
+ * @file state_persist.c
+ * @brief Deferred, coalescing writer for the backend state
+ *
+ * The state subscriber only records a deadline and arms a HAL timer; the
+ * storage write happens in a background timer callback, never on the LVGL
+ * or MQTT task, nor on the timer context whose other callbacks (render
+ * wakeups, publish windows) would wait behind an NVS page erase.
+ */
+
+#include "state_persist.h"
+#include <string.h>
+#include <inttypes.h>
+#include "core_hal.h"
+#include "core_config.h"
+
+static const char *TAG = "PERSIST";
+
+#define PERSIST_KEY         "state"
+#define PERSIST_VERSION     2
+
+// Stored layout; bump PERSIST_VERSION when it changes
+typedef struct __attribute__((packed)) {
+    uint8_t version;
+    uint8_t bright;
+    uint8_t relax;
+    uint8_t water_level[STATE_TANK_MAX];
+    int64_t water_level_time;
+} persist_blob_t;
+
+// Version 1, from before multiple tanks; restored into tank 0
+typedef struct __attribute__((packed)) {
+    uint8_t version;
+    uint8_t bright;
+    uint8_t relax;
+    uint8_t water_level;
+    int64_t water_level_time;
+} persist_blob_v1_t;
+
+static core_hal_timer_t *save_timer = NULL;
+// Earliest pending deadline (core_hal_time_us), 0 when nothing is pending
+static int64_t save_deadline_us = 0;
+static core_hal_lock_t *deadline_lock = NULL;
+
+static persist_blob_t stored;
+static bool stored_valid = false;
+
+static uint32_t stat_changes;
+static uint32_t stat_writes;
+static uint32_t stat_skipped;
+static uint32_t stat_errors;
+
+static void blob_from_state(persist_blob_t *blob, const backend_state_t *state)
+{
+    memset(blob, 0, sizeof(*blob));
+    blob->version = PERSIST_VERSION;
+    blob->bright = state->bright;
+    blob->relax = state->relax;
+    memcpy(blob->water_level, state->water_level, sizeof(blob->water_level));
+    blob->water_level_time = state->water_level_time;
+}
+
+bool state_persist_load(backend_state_t *state)
+{
+    persist_blob_t blob;
+    size_t len = sizeof(blob);
+    if (!core_hal_storage_load(PERSIST_KEY, &blob, &len)) {
+        CORE_LOGI(TAG, "No saved state");
+        return false;
+    }
+
+    if (len == sizeof(persist_blob_v1_t) && blob.version == 1) {
+        persist_blob_v1_t v1;
+        memcpy(&v1, &blob, sizeof(v1));
+        memset(&blob, 0, sizeof(blob));
+        blob.version = 1;
+        blob.bright = v1.bright;
+        blob.relax = v1.relax;
+        memcpy(blob.water_level, state->water_level, sizeof(blob.water_level));
+        blob.water_level[0] = v1.water_level;
+        blob.water_level_time = v1.water_level_time;
+    } else if (len != sizeof(blob) || blob.version != PERSIST_VERSION) {
+        CORE_LOGW(TAG, "Saved state unusable (%u bytes, version %u), using defaults",
+                  (unsigned)len, blob.version);
+        return false;
+    }
+
+    // Never restore both lights on, whatever is in flash
+    state->bright = blob.bright ? 1 : 0;
+    state->relax = blob.relax && !blob.bright ? 1 : 0;
+    for (size_t i = 0; i < STATE_TANK_MAX; i++) {
+        state->water_level[i] = blob.water_level[i] > 100 ? 100 : blob.water_level[i];
+    }
+    state->water_level_time = blob.water_level_time;
+
+    // A migrated blob is rewritten in the new layout by the first save
+    stored = blob;
+    stored_valid = blob.version == PERSIST_VERSION;
+    CORE_LOGI(TAG, "Restored bright=%u relax=%u level=%u%%", state->bright, state->relax, state->water_level[0]);
+    return true;
+}
+
+static void persist_save(void)
+{
+    backend_state_t state;
+    state_store_snapshot(&state);
+
+    persist_blob_t blob;
+    blob_from_state(&blob, &state);
+    if (stored_valid && memcmp(&blob, &stored, sizeof(blob)) == 0) {
+        // e.g. a light switched on and back off within the delay
+        stat_skipped++;
+        return;
+    }
+
+    if (!core_hal_storage_save(PERSIST_KEY, &blob, sizeof(blob))) {
+        stat_errors++;
+        CORE_LOGW(TAG, "Saving state failed");
+        return;
+    }
+
+    stored = blob;
+    stored_valid = true;
+    stat_writes++;
+
+    state_persist_stats_t stats;
+    state_persist_get_stats(&stats);
+    CORE_LOGI(TAG, "State saved (%" PRIu32 " writes for %" PRIu32 " changes, %" PRIu32 " writes/h)",
+              stats.writes, stats.changes, stats.writes_per_hour);
+}
+
+static void persist_timer_cb(void *arg)
+{
+    (void)arg;
+    bool due = false;
+
+    core_hal_lock_take(deadline_lock);
+    if (save_deadline_us != 0) {
+        int64_t remaining_us = save_deadline_us - core_hal_time_us();
+        if (remaining_us <= 0) {
+            // Cleared before reading the state: a change made during
+            // the save sets a new deadline and is not lost
+            save_deadline_us = 0;
+            due = true;
+        } else {
+            // Fired early, or re-armed while this callback was queued
+            core_hal_timer_start_once(save_timer, (uint64_t)remaining_us);
+        }
+    }
+    core_hal_lock_give(deadline_lock);
+
+    if (due) {
+        persist_save();
+    }
+}
+
+/**
+ * @brief State subscriber: schedule a save, keeping the earliest deadline
+ *
+ * Deadlines are never pushed back, so a stream of water level updates still
+ * gets saved once per delay instead of never.
+ */
+static void on_state_changed(uint32_t changed, const backend_state_t *state, void *ctx)
+{
+    (void)state;
+    (void)ctx;
+
+    uint32_t delay_s = changed & (STATE_FIELD_BRIGHT | STATE_FIELD_RELAX)
+                       ? CONFIG_STATE_PERSIST_LIGHT_DELAY_S
+                       : CONFIG_STATE_PERSIST_LEVEL_DELAY_S;
+    uint64_t delay_us = (uint64_t)delay_s * 1000000;
+    int64_t deadline = core_hal_time_us() + (int64_t)delay_us;
+
+    core_hal_lock_take(deadline_lock);
+    stat_changes++;
+    if (save_deadline_us == 0 || deadline < save_deadline_us) {
+        save_deadline_us = deadline;
+        core_hal_timer_stop(save_timer);
+        core_hal_timer_start_once(save_timer, delay_us);
+    }
+    core_hal_lock_give(deadline_lock);
+}
+
+void state_persist_start(void)
+{
+    deadline_lock = core_hal_lock_create();
+    save_timer = core_hal_timer_create_background("persist", persist_timer_cb, NULL);
+    if (save_timer == NULL) {
+        CORE_LOGE(TAG, "No timer, state will not be saved");
+        return;
+    }
+    state_store_subscribe(STATE_FIELD_ALL, on_state_changed, NULL);
+}
+
+void state_persist_get_stats(state_persist_stats_t *out)
+{
+    int64_t uptime_s = core_hal_time_us() / 1000000;
+
+    out->changes = stat_changes;
+    out->writes = stat_writes;
+    out->skipped = stat_skipped;
+    out->errors = stat_errors;
+    out->writes_per_hour = uptime_s > 0 ? (uint32_t)((int64_t)stat_writes * 3600 / uptime_s) : 0;
+}
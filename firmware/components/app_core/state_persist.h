@@ -0,0 +1,52 @@
+/**
+ * @file state_persist.h
+ * @brief Persistence of the backend state store
+ *
+ * Light mode and the last level of every tank (with the time of the latest)
+ * are kept in one blob in HAL storage (NVS on the device). Changes are not
+ * written immediately: light changes are saved after a short delay, water
+ * level changes after a long one, and all changes in between end up in a
+ * single write. A write whose content matches what is already stored is skipped.
+ */
+
+#ifndef STATE_PERSIST_H
+#define STATE_PERSIST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "state_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t changes;       /**< State changes seen */
+    uint32_t writes;        /**< Blob writes committed to storage */
+    uint32_t skipped;       /**< Deferred saves dropped because nothing differed */
+    uint32_t errors;        /**< Failed storage writes */
+    uint32_t writes_per_hour; /**< Average since boot */
+} state_persist_stats_t;
+
+/**
+ * @brief Load the saved state over the given defaults
+ *
+ * Needs working HAL storage (nvs_flash_init() on the device). Fields stay
+ * at their defaults when nothing valid is stored.
+ *
+ * @return true if a saved state was restored
+ */
+bool state_persist_load(backend_state_t *state);
+
+/**
+ * @brief Subscribe to the state store and start the deferred writer
+ */
+void state_persist_start(void);
+
+void state_persist_get_stats(state_persist_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STATE_PERSIST_H */
@@ -0,0 +1,107 @@
+/**
+ * @file state_store.c
+ * @brief Seqlock-based backend state store
+ *
+ * The sequence counter is odd while a write is in progress. Readers copy the
+ * state between two reads of the counter and retry if it was odd or moved,
+ * so they never block writers and never see half of a transition.
+ */
+
+#include "state_store.h"
+#include <stdatomic.h>
+#include <string.h>
+#include "core_hal.h"
+
+typedef struct {
+    uint32_t mask;
+    state_subscriber_fn_t fn;
+    void *ctx;
+} state_subscriber_t;
+
+static backend_state_t state;
+static atomic_uint_fast32_t seq;
+
+static core_hal_lock_t *writer_lock = NULL;
+
+static state_subscriber_t subscribers[STATE_STORE_MAX_SUBSCRIBERS];
+static size_t subscriber_count = 0;
+
+static uint32_t state_diff(const backend_state_t *a, const backend_state_t *b)
+{
+    uint32_t changed = 0;
+    if (a->bright != b->bright) changed |= STATE_FIELD_BRIGHT;
+    if (a->relax != b->relax) changed |= STATE_FIELD_RELAX;
+    for (size_t i = 0; i < STATE_TANK_MAX; i++) {
+        if (a->water_level[i] != b->water_level[i]) changed |= STATE_FIELD_TANK(i);
+    }
+    return changed;
+}
+
+static void state_write(const backend_state_t *next)
+{
+    atomic_fetch_add_explicit(&seq, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&state, next, sizeof(state));
+    atomic_thread_fence(memory_order_release);
+    atomic_fetch_add_explicit(&seq, 1, memory_order_relaxed);
+}
+
+void state_store_init(const backend_state_t *initial)
+{
+    if (writer_lock == NULL) {
+        writer_lock = core_hal_lock_create();
+    }
+    state_write(initial);
+}
+
+uint32_t state_store_update(state_transition_fn_t fn, void *ctx)
+{
+    core_hal_lock_take(writer_lock);
+
+    // Only writers modify state, and they are serialised, so no seqlock
+    // read is needed here
+    backend_state_t draft = state;
+    fn(&draft, ctx);
+
+    uint32_t changed = state_diff(&state, &draft);
+    if (changed) {
+        draft.version = state.version + 1;
+        state_write(&draft);
+
+        // Still under the writer lock: subscribers see transitions in order
+        for (size_t i = 0; i < subscriber_count; i++) {
+            if (subscribers[i].mask & changed) {
+                subscribers[i].fn(changed & subscribers[i].mask, &draft, subscribers[i].ctx);
+            }
+        }
+    }
+
+    core_hal_lock_give(writer_lock);
+    return changed;
+}
+
+void state_store_snapshot(backend_state_t *out)
+{
+    uint32_t begin, end;
+    do {
+        begin = atomic_load_explicit(&seq, memory_order_acquire);
+        memcpy(out, &state, sizeof(*out));
+        atomic_thread_fence(memory_order_acquire);
+        end = atomic_load_explicit(&seq, memory_order_relaxed);
+    } while ((begin & 1) || begin != end);
+}
+
+bool state_store_subscribe(uint32_t mask, state_subscriber_fn_t fn, void *ctx)
+{
+    if (subscriber_count >= STATE_STORE_MAX_SUBSCRIBERS || fn == NULL) {
+        return false;
+    }
+
+    core_hal_lock_take(writer_lock);
+    subscribers[subscriber_count].mask = mask;
+    subscribers[subscriber_count].fn = fn;
+    subscribers[subscriber_count].ctx = ctx;
+    subscriber_count++;
+    core_hal_lock_give(writer_lock);
+    return true;
+}
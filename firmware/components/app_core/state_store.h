@@ -0,0 +1,87 @@
+/**
+ * @file state_store.h
+ * @brief Versioned backend state with lock-free snapshots and change subscriptions
+ *
+ * All backend state lives in one struct. Writers apply complete transitions
+ * (e.g. "bright on, relax off") under a writer lock and publish them through a
+ * sequence counter, so readers on any task take consistent snapshots without
+ * locking. After every transition that changed something, subscribers get the
+ * bitmask of changed fields together with the new snapshot.
+ */
+
+#ifndef STATE_STORE_H
+#define STATE_STORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STATE_STORE_MAX_SUBSCRIBERS 4
+
+/** Water tanks the state has room for; tank 0 is the main tank */
+#define STATE_TANK_MAX          8
+
+/** Field bits for change masks */
+#define STATE_FIELD_BRIGHT      (1u << 0)
+#define STATE_FIELD_RELAX       (1u << 1)
+#define STATE_FIELD_TANK(i)     (1u << (2 + (i)))   /**< Level of tank i */
+#define STATE_FIELD_WATER_LEVEL STATE_FIELD_TANK(0)
+#define STATE_FIELD_TANKS       (((1u << STATE_TANK_MAX) - 1) << 2)
+#define STATE_FIELD_ALL         (STATE_FIELD_BRIGHT | STATE_FIELD_RELAX | STATE_FIELD_TANKS)
+
+typedef struct {
+    uint32_t version;       /**< Incremented by every transition that changed a field */
+    uint8_t bright;         /**< 0 off, 1 on */
+    uint8_t relax;          /**< 0 off, 1 on */
+    uint8_t water_level[STATE_TANK_MAX]; /**< Percent per tank, 0-100 */
+    int64_t water_level_time; /**< time() when a level was last received, 0 if never */
+} backend_state_t;
+
+/**
+ * @brief Transition function: edit the draft in place
+ *
+ * Runs with the writer lock held; must not block or touch the store.
+ */
+typedef void (*state_transition_fn_t)(backend_state_t *draft, void *ctx);
+
+/**
+ * @brief Change notification
+ *
+ * Called from the writing task, in transition order, with the writer lock
+ * held. Must not block or write the store; hand work off instead (UI queue,
+ * publish scheduler, ...).
+ */
+typedef void (*state_subscriber_fn_t)(uint32_t changed, const backend_state_t *state, void *ctx);
+
+/**
+ * @brief Set the initial state; notifies nobody
+ */
+void state_store_init(const backend_state_t *initial);
+
+/**
+ * @brief Apply one transition atomically
+ *
+ * @return Bitmask of fields that actually changed (0 if none)
+ */
+uint32_t state_store_update(state_transition_fn_t fn, void *ctx);
+
+/**
+ * @brief Consistent copy of the current state, lock-free; any task
+ */
+void state_store_snapshot(backend_state_t *out);
+
+/**
+ * @brief Register for changes of the fields in mask
+ *
+ * @return false if the subscriber table is full
+ */
+bool state_store_subscribe(uint32_t mask, state_subscriber_fn_t fn, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STATE_STORE_H */
@@ -0,0 +1,98 @@
+/**
+ * @file asset_pack.h
+ * @brief On-flash layout of the asset pack (written by tools/mkassets.py)
+ *
+ * All fields are little endian. The pack starts at offset 0 of the assets
+ * partition:
+ *
+ *   asset_pack_header_t
+ *   asset_pack_entry_t[count]   sorted by name (strcmp order)
+ *   pixel data                  each asset 4-byte aligned
+ *
+ * Pixels are LVGL's 16-bit true color (RGB565, LV_COLOR_16_SWAP 0), with an
+ * alpha byte after every pixel for ASSET_CF_RGB565A8, i.e. exactly what
+ * LV_IMG_CF_TRUE_COLOR(_ALPHA) expects in memory.
+ *
+ * ASSET_CODEC_RLE stores the pixels as packets of one control byte c:
+ *   c & 0x80: the next pixel repeated (c & 0x7F) + 1 times
+ *   else:     (c + 1) literal pixels follow
+ * where a pixel is 2 or 3 bytes depending on the color format.
+ *
+ * An ASSET_CF_FONT asset (width and height 0, ASSET_CODEC_NONE) is a glyph
+ * subset of one of LVGL's built-in fonts:
+ *
+ *   asset_font_header_t
+ *   asset_font_glyph_t[glyph_count]   sorted by code point
+ *   glyph bitmaps                     as in LVGL's lv_font_fmt_txt fonts:
+ *                                     bpp bits per pixel, MSB first, rows
+ *                                     not padded
+ */
+
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <stdint.h>
+
+#define ASSET_PARTITION_LABEL "assets"  // partitions.csv, components/asset_store/CMakeLists.txt
+
+#define ASSET_PACK_MAGIC    0x50413144u  // "D1AP"
+#define ASSET_PACK_VERSION  1
+#define ASSET_NAME_LEN      24           // Including the terminating NUL
+
+typedef enum {
+    ASSET_CF_RGB565   = 0,
+    ASSET_CF_RGB565A8 = 1,
+    ASSET_CF_FONT     = 2,
+} asset_cf_t;
+
+typedef enum {
+    ASSET_CODEC_NONE = 0,
+    ASSET_CODEC_RLE  = 1,
+} asset_codec_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;         // Number of entries
+    uint32_t size;          // Whole pack in bytes
+    uint32_t reserved;
+} asset_pack_header_t;
+
+typedef struct __attribute__((packed)) {
+    char name[ASSET_NAME_LEN];
+    uint32_t offset;        // From the start of the pack
+    uint32_t size;          // Stored bytes
+    uint16_t width;
+    uint16_t height;
+    uint8_t cf;             // asset_cf_t
+    uint8_t codec;          // asset_codec_t
+    uint16_t reserved;
+} asset_pack_entry_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t line_height;
+    int16_t base_line;      // Baseline measured from the bottom of the line
+    int16_t underline_position;
+    uint16_t underline_thickness;
+    uint16_t glyph_count;
+    uint8_t bpp;            // 1, 2, 4 or 8
+    uint8_t reserved;
+} asset_font_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t codepoint;
+    uint32_t bitmap;        // From the start of the font header
+    uint16_t adv_w;         // In 1/16 px
+    uint8_t box_w;
+    uint8_t box_h;
+    int8_t ofs_x;
+    int8_t ofs_y;
+    uint16_t reserved;
+} asset_font_glyph_t;
+
+_Static_assert(sizeof(asset_pack_header_t) == 16, "asset pack header layout");
+_Static_assert(sizeof(asset_pack_entry_t) == 40, "asset pack entry layout");
+_Static_assert(sizeof(asset_font_header_t) == 12, "asset font header layout");
+_Static_assert(sizeof(asset_font_glyph_t) == 16, "asset font glyph layout");
+
+#endif // ASSET_PACK_H
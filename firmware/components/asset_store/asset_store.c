@@ -0,0 +1,597 @@
+/**
+ * @file asset_store.c
+ * @brief Images in the assets flash partition, shown by LVGL without a copy
+ */
+
+#include "asset_store.h"
+#include "asset_pack.h"
+#include <inttypes.h>
+#include <string.h>
+#include "sdkconfig.h"
+#include "esp_partition.h"
+#include "spi_flash_mmap.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#if LV_COLOR_DEPTH != 16 || LV_COLOR_16_SWAP != 0
+#error "Asset packs hold RGB565 pixels without byte swap"
+#endif
+
+static const char *TAG = "ASSET_STORE";
+
+#define ASSET_SRC_PREFIX_LEN (sizeof(ASSET_SRC("")) - 1)
+
+// More decoded images than this are not worth keeping on a 480x480 screen
+#define ASSET_CACHE_SLOTS 16
+
+// Fonts that can be loaded at the same time
+#define ASSET_FONT_MAX 8
+
+typedef struct {
+    const asset_pack_entry_t *asset;    // NULL: free slot
+    uint8_t *pixels;
+    uint32_t size;
+    uint32_t last_use;
+    uint16_t pins;                      // Open decoder sessions drawing from pixels
+} cache_slot_t;
+
+static spi_flash_mmap_handle_t pack_map;
+static const uint8_t *pack;
+static uint32_t pack_size;
+static const asset_pack_entry_t *entries;
+static uint16_t entry_count;
+
+static cache_slot_t cache[ASSET_CACHE_SLOTS];
+static uint32_t cache_bytes;
+static uint32_t use_clock;
+static uint32_t hits;
+static uint32_t decodes;
+static uint32_t evictions;
+
+// ============================================================================
+// Pack
+// ============================================================================
+
+static uint32_t pixel_bytes(uint8_t cf)
+{
+    return cf == ASSET_CF_RGB565A8 ? 3 : 2;
+}
+
+static uint32_t decoded_size(const asset_pack_entry_t *asset)
+{
+    return (uint32_t)asset->width * asset->height * pixel_bytes(asset->cf);
+}
+
+static const asset_pack_entry_t *find_asset(const char *name)
+{
+    int lo = 0;
+    int hi = (int)entry_count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = strcmp(name, entries[mid].name);
+        if (cmp == 0) {
+            return &entries[mid];
+        }
+        if (cmp < 0) {
+            hi = mid - 1;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return NULL;
+}
+
+static uint32_t glyph_bitmap_size(const asset_font_glyph_t *g, uint8_t bpp)
+{
+    return ((uint32_t)g->box_w * g->box_h * bpp + 7) / 8;
+}
+
+static bool font_valid(const asset_pack_entry_t *e, const uint8_t *blob)
+{
+    const asset_font_header_t *fh = (const asset_font_header_t *)blob;
+    if (e->size < sizeof(*fh) || e->codec != ASSET_CODEC_NONE ||
+        (fh->bpp != 1 && fh->bpp != 2 && fh->bpp != 4 && fh->bpp != 8) ||
+        e->size < sizeof(*fh) + (uint32_t)fh->glyph_count * sizeof(asset_font_glyph_t)) {
+        return false;
+    }
+    const asset_font_glyph_t *glyphs = (const asset_font_glyph_t *)(blob + sizeof(*fh));
+    for (uint16_t i = 0; i < fh->glyph_count; i++) {
+        const asset_font_glyph_t *g = &glyphs[i];
+        if ((i > 0 && glyphs[i - 1].codepoint >= g->codepoint) || g->bitmap > e->size ||
+            glyph_bitmap_size(g, fh->bpp) > e->size - g->bitmap) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Everything the decoder later relies on without checking again
+static bool pack_valid(const uint8_t *base, const asset_pack_header_t *hdr)
+{
+    const asset_pack_entry_t *table = (const asset_pack_entry_t *)(base + sizeof(*hdr));
+    uint32_t data_start = sizeof(*hdr) + (uint32_t)hdr->count * sizeof(*table);
+
+    for (uint16_t i = 0; i < hdr->count; i++) {
+        const asset_pack_entry_t *e = &table[i];
+        if (e->name[0] == '\0' || memchr(e->name, '\0', ASSET_NAME_LEN) == NULL) {
+            ESP_LOGE(TAG, "Asset %u: bad name", i);
+            return false;
+        }
+        if (i > 0 && strcmp(table[i - 1].name, e->name) >= 0) {
+            ESP_LOGE(TAG, "Asset %s: table not sorted", e->name);
+            return false;
+        }
+        if (e->cf > ASSET_CF_FONT || e->codec > ASSET_CODEC_RLE ||
+            (e->cf != ASSET_CF_FONT && (e->width == 0 || e->height == 0))) {
+            ESP_LOGE(TAG, "Asset %s: unknown format", e->name);
+            return false;
+        }
+        if (e->offset < data_start || e->offset % 4 != 0 || e->offset > hdr->size ||
+            e->size > hdr->size - e->offset) {
+            ESP_LOGE(TAG, "Asset %s: data outside the pack", e->name);
+            return false;
+        }
+        if (e->cf == ASSET_CF_FONT) {
+            if (!font_valid(e, base + e->offset)) {
+                ESP_LOGE(TAG, "Asset %s: bad font", e->name);
+                return false;
+            }
+            continue;
+        }
+        if (e->codec == ASSET_CODEC_NONE ? e->size != decoded_size(e) : e->size == 0) {
+            ESP_LOGE(TAG, "Asset %s: wrong data size", e->name);
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Decoded image cache
+// ============================================================================
+
+static bool rle_decode(const uint8_t *in, uint32_t in_len, uint8_t *out, uint32_t out_len, uint32_t px)
+{
+    const uint8_t *end = in + in_len;
+    uint32_t o = 0;
+
+    while (in < end && o < out_len) {
+        uint8_t ctrl = *in++;
+        uint32_t n = ((uint32_t)(ctrl & 0x7F) + 1) * px;
+        if (n > out_len - o) {
+            return false;
+        }
+        if (ctrl & 0x80) {
+            if ((uint32_t)(end - in) < px) {
+                return false;
+            }
+            for (uint32_t i = 0; i < n; i += px) {
+                memcpy(out + o + i, in, px);
+            }
+            in += px;
+        } else {
+            if ((uint32_t)(end - in) < n) {
+                return false;
+            }
+            memcpy(out + o, in, n);
+            in += n;
+        }
+        o += n;
+    }
+    return o == out_len;
+}
+
+static void cache_evict(cache_slot_t *slot)
+{
+    cache_bytes -= slot->size;
+    heap_caps_free(slot->pixels);
+    memset(slot, 0, sizeof(*slot));
+    evictions++;
+}
+
+static cache_slot_t *cache_lru_unpinned(void)
+{
+    cache_slot_t *lru = NULL;
+    for (int i = 0; i < ASSET_CACHE_SLOTS; i++) {
+        cache_slot_t *slot = &cache[i];
+        if (slot->asset != NULL && slot->pins == 0 && (lru == NULL || slot->last_use < lru->last_use)) {
+            lru = slot;
+        }
+    }
+    return lru;
+}
+
+static cache_slot_t *cache_get(const asset_pack_entry_t *asset)
+{
+    cache_slot_t *free_slot = NULL;
+    for (int i = 0; i < ASSET_CACHE_SLOTS; i++) {
+        if (cache[i].asset == asset) {
+            cache[i].last_use = ++use_clock;
+            hits++;
+            return &cache[i];
+        }
+        if (cache[i].asset == NULL && free_slot == NULL) {
+            free_slot = &cache[i];
+        }
+    }
+
+    // Images being drawn cannot go, so the budget may be exceeded until they close
+    uint32_t size = decoded_size(asset);
+    while (free_slot == NULL || cache_bytes + size > CONFIG_ASSET_CACHE_KB * 1024) {
+        cache_slot_t *victim = cache_lru_unpinned();
+        if (victim == NULL) {
+            break;
+        }
+        cache_evict(victim);
+        if (free_slot == NULL) {
+            free_slot = victim;
+        }
+    }
+    if (free_slot == NULL) {
+        ESP_LOGW(TAG, "%s: all %d cache slots are in use", asset->name, ASSET_CACHE_SLOTS);
+        return NULL;
+    }
+
+    uint8_t *pixels = heap_caps_malloc_prefer(size, 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT,
+                                              MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (pixels == NULL) {
+        ESP_LOGW(TAG, "%s: no memory for %" PRIu32 " bytes", asset->name, size);
+        return NULL;
+    }
+
+    int64_t start = esp_timer_get_time();
+    if (!rle_decode(pack + asset->offset, asset->size, pixels, size, pixel_bytes(asset->cf))) {
+        ESP_LOGE(TAG, "%s: corrupt RLE data", asset->name);
+        heap_caps_free(pixels);
+        return NULL;
+    }
+    decodes++;
+    ESP_LOGD(TAG, "%s: decoded %" PRIu32 " bytes in %lld us", asset->name, size,
+             (long long)(esp_timer_get_time() - start));
+
+    free_slot->asset = asset;
+    free_slot->pixels = pixels;
+    free_slot->size = size;
+    free_slot->last_use = ++use_clock;
+    free_slot->pins = 0;
+    cache_bytes += size;
+    return free_slot;
+}
+
+// ============================================================================
+// LVGL image decoder
+// ============================================================================
+
+static const asset_pack_entry_t *asset_of_src(const void *src)
+{
+    if (lv_img_src_get_type(src) != LV_IMG_SRC_FILE ||
+        strncmp(src, ASSET_SRC(""), ASSET_SRC_PREFIX_LEN) != 0) {
+        return NULL;
+    }
+    const asset_pack_entry_t *asset = find_asset((const char *)src + ASSET_SRC_PREFIX_LEN);
+    return asset != NULL && asset->cf != ASSET_CF_FONT ? asset : NULL;
+}
+
+static lv_res_t decoder_info(lv_img_decoder_t *decoder, const void *src, lv_img_header_t *header)
+{
+    LV_UNUSED(decoder);
+    const asset_pack_entry_t *asset = asset_of_src(src);
+    if (asset == NULL) {
+        return LV_RES_INV;
+    }
+    header->always_zero = 0;
+    header->w = asset->width;
+    header->h = asset->height;
+    header->cf = asset->cf == ASSET_CF_RGB565A8 ? LV_IMG_CF_TRUE_COLOR_ALPHA : LV_IMG_CF_TRUE_COLOR;
+    return LV_RES_OK;
+}
+
+static lv_res_t decoder_open(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc)
+{
+    LV_UNUSED(decoder);
+    const asset_pack_entry_t *asset = asset_of_src(dsc->src);
+    if (asset == NULL) {
+        return LV_RES_INV;
+    }
+
+    if (asset->codec == ASSET_CODEC_NONE) {
+        dsc->img_data = pack + asset->offset;
+        dsc->user_data = NULL;
+        return LV_RES_OK;
+    }
+
+    cache_slot_t *slot = cache_get(asset);
+    if (slot == NULL) {
+        dsc->error_msg = "Asset cache full";
+        return LV_RES_INV;
+    }
+    slot->pins++;
+    dsc->img_data = slot->pixels;
+    dsc->user_data = slot;
+    return LV_RES_OK;
+}
+
+static void decoder_close(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc)
+{
+    LV_UNUSED(decoder);
+    cache_slot_t *slot = dsc->user_data;
+    if (slot != NULL && slot->pins > 0) {
+        slot->pins--;
+    }
+    dsc->user_data = NULL;
+}
+
+// ============================================================================
+// Fonts
+// ============================================================================
+
+typedef struct {
+    const asset_font_header_t *header;
+    const asset_font_glyph_t *glyphs;
+    const uint8_t *base;                // Glyph bitmap offsets start here
+    uint32_t max_bitmap;                // Largest glyph bitmap in bytes
+} font_dsc_t;
+
+// The glyph cache is set associative: a glyph can only live in one set, so a
+// lookup scans GLYPH_CACHE_WAYS slots
+#define GLYPH_CACHE_WAYS 4
+
+typedef struct {
+    const asset_font_glyph_t *glyph;    // NULL: free slot
+    uint32_t last_use;
+} glyph_slot_t;
+
+static font_dsc_t fonts[ASSET_FONT_MAX];
+static uint8_t font_count;
+
+static bool glyph_cache_tried;
+static glyph_slot_t *glyph_slots;
+static uint8_t *glyph_data;
+static uint32_t glyph_sets;
+static uint32_t glyph_slot_bytes;
+static uint32_t glyph_clock;
+static uint32_t glyph_hits;
+static uint32_t glyph_misses;
+
+static const asset_font_glyph_t *font_find_glyph(const font_dsc_t *fd, uint32_t letter)
+{
+    int lo = 0;
+    int hi = (int)fd->header->glyph_count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        uint32_t cp = fd->glyphs[mid].codepoint;
+        if (cp == letter) {
+            return &fd->glyphs[mid];
+        }
+        if (letter < cp) {
+            hi = mid - 1;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return NULL;
+}
+
+// Sized on first use, when the fonts the UI needs are loaded
+static bool glyph_cache_alloc(void)
+{
+    uint32_t max_bitmap = 0;
+    for (uint8_t i = 0; i < font_count; i++) {
+        if (fonts[i].max_bitmap > max_bitmap) {
+            max_bitmap = fonts[i].max_bitmap;
+        }
+    }
+    glyph_slot_bytes = (max_bitmap + 3) & ~3u;
+    if (glyph_slot_bytes == 0) {
+        return false;
+    }
+    glyph_sets = CONFIG_ASSET_GLYPH_CACHE_KB * 1024 / glyph_slot_bytes / GLYPH_CACHE_WAYS;
+    if (glyph_sets == 0) {
+        ESP_LOGW(TAG, "Glyph cache too small for %" PRIu32 " byte glyphs", glyph_slot_bytes);
+        return false;
+    }
+
+    uint32_t slots = glyph_sets * GLYPH_CACHE_WAYS;
+    glyph_slots = heap_caps_calloc(slots, sizeof(*glyph_slots), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    glyph_data = heap_caps_malloc(slots * glyph_slot_bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (glyph_slots == NULL || glyph_data == NULL) {
+        ESP_LOGW(TAG, "No SRAM for the glyph cache");
+        heap_caps_free(glyph_slots);
+        heap_caps_free(glyph_data);
+        glyph_slots = NULL;
+        glyph_data = NULL;
+        return false;
+    }
+    ESP_LOGI(TAG, "Glyph cache: %" PRIu32 " glyphs of %" PRIu32 " bytes", slots, glyph_slot_bytes);
+    return true;
+}
+
+// LVGL draws a glyph before it asks for the next one, so the returned bitmap
+// only has to stay valid until the next call
+static const uint8_t *glyph_cache_get(const asset_font_glyph_t *g, const uint8_t *bitmap, uint32_t size)
+{
+    if (glyph_slots == NULL) {
+        if (glyph_cache_tried) {
+            return bitmap;
+        }
+        glyph_cache_tried = true;
+        if (!glyph_cache_alloc()) {
+            return bitmap;
+        }
+    }
+    if (size > glyph_slot_bytes) {
+        return bitmap;
+    }
+
+    // Glyph entries are 16 bytes apart
+    uint32_t set = (uint32_t)(((uintptr_t)g >> 4) % glyph_sets);
+    glyph_slot_t *ways = &glyph_slots[set * GLYPH_CACHE_WAYS];
+    glyph_slot_t *victim = &ways[0];
+    for (int i = 0; i < GLYPH_CACHE_WAYS; i++) {
+        if (ways[i].glyph == g) {
+            ways[i].last_use = ++glyph_clock;
+            glyph_hits++;
+            return glyph_data + (uint32_t)(&ways[i] - glyph_slots) * glyph_slot_bytes;
+        }
+        if (ways[i].glyph == NULL || (victim->glyph != NULL && ways[i].last_use < victim->last_use)) {
+            victim = &ways[i];
+        }
+    }
+
+    uint8_t *data = glyph_data + (uint32_t)(victim - glyph_slots) * glyph_slot_bytes;
+    memcpy(data, bitmap, size);
+    victim->glyph = g;
+    victim->last_use = ++glyph_clock;
+    glyph_misses++;
+    return data;
+}
+
+static bool font_get_glyph_dsc(const lv_font_t *font, lv_font_glyph_dsc_t *dsc_out, uint32_t letter,
+                               uint32_t letter_next)
+{
+    LV_UNUSED(letter_next);
+    const font_dsc_t *fd = font->dsc;
+    const asset_font_glyph_t *g = font_find_glyph(fd, letter);
+    if (g == NULL) {
+        return false;
+    }
+    dsc_out->adv_w = (g->adv_w + 8) >> 4;
+    dsc_out->box_w = g->box_w;
+    dsc_out->box_h = g->box_h;
+    dsc_out->ofs_x = g->ofs_x;
+    dsc_out->ofs_y = g->ofs_y;
+    dsc_out->bpp = fd->header->bpp;
+    dsc_out->is_placeholder = false;
+    return true;
+}
+
+static const uint8_t *font_get_glyph_bitmap(const lv_font_t *font, uint32_t letter)
+{
+    const font_dsc_t *fd = font->dsc;
+    const asset_font_glyph_t *g = font_find_glyph(fd, letter);
+    if (g == NULL) {
+        return NULL;
+    }
+    return glyph_cache_get(g, fd->base + g->bitmap, glyph_bitmap_size(g, fd->header->bpp));
+}
+
+bool asset_store_font_load(const char *name, lv_font_t *font)
+{
+    const asset_pack_entry_t *asset = entries != NULL ? find_asset(name) : NULL;
+    if (asset == NULL || asset->cf != ASSET_CF_FONT) {
+        ESP_LOGW(TAG, "No font asset %s", name);
+        return false;
+    }
+
+    font_dsc_t *fd = NULL;
+    for (uint8_t i = 0; i < font_count; i++) {
+        if (fonts[i].base == pack + asset->offset) {
+            fd = &fonts[i];
+        }
+    }
+    if (fd == NULL) {
+        if (font_count == ASSET_FONT_MAX) {
+            ESP_LOGW(TAG, "%s: only %d fonts can be loaded", name, ASSET_FONT_MAX);
+            return false;
+        }
+        fd = &fonts[font_count++];
+        fd->base = pack + asset->offset;
+        fd->header = (const asset_font_header_t *)fd->base;
+        fd->glyphs = (const asset_font_glyph_t *)(fd->base + sizeof(asset_font_header_t));
+        fd->max_bitmap = 0;
+        for (uint16_t i = 0; i < fd->header->glyph_count; i++) {
+            uint32_t size = glyph_bitmap_size(&fd->glyphs[i], fd->header->bpp);
+            if (size > fd->max_bitmap) {
+                fd->max_bitmap = size;
+            }
+        }
+    }
+
+    memset(font, 0, sizeof(*font));
+    font->get_glyph_dsc = font_get_glyph_dsc;
+    font->get_glyph_bitmap = font_get_glyph_bitmap;
+    font->line_height = fd->header->line_height;
+    font->base_line = fd->header->base_line;
+    font->subpx = LV_FONT_SUBPX_NONE;
+    font->underline_position = fd->header->underline_position;
+    font->underline_thickness = fd->header->underline_thickness;
+    font->dsc = fd;
+    return true;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool asset_store_init(void)
+{
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                           ASSET_PARTITION_LABEL);
+    if (part == NULL) {
+        ESP_LOGW(TAG, "No \"%s\" partition, assets disabled", ASSET_PARTITION_LABEL);
+        return false;
+    }
+
+    asset_pack_header_t hdr;
+    esp_err_t err = esp_partition_read(part, 0, &hdr, sizeof(hdr));
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Cannot read the pack header: %s", esp_err_to_name(err));
+        return false;
+    }
+    if (hdr.magic != ASSET_PACK_MAGIC || hdr.version != ASSET_PACK_VERSION) {
+        ESP_LOGW(TAG, "No asset pack in \"%s\" (idf.py flash writes it)", part->label);
+        return false;
+    }
+    if (hdr.size > part->size || hdr.size < sizeof(hdr) + (uint32_t)hdr.count * sizeof(asset_pack_entry_t)) {
+        ESP_LOGE(TAG, "Pack size %" PRIu32 " does not fit the partition", hdr.size);
+        return false;
+    }
+
+    // Only the part in use takes up MMU pages
+    const void *base;
+    err = esp_partition_mmap(part, 0, hdr.size, SPI_FLASH_MMAP_DATA, &base, &pack_map);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Cannot map the pack: %s", esp_err_to_name(err));
+        return false;
+    }
+    if (!pack_valid(base, &hdr)) {
+        spi_flash_munmap(pack_map);
+        return false;
+    }
+
+    lv_img_decoder_t *decoder = lv_img_decoder_create();
+    if (decoder == NULL) {
+        ESP_LOGE(TAG, "Cannot register the image decoder");
+        spi_flash_munmap(pack_map);
+        return false;
+    }
+    lv_img_decoder_set_info_cb(decoder, decoder_info);
+    lv_img_decoder_set_open_cb(decoder, decoder_open);
+    lv_img_decoder_set_close_cb(decoder, decoder_close);
+
+    pack = base;
+    pack_size = hdr.size;
+    entries = (const asset_pack_entry_t *)(pack + sizeof(hdr));
+    entry_count = hdr.count;
+    ESP_LOGI(TAG, "%u assets, %" PRIu32 " KiB mapped, %d KiB decode cache",
+             entry_count, pack_size / 1024, CONFIG_ASSET_CACHE_KB);
+    return true;
+}
+
+bool asset_store_contains(const char *name)
+{
+    return find_asset(name) != NULL;
+}
+
+void asset_store_get_stats(asset_store_stats_t *out)
+{
+    out->count = entry_count;
+    out->pack_bytes = pack_size;
+    out->cache_bytes = cache_bytes;
+    out->hits = hits;
+    out->decodes = decodes;
+    out->evictions = evictions;
+    out->glyph_hits = glyph_hits;
+    out->glyph_misses = glyph_misses;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file asset_store.h
+ * @brief Images in the assets flash partition, shown by LVGL without a copy
+ *
+ * The pack built by tools/mkassets.py is memory-mapped once at boot and an
+ * LVGL image decoder is registered for it. A widget shows an asset with
+ *
+ *     lv_img_set_src(img, ASSET_SRC("water_drop"));
+ *
+ * Uncompressed assets are drawn directly from the mapped flash: no RAM is
+ * used for their pixels at all. RLE-compressed assets are decoded once into
+ * an LRU cache in PSRAM of CONFIG_ASSET_CACHE_KB and then drawn from there;
+ * a cached image is only evicted when no widget is drawing it.
+ *
+ * Fonts are subsets of LVGL's built-in fonts from the same pack: their glyph
+ * tables are read straight from flash too, and only the bitmaps of the
+ * glyphs being drawn are copied into a small cache in internal SRAM, where
+ * the draw code reads them faster than through the flash cache.
+ *
+ * Everything runs in the LVGL task.
+ */
+
+#ifndef ASSET_STORE_H
+#define ASSET_STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** LVGL image source of the asset called name (a string literal) */
+#define ASSET_SRC(name) ("asset:" name)
+
+typedef struct {
+    uint16_t count;         /**< Assets in the pack, 0 if there is none */
+    uint32_t pack_bytes;    /**< Mapped size of the pack */
+    uint32_t cache_bytes;   /**< Decoded pixels held in the cache */
+    uint32_t hits;          /**< Opens served from the cache */
+    uint32_t decodes;       /**< Opens that had to decompress */
+    uint32_t evictions;
+    uint32_t glyph_hits;    /**< Glyph bitmaps served from the SRAM cache */
+    uint32_t glyph_misses;  /**< Glyph bitmaps copied from flash */
+} asset_store_stats_t;
+
+/**
+ * @brief Map the pack and register the image decoder
+ *
+ * Call after lv_init(). Without a valid pack every ASSET_SRC() image fails
+ * to open (LVGL draws its "no image" placeholder) and false is returned.
+ */
+bool asset_store_init(void);
+
+/**
+ * @brief Make font draw the font asset called name
+ *
+ * font can be a static object that styles already refer to; it is
+ * overwritten. font->fallback is left NULL for the caller to set, e.g. to
+ * the default font for characters outside the subset.
+ *
+ * @return false (font untouched) if the pack has no such font
+ */
+bool asset_store_font_load(const char *name, lv_font_t *font);
+
+/** @brief Whether the pack contains an asset called name */
+bool asset_store_contains(const char *name);
+
+void asset_store_get_stats(asset_store_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASSET_STORE_H
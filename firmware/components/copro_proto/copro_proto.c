@@ -0,0 +1,124 @@
+/**
+ * @file copro_proto.c
+ * @brief Frames of the UART link to the RP2040 co-processor
+ */
+
+#include "copro_proto.h"
+#include <string.h>
+
+// CRC-16/CCITT-FALSE (poly 0x1021), a nibble at a time: 32 bytes of table
+static const uint16_t crc_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+    0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+};
+
+uint16_t copro_crc16(uint16_t crc, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        crc = (uint16_t)((crc << 4) ^ crc_nibble[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ crc_nibble[(crc >> 12) ^ (data[i] & 0x0F)]);
+    }
+    return crc;
+}
+
+void copro_parser_init(copro_parser_t *p)
+{
+    memset(p, 0, sizeof(*p));
+}
+
+void copro_parser_resync(copro_parser_t *p)
+{
+    p->len = 0;
+    p->left = 0;
+    p->zero_due = false;
+    // Whatever arrives before the next delimiter is the tail of a lost frame
+    p->discard = true;
+}
+
+static void frame_end(copro_parser_t *p, copro_frame_cb_t cb, void *ctx)
+{
+    if (p->discard) {
+        p->discard = false;
+    } else if (p->left != 0 || (p->len > 0 && p->len < 3)) {
+        p->stats.framing_errors++;
+    } else if (p->len > 0) {
+        uint16_t crc = (uint16_t)(p->buf[p->len - 2] | (p->buf[p->len - 1] << 8));
+        if (copro_crc16(COPRO_CRC_INIT, p->buf, p->len - 2) != crc) {
+            p->stats.crc_errors++;
+        } else {
+            p->stats.frames++;
+            cb(p->buf[0], p->buf + 1, p->len - 3, ctx);
+        }
+    }
+    // A lone delimiter (idle line, padding) is no frame at all
+    p->len = 0;
+    p->left = 0;
+    p->zero_due = false;
+}
+
+static bool parser_put(copro_parser_t *p, uint8_t b)
+{
+    if (p->len == COPRO_FRAME_MAX) {
+        p->stats.overruns++;
+        copro_parser_resync(p);
+        return false;
+    }
+    p->buf[p->len++] = b;
+    return true;
+}
+
+void copro_parser_feed(copro_parser_t *p, const uint8_t *data, size_t len, copro_frame_cb_t cb, void *ctx)
+{
+    p->stats.bytes += (uint32_t)len;
+
+    for (size_t i = 0; i < len; i++) {
+        uint8_t b = data[i];
+        if (b == 0) {
+            frame_end(p, cb, ctx);
+        } else if (p->discard) {
+            continue;
+        } else if (p->left > 0) {
+            if (parser_put(p, b)) p->left--;
+        } else if (!p->zero_due || parser_put(p, 0)) {
+            // Code byte: the zero it stands for, then b - 1 data bytes
+            p->left = b - 1;
+            p->zero_due = b != 0xFF;
+        }
+    }
+}
+
+size_t copro_encode(uint8_t type, const uint8_t *payload, size_t len, uint8_t *out, size_t size)
+{
+    if (len > COPRO_PAYLOAD_MAX) return 0;
+
+    uint8_t frame[COPRO_FRAME_MAX];
+    frame[0] = type;
+    if (len > 0) memcpy(frame + 1, payload, len);
+    uint16_t crc = copro_crc16(COPRO_CRC_INIT, frame, len + 1);
+    frame[len + 1] = (uint8_t)crc;
+    frame[len + 2] = (uint8_t)(crc >> 8);
+    size_t frame_len = len + 3;
+
+    // COBS: every block starts with the distance to the next zero
+    if (size < frame_len + 2) return 0;
+    size_t code_at = 0;
+    size_t n = 1;
+    uint8_t code = 1;
+    for (size_t i = 0; i < frame_len; i++) {
+        if (frame[i] == 0) {
+            out[code_at] = code;
+            code_at = n++;
+            code = 1;
+        } else {
+            out[n++] = frame[i];
+            if (++code == 0xFF) {
+                out[code_at] = code;
+                code_at = n++;
+                code = 1;
+            }
+        }
+    }
+    out[code_at] = code;
+    out[n++] = 0;
+    return n;
+}
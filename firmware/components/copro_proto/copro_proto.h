@@ -0,0 +1,93 @@
+/**
+ * @file copro_proto.h
+ * @brief Frames of the UART link to the RP2040 co-processor
+ *
+ * Every frame is COBS-encoded and ends with a 0x00 delimiter, so a
+ * receiver that starts mid-stream or loses bytes finds the next frame at
+ * the next zero. Decoded, a frame is
+ *
+ *   byte 0      message type (copro_msg_t)
+ *   bytes 1..n  payload, little-endian
+ *   last two    CRC-16/CCITT-FALSE of type and payload, little-endian
+ *
+ * The parser takes the byte stream in chunks of any size, as they come
+ * out of the UART driver, and decodes in place into a fixed buffer: no
+ * allocation, and each byte is looked at once.
+ */
+
+#ifndef COPRO_PROTO_H
+#define COPRO_PROTO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Largest payload; longer frames are dropped as overruns */
+#define COPRO_PAYLOAD_MAX   32
+/** Decoded frame: type, payload, CRC */
+#define COPRO_FRAME_MAX     (1 + COPRO_PAYLOAD_MAX + 2)
+/** Encoded frame: COBS adds one byte per 254 and the delimiter */
+#define COPRO_WIRE_MAX      (COPRO_FRAME_MAX + 2)
+
+typedef enum {
+    /** RP2040 -> ESP32: tank index (u8), level in percent (u8) */
+    COPRO_MSG_TANK_LEVEL = 0x01,
+    /** RP2040 -> ESP32: levels of GPIO 0..29 (u32), sent on every change */
+    COPRO_MSG_GPIO       = 0x02,
+} copro_msg_t;
+
+typedef struct {
+    uint32_t bytes;             /**< Received, delimiters included */
+    uint32_t frames;            /**< Passed the CRC */
+    uint32_t crc_errors;
+    uint32_t framing_errors;    /**< Broken COBS or shorter than type and CRC */
+    uint32_t overruns;          /**< Longer than COPRO_FRAME_MAX */
+} copro_stats_t;
+
+/**
+ * @brief Called for each good frame; the payload is only valid during the call
+ */
+typedef void (*copro_frame_cb_t)(uint8_t type, const uint8_t *payload, size_t len, void *ctx);
+
+typedef struct {
+    uint8_t buf[COPRO_FRAME_MAX];
+    size_t len;
+    uint8_t left;               /**< Data bytes left in the COBS block, 0 before a code byte */
+    bool zero_due;              /**< The block ended below 254 bytes: a zero follows it */
+    bool discard;               /**< Drop everything up to the next delimiter */
+    copro_stats_t stats;
+} copro_parser_t;
+
+void copro_parser_init(copro_parser_t *p);
+
+/**
+ * @brief Parse the next chunk of the stream, calling cb for each good frame
+ */
+void copro_parser_feed(copro_parser_t *p, const uint8_t *data, size_t len, copro_frame_cb_t cb, void *ctx);
+
+/**
+ * @brief Drop the frame in progress, e.g. after the UART lost bytes
+ */
+void copro_parser_resync(copro_parser_t *p);
+
+/**
+ * @brief Encode one frame, delimiter included
+ *
+ * @return Bytes written, 0 if the payload is too long or out too small
+ */
+size_t copro_encode(uint8_t type, const uint8_t *payload, size_t len, uint8_t *out, size_t size);
+
+uint16_t copro_crc16(uint16_t crc, const uint8_t *data, size_t len);
+
+/** Initial value of copro_crc16() */
+#define COPRO_CRC_INIT      0xFFFF
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COPRO_PROTO_H
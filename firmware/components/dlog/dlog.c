@@ -0,0 +1,280 @@
+/**
+ * @file dlog.c
+ * @brief Deferred logging: record now, format later on a low-priority task
+ */
+
+#include "dlog.h"
+#include <stdatomic.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#endif
+
+#if defined(ESP_PLATFORM) && !CONFIG_FREERTOS_UNICORE
+#define DLOG_CORES 2
+#else
+#define DLOG_CORES 1
+#endif
+
+// Records per core; a power of two
+#ifndef DLOG_RING_RECORDS
+#define DLOG_RING_RECORDS 64
+#endif
+_Static_assert((DLOG_RING_RECORDS & (DLOG_RING_RECORDS - 1)) == 0, "DLOG_RING_RECORDS must be a power of two");
+#define DLOG_RING_MASK (DLOG_RING_RECORDS - 1)
+
+#define DLOG_LINE_MAX 160
+
+#ifdef ESP_PLATFORM
+#define DLOG_TASK_STACK     3072
+#define DLOG_TASK_PRIO      1
+#define DLOG_FLUSH_MS       50
+#endif
+
+typedef struct {
+    const dlog_site_t *site;
+    uint32_t time_ms;
+    uintptr_t args[DLOG_MAX_ARGS];
+} dlog_record_t;
+
+// Each slot carries the lap of the ring it is in, minus its index, so that
+// a zeroed ring is an empty one: lap*N means free for the producer of lap,
+// lap*N + 1 holds that lap's record
+typedef struct {
+    _Atomic uint32_t seq;
+    dlog_record_t rec;
+} dlog_slot_t;
+
+// Any number of producers claim slots by CAS on head (tasks preempting each
+// other, ISRs), one consumer advances tail
+typedef struct {
+    _Atomic uint32_t head;
+    uint32_t tail;
+    _Atomic uint32_t dropped;
+    dlog_slot_t slots[DLOG_RING_RECORDS];
+} dlog_ring_t;
+
+static dlog_ring_t rings[DLOG_CORES];
+
+static uint32_t dlog_now_ms(void)
+{
+#ifdef ESP_PLATFORM
+    return (uint32_t)(esp_timer_get_time() / 1000);
+#else
+    return 0;
+#endif
+}
+
+static dlog_ring_t *dlog_own_ring(void)
+{
+#if DLOG_CORES > 1
+    return &rings[esp_cpu_get_core_id()];
+#else
+    return &rings[0];
+#endif
+}
+
+void dlog_write(const dlog_site_t *site, uintptr_t a0, uintptr_t a1, uintptr_t a2, uintptr_t a3)
+{
+    dlog_ring_t *ring = dlog_own_ring();
+    uint32_t pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    dlog_slot_t *slot;
+
+    for (;;) {
+        slot = &ring->slots[pos & DLOG_RING_MASK];
+        uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int32_t diff = (int32_t)(seq - (pos & ~(uint32_t)DLOG_RING_MASK));
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->head, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+            // pos now holds the head another producer moved on to
+        } else if (diff < 0) {
+            // The consumer has not freed this slot from the last lap
+            atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+            return;
+        } else {
+            pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        }
+    }
+
+    slot->rec.site = site;
+    slot->rec.time_ms = dlog_now_ms();
+    slot->rec.args[0] = a0;
+    slot->rec.args[1] = a1;
+    slot->rec.args[2] = a2;
+    slot->rec.args[3] = a3;
+    atomic_store_explicit(&slot->seq, (pos & ~(uint32_t)DLOG_RING_MASK) + 1, memory_order_release);
+}
+
+// The oldest complete record of the ring, or NULL. A record still being
+// written holds back the ones behind it until the next flush.
+static const dlog_record_t *dlog_peek(dlog_ring_t *ring)
+{
+    dlog_slot_t *slot = &ring->slots[ring->tail & DLOG_RING_MASK];
+    uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if (seq != (ring->tail & ~(uint32_t)DLOG_RING_MASK) + 1) return NULL;
+    return &slot->rec;
+}
+
+static void dlog_release(dlog_ring_t *ring)
+{
+    dlog_slot_t *slot = &ring->slots[ring->tail & DLOG_RING_MASK];
+    atomic_store_explicit(&slot->seq, (ring->tail & ~(uint32_t)DLOG_RING_MASK) + DLOG_RING_RECORDS,
+                          memory_order_release);
+    ring->tail++;
+}
+
+// printf() for one record: each conversion is handed to snprintf() on its
+// own, with its argument cast back to the type the conversion reads
+static void dlog_format(char *out, size_t size, const char *fmt, const uintptr_t *args)
+{
+    size_t n = 0;
+    size_t next_arg = 0;
+    out[0] = '\0';
+
+    while (*fmt != '\0' && n + 1 < size) {
+        if (*fmt != '%') {
+            out[n++] = *fmt++;
+            out[n] = '\0';
+            continue;
+        }
+        if (fmt[1] == '%') {
+            out[n++] = '%';
+            out[n] = '\0';
+            fmt += 2;
+            continue;
+        }
+
+        // Copy the conversion, replacing * by the value of its argument
+        char spec[24];
+        size_t len = 0;
+        spec[len++] = *fmt++;
+        while (*fmt != '\0' && strchr("-+ #0123456789.*hlz", *fmt) != NULL && len + 12 < sizeof(spec)) {
+            if (*fmt == '*') {
+                int v = next_arg < DLOG_MAX_ARGS ? (int)args[next_arg++] : 0;
+                len += (size_t)snprintf(spec + len, sizeof(spec) - len, "%d", v);
+            } else {
+                spec[len++] = *fmt;
+            }
+            fmt++;
+        }
+        char conv = *fmt;
+        if (conv == '\0') break;
+        fmt++;
+        spec[len++] = conv;
+        spec[len] = '\0';
+
+        uintptr_t a = next_arg < DLOG_MAX_ARGS ? args[next_arg++] : 0;
+        bool is_long = strchr(spec, 'l') != NULL;
+        bool is_size = strchr(spec, 'z') != NULL;
+        int w;
+        switch (conv) {
+            case 'd':
+            case 'i':
+                if (is_long) w = snprintf(out + n, size - n, spec, (long)a);
+                else if (is_size) w = snprintf(out + n, size - n, spec, (size_t)a);
+                else w = snprintf(out + n, size - n, spec, (int)a);
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+                if (is_long) w = snprintf(out + n, size - n, spec, (unsigned long)a);
+                else if (is_size) w = snprintf(out + n, size - n, spec, (size_t)a);
+                else w = snprintf(out + n, size - n, spec, (unsigned)a);
+                break;
+            case 'c':
+                w = snprintf(out + n, size - n, spec, (int)a);
+                break;
+            case 's':
+                w = snprintf(out + n, size - n, spec, a != 0 ? (const char *)a : "(null)");
+                break;
+            case 'p':
+                w = snprintf(out + n, size - n, spec, (void *)a);
+                break;
+            default:
+                // Not deferrable (floats, 64-bit): shown as written
+                w = snprintf(out + n, size - n, "%s", spec);
+                break;
+        }
+        if (w < 0) break;
+        n += (size_t)w;
+        if (n >= size) n = size - 1;
+    }
+}
+
+static void dlog_emit(uint8_t level, uint32_t time_ms, const char *module, const char *text)
+{
+    static const char letters[] = "?EWID";
+    char letter = level <= DLOG_DEBUG ? letters[level] : '?';
+#ifdef ESP_PLATFORM
+    // Same layout as ESP_LOGx, so monitors and filters treat both alike
+    printf("%c (%" PRIu32 ") %s: %s\n", letter, time_ms, module, text);
+#else
+    (void)time_ms;
+    fprintf(stderr, "%c %s: %s\n", letter, module, text);
+#endif
+}
+
+void dlog_flush(void)
+{
+    char text[DLOG_LINE_MAX];
+
+    for (;;) {
+        // Merge the rings by time, so lines from both cores stay in order
+        dlog_ring_t *oldest = NULL;
+        const dlog_record_t *rec = NULL;
+        for (int i = 0; i < DLOG_CORES; i++) {
+            const dlog_record_t *r = dlog_peek(&rings[i]);
+            if (r != NULL && (rec == NULL || (int32_t)(r->time_ms - rec->time_ms) < 0)) {
+                rec = r;
+                oldest = &rings[i];
+            }
+        }
+        if (rec == NULL) break;
+
+        dlog_format(text, sizeof(text), rec->site->fmt, rec->args);
+        dlog_emit(rec->site->level, rec->time_ms, rec->site->module, text);
+        dlog_release(oldest);
+    }
+
+    for (int i = 0; i < DLOG_CORES; i++) {
+        uint32_t dropped = atomic_exchange_explicit(&rings[i].dropped, 0, memory_order_relaxed);
+        if (dropped > 0) {
+            snprintf(text, sizeof(text), "%" PRIu32 " records dropped on core %d", dropped, i);
+            dlog_emit(DLOG_WARN, dlog_now_ms(), "DLOG", text);
+        }
+    }
+}
+
+#ifdef ESP_PLATFORM
+static void dlog_task(void *arg)
+{
+    for (;;) {
+        dlog_flush();
+        vTaskDelay(pdMS_TO_TICKS(DLOG_FLUSH_MS));
+    }
+}
+
+void dlog_start(void)
+{
+    static bool started = false;
+    if (started) return;
+    started = true;
+    // Below everything else: logging only gets the CPU time left over
+    xTaskCreate(dlog_task, "dlog", DLOG_TASK_STACK, NULL, DLOG_TASK_PRIO, NULL);
+}
+#else
+void dlog_start(void)
+{
+}
+#endif
@@ -0,0 +1,130 @@
+/**
+ * @file dlog.h
+ * @brief Deferred logging: record now, format later on a low-priority task
+ *
+ * A log statement on a hot path (LVGL event handlers, the MQTT event
+ * handler, backend setters) costs the formatting and, on the device, the
+ * UART write of every character at 115200 baud. DLOGx() instead stores a
+ * pointer to a constant description of the statement (level, module,
+ * format: its ID) plus up to DLOG_MAX_ARGS arguments in a lock-free ring,
+ * one per core, and returns. dlog_flush() formats and writes the records
+ * later: the dlog task on the device, the main loop in the simulator.
+ *
+ * Arguments are stored as uintptr_t, so they must be integers, characters
+ * or pointers. A %s argument is read when the record is formatted, not
+ * when it is written: only string literals and other strings that live
+ * forever. Supported conversions: d i u x X o c s p with the l, h, hh and
+ * z modifiers and * widths; no 64-bit integers and no floating point.
+ *
+ * Each module has a compile-time level, DLOG_LEVEL_<MODULE>: from
+ * CONFIG_DLOG_LEVEL_<MODULE> on the device, DLOG_INFO elsewhere, and
+ * overridable with -D. Statements above it compile to nothing, arguments
+ * included.
+ */
+
+#ifndef DLOG_H
+#define DLOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DLOG_NONE   0
+#define DLOG_ERROR  1
+#define DLOG_WARN   2
+#define DLOG_INFO   3
+#define DLOG_DEBUG  4
+
+#define DLOG_MAX_ARGS 4
+
+#ifndef DLOG_LEVEL_BACKEND
+#ifdef CONFIG_DLOG_LEVEL_BACKEND
+#define DLOG_LEVEL_BACKEND CONFIG_DLOG_LEVEL_BACKEND
+#else
+#define DLOG_LEVEL_BACKEND DLOG_INFO
+#endif
+#endif
+
+#ifndef DLOG_LEVEL_UI
+#ifdef CONFIG_DLOG_LEVEL_UI
+#define DLOG_LEVEL_UI CONFIG_DLOG_LEVEL_UI
+#else
+#define DLOG_LEVEL_UI DLOG_INFO
+#endif
+#endif
+
+#ifndef DLOG_LEVEL_MQTT
+#ifdef CONFIG_DLOG_LEVEL_MQTT
+#define DLOG_LEVEL_MQTT CONFIG_DLOG_LEVEL_MQTT
+#else
+#define DLOG_LEVEL_MQTT DLOG_INFO
+#endif
+#endif
+
+/**
+ * One log statement; its address is the format ID stored in a record
+ */
+typedef struct {
+    uint8_t level;
+    const char *module;
+    const char *fmt;
+} dlog_site_t;
+
+/**
+ * @brief Record a statement; use the DLOGx() macros instead
+ *
+ * Safe from any task or ISR on either core, never blocks. When the ring of
+ * the calling core is full the record is dropped and counted.
+ */
+void dlog_write(const dlog_site_t *site, uintptr_t a0, uintptr_t a1, uintptr_t a2, uintptr_t a3);
+
+/**
+ * @brief Format and write every record so far, oldest first
+ *
+ * A single caller at a time. Reports dropped records as a warning.
+ */
+void dlog_flush(void);
+
+/**
+ * @brief Start the task that calls dlog_flush() periodically (device only)
+ */
+void dlog_start(void);
+
+#define DLOGE(module, fmt, ...) DLOG_AT(module, DLOG_ERROR, fmt, ##__VA_ARGS__)
+#define DLOGW(module, fmt, ...) DLOG_AT(module, DLOG_WARN, fmt, ##__VA_ARGS__)
+#define DLOGI(module, fmt, ...) DLOG_AT(module, DLOG_INFO, fmt, ##__VA_ARGS__)
+#define DLOGD(module, fmt, ...) DLOG_AT(module, DLOG_DEBUG, fmt, ##__VA_ARGS__)
+
+// Constant condition: the compiler drops disabled statements entirely
+#define DLOG_AT(module, lvl, fmt, ...)                                          \
+    do {                                                                        \
+        if (DLOG_LEVEL_##module >= (lvl)) {                                     \
+            static const dlog_site_t dlog_site_ = {(lvl), #module, fmt};        \
+            dlog_write(&dlog_site_, DLOG_ARGS_(DLOG_NARGS_(__VA_ARGS__), ##__VA_ARGS__)); \
+        }                                                                       \
+    } while (0)
+
+// Argument count 0..4, each argument cast and the rest padded with 0
+#define DLOG_NARGS_(...) DLOG_NARGS_N_(0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define DLOG_NARGS_N_(_0, _1, _2, _3, _4, n, ...) n
+#define DLOG_ARGS_(n, ...) DLOG_CAT_(DLOG_ARGS_, n)(__VA_ARGS__)
+#define DLOG_CAT_(a, b) DLOG_CAT2_(a, b)
+#define DLOG_CAT2_(a, b) a##b
+#define DLOG_ARGS_0() 0, 0, 0, 0
+#define DLOG_ARGS_1(a) (uintptr_t)(a), 0, 0, 0
+#define DLOG_ARGS_2(a, b) (uintptr_t)(a), (uintptr_t)(b), 0, 0
+#define DLOG_ARGS_3(a, b, c) (uintptr_t)(a), (uintptr_t)(b), (uintptr_t)(c), 0
+#define DLOG_ARGS_4(a, b, c, d) (uintptr_t)(a), (uintptr_t)(b), (uintptr_t)(c), (uintptr_t)(d)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DLOG_H
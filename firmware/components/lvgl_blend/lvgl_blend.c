@@ -0,0 +1,179 @@
+/**
+ * @file lvgl_blend.c
+ * @brief Draw context that sends LVGL's blends to lvgl_blend_kernels.h
+ */
+
+#include "lvgl_blend.h"
+// lv_draw_sw_blend_basic() and _lv_refr_get_disp_refreshing()
+#include "core/lv_refr.h"
+#include "draw/sw/lv_draw_sw.h"
+
+#if defined(ESP_PLATFORM) && CONFIG_LVGL_BLEND_DUAL_CORE && !CONFIG_FREERTOS_UNICORE
+#define LVGL_BLEND_DUAL_CORE 1
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#else
+#define LVGL_BLEND_DUAL_CORE 0
+#endif
+
+// The kernels work on RGB565 with lv_color_mix()'s rounding
+#define LVGL_BLEND_APPLIES (LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP == 0 && LV_COLOR_MIX_ROUND_OFS == 0)
+
+#if LVGL_BLEND_HAVE_PIE
+static const lvgl_blend_kernels_t *active_kernels = &lvgl_blend_kernels_pie;
+#else
+static const lvgl_blend_kernels_t *active_kernels = &lvgl_blend_kernels_swar;
+#endif
+
+#if LVGL_BLEND_APPLIES
+
+_Static_assert(sizeof(lv_color_t) == sizeof(uint16_t), "RGB565 expected");
+
+#if LVGL_BLEND_DUAL_CORE
+// lvgl_task runs on core 1; the helper takes the bottom half of large
+// blends on core 0, above the network tasks and below WiFi
+#define WORKER_CORE     0
+#define WORKER_PRIO     10
+#define WORKER_STACK    2048
+
+static TaskHandle_t worker_task = NULL;
+static SemaphoreHandle_t worker_start;
+static SemaphoreHandle_t worker_done;
+// Handed over through worker_start, released through worker_done
+static lvgl_blend_kernel_t worker_kernel;
+static lvgl_blend_job_t worker_job;
+
+static void lvgl_blend_worker(void *arg)
+{
+    for (;;) {
+        xSemaphoreTake(worker_start, portMAX_DELAY);
+        worker_kernel(&worker_job);
+        xSemaphoreGive(worker_done);
+    }
+}
+
+static void lvgl_blend_worker_start(void)
+{
+    if (worker_task != NULL) return;
+    worker_start = xSemaphoreCreateBinary();
+    worker_done = xSemaphoreCreateBinary();
+    if (worker_start == NULL || worker_done == NULL ||
+        xTaskCreatePinnedToCore(lvgl_blend_worker, "lvgl_blend", WORKER_STACK, NULL, WORKER_PRIO, &worker_task,
+                                WORKER_CORE) != pdPASS) {
+        // Every blend stays on the LVGL task
+        worker_task = NULL;
+    }
+}
+#endif
+
+// Rows of a job are independent, so a large one is cut in two bands: the
+// bottom one for the worker, the top one here, joined before LVGL goes on
+// drawing over the same pixels
+static void LV_ATTRIBUTE_FAST_MEM lvgl_blend_run(lvgl_blend_kernel_t kernel, const lvgl_blend_job_t *job)
+{
+#if LVGL_BLEND_DUAL_CORE
+    if (worker_task != NULL && job->h >= 2 && job->w * job->h >= CONFIG_LVGL_BLEND_DUAL_CORE_MIN_PX) {
+        int32_t top = job->h / 2;
+        worker_kernel = kernel;
+        worker_job = *job;
+        worker_job.h = job->h - top;
+        worker_job.dst += top * job->dst_stride;
+        if (job->src != NULL) worker_job.src += top * job->src_stride;
+        if (job->mask != NULL) worker_job.mask += top * job->mask_stride;
+        xSemaphoreGive(worker_start);
+
+        lvgl_blend_job_t own = *job;
+        own.h = top;
+        kernel(&own);
+        xSemaphoreTake(worker_done, portMAX_DELAY);
+        return;
+    }
+#endif
+    kernel(job);
+}
+
+// lv_draw_sw_blend() has already dropped transparent and clipped away
+// blends; the rest of lv_draw_sw_blend_basic()'s preamble is repeated here
+static void LV_ATTRIBUTE_FAST_MEM lvgl_blend_cb(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc)
+{
+    const lv_opa_t *mask = dsc->mask_buf;
+    if (mask != NULL && dsc->mask_res == LV_DRAW_MASK_RES_TRANSP) return;
+    if (dsc->mask_res == LV_DRAW_MASK_RES_FULL_COVER) mask = NULL;
+
+    const lvgl_blend_kernels_t *k = active_kernels;
+    lv_disp_drv_t *drv = _lv_refr_get_disp_refreshing()->driver;
+    if (k == NULL || drv->set_px_cb != NULL || drv->screen_transp || dsc->blend_mode != LV_BLEND_MODE_NORMAL ||
+        (mask != NULL && !drv->antialiasing)) {
+        lv_draw_sw_blend_basic(draw_ctx, dsc);
+        return;
+    }
+
+    lv_area_t area;
+    if (!_lv_area_intersect(&area, dsc->blend_area, draw_ctx->clip_area)) return;
+
+    lv_coord_t dst_stride = lv_area_get_width(draw_ctx->buf_area);
+    lvgl_blend_job_t job = {
+        .dst = (uint16_t *)draw_ctx->buf + dst_stride * (area.y1 - draw_ctx->buf_area->y1) +
+               (area.x1 - draw_ctx->buf_area->x1),
+        .dst_stride = dst_stride,
+        .w = lv_area_get_width(&area),
+        .h = lv_area_get_height(&area),
+        .color = dsc->color.full,
+        .opa = dsc->opa,
+    };
+    if (dsc->src_buf != NULL) {
+        job.src_stride = lv_area_get_width(dsc->blend_area);
+        job.src = (const uint16_t *)dsc->src_buf + job.src_stride * (area.y1 - dsc->blend_area->y1) +
+                  (area.x1 - dsc->blend_area->x1);
+    }
+    if (mask != NULL) {
+        job.mask_stride = lv_area_get_width(dsc->mask_area);
+        job.mask = mask + job.mask_stride * (area.y1 - dsc->mask_area->y1) + (area.x1 - dsc->mask_area->x1);
+    }
+
+    if (job.src == NULL) {
+        if (job.mask != NULL) lvgl_blend_run(k->fill_mask, &job);
+        else if (job.opa >= LV_OPA_MAX) lvgl_blend_run(k->fill, &job);
+        else lvgl_blend_run(k->fill_opa, &job);
+    } else {
+        if (job.mask != NULL) lvgl_blend_run(k->copy_mask, &job);
+        else if (job.opa >= LV_OPA_MAX) lvgl_blend_run(k->copy, &job);
+        else lvgl_blend_run(k->copy_opa, &job);
+    }
+}
+
+static void lvgl_blend_ctx_init(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx)
+{
+    lv_draw_sw_init_ctx(drv, draw_ctx);
+    ((lv_draw_sw_ctx_t *)draw_ctx)->blend = lvgl_blend_cb;
+}
+
+void lvgl_blend_install(lv_disp_drv_t *drv)
+{
+    drv->draw_ctx_init = lvgl_blend_ctx_init;
+    drv->draw_ctx_deinit = lv_draw_sw_deinit_ctx;
+    drv->draw_ctx_size = sizeof(lv_draw_sw_ctx_t);
+#if LVGL_BLEND_DUAL_CORE
+    lvgl_blend_worker_start();
+#endif
+}
+
+#else
+
+void lvgl_blend_install(lv_disp_drv_t *drv)
+{
+    (void)drv;
+}
+
+#endif // LVGL_BLEND_APPLIES
+
+void lvgl_blend_set_kernels(const lvgl_blend_kernels_t *kernels)
+{
+    active_kernels = kernels;
+}
+
+const lvgl_blend_kernels_t *lvgl_blend_get_kernels(void)
+{
+    return active_kernels;
+}
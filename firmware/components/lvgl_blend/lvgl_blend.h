@@ -0,0 +1,46 @@
+/**
+ * @file lvgl_blend.h
+ * @brief Draw context that sends LVGL's blends to lvgl_blend_kernels.h
+ *
+ * LVGL's software renderer ends every rectangle, border, arc, label and
+ * image in one blend call: a solid or image source, an opacity and an
+ * optional anti-aliasing mask. This draw context is LVGL's own software
+ * one (lv_draw_sw_ctx_t) with only that call replaced: RGB565 blends in
+ * normal mode go to a kernel table, everything else (other blend modes,
+ * set_px_cb, screen transparency, masks without anti-aliasing) still goes
+ * to lv_draw_sw_blend_basic(). Without a table, all of it does.
+ *
+ * With CONFIG_LVGL_BLEND_DUAL_CORE, kernel calls of at least
+ * CONFIG_LVGL_BLEND_DUAL_CORE_MIN_PX pixels are split by rows between the
+ * calling task and a helper task on core 0, and return once both halves
+ * are done. This is where a full-screen redraw spends most of its time;
+ * LVGL's walk of the widget tree (masks, glyphs, image decoding) keeps
+ * global state and stays on one core.
+ */
+
+#ifndef LVGL_BLEND_H
+#define LVGL_BLEND_H
+
+#include "lvgl.h"
+#include "lvgl_blend_kernels.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Give drv this draw context, and start the core 0 helper if enabled; call
+// before lv_disp_drv_register(). Does nothing where the kernels do not
+// apply (not RGB565, swapped bytes or a different color mix rounding).
+void lvgl_blend_install(lv_disp_drv_t *drv);
+
+// Table used from the next blend on; NULL makes every blend LVGL's own.
+// Starts as lvgl_blend_kernels_best(). LVGL task only.
+void lvgl_blend_set_kernels(const lvgl_blend_kernels_t *kernels);
+
+const lvgl_blend_kernels_t *lvgl_blend_get_kernels(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LVGL_BLEND_H
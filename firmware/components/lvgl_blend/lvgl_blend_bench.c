@@ -0,0 +1,173 @@
+#include "lvgl_blend_kernels.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+// Microbenchmark: every kernel of every table on the same rectangle, timed
+// and compared pixel by pixel with the generic table.
+//
+// On the device it runs at boot with CONFIG_LVGL_BLEND_BENCH. On a host:
+//   cc -O2 -DLVGL_BLEND_BENCH_MAIN lvgl_blend_kernels.c lvgl_blend_bench.c -o blend_bench
+//   ./blend_bench [iterations]
+
+// A band of a widget: odd x offset, so rows start and end unaligned
+#define BENCH_STRIDE    256
+#define BENCH_X         3
+#define BENCH_W         240
+#define BENCH_H         32
+
+typedef struct {
+    const char *name;
+    size_t kernel;          // Offset of the kernel in lvgl_blend_kernels_t
+    uint8_t opa;
+    int masked;
+    int copies;
+    int max_err;            // Allowed per-channel difference from generic
+} bench_case_t;
+
+#define KERNEL(k) offsetof(lvgl_blend_kernels_t, k)
+
+static const bench_case_t bench_cases[] = {
+    {"fill",          KERNEL(fill),      255, 0, 0, 0},
+    {"fill_opa",      KERNEL(fill_opa),  128, 0, 0, 2},
+    {"fill_mask",     KERNEL(fill_mask), 255, 1, 0, 0},
+    {"fill_mask_opa", KERNEL(fill_mask), 160, 1, 0, 0},
+    {"copy",          KERNEL(copy),      255, 0, 1, 0},
+    {"copy_opa",      KERNEL(copy_opa),  128, 0, 1, 0},
+    {"copy_mask",     KERNEL(copy_mask), 255, 1, 1, 0},
+    {"copy_mask_opa", KERNEL(copy_mask), 160, 1, 1, 0},
+};
+
+static const lvgl_blend_kernels_t *const bench_tables[] = {
+    &lvgl_blend_kernels_generic,
+    &lvgl_blend_kernels_swar,
+#if LVGL_BLEND_HAVE_PIE
+    &lvgl_blend_kernels_pie,
+#endif
+};
+
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+static lvgl_blend_kernel_t table_kernel(const lvgl_blend_kernels_t *t, size_t offset)
+{
+    lvgl_blend_kernel_t k;
+    memcpy(&k, (const uint8_t *)t + offset, sizeof(k));
+    return k;
+}
+
+// What an anti-aliased arc leaves in a mask: outside, a ramp, inside, a
+// ramp, outside, drifting from row to row
+static void bench_mask_init(uint8_t *mask)
+{
+    for (int32_t y = 0; y < BENCH_H; y++) {
+        int32_t in = 40 + y, out = 200 - y;
+        for (int32_t x = 0; x < BENCH_W; x++) {
+            int32_t v;
+            if (x < in) v = (x - in + 8) * 32;
+            else if (x > out) v = (out - x + 8) * 32;
+            else v = 255;
+            mask[y * BENCH_W + x] = (uint8_t)(v < 0 ? 0 : v > 255 ? 255 : v);
+        }
+    }
+}
+
+static int channel_err(uint16_t a, uint16_t b)
+{
+    int dr = abs((a >> 11) - (b >> 11));
+    int dg = abs(((a >> 5) & 0x3F) - ((b >> 5) & 0x3F));
+    int db = abs((a & 0x1F) - (b & 0x1F));
+    int e = dr > dg ? dr : dg;
+    return e > db ? e : db;
+}
+
+void lvgl_blend_bench_run(uint32_t iterations, int64_t (*clock_us)(void))
+{
+    size_t dst_px = BENCH_STRIDE * BENCH_H;
+    uint16_t *init = malloc(dst_px * sizeof(uint16_t));
+    uint16_t *ref = malloc(dst_px * sizeof(uint16_t));
+    uint16_t *dst = malloc(dst_px * sizeof(uint16_t));
+    // One spare pixel or byte, so source and mask start unaligned as well
+    uint16_t *src = malloc((BENCH_W * BENCH_H + 1) * sizeof(uint16_t));
+    uint8_t *mask = malloc(BENCH_W * BENCH_H + 1);
+    if (!init || !ref || !dst || !src || !mask) {
+        printf("lvgl blend bench: out of memory\n");
+        goto out;
+    }
+
+    for (size_t i = 0; i < dst_px; i++) init[i] = (uint16_t)(i * 0x9E37u + (i >> 4) * 0x0841u);
+    for (size_t i = 0; i <= BENCH_W * BENCH_H; i++) src[i] = (uint16_t)(i * 0x2F1Bu ^ 0xA5A5u);
+    bench_mask_init(mask + 1);
+
+    printf("lvgl blend bench, %" PRIu32 " runs of %dx%d px per kernel\n", iterations, BENCH_W, BENCH_H);
+    printf("%-14s %-8s %10s %8s %8s\n", "kernel", "table", "ns/run", "speedup", "max err");
+
+    for (size_t c = 0; c < COUNT(bench_cases); c++) {
+        const bench_case_t *bc = &bench_cases[c];
+        lvgl_blend_job_t job = {
+            .dst_stride = BENCH_STRIDE,
+            .w = BENCH_W,
+            .h = BENCH_H,
+            .color = 0x1F84u,
+            .src = bc->copies ? src + 1 : NULL,
+            .src_stride = BENCH_W,
+            .opa = bc->opa,
+            .mask = bc->masked ? mask + 1 : NULL,
+            .mask_stride = BENCH_W,
+        };
+        int64_t generic_ns = 0;
+
+        memcpy(ref, init, dst_px * sizeof(uint16_t));
+        job.dst = ref + BENCH_X;
+        table_kernel(&lvgl_blend_kernels_generic, bc->kernel)(&job);
+
+        for (size_t t = 0; t < COUNT(bench_tables); t++) {
+            lvgl_blend_kernel_t kernel = table_kernel(bench_tables[t], bc->kernel);
+            job.dst = dst + BENCH_X;
+
+            // Checked on a fresh destination, timed on whatever it becomes
+            memcpy(dst, init, dst_px * sizeof(uint16_t));
+            kernel(&job);
+            int err = 0;
+            for (size_t i = 0; i < dst_px; i++) {
+                int e = channel_err(dst[i], ref[i]);
+                if (e > err) err = e;
+            }
+
+            int64_t start = clock_us();
+            for (uint32_t i = 0; i < iterations; i++) kernel(&job);
+            int64_t elapsed_ns = iterations ? (clock_us() - start) * 1000 / iterations : 0;
+            if (t == 0) generic_ns = elapsed_ns;
+
+            int64_t speedup_x10 = elapsed_ns ? generic_ns * 10 / elapsed_ns : 0;
+            printf("%-14s %-8s %10" PRId64 " %5" PRId64 ".%" PRId64 "x %8d%s\n", bc->name, bench_tables[t]->name,
+                   elapsed_ns, speedup_x10 / 10, speedup_x10 % 10, err, err > bc->max_err ? "  MISMATCH" : "");
+        }
+    }
+
+out:
+    free(init);
+    free(ref);
+    free(dst);
+    free(src);
+    free(mask);
+}
+
+#ifdef LVGL_BLEND_BENCH_MAIN
+#include <time.h>
+
+static int64_t host_clock_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 20000;
+    lvgl_blend_bench_run(iterations, host_clock_us);
+    return 0;
+}
+#endif
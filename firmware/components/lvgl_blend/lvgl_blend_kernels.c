@@ -0,0 +1,408 @@
+#include "lvgl_blend_kernels.h"
+#include <stdbool.h>
+#include <string.h>
+
+// Word access to pixel and mask buffers, as LVGL's own fill loops do
+typedef uint32_t __attribute__((__may_alias__)) word_t;
+
+// lv_color_mix() of LVGL v8.3 for RGB565, LV_COLOR_MIX_ROUND_OFS 0: the
+// channels are spread apart in one word so that a single multiply by a
+// 5-bit weight blends all three
+#define SPREAD_MASK 0x07E0F81Fu
+
+static inline uint32_t spread(uint16_t c)
+{
+    return ((uint32_t)c | ((uint32_t)c << 16)) & SPREAD_MASK;
+}
+
+static inline uint32_t weight(uint32_t opa)
+{
+    return (opa + 4) >> 3;
+}
+
+static inline uint16_t mix_spread(uint32_t fg, uint16_t bg_px, uint32_t w)
+{
+    uint32_t bg = spread(bg_px);
+    uint32_t res = ((((fg - bg) * w) >> 5) + bg) & SPREAD_MASK;
+    return (uint16_t)((res >> 16) | res);
+}
+
+static inline uint16_t mix(uint16_t fg, uint16_t bg, uint32_t opa)
+{
+    return mix_spread(spread(fg), bg, weight(opa));
+}
+
+/*
+ * generic: LVGL's fill_normal() and map_normal() one pixel at a time
+ */
+
+#define UDIV255(x) (((x) * 0x8081u) >> 0x17)
+
+static void generic_fill(const lvgl_blend_job_t *job)
+{
+    uint16_t *dst = job->dst;
+    for (int32_t y = 0; y < job->h; y++) {
+        for (int32_t x = 0; x < job->w; x++) dst[x] = job->color;
+        dst += job->dst_stride;
+    }
+}
+
+// lv_color_premult() + lv_color_mix_premult()
+static void generic_fill_opa(const lvgl_blend_job_t *job)
+{
+    uint32_t opa = job->opa, inv = 255 - opa;
+    uint32_t r = ((job->color >> 11) & 0x1F) * opa;
+    uint32_t g = ((job->color >> 5) & 0x3F) * opa;
+    uint32_t b = (job->color & 0x1F) * opa;
+    uint16_t *dst = job->dst;
+
+    for (int32_t y = 0; y < job->h; y++) {
+        for (int32_t x = 0; x < job->w; x++) {
+            uint32_t d = dst[x];
+            dst[x] = (uint16_t)(UDIV255(r + ((d >> 11) & 0x1F) * inv) << 11 |
+                                UDIV255(g + ((d >> 5) & 0x3F) * inv) << 5 |
+                                UDIV255(b + (d & 0x1F) * inv));
+        }
+        dst += job->dst_stride;
+    }
+}
+
+static void generic_fill_mask(const lvgl_blend_job_t *job)
+{
+    uint16_t *dst = job->dst;
+    const uint8_t *mask = job->mask;
+
+    for (int32_t y = 0; y < job->h; y++) {
+        for (int32_t x = 0; x < job->w; x++) {
+            uint32_t m = mask[x];
+            if (m == 0) continue;
+            if (job->opa >= LVGL_BLEND_OPA_MAX) {
+                dst[x] = m == LVGL_BLEND_OPA_COVER ? job->color : mix(job->color, dst[x], m);
+            } else {
+                uint32_t opa = m == LVGL_BLEND_OPA_COVER ? job->opa : (m * job->opa) >> 8;
+                dst[x] = mix(job->color, dst[x], opa);
+            }
+        }
+        dst += job->dst_stride;
+        mask += job->mask_stride;
+    }
+}
+
+static void generic_copy(const lvgl_blend_job_t *job)
+{
+    uint16_t *dst = job->dst;
+    const uint16_t *src = job->src;
+    for (int32_t y = 0; y < job->h; y++) {
+        for (int32_t x = 0; x < job->w; x++) dst[x] = src[x];
+        dst += job->dst_stride;
+        src += job->src_stride;
+    }
+}
+
+static void generic_copy_opa(const lvgl_blend_job_t *job)
+{
+    uint16_t *dst = job->dst;
+    const uint16_t *src = job->src;
+    for (int32_t y = 0; y < job->h; y++) {
+        for (int32_t x = 0; x < job->w; x++) dst[x] = mix(src[x], dst[x], job->opa);
+        dst += job->dst_stride;
+        src += job->src_stride;
+    }
+}
+
+static void generic_copy_mask(const lvgl_blend_job_t *job)
+{
+    uint16_t *dst = job->dst;
+    const uint16_t *src = job->src;
+    const uint8_t *mask = job->mask;
+
+    for (int32_t y = 0; y < job->h; y++) {
+        for (int32_t x = 0; x < job->w; x++) {
+            uint32_t m = mask[x];
+            if (m == 0) continue;
+            // map_normal() compares with > here, fill_normal() with >=
+            if (job->opa > LVGL_BLEND_OPA_MAX) {
+                dst[x] = m == LVGL_BLEND_OPA_COVER ? src[x] : mix(src[x], dst[x], m);
+            } else {
+                uint32_t opa = m >= LVGL_BLEND_OPA_MAX ? job->opa : (job->opa * m) >> 8;
+                dst[x] = mix(src[x], dst[x], opa);
+            }
+        }
+        dst += job->dst_stride;
+        src += job->src_stride;
+        mask += job->mask_stride;
+    }
+}
+
+const lvgl_blend_kernels_t lvgl_blend_kernels_generic = {
+    .name = "generic",
+    .fill = generic_fill,
+    .fill_opa = generic_fill_opa,
+    .fill_mask = generic_fill_mask,
+    .copy = generic_copy,
+    .copy_opa = generic_copy_opa,
+    .copy_mask = generic_copy_mask,
+};
+
+/*
+ * swar: the same results, a word at a time where the data allows it
+ */
+
+static inline void fill_row(uint16_t *dst, int32_t w, uint16_t color)
+{
+    uint32_t c32 = (uint32_t)color | ((uint32_t)color << 16);
+    if (w > 0 && ((uintptr_t)dst & 2)) {
+        *dst++ = color;
+        w--;
+    }
+    word_t *d32 = (word_t *)dst;
+    for (; w >= 8; w -= 8, d32 += 4) {
+        d32[0] = c32;
+        d32[1] = c32;
+        d32[2] = c32;
+        d32[3] = c32;
+    }
+    for (; w >= 2; w -= 2) *d32++ = c32;
+    if (w) *(uint16_t *)d32 = color;
+}
+
+static void swar_fill(const lvgl_blend_job_t *job)
+{
+    uint16_t *dst = job->dst;
+    for (int32_t y = 0; y < job->h; y++) {
+        fill_row(dst, job->w, job->color);
+        dst += job->dst_stride;
+    }
+}
+
+static inline uint32_t mix_pair(uint32_t fg, uint32_t pair, uint32_t w)
+{
+    return mix_spread(fg, (uint16_t)pair, w) | ((uint32_t)mix_spread(fg, (uint16_t)(pair >> 16), w) << 16);
+}
+
+// Under a translucent fill the background mostly repeats, so the result
+// of the last pixel pair is reused while the pairs match
+static void swar_fill_opa(const lvgl_blend_job_t *job)
+{
+    uint32_t fg = spread(job->color), w = weight(job->opa);
+    uint32_t last_in = 0, last_out = mix_pair(fg, 0, w);
+    uint16_t *dst = job->dst;
+
+    for (int32_t y = 0; y < job->h; y++) {
+        uint16_t *d = dst;
+        int32_t n = job->w;
+        if (n > 0 && ((uintptr_t)d & 2)) {
+            *d = mix_spread(fg, *d, w);
+            d++;
+            n--;
+        }
+        word_t *d32 = (word_t *)d;
+        for (; n >= 2; n -= 2, d32++) {
+            uint32_t in = *d32;
+            if (in != last_in) {
+                last_in = in;
+                last_out = mix_pair(fg, in, w);
+            }
+            *d32 = last_out;
+        }
+        if (n) {
+            d = (uint16_t *)d32;
+            *d = mix_spread(fg, *d, w);
+        }
+        dst += job->dst_stride;
+    }
+}
+
+static inline void fill_mask_px(uint16_t *d, uint32_t m, const lvgl_blend_job_t *job, uint32_t fg, bool opaque)
+{
+    if (m == 0) return;
+    uint32_t opa = opaque ? m : (m == LVGL_BLEND_OPA_COVER ? job->opa : (m * job->opa) >> 8);
+    *d = opa == LVGL_BLEND_OPA_COVER ? job->color : mix_spread(fg, *d, weight(opa));
+}
+
+// Masks are mostly runs of 0x00 (outside the shape) and 0xFF (inside), so
+// four mask bytes are tested at once and only edges blend per pixel
+static void swar_fill_mask(const lvgl_blend_job_t *job)
+{
+    bool opaque = job->opa >= LVGL_BLEND_OPA_MAX;
+    uint32_t fg = spread(job->color);
+    uint16_t *dst = job->dst;
+    const uint8_t *mask = job->mask;
+
+    for (int32_t y = 0; y < job->h; y++) {
+        int32_t x = 0;
+        for (; x < job->w && ((uintptr_t)(mask + x) & 3); x++) fill_mask_px(&dst[x], mask[x], job, fg, opaque);
+        for (; x + 4 <= job->w; x += 4) {
+            uint32_t m4 = *(const word_t *)(mask + x);
+            if (m4 == 0) continue;
+            if (m4 == 0xFFFFFFFFu && opaque) {
+                fill_row(&dst[x], 4, job->color);
+            } else {
+                fill_mask_px(&dst[x], mask[x], job, fg, opaque);
+                fill_mask_px(&dst[x + 1], mask[x + 1], job, fg, opaque);
+                fill_mask_px(&dst[x + 2], mask[x + 2], job, fg, opaque);
+                fill_mask_px(&dst[x + 3], mask[x + 3], job, fg, opaque);
+            }
+        }
+        for (; x < job->w; x++) fill_mask_px(&dst[x], mask[x], job, fg, opaque);
+        dst += job->dst_stride;
+        mask += job->mask_stride;
+    }
+}
+
+static void swar_copy(const lvgl_blend_job_t *job)
+{
+    uint16_t *dst = job->dst;
+    const uint16_t *src = job->src;
+    for (int32_t y = 0; y < job->h; y++) {
+        memcpy(dst, src, (size_t)job->w * sizeof(uint16_t));
+        dst += job->dst_stride;
+        src += job->src_stride;
+    }
+}
+
+static void swar_copy_opa(const lvgl_blend_job_t *job)
+{
+    uint32_t w = weight(job->opa);
+    uint16_t *dst = job->dst;
+    const uint16_t *src = job->src;
+    for (int32_t y = 0; y < job->h; y++) {
+        for (int32_t x = 0; x < job->w; x++) dst[x] = mix_spread(spread(src[x]), dst[x], w);
+        dst += job->dst_stride;
+        src += job->src_stride;
+    }
+}
+
+static inline void copy_mask_px(uint16_t *d, uint16_t s, uint32_t m, uint8_t opa, bool opaque)
+{
+    if (m == 0) return;
+    if (opaque) {
+        *d = m == LVGL_BLEND_OPA_COVER ? s : mix(s, *d, m);
+    } else {
+        *d = mix(s, *d, m >= LVGL_BLEND_OPA_MAX ? opa : (opa * m) >> 8);
+    }
+}
+
+static void swar_copy_mask(const lvgl_blend_job_t *job)
+{
+    bool opaque = job->opa > LVGL_BLEND_OPA_MAX;
+    uint16_t *dst = job->dst;
+    const uint16_t *src = job->src;
+    const uint8_t *mask = job->mask;
+
+    for (int32_t y = 0; y < job->h; y++) {
+        int32_t x = 0;
+        for (; x < job->w && ((uintptr_t)(mask + x) & 3); x++) copy_mask_px(&dst[x], src[x], mask[x], job->opa, opaque);
+        for (; x + 4 <= job->w; x += 4) {
+            uint32_t m4 = *(const word_t *)(mask + x);
+            if (m4 == 0) continue;
+            if (m4 == 0xFFFFFFFFu && opaque) {
+                memcpy(&dst[x], &src[x], 4 * sizeof(uint16_t));
+            } else {
+                copy_mask_px(&dst[x], src[x], mask[x], job->opa, opaque);
+                copy_mask_px(&dst[x + 1], src[x + 1], mask[x + 1], job->opa, opaque);
+                copy_mask_px(&dst[x + 2], src[x + 2], mask[x + 2], job->opa, opaque);
+                copy_mask_px(&dst[x + 3], src[x + 3], mask[x + 3], job->opa, opaque);
+            }
+        }
+        for (; x < job->w; x++) copy_mask_px(&dst[x], src[x], mask[x], job->opa, opaque);
+        dst += job->dst_stride;
+        src += job->src_stride;
+        mask += job->mask_stride;
+    }
+}
+
+const lvgl_blend_kernels_t lvgl_blend_kernels_swar = {
+    .name = "swar",
+    .fill = swar_fill,
+    .fill_opa = swar_fill_opa,
+    .fill_mask = swar_fill_mask,
+    .copy = swar_copy,
+    .copy_opa = swar_copy_opa,
+    .copy_mask = swar_copy_mask,
+};
+
+/*
+ * pie: swar with the bulk of opaque rows done by 128-bit vector stores
+ */
+
+#if LVGL_BLEND_HAVE_PIE
+
+// lvgl_blend_pie.S; dst, src and pattern 16-byte aligned, blocks of 16 bytes
+void lvgl_blend_pie_fill(uint16_t *dst, const uint32_t *pattern, uint32_t blocks);
+void lvgl_blend_pie_copy(uint16_t *dst, const uint16_t *src, uint32_t blocks);
+
+// Shorter rows are not worth the alignment head and the call
+#define PIE_MIN_PX 32
+
+static void pie_fill(const lvgl_blend_job_t *job)
+{
+    uint32_t c32 = (uint32_t)job->color | ((uint32_t)job->color << 16);
+    uint32_t pattern[4] __attribute__((aligned(16))) = {c32, c32, c32, c32};
+    uint16_t *dst = job->dst;
+
+    for (int32_t y = 0; y < job->h; y++) {
+        uint16_t *d = dst;
+        int32_t n = job->w;
+        if (n >= PIE_MIN_PX) {
+            int32_t head = (int32_t)((16 - ((uintptr_t)d & 15)) & 15) / 2;
+            fill_row(d, head, job->color);
+            d += head;
+            n -= head;
+            lvgl_blend_pie_fill(d, pattern, (uint32_t)n / 8);
+            d += n & ~7;
+            n &= 7;
+        }
+        fill_row(d, n, job->color);
+        dst += job->dst_stride;
+    }
+}
+
+// Only rows whose source and destination share their alignment; the rest
+// is left to memcpy()
+static void pie_copy(const lvgl_blend_job_t *job)
+{
+    uint16_t *dst = job->dst;
+    const uint16_t *src = job->src;
+
+    for (int32_t y = 0; y < job->h; y++) {
+        uint16_t *d = dst;
+        const uint16_t *s = src;
+        int32_t n = job->w;
+        if (n >= PIE_MIN_PX && (((uintptr_t)d ^ (uintptr_t)s) & 15) == 0) {
+            int32_t head = (int32_t)((16 - ((uintptr_t)d & 15)) & 15) / 2;
+            memcpy(d, s, (size_t)head * sizeof(uint16_t));
+            d += head;
+            s += head;
+            n -= head;
+            lvgl_blend_pie_copy(d, s, (uint32_t)n / 8);
+            d += n & ~7;
+            s += n & ~7;
+            n &= 7;
+        }
+        memcpy(d, s, (size_t)n * sizeof(uint16_t));
+        dst += job->dst_stride;
+        src += job->src_stride;
+    }
+}
+
+const lvgl_blend_kernels_t lvgl_blend_kernels_pie = {
+    .name = "pie",
+    .fill = pie_fill,
+    .fill_opa = swar_fill_opa,
+    .fill_mask = swar_fill_mask,
+    .copy = pie_copy,
+    .copy_opa = swar_copy_opa,
+    .copy_mask = swar_copy_mask,
+};
+
+#endif // LVGL_BLEND_HAVE_PIE
+
+const lvgl_blend_kernels_t *lvgl_blend_kernels_best(void)
+{
+#if LVGL_BLEND_HAVE_PIE
+    return &lvgl_blend_kernels_pie;
+#else
+    return &lvgl_blend_kernels_swar;
+#endif
+}
@@ -0,0 +1,93 @@
+/**
+ * @file lvgl_blend_kernels.h
+ * @brief RGB565 fill, blend and copy kernels behind LVGL's software renderer
+ *
+ * Plain C on uint16_t pixels that builds without LVGL or ESP-IDF, so the
+ * microbenchmark also runs on a host. Three kernel tables:
+ *   - generic: one pixel at a time with LVGL v8.3's own formulas; the
+ *              reference the others are checked against
+ *   - swar:    portable C, two pixels per 32-bit access, colors spread once
+ *              per call, 4-byte mask words skipped or copied in one go
+ *   - pie:     ESP32-S3 only, swar with the opaque fill and copy done by
+ *              128-bit PIE vector stores (lvgl_blend_pie.S)
+ *
+ * Every table gives the same pixels as LVGL (LV_COLOR_MIX_ROUND_OFS 0),
+ * except fill_opa in swar and pie, which uses the 5-bit mix of
+ * lv_color_mix() instead of LVGL's 8-bit premultiplied one: at most two
+ * steps per channel apart, the same difference LVGL itself shows between
+ * the masked and unmasked parts of one translucent rectangle.
+ */
+
+#ifndef LVGL_BLEND_KERNELS_H
+#define LVGL_BLEND_KERNELS_H
+
+#include <stdint.h>
+
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && CONFIG_LVGL_BLEND_PIE
+#define LVGL_BLEND_HAVE_PIE 1
+#else
+#define LVGL_BLEND_HAVE_PIE 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// LVGL's opacity limits: at or above MAX counts as opaque, at or below MIN
+// is not drawn at all
+#define LVGL_BLEND_OPA_MIN      2
+#define LVGL_BLEND_OPA_MAX      253
+#define LVGL_BLEND_OPA_COVER    255
+
+/**
+ * One rectangle to blend, already clipped. Strides are in pixels (mask
+ * stride in bytes); src and mask start at the rectangle's first pixel.
+ */
+typedef struct {
+    uint16_t *dst;
+    int32_t dst_stride;
+    int32_t w;
+    int32_t h;
+    uint16_t color;             // fills
+    const uint16_t *src;        // copies
+    int32_t src_stride;
+    uint8_t opa;
+    const uint8_t *mask;        // NULL: fully covered
+    int32_t mask_stride;
+} lvgl_blend_job_t;
+
+typedef void (*lvgl_blend_kernel_t)(const lvgl_blend_job_t *job);
+
+typedef struct {
+    const char *name;
+    lvgl_blend_kernel_t fill;       // color, opa >= MAX, no mask
+    lvgl_blend_kernel_t fill_opa;   // color, opa < MAX, no mask
+    lvgl_blend_kernel_t fill_mask;  // color, any opa, mask
+    lvgl_blend_kernel_t copy;       // src, opa >= MAX, no mask
+    lvgl_blend_kernel_t copy_opa;   // src, opa < MAX, no mask
+    lvgl_blend_kernel_t copy_mask;  // src, any opa, mask
+} lvgl_blend_kernels_t;
+
+extern const lvgl_blend_kernels_t lvgl_blend_kernels_generic;
+extern const lvgl_blend_kernels_t lvgl_blend_kernels_swar;
+#if LVGL_BLEND_HAVE_PIE
+extern const lvgl_blend_kernels_t lvgl_blend_kernels_pie;
+#endif
+
+// The fastest table this build has
+const lvgl_blend_kernels_t *lvgl_blend_kernels_best(void);
+
+// Per-kernel microbenchmark of every table against generic, with a check
+// of each result; prints through printf. clock_us returns a monotonic
+// microsecond timestamp.
+void lvgl_blend_bench_run(uint32_t iterations, int64_t (*clock_us)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LVGL_BLEND_KERNELS_H
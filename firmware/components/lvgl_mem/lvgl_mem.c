@@ -0,0 +1,177 @@
+/**
+ * @file lvgl_mem.c
+ * @brief Dedicated memory pools behind LVGL's allocator
+ */
+
+#include "lvgl_mem.h"
+#include <string.h>
+#include "sdkconfig.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "multi_heap.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "LVGL_MEM";
+
+typedef struct {
+    multi_heap_handle_t heap;   // NULL if the pool could not be reserved
+    uint8_t *start;
+    size_t size;
+    portMUX_TYPE lock;
+} pool_t;
+
+static pool_t pools[LVGL_MEM_POOL_COUNT] = {
+    [LVGL_MEM_POOL_SRAM] = { .lock = portMUX_INITIALIZER_UNLOCKED },
+    [LVGL_MEM_POOL_PSRAM] = { .lock = portMUX_INITIALIZER_UNLOCKED },
+};
+
+// LVGL allocates from its own task only; readers may see a stale count
+static volatile uint32_t fallbacks;
+static volatile uint32_t failures;
+
+static void pool_reserve(pool_t *pool, size_t size, uint32_t caps, const char *name)
+{
+    if (size == 0) {
+        return;
+    }
+    pool->start = heap_caps_malloc(size, caps);
+    if (pool->start == NULL) {
+        ESP_LOGW(TAG, "No room for a %u KiB %s pool", (unsigned)(size / 1024), name);
+        return;
+    }
+    pool->heap = multi_heap_register(pool->start, size);
+    if (pool->heap == NULL) {
+        ESP_LOGW(TAG, "Cannot set up the %s pool", name);
+        heap_caps_free(pool->start);
+        pool->start = NULL;
+        return;
+    }
+    // Stats are read from the telemetry task
+    multi_heap_set_lock(pool->heap, &pool->lock);
+    pool->size = size;
+    ESP_LOGI(TAG, "%s pool: %u KiB", name, (unsigned)(size / 1024));
+}
+
+void lvgl_mem_init(void)
+{
+    pool_reserve(&pools[LVGL_MEM_POOL_SRAM], CONFIG_LVGL_MEM_SRAM_POOL_KB * 1024,
+                 MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT, "SRAM");
+    pool_reserve(&pools[LVGL_MEM_POOL_PSRAM], CONFIG_LVGL_MEM_PSRAM_POOL_KB * 1024,
+                 MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, "PSRAM");
+}
+
+static pool_t *pool_of(const void *ptr)
+{
+    const uint8_t *p = ptr;
+    for (int i = 0; i < LVGL_MEM_POOL_COUNT; i++) {
+        if (pools[i].heap != NULL && p >= pools[i].start && p < pools[i].start + pools[i].size) {
+            return &pools[i];
+        }
+    }
+    return NULL;
+}
+
+static pool_t *preferred_pool(size_t size)
+{
+    if (size >= CONFIG_LVGL_MEM_LARGE_ALLOC_BYTES && pools[LVGL_MEM_POOL_PSRAM].heap != NULL) {
+        return &pools[LVGL_MEM_POOL_PSRAM];
+    }
+    return &pools[LVGL_MEM_POOL_SRAM];
+}
+
+static void *pool_alloc(pool_t *pool, size_t size)
+{
+    return pool->heap != NULL ? multi_heap_malloc(pool->heap, size) : NULL;
+}
+
+void *lvgl_mem_alloc(size_t size)
+{
+    pool_t *preferred = preferred_pool(size);
+    void *p = pool_alloc(preferred, size);
+    if (p != NULL) {
+        return p;
+    }
+
+    pool_t *other = preferred == &pools[LVGL_MEM_POOL_SRAM] ? &pools[LVGL_MEM_POOL_PSRAM]
+                                                            : &pools[LVGL_MEM_POOL_SRAM];
+    p = pool_alloc(other, size);
+    if (p == NULL) {
+        p = heap_caps_malloc(size, MALLOC_CAP_8BIT);
+    }
+    if (p != NULL) {
+        fallbacks++;
+    } else {
+        failures++;
+    }
+    return p;
+}
+
+void lvgl_mem_free(void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+    pool_t *pool = pool_of(ptr);
+    if (pool != NULL) {
+        multi_heap_free(pool->heap, ptr);
+    } else {
+        heap_caps_free(ptr);
+    }
+}
+
+void *lvgl_mem_realloc(void *ptr, size_t size)
+{
+    if (ptr == NULL) {
+        return lvgl_mem_alloc(size);
+    }
+    if (size == 0) {
+        lvgl_mem_free(ptr);
+        return NULL;
+    }
+
+    pool_t *pool = pool_of(ptr);
+    size_t old_size = pool != NULL ? multi_heap_get_allocated_size(pool->heap, ptr)
+                                   : heap_caps_get_allocated_size(ptr);
+
+    // Grow in place only within the right pool; shrinking never moves
+    if (pool != NULL && (pool == preferred_pool(size) || size <= old_size)) {
+        void *p = multi_heap_realloc(pool->heap, ptr, size);
+        if (p != NULL) {
+            return p;
+        }
+    }
+
+    void *p = lvgl_mem_alloc(size);
+    if (p == NULL) {
+        return NULL;
+    }
+    memcpy(p, ptr, old_size < size ? old_size : size);
+    lvgl_mem_free(ptr);
+    return p;
+}
+
+void lvgl_mem_get_stats(lvgl_mem_stats_t *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    for (int i = 0; i < LVGL_MEM_POOL_COUNT; i++) {
+        const pool_t *pool = &pools[i];
+        if (pool->heap == NULL) {
+            continue;
+        }
+        multi_heap_info_t info;
+        multi_heap_get_info(pool->heap, &info);
+
+        // The usable total excludes the TLSF control structure
+        size_t usable = info.total_free_bytes + info.total_allocated_bytes;
+        lvgl_mem_pool_stats_t *s = &out->pools[i];
+        s->size = pool->size;
+        s->used = info.total_allocated_bytes;
+        s->peak = usable - info.minimum_free_bytes;
+        s->largest_free = info.largest_free_block;
+        s->frag_pct = info.total_free_bytes == 0 ? 0
+                    : (uint8_t)(100 - (uint64_t)info.largest_free_block * 100 / info.total_free_bytes);
+    }
+    out->fallbacks = fallbacks;
+    out->failures = failures;
+}
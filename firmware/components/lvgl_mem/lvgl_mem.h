@@ -0,0 +1,70 @@
+/**
+ * @file lvgl_mem.h
+ * @brief Dedicated memory pools behind LVGL's allocator
+ *
+ * Two TLSF heaps (ESP-IDF's multi_heap) are carved out of the system heap
+ * once at boot, before WiFi and TLS fragment it:
+ *   - SRAM:  small, hot allocations (objects, styles, label text)
+ *   - PSRAM: allocations of CONFIG_LVGL_MEM_LARGE_ALLOC_BYTES and more
+ *            (draw layers, decoded images)
+ * LVGL's churn then stays inside its own pools, where TLSF allocates in
+ * constant time and merges free neighbours at once, and it cannot starve
+ * or fragment the memory the network stack needs.
+ *
+ * When the preferred pool is full the other one is tried, then the system
+ * heap; each such fallback is counted. Without PSRAM every allocation
+ * uses the SRAM pool.
+ */
+
+#ifndef LVGL_MEM_H
+#define LVGL_MEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    LVGL_MEM_POOL_SRAM,
+    LVGL_MEM_POOL_PSRAM,
+    LVGL_MEM_POOL_COUNT,
+} lvgl_mem_pool_t;
+
+typedef struct {
+    uint32_t size;          /**< Pool size in bytes, 0 if the pool does not exist */
+    uint32_t used;          /**< Bytes allocated now */
+    uint32_t peak;          /**< Highest allocated since boot */
+    uint32_t largest_free;  /**< Largest block that can still be allocated */
+    uint8_t frag_pct;       /**< Free memory not in the largest free block, in percent */
+} lvgl_mem_pool_stats_t;
+
+typedef struct {
+    lvgl_mem_pool_stats_t pools[LVGL_MEM_POOL_COUNT];
+    uint32_t fallbacks;     /**< Allocations served by a pool other than the preferred one */
+    uint32_t failures;      /**< Allocations that failed everywhere */
+} lvgl_mem_stats_t;
+
+/**
+ * @brief Reserve the pools
+ *
+ * Call before lv_init(). Allocations made before (or if a pool cannot be
+ * reserved) go to the system heap.
+ */
+void lvgl_mem_init(void);
+
+/** @brief LV_MEM_CUSTOM_ALLOC / _FREE / _REALLOC */
+void *lvgl_mem_alloc(size_t size);
+void lvgl_mem_free(void *ptr);
+void *lvgl_mem_realloc(void *ptr, size_t size);
+
+/** @brief Usage of both pools; callable from any task */
+void lvgl_mem_get_stats(lvgl_mem_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LVGL_MEM_H
@@ -0,0 +1,516 @@
+#include "payload_codec.h"
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#define HEADER(type)    ((uint8_t)((PAYLOAD_VERSION << 4) | ((type) & 0x0F)))
+
+// ==================== Binary helpers ====================
+
+static inline uint8_t *put_u8(uint8_t *p, uint8_t v)
+{
+    *p++ = v;
+    return p;
+}
+
+static inline uint8_t *put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static inline uint8_t *put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+static inline uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint16_t clamp_u16(uint32_t v)
+{
+    return v > UINT16_MAX ? UINT16_MAX : (uint16_t)v;
+}
+
+// Header check shared by all binary decoders
+static bool binary_header_ok(const uint8_t *data, size_t len, payload_type_t type, size_t min_len)
+{
+    return len >= min_len && data[0] == PAYLOAD_MAGIC &&
+           (data[1] >> 4) == PAYLOAD_VERSION && (data[1] & 0x0F) == type;
+}
+
+payload_format_t payload_detect_format(const uint8_t *data, size_t len)
+{
+    return len >= 2 && data[0] == PAYLOAD_MAGIC ? PAYLOAD_FORMAT_BINARY : PAYLOAD_FORMAT_JSON;
+}
+
+// ==================== JSON helpers ====================
+
+// snprintf wrapper returning -1 on truncation, like the binary encoders
+static int json_result(int n, size_t size)
+{
+    return n < 0 || (size_t)n >= size ? -1 : n;
+}
+
+// Value following "key": in a flat JSON object, or NULL. Keys are plain
+// identifiers, so a byte scan is enough; no escapes are involved.
+static const uint8_t *json_find(const uint8_t *data, size_t len, const char *key)
+{
+    size_t key_len = strlen(key);
+    const uint8_t *end = data + len;
+
+    for (const uint8_t *p = data; p + key_len + 2 < end; p++) {
+        if (*p != '"' || p[key_len + 1] != '"' || memcmp(p + 1, key, key_len) != 0) {
+            continue;
+        }
+        p += key_len + 2;
+        while (p < end && (*p == ' ' || *p == '\t')) p++;
+        if (p >= end || *p != ':') return NULL;
+        p++;
+        while (p < end && (*p == ' ' || *p == '\t')) p++;
+        return p < end ? p : NULL;
+    }
+    return NULL;
+}
+
+// Unsigned integer at p; optionally one decimal digit scaled in (x10)
+static const uint8_t *json_parse_uint(const uint8_t *p, const uint8_t *end, uint32_t *out, bool x10)
+{
+    if (p >= end || *p < '0' || *p > '9') return NULL;
+
+    uint32_t v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (v <= (UINT32_MAX - 9) / 10) v = v * 10 + (uint32_t)(*p - '0');
+        p++;
+    }
+    if (x10) {
+        uint32_t frac = 0;
+        if (p + 1 < end && *p == '.' && p[1] >= '0' && p[1] <= '9') {
+            frac = (uint32_t)(p[1] - '0');
+            p += 2;
+            while (p < end && *p >= '0' && *p <= '9') p++;
+        }
+        v = v * 10 + frac;
+    }
+    *out = v;
+    return p;
+}
+
+static bool json_get_uint(const uint8_t *data, size_t len, const char *key, uint32_t *out)
+{
+    const uint8_t *p = json_find(data, len, key);
+    return p && json_parse_uint(p, data + len, out, false);
+}
+
+// "key":[a,b] into out[0..1]
+static bool json_get_pair(const uint8_t *data, size_t len, const char *key, uint32_t out[2])
+{
+    const uint8_t *end = data + len;
+    const uint8_t *p = json_find(data, len, key);
+    if (p == NULL || *p++ != '[') return false;
+
+    for (int i = 0; i < 2; i++) {
+        while (p < end && *p == ' ') p++;
+        p = json_parse_uint(p, end, &out[i], false);
+        if (p == NULL) return false;
+        while (p < end && *p == ' ') p++;
+        if (p >= end || *p++ != (i == 0 ? ',' : ']')) return false;
+    }
+    return true;
+}
+
+// ==================== Light state ====================
+
+int payload_encode_light_state(payload_format_t fmt, const payload_light_state_t *in,
+                               uint8_t *buf, size_t size)
+{
+    if (fmt == PAYLOAD_FORMAT_BINARY) {
+        if (size < PAYLOAD_LIGHT_STATE_BIN_LEN) return -1;
+        uint8_t *p = buf;
+        p = put_u8(p, PAYLOAD_MAGIC);
+        p = put_u8(p, HEADER(PAYLOAD_TYPE_LIGHT_STATE));
+        p = put_u8(p, (uint8_t)((in->bright ? 0x01 : 0) | (in->relax ? 0x02 : 0)));
+        return (int)(p - buf);
+    }
+    return json_result(snprintf((char *)buf, size, "{\"bright\":%u,\"relax\":%u}",
+                                in->bright ? 1u : 0u, in->relax ? 1u : 0u), size);
+}
+
+bool payload_decode_light_state(const uint8_t *data, size_t len, payload_light_state_t *out)
+{
+    if (payload_detect_format(data, len) == PAYLOAD_FORMAT_BINARY) {
+        if (!binary_header_ok(data, len, PAYLOAD_TYPE_LIGHT_STATE, PAYLOAD_LIGHT_STATE_BIN_LEN)) {
+            return false;
+        }
+        out->bright = data[2] & 0x01 ? 1 : 0;
+        out->relax = data[2] & 0x02 ? 1 : 0;
+        return true;
+    }
+
+    uint32_t bright, relax;
+    if (!json_get_uint(data, len, "bright", &bright) || !json_get_uint(data, len, "relax", &relax)) {
+        return false;
+    }
+    out->bright = bright ? 1 : 0;
+    out->relax = relax ? 1 : 0;
+    return true;
+}
+
+// ==================== Water level ====================
+
+int payload_encode_water_level(payload_format_t fmt, const payload_water_level_t *in,
+                               uint8_t *buf, size_t size)
+{
+    uint8_t level = in->level > 100 ? 100 : in->level;
+
+    if (fmt == PAYLOAD_FORMAT_BINARY) {
+        if (size < PAYLOAD_WATER_LEVEL_BIN_LEN) return -1;
+        uint8_t *p = buf;
+        p = put_u8(p, PAYLOAD_MAGIC);
+        p = put_u8(p, HEADER(PAYLOAD_TYPE_WATER_LEVEL));
+        p = put_u8(p, level);
+        return (int)(p - buf);
+    }
+    return json_result(snprintf((char *)buf, size, "{\"level\":%u}", level), size);
+}
+
+bool payload_decode_water_level(const uint8_t *data, size_t len, payload_water_level_t *out)
+{
+    uint32_t level;
+
+    if (payload_detect_format(data, len) == PAYLOAD_FORMAT_BINARY) {
+        if (!binary_header_ok(data, len, PAYLOAD_TYPE_WATER_LEVEL, PAYLOAD_WATER_LEVEL_BIN_LEN)) {
+            return false;
+        }
+        level = data[2];
+    } else {
+        const uint8_t *end = data + len;
+        const uint8_t *p = data;
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+        if (p < end && *p == '{') {
+            if (!json_get_uint(data, len, "level", &level)) return false;
+        } else if (!json_parse_uint(p, end, &level, false)) {
+            return false;
+        }
+    }
+
+    out->level = level > 100 ? 100 : (uint8_t)level;
+    return true;
+}
+
+// ==================== Telemetry ====================
+
+int payload_encode_telemetry(payload_format_t fmt, const payload_telemetry_t *in,
+                             uint8_t *buf, size_t size)
+{
+    uint8_t task_count = in->task_count > PAYLOAD_TELEMETRY_MAX_TASKS ? PAYLOAD_TELEMETRY_MAX_TASKS
+                                                                      : in->task_count;
+
+    if (fmt == PAYLOAD_FORMAT_BINARY) {
+        size_t need = PAYLOAD_TELEMETRY_BIN_LEN + 1 + PAYLOAD_TELEMETRY_POOLS_LEN + PAYLOAD_TELEMETRY_WIFI_LEN +
+                      PAYLOAD_TELEMETRY_MQTT_LEN + PAYLOAD_TELEMETRY_COPRO_LEN;
+        for (uint8_t i = 0; i < task_count; i++) {
+            need += 2 + strnlen(in->tasks[i].name, sizeof(in->tasks[i].name));
+        }
+        if (size < need) return -1;
+
+        uint8_t *p = buf;
+        p = put_u8(p, PAYLOAD_MAGIC);
+        p = put_u8(p, HEADER(PAYLOAD_TYPE_TELEMETRY));
+        p = put_u32(p, in->uptime_s);
+        p = put_u16(p, in->fps_x10);
+        p = put_u8(p, in->lvgl_idle_pct);
+        p = put_u16(p, in->render_max_ms);
+        p = put_u32(p, in->flush_max_us);
+        p = put_u8(p, in->core_load_pct[0]);
+        p = put_u8(p, in->core_load_pct[1]);
+        p = put_u32(p, in->internal_free);
+        p = put_u32(p, in->internal_min_free);
+        p = put_u32(p, in->psram_free);
+        p = put_u32(p, in->psram_min_free);
+        p = put_u16(p, in->touch_i2c_avg_us);
+        p = put_u16(p, in->touch_i2c_max_us);
+        p = put_u16(p, in->touch_i2c_errors);
+        p = put_u16(p, in->mqtt_rtt_ms);
+        p = put_u16(p, in->nvs_writes_per_hour);
+
+        p = put_u8(p, task_count);
+        for (uint8_t i = 0; i < task_count; i++) {
+            size_t name_len = strnlen(in->tasks[i].name, sizeof(in->tasks[i].name));
+            p = put_u8(p, in->tasks[i].cpu_pct);
+            p = put_u8(p, (uint8_t)name_len);
+            memcpy(p, in->tasks[i].name, name_len);
+            p += name_len;
+        }
+
+        p = put_u32(p, in->lvgl_sram_used);
+        p = put_u32(p, in->lvgl_sram_peak);
+        p = put_u32(p, in->lvgl_psram_used);
+        p = put_u32(p, in->lvgl_psram_peak);
+        p = put_u8(p, in->lvgl_sram_frag_pct);
+        p = put_u8(p, in->lvgl_psram_frag_pct);
+        p = put_u16(p, in->lvgl_mem_fallbacks);
+
+        p = put_u32(p, in->wifi_reconnect_ms);
+        p = put_u16(p, in->wifi_reconnects);
+        p = put_u16(p, in->wifi_fast_reconnects);
+
+        p = put_u32(p, in->mqtt_connect_ms);
+        p = put_u32(p, in->tls_heap_peak);
+        p = put_u16(p, in->tls_handshake_ms);
+        p = put_u16(p, in->mqtt_connects);
+        p = put_u16(p, in->mqtt_sessions_kept);
+        p = put_u16(p, in->tls_resumed);
+
+        p = put_u32(p, in->copro_frames);
+        p = put_u32(p, in->copro_bytes);
+        p = put_u16(p, in->copro_crc_errors);
+        p = put_u16(p, in->copro_framing_errors);
+        p = put_u16(p, in->copro_overruns);
+        p = put_u16(p, in->copro_parse_kbs);
+        return (int)(p - buf);
+    }
+
+    int n = snprintf((char *)buf, size,
+        "{\"up\":%" PRIu32 ",\"fps\":%u.%u,\"idle\":%u,"
+        "\"render_ms\":%u,\"flush_us\":%" PRIu32 ","
+        "\"cpu\":[%u,%u],"
+        "\"heap\":[%" PRIu32 ",%" PRIu32 "],\"psram\":[%" PRIu32 ",%" PRIu32 "],"
+        "\"touch_us\":[%u,%u],\"i2c_err\":%u,"
+        "\"rtt_ms\":%u,\"nvs_wph\":%u,"
+        "\"lv_sram\":[%" PRIu32 ",%" PRIu32 "],\"lv_psram\":[%" PRIu32 ",%" PRIu32 "],"
+        "\"lv_frag\":[%u,%u],\"lv_fallback\":%u,"
+        "\"wifi_rc\":[%" PRIu32 ",%u],\"wifi_fast\":%u,"
+        "\"mqtt_conn\":[%" PRIu32 ",%u],\"mqtt_kept\":%u,"
+        "\"tls\":[%u,%" PRIu32 "],\"tls_resumed\":%u,"
+        "\"copro\":[%" PRIu32 ",%" PRIu32 "],\"copro_err\":[%u,%u],\"copro_ovf\":%u,\"copro_kbs\":%u,"
+        "\"tasks\":{",
+        in->uptime_s, in->fps_x10 / 10u, in->fps_x10 % 10u, in->lvgl_idle_pct,
+        in->render_max_ms, in->flush_max_us,
+        in->core_load_pct[0], in->core_load_pct[1],
+        in->internal_free, in->internal_min_free, in->psram_free, in->psram_min_free,
+        in->touch_i2c_avg_us, in->touch_i2c_max_us, in->touch_i2c_errors,
+        in->mqtt_rtt_ms, in->nvs_writes_per_hour,
+        in->lvgl_sram_used, in->lvgl_sram_peak, in->lvgl_psram_used, in->lvgl_psram_peak,
+        in->lvgl_sram_frag_pct, in->lvgl_psram_frag_pct, in->lvgl_mem_fallbacks,
+        in->wifi_reconnect_ms, in->wifi_reconnects, in->wifi_fast_reconnects,
+        in->mqtt_connect_ms, in->mqtt_connects, in->mqtt_sessions_kept,
+        in->tls_handshake_ms, in->tls_heap_peak, in->tls_resumed,
+        in->copro_frames, in->copro_bytes, in->copro_crc_errors, in->copro_framing_errors,
+        in->copro_overruns, in->copro_parse_kbs);
+
+    for (uint8_t i = 0; i < task_count && json_result(n, size) >= 0; i++) {
+        n += snprintf((char *)buf + n, size - n, "%s\"%.*s\":%u", i ? "," : "",
+                      (int)sizeof(in->tasks[i].name), in->tasks[i].name, in->tasks[i].cpu_pct);
+    }
+    if (json_result(n, size) >= 0) {
+        n += snprintf((char *)buf + n, size - n, "}}");
+    }
+    return json_result(n, size);
+}
+
+bool payload_decode_telemetry(const uint8_t *data, size_t len, payload_telemetry_t *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    if (payload_detect_format(data, len) == PAYLOAD_FORMAT_BINARY) {
+        if (!binary_header_ok(data, len, PAYLOAD_TYPE_TELEMETRY, PAYLOAD_TELEMETRY_BIN_LEN)) {
+            return false;
+        }
+        const uint8_t *p = data + 2;
+        out->uptime_s = get_u32(p);             p += 4;
+        out->fps_x10 = get_u16(p);              p += 2;
+        out->lvgl_idle_pct = *p++;
+        out->render_max_ms = get_u16(p);        p += 2;
+        out->flush_max_us = get_u32(p);         p += 4;
+        out->core_load_pct[0] = *p++;
+        out->core_load_pct[1] = *p++;
+        out->internal_free = get_u32(p);        p += 4;
+        out->internal_min_free = get_u32(p);    p += 4;
+        out->psram_free = get_u32(p);           p += 4;
+        out->psram_min_free = get_u32(p);       p += 4;
+        out->touch_i2c_avg_us = get_u16(p);     p += 2;
+        out->touch_i2c_max_us = get_u16(p);     p += 2;
+        out->touch_i2c_errors = get_u16(p);     p += 2;
+        out->mqtt_rtt_ms = get_u16(p);          p += 2;
+        out->nvs_writes_per_hour = get_u16(p);  p += 2;
+
+        // Task trailer; a truncated trailer keeps the tasks read so far
+        const uint8_t *end = data + len;
+        if (p >= end) return true;
+        uint8_t count = *p++;
+        for (uint8_t i = 0; i < count; i++) {
+            if (end - p < 2 || end - p < 2 + p[1]) return true;
+            if (out->task_count == PAYLOAD_TELEMETRY_MAX_TASKS) {
+                p += 2 + p[1];
+                continue;
+            }
+            size_t name_len = p[1] < sizeof(out->tasks[0].name) ? p[1] : sizeof(out->tasks[0].name) - 1;
+            out->tasks[out->task_count].cpu_pct = p[0];
+            memcpy(out->tasks[out->task_count].name, p + 2, name_len);
+            out->tasks[out->task_count].name[name_len] = '\0';
+            out->task_count++;
+            p += 2 + p[1];
+        }
+
+        // Pool block, absent from older senders
+        if (end - p < PAYLOAD_TELEMETRY_POOLS_LEN) return true;
+        out->lvgl_sram_used = get_u32(p);       p += 4;
+        out->lvgl_sram_peak = get_u32(p);       p += 4;
+        out->lvgl_psram_used = get_u32(p);      p += 4;
+        out->lvgl_psram_peak = get_u32(p);      p += 4;
+        out->lvgl_sram_frag_pct = *p++;
+        out->lvgl_psram_frag_pct = *p++;
+        out->lvgl_mem_fallbacks = get_u16(p);   p += 2;
+
+        // WiFi block, absent from older senders
+        if (end - p < PAYLOAD_TELEMETRY_WIFI_LEN) return true;
+        out->wifi_reconnect_ms = get_u32(p);    p += 4;
+        out->wifi_reconnects = get_u16(p);      p += 2;
+        out->wifi_fast_reconnects = get_u16(p); p += 2;
+
+        // MQTT block, absent from older senders
+        if (end - p < PAYLOAD_TELEMETRY_MQTT_LEN) return true;
+        out->mqtt_connect_ms = get_u32(p);      p += 4;
+        out->tls_heap_peak = get_u32(p);        p += 4;
+        out->tls_handshake_ms = get_u16(p);     p += 2;
+        out->mqtt_connects = get_u16(p);        p += 2;
+        out->mqtt_sessions_kept = get_u16(p);   p += 2;
+        out->tls_resumed = get_u16(p);          p += 2;
+
+        // Co-processor block, absent from older senders
+        if (end - p < PAYLOAD_TELEMETRY_COPRO_LEN) return true;
+        out->copro_frames = get_u32(p);         p += 4;
+        out->copro_bytes = get_u32(p);          p += 4;
+        out->copro_crc_errors = get_u16(p);     p += 2;
+        out->copro_framing_errors = get_u16(p); p += 2;
+        out->copro_overruns = get_u16(p);       p += 2;
+        out->copro_parse_kbs = get_u16(p);
+        return true;
+    }
+
+    uint32_t v, pair[2];
+    if (!json_get_uint(data, len, "up", &v)) return false;
+    out->uptime_s = v;
+
+    const uint8_t *p = json_find(data, len, "fps");
+    if (p && json_parse_uint(p, data + len, &v, true)) out->fps_x10 = clamp_u16(v);
+    if (json_get_uint(data, len, "idle", &v)) out->lvgl_idle_pct = v > 100 ? 100 : (uint8_t)v;
+    if (json_get_uint(data, len, "render_ms", &v)) out->render_max_ms = clamp_u16(v);
+    if (json_get_uint(data, len, "flush_us", &v)) out->flush_max_us = v;
+    if (json_get_pair(data, len, "cpu", pair)) {
+        out->core_load_pct[0] = pair[0] > 100 ? 100 : (uint8_t)pair[0];
+        out->core_load_pct[1] = pair[1] > 100 ? 100 : (uint8_t)pair[1];
+    }
+    if (json_get_pair(data, len, "heap", pair)) {
+        out->internal_free = pair[0];
+        out->internal_min_free = pair[1];
+    }
+    if (json_get_pair(data, len, "psram", pair)) {
+        out->psram_free = pair[0];
+        out->psram_min_free = pair[1];
+    }
+    if (json_get_pair(data, len, "touch_us", pair)) {
+        out->touch_i2c_avg_us = clamp_u16(pair[0]);
+        out->touch_i2c_max_us = clamp_u16(pair[1]);
+    }
+    if (json_get_uint(data, len, "i2c_err", &v)) out->touch_i2c_errors = clamp_u16(v);
+    if (json_get_uint(data, len, "rtt_ms", &v)) out->mqtt_rtt_ms = clamp_u16(v);
+    if (json_get_uint(data, len, "nvs_wph", &v)) out->nvs_writes_per_hour = clamp_u16(v);
+    if (json_get_pair(data, len, "lv_sram", pair)) {
+        out->lvgl_sram_used = pair[0];
+        out->lvgl_sram_peak = pair[1];
+    }
+    if (json_get_pair(data, len, "lv_psram", pair)) {
+        out->lvgl_psram_used = pair[0];
+        out->lvgl_psram_peak = pair[1];
+    }
+    if (json_get_pair(data, len, "lv_frag", pair)) {
+        out->lvgl_sram_frag_pct = pair[0] > 100 ? 100 : (uint8_t)pair[0];
+        out->lvgl_psram_frag_pct = pair[1] > 100 ? 100 : (uint8_t)pair[1];
+    }
+    if (json_get_uint(data, len, "lv_fallback", &v)) out->lvgl_mem_fallbacks = clamp_u16(v);
+    if (json_get_pair(data, len, "wifi_rc", pair)) {
+        out->wifi_reconnect_ms = pair[0];
+        out->wifi_reconnects = clamp_u16(pair[1]);
+    }
+    if (json_get_uint(data, len, "wifi_fast", &v)) out->wifi_fast_reconnects = clamp_u16(v);
+    if (json_get_pair(data, len, "mqtt_conn", pair)) {
+        out->mqtt_connect_ms = pair[0];
+        out->mqtt_connects = clamp_u16(pair[1]);
+    }
+    if (json_get_uint(data, len, "mqtt_kept", &v)) out->mqtt_sessions_kept = clamp_u16(v);
+    if (json_get_pair(data, len, "tls", pair)) {
+        out->tls_handshake_ms = clamp_u16(pair[0]);
+        out->tls_heap_peak = pair[1];
+    }
+    if (json_get_uint(data, len, "tls_resumed", &v)) out->tls_resumed = clamp_u16(v);
+    if (json_get_pair(data, len, "copro", pair)) {
+        out->copro_frames = pair[0];
+        out->copro_bytes = pair[1];
+    }
+    if (json_get_pair(data, len, "copro_err", pair)) {
+        out->copro_crc_errors = clamp_u16(pair[0]);
+        out->copro_framing_errors = clamp_u16(pair[1]);
+    }
+    if (json_get_uint(data, len, "copro_ovf", &v)) out->copro_overruns = clamp_u16(v);
+    if (json_get_uint(data, len, "copro_kbs", &v)) out->copro_parse_kbs = clamp_u16(v);
+    return true;
+}
+
+// ==================== Local link ====================
+
+int payload_encode_local_frame(const payload_local_frame_t *in, uint8_t *buf, size_t size)
+{
+    if (size < PAYLOAD_LOCAL_FRAME_LEN) return -1;
+
+    uint8_t *p = buf;
+    p = put_u8(p, PAYLOAD_MAGIC);
+    p = put_u8(p, HEADER(PAYLOAD_TYPE_LOCAL_FRAME));
+    p = put_u8(p, in->kind);
+    p = put_u8(p, in->tank);
+    p = put_u32(p, in->node);
+    p = put_u16(p, in->seq);
+    if (in->kind == PAYLOAD_LOCAL_LIGHT_STATE) {
+        p = put_u8(p, in->light.bright ? 1 : 0);
+        p = put_u8(p, in->light.relax ? 1 : 0);
+    } else {
+        p = put_u8(p, in->level.level);
+        p = put_u8(p, 0);
+    }
+    return (int)(p - buf);
+}
+
+bool payload_decode_local_frame(const uint8_t *data, size_t len, payload_local_frame_t *out)
+{
+    if (!binary_header_ok(data, len, PAYLOAD_TYPE_LOCAL_FRAME, PAYLOAD_LOCAL_FRAME_LEN)) return false;
+
+    memset(out, 0, sizeof(*out));
+    out->kind = data[2];
+    out->tank = data[3];
+    out->node = get_u32(data + 4);
+    out->seq = get_u16(data + 8);
+    switch (out->kind) {
+        case PAYLOAD_LOCAL_LIGHT_STATE:
+            out->light.bright = data[10] ? 1 : 0;
+            out->light.relax = data[11] ? 1 : 0;
+            return true;
+        case PAYLOAD_LOCAL_WATER_LEVEL:
+            out->level.level = data[10] > 100 ? 100 : data[10];
+            return true;
+        default:
+            return false;
+    }
+}
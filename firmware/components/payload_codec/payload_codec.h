@@ -0,0 +1,170 @@
+#ifndef PAYLOAD_CODEC_H
+#define PAYLOAD_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Encoders and decoders for the MQTT payloads, shared by the firmware and
+// the simulator (plain C, no ESP-IDF dependencies).
+//
+// Every message exists in two formats:
+//   JSON    human readable, the original wire format
+//   BINARY  fixed packed little-endian layout behind a 2-byte header:
+//             byte 0  PAYLOAD_MAGIC
+//             byte 1  version (high nibble) | message type (low nibble)
+//
+// Decoders detect the format from the first byte, so a subscriber accepts
+// both while publishers migrate. Binary frames of a newer major version
+// are rejected rather than misparsed; fields appended within a version
+// are ignored by older decoders (frames may be longer than expected).
+
+#define PAYLOAD_MAGIC           0xD1
+#define PAYLOAD_VERSION         1
+
+typedef enum {
+    PAYLOAD_FORMAT_JSON,
+    PAYLOAD_FORMAT_BINARY,
+} payload_format_t;
+
+typedef enum {
+    PAYLOAD_TYPE_LIGHT_STATE = 1,
+    PAYLOAD_TYPE_WATER_LEVEL = 2,
+    PAYLOAD_TYPE_TELEMETRY   = 3,
+    PAYLOAD_TYPE_LOCAL_FRAME = 4,
+} payload_type_t;
+
+typedef struct {
+    uint8_t bright;
+    uint8_t relax;
+} payload_light_state_t;
+
+typedef struct {
+    uint8_t level;              // Percent, 0-100
+} payload_water_level_t;
+
+#define PAYLOAD_TELEMETRY_MAX_TASKS 4
+
+// Frames of the local link, the UDP multicast path next to the broker.
+// Binary only and fixed size: header, kind, tank, sender node (u32),
+// sequence (u16), then two value bytes (bright and relax, or the level
+// and 0).
+typedef enum {
+    PAYLOAD_LOCAL_LIGHT_STATE = 0,
+    PAYLOAD_LOCAL_WATER_LEVEL = 1,
+} payload_local_kind_t;
+
+typedef struct {
+    uint32_t node;              // Sender, unique on the LAN
+    uint16_t seq;               // Per sender; repeats of a frame share it
+    uint8_t kind;               // payload_local_kind_t
+    uint8_t tank;               // Water level: tank index, 0 the main tank
+    payload_light_state_t light;
+    payload_water_level_t level;
+} payload_local_frame_t;
+
+typedef struct {
+    uint32_t uptime_s;
+    uint16_t fps_x10;
+    uint8_t lvgl_idle_pct;
+    uint16_t render_max_ms;
+    uint32_t flush_max_us;
+    uint8_t core_load_pct[2];
+    uint32_t internal_free;
+    uint32_t internal_min_free;
+    uint32_t psram_free;
+    uint32_t psram_min_free;
+    uint16_t touch_i2c_avg_us;
+    uint16_t touch_i2c_max_us;
+    uint16_t touch_i2c_errors;
+    uint16_t mqtt_rtt_ms;
+    uint16_t nvs_writes_per_hour;
+    // Optional trailer: busiest tasks
+    uint8_t task_count;
+    struct {
+        char name[16];
+        uint8_t cpu_pct;
+    } tasks[PAYLOAD_TELEMETRY_MAX_TASKS];
+    // Optional trailer: LVGL memory pools, 0 when absent
+    uint32_t lvgl_sram_used;
+    uint32_t lvgl_sram_peak;
+    uint32_t lvgl_psram_used;
+    uint32_t lvgl_psram_peak;
+    uint8_t lvgl_sram_frag_pct;
+    uint8_t lvgl_psram_frag_pct;
+    uint16_t lvgl_mem_fallbacks;
+    // Optional trailer: WiFi reconnects, 0 when absent
+    uint32_t wifi_reconnect_ms;
+    uint16_t wifi_reconnects;
+    uint16_t wifi_fast_reconnects;
+    // Optional trailer: broker connects, 0 when absent
+    uint32_t mqtt_connect_ms;
+    uint32_t tls_heap_peak;
+    uint16_t tls_handshake_ms;
+    uint16_t mqtt_connects;
+    uint16_t mqtt_sessions_kept;
+    uint16_t tls_resumed;
+    // Optional trailer: co-processor link, 0 when absent
+    uint32_t copro_frames;
+    uint32_t copro_bytes;
+    uint16_t copro_crc_errors;
+    uint16_t copro_framing_errors;
+    uint16_t copro_overruns;
+    uint16_t copro_parse_kbs;
+} payload_telemetry_t;
+
+// Sizes of the binary frames, header included. Telemetry is followed by
+// a task count byte and, per task, cpu_pct, name length and name bytes,
+// then by the LVGL pool block: used and peak of the SRAM and the PSRAM
+// pool (u32 each), their fragmentation (u8 each) and fallbacks (u16),
+// then by the WiFi block: last reconnect time (u32), reconnects and those
+// that went to the cached AP (u16 each), then by the MQTT block: last
+// connect time and mbedTLS heap peak of its handshake (u32 each), the
+// handshake time, connects, those that kept the persistent session and
+// resumed TLS handshakes (u16 each), then by the co-processor block: good
+// frames and bytes received (u32 each), CRC and framing errors, UART
+// overruns and parse speed in KB/s (u16 each).
+#define PAYLOAD_LIGHT_STATE_BIN_LEN 3
+#define PAYLOAD_WATER_LEVEL_BIN_LEN 3
+#define PAYLOAD_TELEMETRY_BIN_LEN   43
+#define PAYLOAD_TELEMETRY_POOLS_LEN 20
+#define PAYLOAD_TELEMETRY_WIFI_LEN  8
+#define PAYLOAD_TELEMETRY_MQTT_LEN  16
+#define PAYLOAD_TELEMETRY_COPRO_LEN 16
+#define PAYLOAD_LOCAL_FRAME_LEN     12
+
+// Encoders return the payload length, or -1 if buf is too small. JSON
+// output is NUL-terminated; binary output is not.
+int payload_encode_light_state(payload_format_t fmt, const payload_light_state_t *in,
+                               uint8_t *buf, size_t size);
+int payload_encode_water_level(payload_format_t fmt, const payload_water_level_t *in,
+                               uint8_t *buf, size_t size);
+int payload_encode_telemetry(payload_format_t fmt, const payload_telemetry_t *in,
+                             uint8_t *buf, size_t size);
+int payload_encode_local_frame(const payload_local_frame_t *in, uint8_t *buf, size_t size);
+
+// Decoders take a payload that need not be NUL-terminated and return
+// false if it is malformed or of another message type. Water level also
+// accepts a bare JSON number ("42"). The JSON telemetry decoder ignores
+// the task list.
+bool payload_decode_light_state(const uint8_t *data, size_t len, payload_light_state_t *out);
+bool payload_decode_water_level(const uint8_t *data, size_t len, payload_water_level_t *out);
+bool payload_decode_telemetry(const uint8_t *data, size_t len, payload_telemetry_t *out);
+bool payload_decode_local_frame(const uint8_t *data, size_t len, payload_local_frame_t *out);
+
+// Format of a received payload
+payload_format_t payload_detect_format(const uint8_t *data, size_t len);
+
+// Microbenchmark of both formats on every message type; prints through
+// printf. clock_us returns a monotonic microsecond timestamp.
+void payload_codec_bench_run(uint32_t iterations, int64_t (*clock_us)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PAYLOAD_CODEC_H
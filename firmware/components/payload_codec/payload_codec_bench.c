@@ -0,0 +1,120 @@
+#include "payload_codec.h"
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+// Microbenchmark: encode + decode of each message type in both formats.
+//
+// On the device it runs at boot with CONFIG_PAYLOAD_CODEC_BENCH. On a host:
+//   cc -O2 -DPAYLOAD_CODEC_BENCH_MAIN payload_codec.c payload_codec_bench.c -o payload_bench
+//   ./payload_bench [iterations]
+
+// Keeps the optimiser from discarding the decoded results
+static volatile uint32_t bench_sink;
+
+static const payload_telemetry_t bench_telemetry = {
+    .uptime_s = 86400, .fps_x10 = 598, .lvgl_idle_pct = 83,
+    .render_max_ms = 14, .flush_max_us = 4210,
+    .core_load_pct = {21, 37},
+    .internal_free = 182344, .internal_min_free = 151200,
+    .psram_free = 6912000, .psram_min_free = 6800000,
+    .touch_i2c_avg_us = 412, .touch_i2c_max_us = 1180, .touch_i2c_errors = 0,
+    .mqtt_rtt_ms = 38, .nvs_writes_per_hour = 12,
+    .task_count = 3,
+    .tasks = {{"lvgl_task", 31}, {"wifi", 6}, {"touch_task", 2}},
+    .lvgl_sram_used = 23104, .lvgl_sram_peak = 30512,
+    .lvgl_psram_used = 49152, .lvgl_psram_peak = 98304,
+    .lvgl_sram_frag_pct = 7, .lvgl_psram_frag_pct = 0, .lvgl_mem_fallbacks = 0,
+    .wifi_reconnect_ms = 412, .wifi_reconnects = 3, .wifi_fast_reconnects = 3,
+    .mqtt_connect_ms = 184, .tls_heap_peak = 41872, .tls_handshake_ms = 152,
+    .mqtt_connects = 4, .mqtt_sessions_kept = 3, .tls_resumed = 3,
+    .copro_frames = 172800, .copro_bytes = 1209600, .copro_crc_errors = 2,
+    .copro_framing_errors = 1, .copro_overruns = 0, .copro_parse_kbs = 4096,
+};
+
+typedef struct {
+    const char *name;
+    int (*round_trip)(payload_format_t fmt, uint8_t *buf, size_t size, uint32_t i);
+} bench_case_t;
+
+static int bench_light(payload_format_t fmt, uint8_t *buf, size_t size, uint32_t i)
+{
+    payload_light_state_t in = { .bright = i & 1, .relax = (i >> 1) & 1 }, out;
+    int len = payload_encode_light_state(fmt, &in, buf, size);
+    if (len < 0 || !payload_decode_light_state(buf, (size_t)len, &out)) return -1;
+    bench_sink += out.bright + out.relax;
+    return len;
+}
+
+static int bench_water(payload_format_t fmt, uint8_t *buf, size_t size, uint32_t i)
+{
+    payload_water_level_t in = { .level = (uint8_t)(i % 101) }, out;
+    int len = payload_encode_water_level(fmt, &in, buf, size);
+    if (len < 0 || !payload_decode_water_level(buf, (size_t)len, &out)) return -1;
+    bench_sink += out.level;
+    return len;
+}
+
+static int bench_telemetry_case(payload_format_t fmt, uint8_t *buf, size_t size, uint32_t i)
+{
+    payload_telemetry_t in = bench_telemetry, out;
+    in.uptime_s += i;
+    int len = payload_encode_telemetry(fmt, &in, buf, size);
+    if (len < 0 || !payload_decode_telemetry(buf, (size_t)len, &out)) return -1;
+    bench_sink += out.uptime_s;
+    return len;
+}
+
+static const bench_case_t bench_cases[] = {
+    {"light_state", bench_light},
+    {"water_level", bench_water},
+    {"telemetry", bench_telemetry_case},
+};
+
+void payload_codec_bench_run(uint32_t iterations, int64_t (*clock_us)(void))
+{
+    uint8_t buf[512];
+
+    printf("payload codec bench, %" PRIu32 " round trips per case\n", iterations);
+    printf("%-12s %-6s %6s %10s\n", "message", "format", "bytes", "ns/trip");
+
+    for (size_t c = 0; c < sizeof(bench_cases) / sizeof(bench_cases[0]); c++) {
+        for (int f = 0; f < 2; f++) {
+            payload_format_t fmt = f ? PAYLOAD_FORMAT_BINARY : PAYLOAD_FORMAT_JSON;
+            int len = 0;
+
+            int64_t start = clock_us();
+            for (uint32_t i = 0; i < iterations; i++) {
+                len = bench_cases[c].round_trip(fmt, buf, sizeof(buf), i);
+                if (len < 0) break;
+            }
+            int64_t elapsed = clock_us() - start;
+
+            if (len < 0) {
+                printf("%-12s %-6s  round trip failed\n", bench_cases[c].name, f ? "binary" : "json");
+                continue;
+            }
+            printf("%-12s %-6s %6d %10" PRId64 "\n", bench_cases[c].name, f ? "binary" : "json",
+                   len, iterations ? elapsed * 1000 / iterations : 0);
+        }
+    }
+}
+
+#ifdef PAYLOAD_CODEC_BENCH_MAIN
+#include <stdlib.h>
+#include <time.h>
+
+static int64_t host_clock_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 1000000;
+    payload_codec_bench_run(iterations, host_clock_us);
+    return 0;
+}
+#endif
@@ -0,0 +1,172 @@
+#include "copro_link.h"
+#include "sdkconfig.h"
+
+#if CONFIG_COPRO_LINK
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "driver/uart.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "backend.h"
+#include <inttypes.h>
+
+static const char *TAG = "COPRO";
+
+// Frames are small and the backend does the work: a short task on core 0,
+// next to the network stack and away from rendering
+#define COPRO_TASK_STACK    3072
+#define COPRO_TASK_PRIO     5
+#define COPRO_TASK_CORE     0
+
+// The ISR empties the 128-byte hardware FIFO into this ring buffer; at
+// 115200 baud it holds about a third of a second of the stream
+#define COPRO_RX_RING_BYTES 4096
+#define COPRO_EVENT_QUEUE   16
+// Interrupt once the FIFO is half full, or after this many idle symbols,
+// so a frame reaches the parser within a few bytes' time of its delimiter
+#define COPRO_RX_FULL_BYTES 64
+#define COPRO_RX_IDLE_SYMS  4
+#define COPRO_READ_CHUNK    128
+
+static QueueHandle_t uart_queue = NULL;
+static copro_parser_t parser;
+static uint32_t gpio_last;
+static bool gpio_known = false;
+
+// Task time spent in copro_parser_feed(), frame routing included
+static uint64_t parse_us = 0;
+static uint64_t parse_bytes = 0;
+
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static copro_link_stats_t stats;
+
+static bool rising(uint32_t now, int pin)
+{
+    return pin >= 0 && (now & (1u << pin)) && !(gpio_last & (1u << pin));
+}
+
+static void on_gpio(uint32_t levels)
+{
+    // The first report is the state at connect, not a press
+    if (gpio_known) {
+        if (rising(levels, CONFIG_COPRO_GPIO_BRIGHT_PIN)) backend_toggle_bright();
+        if (rising(levels, CONFIG_COPRO_GPIO_RELAX_PIN)) backend_toggle_relax();
+    }
+    gpio_last = levels;
+    gpio_known = true;
+}
+
+static void on_frame(uint8_t type, const uint8_t *payload, size_t len, void *ctx)
+{
+    (void)ctx;
+    switch (type) {
+    case COPRO_MSG_TANK_LEVEL:
+        if (len == 2) backend_update_tank_level_from(BACKEND_SOURCE_COPRO, payload[0], payload[1]);
+        break;
+    case COPRO_MSG_GPIO:
+        if (len == 4) {
+            on_gpio((uint32_t)payload[0] | ((uint32_t)payload[1] << 8) | ((uint32_t)payload[2] << 16) |
+                    ((uint32_t)payload[3] << 24));
+        }
+        break;
+    default:
+        // Newer RP2040 firmware: skip what this side does not know yet
+        break;
+    }
+}
+
+static void lost_bytes(void)
+{
+    uart_flush_input(CONFIG_COPRO_UART_NUM);
+    xQueueReset(uart_queue);
+    copro_parser_resync(&parser);
+    portENTER_CRITICAL(&stats_lock);
+    stats.uart_overruns++;
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+static void copro_task(void *arg)
+{
+    uint8_t buf[COPRO_READ_CHUNK];
+    uart_event_t event;
+
+    for (;;) {
+        if (!xQueueReceive(uart_queue, &event, portMAX_DELAY)) continue;
+
+        switch (event.type) {
+        case UART_DATA: {
+            size_t left = event.size;
+            while (left > 0) {
+                int n = uart_read_bytes(CONFIG_COPRO_UART_NUM, buf, left < sizeof(buf) ? left : sizeof(buf), 0);
+                if (n <= 0) break;
+                left -= (size_t)n;
+
+                int64_t start = esp_timer_get_time();
+                copro_parser_feed(&parser, buf, (size_t)n, on_frame, NULL);
+                parse_us += (uint64_t)(esp_timer_get_time() - start);
+                parse_bytes += (uint64_t)n;
+            }
+            uint32_t kbs = parse_us > 0 ? (uint32_t)(parse_bytes * 1000000ULL / 1024 / parse_us) : 0;
+            portENTER_CRITICAL(&stats_lock);
+            stats.proto = parser.stats;
+            stats.parse_kbs = kbs;
+            portEXIT_CRITICAL(&stats_lock);
+            break;
+        }
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+            ESP_LOGW(TAG, "UART overrun, resynchronizing");
+            lost_bytes();
+            break;
+        case UART_FRAME_ERR:
+        case UART_PARITY_ERR:
+            // The CRC rejects the frame the bad byte landed in
+            portENTER_CRITICAL(&stats_lock);
+            stats.line_errors++;
+            portEXIT_CRITICAL(&stats_lock);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void copro_link_start(void)
+{
+    const uart_config_t cfg = {
+        .baud_rate = CONFIG_COPRO_UART_BAUD,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .source_clk = UART_SCLK_DEFAULT,
+    };
+    esp_err_t err = uart_driver_install(CONFIG_COPRO_UART_NUM, COPRO_RX_RING_BYTES, 0, COPRO_EVENT_QUEUE,
+                                        &uart_queue, 0);
+    if (err == ESP_OK) err = uart_param_config(CONFIG_COPRO_UART_NUM, &cfg);
+    if (err == ESP_OK) {
+        err = uart_set_pin(CONFIG_COPRO_UART_NUM, CONFIG_COPRO_UART_TX_GPIO, CONFIG_COPRO_UART_RX_GPIO,
+                           UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    }
+    if (err == ESP_OK) err = uart_set_rx_full_threshold(CONFIG_COPRO_UART_NUM, COPRO_RX_FULL_BYTES);
+    if (err == ESP_OK) err = uart_set_rx_timeout(CONFIG_COPRO_UART_NUM, COPRO_RX_IDLE_SYMS);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "UART%d setup failed: %s", CONFIG_COPRO_UART_NUM, esp_err_to_name(err));
+        return;
+    }
+
+    copro_parser_init(&parser);
+    xTaskCreatePinnedToCore(copro_task, "copro", COPRO_TASK_STACK, NULL, COPRO_TASK_PRIO, NULL, COPRO_TASK_CORE);
+    ESP_LOGI(TAG, "UART%d at %d baud (TX %d, RX %d)", CONFIG_COPRO_UART_NUM, CONFIG_COPRO_UART_BAUD,
+             CONFIG_COPRO_UART_TX_GPIO, CONFIG_COPRO_UART_RX_GPIO);
+}
+
+void copro_link_get_stats(copro_link_stats_t *out)
+{
+    portENTER_CRITICAL(&stats_lock);
+    *out = stats;
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+#endif // CONFIG_COPRO_LINK
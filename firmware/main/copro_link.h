@@ -0,0 +1,25 @@
+#ifndef COPRO_LINK_H
+#define COPRO_LINK_H
+
+#include <stdint.h>
+#include "copro_proto.h"
+
+// Co-processor link: sensor frames from the RP2040 over UART, framed by
+// components/copro_proto and parsed as they arrive. Tank levels go to the
+// backend as BACKEND_SOURCE_COPRO; rising edges of two configurable RP2040
+// inputs toggle the lights.
+
+typedef struct {
+    copro_stats_t proto;        // Bytes, good frames and rejected frames
+    uint32_t uart_overruns;     // UART FIFO or ring buffer was full: bytes lost
+    uint32_t line_errors;       // Framing or parity errors on the line
+    uint32_t parse_kbs;         // Parse and routing speed, KB per second of task time
+} copro_link_stats_t;
+
+// Install the UART driver and start the receive task; call after
+// backend_init()
+void copro_link_start(void);
+
+void copro_link_get_stats(copro_link_stats_t *out);
+
+#endif // COPRO_LINK_H
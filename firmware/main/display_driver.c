@@ -4,12 +4,23 @@
 #include "esp_lcd_panel_rgb.h"
 #include "esp_lcd_panel_ops.h"
 #include "driver/gpio.h"
-#include "driver/i2c.h"
+#include "driver/ledc.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "esp_rom_sys.h"
+#include "freertos/semphr.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "i2c_bus.h"
+#include "lvgl_blend.h"
+#include <inttypes.h>
 #include <string.h>
+#if CONFIG_DISPLAY_MODE_ASYNC_FLUSH
+#include "esp_async_memcpy.h"
+#include "esp_memory_utils.h"
+#include "esp32s3/rom/cache.h"
+#endif
 
 static const char *TAG = "DISPLAY";
 
@@ -40,7 +51,14 @@ static const char *TAG = "DISPLAY";
 #define LCD_GPIO_HSYNC   16
 #define LCD_GPIO_DE      18
 #define LCD_GPIO_PCLK    21
-#define LCD_GPIO_BL      45  // Backlight (active high)
+#define LCD_GPIO_BL      45  // Backlight (active high), LEDC PWM
+
+// Backlight PWM: above the audible range, 10-bit duty from the 80 MHz APB
+#define BL_LEDC_MODE     LEDC_LOW_SPEED_MODE
+#define BL_LEDC_TIMER    LEDC_TIMER_0
+#define BL_LEDC_CHANNEL  LEDC_CHANNEL_0
+#define BL_LEDC_FREQ_HZ  20000
+#define BL_LEDC_RES      LEDC_TIMER_10_BIT
 
 // Display timing parameters for 480x480 ST7701
 // From: sensecap_indicator_board.c timing configuration
@@ -50,7 +68,39 @@ static const char *TAG = "DISPLAY";
 #define VSYNC_BACK_PORCH     50
 #define VSYNC_FRONT_PORCH    10
 #define VSYNC_PULSE_WIDTH     8
-#define LCD_FREQ         (16000000)  // 16MHz
+#define LCD_FREQ         CONFIG_DISPLAY_PCLK_HZ  // 16MHz default, higher with bounce buffers
+
+// Full line length and frame height in pixel clocks, used for the expected frame period
+#define LCD_H_TOTAL      (DISP_HOR_RES + HSYNC_BACK_PORCH + HSYNC_FRONT_PORCH + HSYNC_PULSE_WIDTH)
+#define LCD_V_TOTAL      (DISP_VER_RES + VSYNC_BACK_PORCH + VSYNC_FRONT_PORCH + VSYNC_PULSE_WIDTH)
+
+#if CONFIG_DISPLAY_BOUNCE_BUFFER
+// Bounce buffers live in internal SRAM; the driver requires the frame to be an even multiple of them
+#define LCD_BOUNCE_BUFFER_PX (DISP_HOR_RES * CONFIG_DISPLAY_BOUNCE_BUFFER_LINES)
+_Static_assert(DISP_VER_RES % (2 * CONFIG_DISPLAY_BOUNCE_BUFFER_LINES) == 0,
+               "DISPLAY_BOUNCE_BUFFER_LINES must divide 240");
+#else
+#define LCD_BOUNCE_BUFFER_PX 0
+#endif
+
+// Number of panel framebuffers for the selected refresh mode
+#if CONFIG_DISPLAY_MODE_DIRECT_DOUBLE_FB
+#define LCD_NUM_FBS          2
+#else
+#define LCD_NUM_FBS          1
+#endif
+
+#if CONFIG_DISPLAY_MODE_ASYNC_FLUSH
+#define ASYNC_FLUSH_PX       (DISP_HOR_RES * CONFIG_DISPLAY_ASYNC_FLUSH_LINES)
+// GDMA moves PSRAM in whole 64-byte blocks; a display line is 15 of them,
+// so flushes of whole lines start and end on block boundaries
+#define ASYNC_FLUSH_ALIGN    64
+_Static_assert(DISP_HOR_RES * 2 % ASYNC_FLUSH_ALIGN == 0, "display line must be whole GDMA blocks");
+// One descriptor per 4032 aligned bytes, for the largest flush
+#define ASYNC_FLUSH_BACKLOG  ((ASYNC_FLUSH_PX * 2 + 4031) / 4032 + 1)
+// A copy of a whole buffer takes a few ms; far longer means it was lost
+#define ASYNC_FLUSH_TIMEOUT_MS 100
+#endif
 
 // =============================================================================
 // OFFICIAL SDK REFERENCE: components/bsp/src/boards/lcd_panel_config.c
@@ -75,19 +125,56 @@ static const char *TAG = "DISPLAY";
 #define TCA9535_OUTPUT_PORT_REG         0x02
 #define TCA9535_CONFIGURATION_REG       0x06
 
-// I2C configuration for IO expander
-// From: sensecap_indicator_board.c GPIO_I2C_* definitions
-#define I2C_MASTER_NUM      I2C_NUM_0
-#define I2C_MASTER_SDA_IO   39          // GPIO_I2C_SDA
-#define I2C_MASTER_SCL_IO   40          // GPIO_I2C_SCL
-#define I2C_MASTER_FREQ_HZ  400000
-
 static lv_disp_drv_t disp_drv;
 static lv_disp_draw_buf_t draw_buf;
-static lv_color_t *buf1 = NULL;
 static esp_lcd_panel_handle_t panel_handle = NULL;
 
+// Frame timing, updated from the panel ISRs
+static volatile display_timing_stats_t timing_stats;
+static volatile int64_t last_vsync_us = 0;
+// Completed LVGL frames, counted on the last flush of each refresh
+static volatile uint32_t frame_count = 0;
+// Per-frame render/flush cost, updated from the LVGL task
+static display_render_stats_t render_stats;
+static uint32_t frame_flush_us = 0;
+
+#if CONFIG_DISPLAY_MODE_DIRECT_DOUBLE_FB
+// Panel framebuffers used directly as LVGL draw buffers
+static void *panel_fbs[LCD_NUM_FBS];
+static SemaphoreHandle_t vsync_sem = NULL;
+#elif CONFIG_DISPLAY_MODE_ASYNC_FLUSH
+// LVGL draws into one buffer while GDMA copies the other into the panel
+static lv_color_t *async_bufs[2];
+static void *panel_fb;
+static async_memcpy_t async_mcp;
+static SemaphoreHandle_t copy_done_sem = NULL;
+// One GDMA copy. Its completion gets it as cb_args, so a copy that ends
+// after its timeout still invalidates and times its own lines and cannot
+// end a newer copy. A slot is reused COPY_JOBS copies later.
+typedef struct {
+    lv_color_t *dst;
+    size_t len;
+    int64_t start_us;
+} copy_job_t;
+
+#define COPY_JOBS 4
+static copy_job_t copy_jobs[COPY_JOBS];
+static uint32_t copy_seq;
+// The copy LVGL waits for, NULL once it is done or given up on; LVGL
+// hands over at most one buffer at a time
+static copy_job_t *copy_current;
+// copy_current, copy time finished and time LVGL waited for copies since
+// the last refresh
+static portMUX_TYPE copy_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t frame_copy_us;
+static uint32_t frame_wait_us;
+static uint32_t cpu_copies;
+#else
+static lv_color_t *buf1 = NULL;
+#endif
+
 // IO Expander state
+static i2c_bus_device_handle_t io_expander = NULL;
 static uint16_t io_expander_output = 0;
 static uint16_t io_expander_config = 0xFFFF;  // All inputs by default
 static bool io_expander_initialized = false;
@@ -99,46 +186,22 @@ static bool io_expander_initialized = false;
 
 static esp_err_t tca9535_write_reg(uint8_t reg, uint16_t data)
 {
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (TCA9535_I2C_ADDR << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(cmd, reg, true);
-    i2c_master_write_byte(cmd, data & 0xFF, true);  // Low byte
-    i2c_master_write_byte(cmd, (data >> 8) & 0xFF, true);  // High byte
-    i2c_master_stop(cmd);
-    esp_err_t ret = i2c_master_cmd_begin(I2C_MASTER_NUM, cmd, pdMS_TO_TICKS(100));
-    i2c_cmd_link_delete(cmd);
-    return ret;
+    uint8_t buf[2] = { data & 0xFF, (data >> 8) & 0xFF };  // Low byte first
+    return i2c_bus_write(io_expander, &reg, 1, buf, sizeof(buf));
 }
 
 static esp_err_t tca9535_init(void)
 {
     ESP_LOGI(TAG, "Initializing TCA9535 IO expander at 0x%02X", TCA9535_I2C_ADDR);
     
-    // Initialize I2C master
-    i2c_config_t conf = {
-        .mode = I2C_MODE_MASTER,
-        .sda_io_num = I2C_MASTER_SDA_IO,
-        .scl_io_num = I2C_MASTER_SCL_IO,
-        .sda_pullup_en = GPIO_PULLUP_ENABLE,
-        .scl_pullup_en = GPIO_PULLUP_ENABLE,
-        .master.clk_speed = I2C_MASTER_FREQ_HZ,
-    };
-    ESP_ERROR_CHECK(i2c_param_config(I2C_MASTER_NUM, &conf));
-    ESP_ERROR_CHECK(i2c_driver_install(I2C_MASTER_NUM, conf.mode, 0, 0, 0));
+    // The bus is shared with the touch controller
+    ESP_ERROR_CHECK(i2c_bus_init());
+    ESP_ERROR_CHECK(i2c_bus_add_device("tca9535", TCA9535_I2C_ADDR, &io_expander));
     
     // Test communication by reading input port
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (TCA9535_I2C_ADDR << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(cmd, TCA9535_INPUT_PORT_REG, true);
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (TCA9535_I2C_ADDR << 1) | I2C_MASTER_READ, true);
+    uint8_t reg = TCA9535_INPUT_PORT_REG;
     uint8_t data[2];
-    i2c_master_read(cmd, data, 2, I2C_MASTER_LAST_NACK);
-    i2c_master_stop(cmd);
-    esp_err_t ret = i2c_master_cmd_begin(I2C_MASTER_NUM, cmd, pdMS_TO_TICKS(100));
-    i2c_cmd_link_delete(cmd);
+    esp_err_t ret = i2c_bus_read(io_expander, &reg, 1, data, sizeof(data));
     
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "TCA9535 not found at 0x%02X", TCA9535_I2C_ADDR);
@@ -163,11 +226,11 @@ static void tca9535_set_level(uint8_t pin, bool level)
 {
     if (!io_expander_initialized) return;
     
-    if (level) {
-        io_expander_output |= BIT(pin);
-    } else {
-        io_expander_output &= ~BIT(pin);
-    }
+    uint16_t output = level ? (io_expander_output | BIT(pin)) : (io_expander_output & ~BIT(pin));
+    // The output register latches, so an unchanged level needs no bus traffic
+    if (output == io_expander_output) return;
+    
+    io_expander_output = output;
     tca9535_write_reg(TCA9535_OUTPUT_PORT_REG, io_expander_output);
 }
 
@@ -181,7 +244,6 @@ static void tca9535_set_level(uint8_t pin, bool level)
 #define CLK(n)  gpio_set_level(SPI_GPIO_CLK, n)
 #define MOSI(n) gpio_set_level(SPI_GPIO_MOSI, n)
 #define Delay(t) vTaskDelay(pdMS_TO_TICKS(t))
-#define udelay(_t) esp_rom_delay_us(_t)
 
 static void spi_init_gpio(void)
 {
@@ -197,67 +259,31 @@ static void spi_init_gpio(void)
     MOSI(1);
 }
 
+// 9-bit SPI word: bit 8 selects data (1) or command (0), then 8 bits MSB
+// first. The panel samples on the rising edge; each gpio_set_level() call
+// already takes longer than the ST7701S minimum SCL high/low time, so the
+// bits are clocked out back to back without extra delays.
 static void SPI_SendData(unsigned short i)
 {
-    // 9-bit SPI: 1 bit for data/command, 8 bits for data
-    // Reference: lcd_panel_config.c SPI_SendData function
     for (int n = 0; n < 9; n++) {
-        if (i & 0x0100) {
-            MOSI(1);
-        } else {
-            MOSI(0);
-        }
+        MOSI((i & 0x0100) ? 1 : 0);
         i = i << 1;
         CLK(1);
-        udelay(10);
         CLK(0);
-        udelay(10);
     }
 }
 
-static void SPI_WriteComm(unsigned short c)
+// Send a command and its parameters with CS held low for the whole group,
+// so the expander is written twice per command instead of per byte
+static void SPI_WriteGroup(uint8_t cmd, const uint8_t *data, size_t len)
 {
-    // Send command (bit 8 = 0 for command)
-    CS(0);
-    udelay(10);
-    CLK(0);
-    udelay(10);
-    
-    SPI_SendData(((c >> 8) & 0x00FF) | 0x2000);  // High byte with command bit
-    
-    CLK(1);
-    udelay(10);
     CLK(0);
-    
-    CS(1);
-    udelay(10);
-    CS(0);
-    udelay(10);
-    
-    SPI_SendData((c & 0x00FF));  // Low byte
-    CS(1);
-    udelay(10);
-}
-
-static void SPI_WriteData(unsigned short d)
-{
-    // Send data (bit 8 = 1 for data)
     CS(0);
-    udelay(10);
-    CLK(0);
-    udelay(10);
-    
-    d &= 0x00FF;
-    d |= 0x0100;  // Set data bit
-    SPI_SendData(d);
-    
-    CLK(1);
-    udelay(10);
-    CLK(0);
-    udelay(10);
-    
+    SPI_SendData(cmd);
+    for (size_t i = 0; i < len; i++) {
+        SPI_SendData(0x0100 | data[i]);
+    }
     CS(1);
-    udelay(10);
 }
 
 // =============================================================================
@@ -265,290 +291,163 @@ static void SPI_WriteData(unsigned short d)
 // Reference: components/bsp/src/boards/lcd_panel_config.c lcd_panel_st7701s_init()
 // =============================================================================
 
-static void st7701s_init_sequence(void)
-{
-    ESP_LOGI(TAG, "Starting ST7701S initialization sequence");
-    
-    // Reset sequence
-    RST(0);
-    Delay(10);
-    RST(1);
-    
+// One command with its parameters, sent as a single CS-low group
+typedef struct {
+    uint8_t cmd;
+    const uint8_t *data;
+    uint8_t data_len;
+    uint8_t delay_ms;   // Wait after the group
+} st7701s_init_cmd_t;
+
+static const st7701s_init_cmd_t st7701s_init_cmds[] = {
     // Command 2 BK0 (PAGE1)
-    SPI_WriteComm(0xFF);
-    SPI_WriteData(0x77);
-    SPI_WriteData(0x01);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x10);
+    {0xFF, (const uint8_t[]){0x77, 0x01, 0x00, 0x00, 0x10}, 5, 0},
 
     // Display resolution
-    SPI_WriteComm(0xC0);
-    SPI_WriteData(0x3B);  // 480*480
-    SPI_WriteData(0x00);
-
-    SPI_WriteComm(0xC1);
-    SPI_WriteData(0x0D);
-    SPI_WriteData(0x02);
-
-    SPI_WriteComm(0xC2);
-    SPI_WriteData(0x31);
-    SPI_WriteData(0x05);
-
-    SPI_WriteComm(0xC7);
-    SPI_WriteData(0x04);
-
-    SPI_WriteComm(0xCD);
-    SPI_WriteData(0x08);
+    {0xC0, (const uint8_t[]){0x3B, 0x00}, 2, 0},
+    {0xC1, (const uint8_t[]){0x0D, 0x02}, 2, 0},
+    {0xC2, (const uint8_t[]){0x31, 0x05}, 2, 0},
+    {0xC7, (const uint8_t[]){0x04}, 1, 0},
+    {0xCD, (const uint8_t[]){0x08}, 1, 0},
 
     // Gamma settings
-    SPI_WriteComm(0xB0);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x11);
-    SPI_WriteData(0x18);
-    SPI_WriteData(0x0E);
-    SPI_WriteData(0x11);
-    SPI_WriteData(0x06);
-    SPI_WriteData(0x07);
-    SPI_WriteData(0x08);
-    SPI_WriteData(0x07);
-    SPI_WriteData(0x22);
-    SPI_WriteData(0x04);
-    SPI_WriteData(0x12);
-    SPI_WriteData(0x0F);
-    SPI_WriteData(0xAA);
-    SPI_WriteData(0x31);
-    SPI_WriteData(0x18);
-
-    SPI_WriteComm(0xB1);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x11);
-    SPI_WriteData(0x19);
-    SPI_WriteData(0x0E);
-    SPI_WriteData(0x12);
-    SPI_WriteData(0x07);
-    SPI_WriteData(0x08);
-    SPI_WriteData(0x08);
-    SPI_WriteData(0x08);
-    SPI_WriteData(0x22);
-    SPI_WriteData(0x04);
-    SPI_WriteData(0x11);
-    SPI_WriteData(0x11);
-    SPI_WriteData(0xA9);
-    SPI_WriteData(0x32);
-    SPI_WriteData(0x18);
+    {0xB0, (const uint8_t[]){0x00, 0x11, 0x18, 0x0E, 0x11, 0x06, 0x07, 0x08,
+                             0x07, 0x22, 0x04, 0x12, 0x0F, 0xAA, 0x31, 0x18}, 16, 0},
+    {0xB1, (const uint8_t[]){0x00, 0x11, 0x19, 0x0E, 0x12, 0x07, 0x08, 0x08,
+                             0x08, 0x22, 0x04, 0x11, 0x11, 0xA9, 0x32, 0x18}, 16, 0},
 
     // Command 2 BK1 (PAGE2)
-    SPI_WriteComm(0xFF);
-    SPI_WriteData(0x77);
-    SPI_WriteData(0x01);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x11);
-
-    SPI_WriteComm(0xB0);
-    SPI_WriteData(0x60);
-
-    SPI_WriteComm(0xB1);
-    SPI_WriteData(0x32);
-
-    SPI_WriteComm(0xB2);
-    SPI_WriteData(0x07);
-
-    SPI_WriteComm(0xB3);
-    SPI_WriteData(0x80);
-
-    SPI_WriteComm(0xB5);
-    SPI_WriteData(0x49);
-
-    SPI_WriteComm(0xB7);
-    SPI_WriteData(0x85);
-
-    SPI_WriteComm(0xB8);
-    SPI_WriteData(0x21);
-
-    SPI_WriteComm(0xC1);
-    SPI_WriteData(0x78);
-
-    SPI_WriteComm(0xC2);
-    SPI_WriteData(0x78);
-
-    Delay(20);
+    {0xFF, (const uint8_t[]){0x77, 0x01, 0x00, 0x00, 0x11}, 5, 0},
+    {0xB0, (const uint8_t[]){0x60}, 1, 0},
+    {0xB1, (const uint8_t[]){0x32}, 1, 0},
+    {0xB2, (const uint8_t[]){0x07}, 1, 0},
+    {0xB3, (const uint8_t[]){0x80}, 1, 0},
+    {0xB5, (const uint8_t[]){0x49}, 1, 0},
+    {0xB7, (const uint8_t[]){0x85}, 1, 0},
+    {0xB8, (const uint8_t[]){0x21}, 1, 0},
+    {0xC1, (const uint8_t[]){0x78}, 1, 0},
+    {0xC2, (const uint8_t[]){0x78}, 1, 20},
 
     // VCOM settings
-    SPI_WriteComm(0xE0);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x1B);
-    SPI_WriteData(0x02);
-
-    SPI_WriteComm(0xE1);
-    SPI_WriteData(0x08);
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x07);
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x44);
-    SPI_WriteData(0x44);
-
-    SPI_WriteComm(0xE2);
-    SPI_WriteData(0x11);
-    SPI_WriteData(0x11);
-    SPI_WriteData(0x44);
-    SPI_WriteData(0x44);
-    SPI_WriteData(0xED);
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0xEC);
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-
-    SPI_WriteComm(0xE3);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x11);
-    SPI_WriteData(0x11);
-
-    SPI_WriteComm(0xE4);
-    SPI_WriteData(0x44);
-    SPI_WriteData(0x44);
-
-    SPI_WriteComm(0xE5);
-    SPI_WriteData(0x0A);
-    SPI_WriteData(0xE9);
-    SPI_WriteData(0xD8);
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x0C);
-    SPI_WriteData(0xEB);
-    SPI_WriteData(0xD8);
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x0E);
-    SPI_WriteData(0xED);
-    SPI_WriteData(0xD8);
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x10);
-    SPI_WriteData(0xEF);
-    SPI_WriteData(0xD8);
-    SPI_WriteData(0xA0);
-
-    SPI_WriteComm(0xE6);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x11);
-    SPI_WriteData(0x11);
-
-    SPI_WriteComm(0xE7);
-    SPI_WriteData(0x44);
-    SPI_WriteData(0x44);
-
-    SPI_WriteComm(0xE8);
-    SPI_WriteData(0x09);
-    SPI_WriteData(0xE8);
-    SPI_WriteData(0xD8);
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x0B);
-    SPI_WriteData(0xEA);
-    SPI_WriteData(0xD8);
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x0D);
-    SPI_WriteData(0xEC);
-    SPI_WriteData(0xD8);
-    SPI_WriteData(0xA0);
-    SPI_WriteData(0x0F);
-    SPI_WriteData(0xEE);
-    SPI_WriteData(0xD8);
-    SPI_WriteData(0xA0);
-
-    SPI_WriteComm(0xEB);
-    SPI_WriteData(0x02);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0xE4);
-    SPI_WriteData(0xE4);
-    SPI_WriteData(0x88);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x40);
-
-    SPI_WriteComm(0xEC);
-    SPI_WriteData(0x3C);
-    SPI_WriteData(0x00);
-
-    SPI_WriteComm(0xED);
-    SPI_WriteData(0xAB);
-    SPI_WriteData(0x89);
-    SPI_WriteData(0x76);
-    SPI_WriteData(0x54);
-    SPI_WriteData(0x02);
-    SPI_WriteData(0xFF);
-    SPI_WriteData(0xFF);
-    SPI_WriteData(0xFF);
-    SPI_WriteData(0xFF);
-    SPI_WriteData(0xFF);
-    SPI_WriteData(0xFF);
-    SPI_WriteData(0x20);
-    SPI_WriteData(0x45);
-    SPI_WriteData(0x67);
-    SPI_WriteData(0x98);
-    SPI_WriteData(0xBA);
+    {0xE0, (const uint8_t[]){0x00, 0x1B, 0x02}, 3, 0},
+    {0xE1, (const uint8_t[]){0x08, 0xA0, 0x00, 0x00, 0x07, 0xA0, 0x00, 0x00,
+                             0x00, 0x44, 0x44}, 11, 0},
+    {0xE2, (const uint8_t[]){0x11, 0x11, 0x44, 0x44, 0xED, 0xA0, 0x00, 0x00,
+                             0xEC, 0xA0, 0x00, 0x00}, 12, 0},
+    {0xE3, (const uint8_t[]){0x00, 0x00, 0x11, 0x11}, 4, 0},
+    {0xE4, (const uint8_t[]){0x44, 0x44}, 2, 0},
+    {0xE5, (const uint8_t[]){0x0A, 0xE9, 0xD8, 0xA0, 0x0C, 0xEB, 0xD8, 0xA0,
+                             0x0E, 0xED, 0xD8, 0xA0, 0x10, 0xEF, 0xD8, 0xA0}, 16, 0},
+    {0xE6, (const uint8_t[]){0x00, 0x00, 0x11, 0x11}, 4, 0},
+    {0xE7, (const uint8_t[]){0x44, 0x44}, 2, 0},
+    {0xE8, (const uint8_t[]){0x09, 0xE8, 0xD8, 0xA0, 0x0B, 0xEA, 0xD8, 0xA0,
+                             0x0D, 0xEC, 0xD8, 0xA0, 0x0F, 0xEE, 0xD8, 0xA0}, 16, 0},
+    {0xEB, (const uint8_t[]){0x02, 0x00, 0xE4, 0xE4, 0x88, 0x00, 0x40}, 7, 0},
+    {0xEC, (const uint8_t[]){0x3C, 0x00}, 2, 0},
+    {0xED, (const uint8_t[]){0xAB, 0x89, 0x76, 0x54, 0x02, 0xFF, 0xFF, 0xFF,
+                             0xFF, 0xFF, 0xFF, 0x20, 0x45, 0x67, 0x98, 0xBA}, 16, 0},
 
     // Memory access control
-    SPI_WriteComm(0x36);
-    SPI_WriteData(0x10);
+    {0x36, (const uint8_t[]){0x10}, 1, 0},
 
     // Command 2 BK3 (PAGE3)
-    SPI_WriteComm(0xFF);
-    SPI_WriteData(0x77);
-    SPI_WriteData(0x01);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x13);
-
-    SPI_WriteComm(0xE5);
-    SPI_WriteData(0xE4);
+    {0xFF, (const uint8_t[]){0x77, 0x01, 0x00, 0x00, 0x13}, 5, 0},
+    {0xE5, (const uint8_t[]){0xE4}, 1, 0},
 
     // Return to CMD1
-    SPI_WriteComm(0xFF);
-    SPI_WriteData(0x77);
-    SPI_WriteData(0x01);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
-    SPI_WriteData(0x00);
+    {0xFF, (const uint8_t[]){0x77, 0x01, 0x00, 0x00, 0x00}, 5, 0},
 
-    // Interface pixel format: RGB666
-    SPI_WriteComm(0x3A);
-    SPI_WriteData(0x60);  // 0x70 RGB888, 0x60 RGB666, 0x50 RGB565
+    // Interface pixel format: RGB666 (0x70 RGB888, 0x60 RGB666, 0x50 RGB565)
+    {0x3A, (const uint8_t[]){0x60}, 1, 0},
 
     // Display Inversion On
-    SPI_WriteComm(0x21);
+    {0x21, NULL, 0, 0},
 
-    // Sleep Out
-    SPI_WriteComm(0x11);
-    Delay(120);
+    // Sleep Out, then the datasheet-mandated 120 ms before further commands
+    {0x11, NULL, 0, 120},
 
-    // Display On
-    SPI_WriteComm(0x29);
-    Delay(120);
+    // Display On; the RGB panel is started right after, no settle time needed
+    {0x29, NULL, 0, 0},
+};
+
+static void st7701s_init_sequence(void)
+{
+    ESP_LOGI(TAG, "Starting ST7701S initialization sequence");
+    int64_t start_us = esp_timer_get_time();
+    
+    // Reset sequence; the panel accepts commands 5 ms after reset release
+    RST(0);
+    Delay(10);
+    RST(1);
+    Delay(5);
+    
+    for (size_t i = 0; i < sizeof(st7701s_init_cmds) / sizeof(st7701s_init_cmds[0]); i++) {
+        const st7701s_init_cmd_t *c = &st7701s_init_cmds[i];
+        SPI_WriteGroup(c->cmd, c->data, c->data_len);
+        if (c->delay_ms) {
+            Delay(c->delay_ms);
+        }
+    }
 
     // Set pins high
-    CS(1);
     CLK(1);
     MOSI(1);
     
-    ESP_LOGI(TAG, "ST7701S initialization complete");
+    ESP_LOGI(TAG, "ST7701S initialization complete in %" PRId64 " ms",
+             (esp_timer_get_time() - start_us) / 1000);
 }
 
 // =============================================================================
 // RGB DISPLAY INTERFACE
 // =============================================================================
 
+static bool IRAM_ATTR display_on_vsync(esp_lcd_panel_handle_t panel,
+                                       const esp_lcd_rgb_panel_event_data_t *edata,
+                                       void *user_ctx)
+{
+    int64_t now = esp_timer_get_time();
+    if (last_vsync_us != 0) {
+        uint32_t period = (uint32_t)(now - last_vsync_us);
+        if (period < timing_stats.min_frame_us) timing_stats.min_frame_us = period;
+        if (period > timing_stats.max_frame_us) timing_stats.max_frame_us = period;
+    }
+    last_vsync_us = now;
+    timing_stats.vsync_count++;
+
+#if CONFIG_DISPLAY_MODE_DIRECT_DOUBLE_FB && !CONFIG_DISPLAY_BOUNCE_BUFFER
+    BaseType_t need_yield = pdFALSE;
+    xSemaphoreGiveFromISR(vsync_sem, &need_yield);
+    return need_yield == pdTRUE;
+#else
+    return false;
+#endif
+}
+
+#if CONFIG_DISPLAY_BOUNCE_BUFFER
+// With bounce buffers the framebuffer is consumed by the bounce copy, not by
+// the DMA, so a frame is only done with its buffer once the last bounce
+// buffer has been refilled
+static bool IRAM_ATTR display_on_bounce_frame_finish(esp_lcd_panel_handle_t panel,
+                                                     const esp_lcd_rgb_panel_event_data_t *edata,
+                                                     void *user_ctx)
+{
+    timing_stats.bounce_frame_count++;
+
+#if CONFIG_DISPLAY_MODE_DIRECT_DOUBLE_FB
+    BaseType_t need_yield = pdFALSE;
+    xSemaphoreGiveFromISR(vsync_sem, &need_yield);
+    return need_yield == pdTRUE;
+#else
+    return false;
+#endif
+}
+#endif
+
 void display_init(void)
 {
     ESP_LOGI(TAG, "Initializing SenseCAP Indicator D1 Display");
     ESP_LOGI(TAG, "Reference: Seeed Studio SDK - sensecap_indicator_esp32");
+    int64_t init_start_us = esp_timer_get_time();
     
     // Step 1: Initialize IO Expander (TCA9535)
     // Reference: components/i2c_devices/io_expander/tca9535.c
@@ -558,13 +457,23 @@ void display_init(void)
     // Reference: lcd_panel_config.c init_gpios()
     spi_init_gpio();
     
-    // Step 3: Configure backlight
-    gpio_config_t bk_gpio_config = {
-        .mode = GPIO_MODE_OUTPUT,
-        .pin_bit_mask = 1ULL << LCD_GPIO_BL
+    // Step 3: Configure backlight, off until the panel is running
+    ledc_timer_config_t bl_timer_config = {
+        .speed_mode = BL_LEDC_MODE,
+        .timer_num = BL_LEDC_TIMER,
+        .duty_resolution = BL_LEDC_RES,
+        .freq_hz = BL_LEDC_FREQ_HZ,
+        .clk_cfg = LEDC_AUTO_CLK,
+    };
+    ESP_ERROR_CHECK(ledc_timer_config(&bl_timer_config));
+    ledc_channel_config_t bl_channel_config = {
+        .gpio_num = LCD_GPIO_BL,
+        .speed_mode = BL_LEDC_MODE,
+        .channel = BL_LEDC_CHANNEL,
+        .timer_sel = BL_LEDC_TIMER,
+        .duty = 0,
     };
-    ESP_ERROR_CHECK(gpio_config(&bk_gpio_config));
-    gpio_set_level(LCD_GPIO_BL, 0);  // Off initially
+    ESP_ERROR_CHECK(ledc_channel_config(&bl_channel_config));
     
     // Step 4: Initialize ST7701S via SPI
     // Reference: lcd_panel_config.c lcd_panel_st7701s_init()
@@ -574,6 +483,10 @@ void display_init(void)
     // Reference: bsp_lcd.c bsp_lcd_init() with RGB interface
     esp_lcd_rgb_panel_config_t panel_config = {
         .clk_src = LCD_CLK_SRC_PLL160M,
+#if CONFIG_DISPLAY_MODE_ASYNC_FLUSH
+        // The framebuffer is a GDMA destination
+        .psram_trans_align = ASYNC_FLUSH_ALIGN,
+#endif
         .data_width = 16,
         .disp_gpio_num = GPIO_NUM_NC,
         .pclk_gpio_num = LCD_GPIO_PCLK,
@@ -598,8 +511,9 @@ void display_init(void)
             .vsync_pulse_width = VSYNC_PULSE_WIDTH,
             .flags.pclk_active_neg = false,
         },
+        .bounce_buffer_size_px = LCD_BOUNCE_BUFFER_PX,
         .flags.fb_in_psram = 1,
-        .num_fbs = 1,
+        .num_fbs = LCD_NUM_FBS,
     };
     
     ESP_LOGI(TAG, "Creating RGB panel: %dx%d @ %d Hz", DISP_HOR_RES, DISP_VER_RES, LCD_FREQ);
@@ -607,28 +521,301 @@ void display_init(void)
     ESP_ERROR_CHECK(esp_lcd_panel_reset(panel_handle));
     ESP_ERROR_CHECK(esp_lcd_panel_init(panel_handle));
     ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(panel_handle, true));
+
+#if CONFIG_DISPLAY_MODE_DIRECT_DOUBLE_FB
+    // Fetch both framebuffers and get notified when the panel starts
+    // scanning out a new frame, so a swapped buffer is known to be live
+    ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(panel_handle, LCD_NUM_FBS,
+                                                       &panel_fbs[0], &panel_fbs[1]));
+    vsync_sem = xSemaphoreCreateBinary();
+    assert(vsync_sem);
+    ESP_LOGI(TAG, "Double framebuffer mode: fb0=%p fb1=%p", panel_fbs[0], panel_fbs[1]);
+#elif CONFIG_DISPLAY_MODE_ASYNC_FLUSH
+    ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(panel_handle, 1, &panel_fb));
+    copy_done_sem = xSemaphoreCreateBinary();
+    assert(copy_done_sem);
+    async_memcpy_config_t mcp_config = ASYNC_MEMCPY_DEFAULT_CONFIG();
+    mcp_config.backlog = ASYNC_FLUSH_BACKLOG;
+    mcp_config.psram_trans_align = ASYNC_FLUSH_ALIGN;
+    if (esp_async_memcpy_install(&mcp_config, &async_mcp) != ESP_OK) {
+        ESP_LOGW(TAG, "No GDMA channel for async flush, copying on the CPU");
+        async_mcp = NULL;
+    }
+#endif
+
+    display_reset_timing_stats();
+    esp_lcd_rgb_panel_event_callbacks_t cbs = {
+        .on_vsync = display_on_vsync,
+#if CONFIG_DISPLAY_BOUNCE_BUFFER
+        .on_bounce_frame_finish = display_on_bounce_frame_finish,
+#endif
+    };
+    ESP_ERROR_CHECK(esp_lcd_rgb_panel_register_event_callbacks(panel_handle, &cbs, NULL));
+#if CONFIG_DISPLAY_BOUNCE_BUFFER
+    ESP_LOGI(TAG, "Bounce buffers: 2 x %d lines in internal SRAM", CONFIG_DISPLAY_BOUNCE_BUFFER_LINES);
+#endif
     
     // Turn on backlight
-    gpio_set_level(LCD_GPIO_BL, 1);
+    display_set_backlight(100);
     
-    ESP_LOGI(TAG, "Display initialization complete");
+    ESP_LOGI(TAG, "Display initialization complete in %" PRId64 " ms (boot +%" PRId64 " ms)",
+             (esp_timer_get_time() - init_start_us) / 1000, esp_timer_get_time() / 1000);
+}
+
+#if CONFIG_DISPLAY_MODE_DIRECT_DOUBLE_FB
+// Copy the areas LVGL just redrew from the new front buffer into the back
+// buffer, so both framebuffers hold the same picture after the swap
+static void display_sync_dirty_areas(lv_disp_t *disp, const lv_color_t *front)
+{
+    lv_color_t *back = (front == panel_fbs[0]) ? panel_fbs[1] : panel_fbs[0];
+
+    for (uint16_t i = 0; i < disp->inv_p; i++) {
+        if (disp->inv_area_joined[i]) continue;
+
+        const lv_area_t *a = &disp->inv_areas[i];
+        size_t offset = (size_t)a->y1 * DISP_HOR_RES + a->x1;
+        size_t line_bytes = lv_area_get_width(a) * sizeof(lv_color_t);
+
+        for (lv_coord_t y = a->y1; y <= a->y2; y++) {
+            memcpy(back + offset, front + offset, line_bytes);
+            offset += DISP_HOR_RES;
+        }
+    }
+}
+#endif
+
+#if CONFIG_DISPLAY_MODE_ASYNC_FLUSH
+// GDMA completion, in interrupt context: the buffer is LVGL's again
+static bool display_on_copy_done(async_memcpy_t mcp, async_memcpy_event_t *event, void *cb_args)
+{
+    copy_job_t *job = cb_args;
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - job->start_us);
+#if CONFIG_DISPLAY_BOUNCE_BUFFER
+    // The bounce copy reads the framebuffer through the cache, which may
+    // still hold the lines GDMA just replaced
+    Cache_Invalidate_Addr((uint32_t)job->dst, job->len);
+#endif
+    portENTER_CRITICAL_ISR(&copy_stats_lock);
+    frame_copy_us += elapsed;
+    bool current = job == copy_current;
+    if (current) copy_current = NULL;
+    portEXIT_CRITICAL_ISR(&copy_stats_lock);
+
+    // A copy display_wait_cb() gave up on: LVGL has moved on
+    if (!current) return false;
+
+    lv_disp_flush_ready(&disp_drv);
+    BaseType_t need_yield = pdFALSE;
+    xSemaphoreGiveFromISR(copy_done_sem, &need_yield);
+    return need_yield == pdTRUE;
+}
+
+// Queue the copy of one flushed area; false if GDMA cannot take it
+static bool display_copy_start(const lv_area_t *area, lv_color_t *color_map)
+{
+    if (async_mcp == NULL) return false;
+
+    // display_rounder_cb() makes every area whole lines: one contiguous run
+    copy_job_t *job = &copy_jobs[copy_seq++ % COPY_JOBS];
+    job->dst = (lv_color_t *)panel_fb + (size_t)area->y1 * DISP_HOR_RES;
+    job->len = (size_t)lv_area_get_height(area) * DISP_HOR_RES * sizeof(lv_color_t);
+    if (esp_ptr_external_ram(color_map)) {
+        // GDMA reads PSRAM behind the cache
+        Cache_WriteBack_Addr((uint32_t)color_map, job->len);
+    }
+    job->start_us = esp_timer_get_time();
+
+    // Current before the start: the completion may come first
+    portENTER_CRITICAL(&copy_stats_lock);
+    copy_current = job;
+    portEXIT_CRITICAL(&copy_stats_lock);
+    if (esp_async_memcpy(async_mcp, job->dst, color_map, job->len, display_on_copy_done, job) == ESP_OK) {
+        return true;
+    }
+    portENTER_CRITICAL(&copy_stats_lock);
+    copy_current = NULL;
+    portEXIT_CRITICAL(&copy_stats_lock);
+    return false;
+}
+
+static void display_rounder_cb(lv_disp_drv_t *drv, lv_area_t *area)
+{
+    area->x1 = 0;
+    area->x2 = DISP_HOR_RES - 1;
+}
+
+// LVGL calls this in a loop while the buffer it needs is still being copied
+static void display_wait_cb(lv_disp_drv_t *drv)
+{
+    int64_t start = esp_timer_get_time();
+    if (xSemaphoreTake(copy_done_sem, pdMS_TO_TICKS(ASYNC_FLUSH_TIMEOUT_MS)) != pdTRUE &&
+        drv->draw_buf->flushing) {
+        // A lost completion costs one garbled band, not a hung UI. The
+        // copy is given up under the lock, so its completion, should it
+        // still come, does not end the next one.
+        portENTER_CRITICAL(&copy_stats_lock);
+        bool abandoned = copy_current != NULL;
+        copy_current = NULL;
+        portEXIT_CRITICAL(&copy_stats_lock);
+        if (abandoned) {
+            ESP_LOGW(TAG, "Async flush copy timed out");
+            lv_disp_flush_ready(drv);
+        }
+    }
+    frame_wait_us += (uint32_t)(esp_timer_get_time() - start);
 }
+#endif
 
 void display_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
 {
+    int64_t flush_start = esp_timer_get_time();
+#if CONFIG_DISPLAY_MODE_DIRECT_DOUBLE_FB
+    // In direct mode LVGL renders straight into a panel framebuffer, so only
+    // the last area of a frame has to do anything: swap and sync
+    if (!lv_disp_flush_is_last(drv)) {
+        frame_flush_us += (uint32_t)(esp_timer_get_time() - flush_start);
+        lv_disp_flush_ready(drv);
+        return;
+    }
+
+    // Passing one of the panel's own framebuffers makes the driver switch
+    // to it at the next frame instead of copying
+    xSemaphoreTake(vsync_sem, 0);
+    esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, DISP_HOR_RES, DISP_VER_RES, color_map);
+    xSemaphoreTake(vsync_sem, portMAX_DELAY);
+
+    display_sync_dirty_areas(_lv_refr_get_disp_refreshing(), color_map);
+    frame_count++;
+#elif CONFIG_DISPLAY_MODE_ASYNC_FLUSH
+    if (lv_disp_flush_is_last(drv)) {
+        frame_count++;
+    }
+    if (display_copy_start(area, color_map)) {
+        // The copy's completion calls lv_disp_flush_ready()
+        frame_flush_us += (uint32_t)(esp_timer_get_time() - flush_start);
+        return;
+    }
+    esp_lcd_panel_draw_bitmap(panel_handle, 0, area->y1, DISP_HOR_RES, area->y2 + 1, color_map);
+    cpu_copies++;
+#else
     esp_lcd_panel_draw_bitmap(panel_handle, 
                               area->x1, area->y1, 
                               area->x2 + 1, area->y2 + 1, 
                               color_map);
+    if (lv_disp_flush_is_last(drv)) {
+        frame_count++;
+    }
+#endif
+    frame_flush_us += (uint32_t)(esp_timer_get_time() - flush_start);
     lv_disp_flush_ready(drv);
 }
 
+// Called by LVGL after each refresh with its total duration (render + flush)
+static void display_monitor_cb(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px)
+{
+    uint32_t flush_ms = frame_flush_us / 1000;
+#if CONFIG_DISPLAY_MODE_ASYNC_FLUSH
+    portENTER_CRITICAL(&copy_stats_lock);
+    uint32_t copy_us = frame_copy_us;
+    frame_copy_us = 0;
+    portEXIT_CRITICAL(&copy_stats_lock);
+
+    // Waiting for a copy is neither drawing nor flushing
+    flush_ms = (frame_flush_us + frame_wait_us) / 1000;
+    render_stats.last_copy_us = copy_us;
+    render_stats.last_wait_us = frame_wait_us;
+    render_stats.last_overlap_pct = copy_us > frame_wait_us ? (uint8_t)((copy_us - frame_wait_us) * 100 / copy_us) : 0;
+    render_stats.cpu_copies = cpu_copies;
+    frame_wait_us = 0;
+#endif
+    uint32_t render_ms = time_ms > flush_ms ? time_ms - flush_ms : 0;
+
+    render_stats.frames++;
+    render_stats.last_render_ms = render_ms;
+    render_stats.last_flush_us = frame_flush_us;
+    render_stats.last_px = px;
+    if (render_ms > render_stats.max_render_ms) render_stats.max_render_ms = render_ms;
+    if (frame_flush_us > render_stats.max_flush_us) render_stats.max_flush_us = frame_flush_us;
+    frame_flush_us = 0;
+}
+
+void display_set_backlight(uint8_t percent)
+{
+    if (percent > 100) percent = 100;
+    uint32_t duty = ((1u << BL_LEDC_RES) - 1) * percent / 100;
+    ledc_set_duty(BL_LEDC_MODE, BL_LEDC_CHANNEL, duty);
+    ledc_update_duty(BL_LEDC_MODE, BL_LEDC_CHANNEL);
+}
+
+uint32_t display_get_frame_count(void)
+{
+    return frame_count;
+}
+
+void display_get_render_stats(display_render_stats_t *out)
+{
+    *out = render_stats;
+}
+
+void display_reset_render_stats(void)
+{
+    render_stats.frames = 0;
+    render_stats.max_render_ms = 0;
+    render_stats.max_flush_us = 0;
+}
+
+uint32_t display_get_expected_frame_us(void)
+{
+    return (uint32_t)((uint64_t)LCD_H_TOTAL * LCD_V_TOTAL * 1000000ULL / LCD_FREQ);
+}
+
+void display_get_timing_stats(display_timing_stats_t *out)
+{
+    out->vsync_count = timing_stats.vsync_count;
+    out->bounce_frame_count = timing_stats.bounce_frame_count;
+    out->min_frame_us = timing_stats.min_frame_us;
+    out->max_frame_us = timing_stats.max_frame_us;
+}
+
+void display_reset_timing_stats(void)
+{
+    last_vsync_us = 0;
+    timing_stats.vsync_count = 0;
+    timing_stats.bounce_frame_count = 0;
+    timing_stats.min_frame_us = UINT32_MAX;
+    timing_stats.max_frame_us = 0;
+}
+
 void display_driver_init(void)
 {
     ESP_LOGI(TAG, "Initializing LVGL display driver");
     
     size_t buffer_size = DISP_HOR_RES * DISP_VER_RES;
     
+#if CONFIG_DISPLAY_MODE_DIRECT_DOUBLE_FB
+    lv_disp_draw_buf_init(&draw_buf, panel_fbs[0], panel_fbs[1], buffer_size);
+#elif CONFIG_DISPLAY_MODE_ASYNC_FLUSH
+    // GDMA source, so aligned; PSRAM first, then DMA-capable internal RAM
+    buffer_size = ASYNC_FLUSH_PX;
+    for (int i = 0; i < 2; i++) {
+        async_bufs[i] = heap_caps_aligned_alloc(ASYNC_FLUSH_ALIGN, buffer_size * sizeof(lv_color_t),
+                                                MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (async_bufs[i] == NULL) {
+            async_bufs[i] = heap_caps_aligned_alloc(ASYNC_FLUSH_ALIGN, buffer_size * sizeof(lv_color_t),
+                                                    MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+        }
+    }
+    if (async_bufs[0] == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate display buffer");
+        return;
+    }
+    if (async_bufs[1] == NULL) {
+        ESP_LOGW(TAG, "One draw buffer only, drawing waits for each copy");
+    }
+    lv_disp_draw_buf_init(&draw_buf, async_bufs[0], async_bufs[1], buffer_size);
+    ESP_LOGI(TAG, "Async flush: 2 x %d lines, %s", CONFIG_DISPLAY_ASYNC_FLUSH_LINES,
+             async_mcp != NULL ? "GDMA" : "CPU copy");
+#else
     // Allocate from PSRAM
     buf1 = heap_caps_malloc(buffer_size * sizeof(lv_color_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
     if (buf1 == NULL) {
@@ -641,13 +828,26 @@ void display_driver_init(void)
     }
     
     lv_disp_draw_buf_init(&draw_buf, buf1, NULL, buffer_size);
+#endif
     
     lv_disp_drv_init(&disp_drv);
     disp_drv.hor_res = DISP_HOR_RES;
     disp_drv.ver_res = DISP_VER_RES;
     disp_drv.flush_cb = display_flush_cb;
+    disp_drv.monitor_cb = display_monitor_cb;
     disp_drv.draw_buf = &draw_buf;
+#if CONFIG_DISPLAY_MODE_DIRECT_DOUBLE_FB
+    disp_drv.direct_mode = 1;
+#elif CONFIG_DISPLAY_MODE_ASYNC_FLUSH
+    disp_drv.rounder_cb = display_rounder_cb;
+    disp_drv.wait_cb = display_wait_cb;
+#else
     disp_drv.full_refresh = 1;
+#endif
+#if CONFIG_LVGL_BLEND_ACCEL
+    lvgl_blend_install(&disp_drv);
+    ESP_LOGI(TAG, "Blend kernels: %s", lvgl_blend_get_kernels()->name);
+#endif
     lv_disp_drv_register(&disp_drv);
     
     ESP_LOGI(TAG, "LVGL display driver initialized");
@@ -7,11 +7,49 @@
 #define DISP_HOR_RES 480
 #define DISP_VER_RES 480
 
+// Panel frame timing, sampled in the VSYNC / bounce-buffer ISRs
+typedef struct {
+    uint32_t vsync_count;         // Frames started by the panel
+    uint32_t bounce_frame_count;  // Frames fully fed through the bounce buffers
+    uint32_t min_frame_us;        // Shortest VSYNC-to-VSYNC period
+    uint32_t max_frame_us;        // Longest VSYNC-to-VSYNC period
+} display_timing_stats_t;
+
+// LVGL refresh cost, from the flush and monitor callbacks
+typedef struct {
+    uint32_t frames;              // Refreshes since the last reset
+    uint32_t last_render_ms;      // Drawing time of the last refresh (excl. flush)
+    uint32_t max_render_ms;
+    uint32_t last_flush_us;       // Time spent in display_flush_cb for the last refresh
+    uint32_t max_flush_us;
+    uint32_t last_px;             // Pixels redrawn by the last refresh
+    // DISPLAY_MODE_ASYNC_FLUSH only: GDMA copies into the panel framebuffer
+    uint32_t last_copy_us;        // Copy time finished since the previous refresh
+    uint32_t last_wait_us;        // Time LVGL waited for a copy to hand a buffer back
+    uint8_t last_overlap_pct;     // Share of the copy time hidden behind drawing
+    uint32_t cpu_copies;          // Flushes copied by the CPU since boot (no GDMA)
+} display_render_stats_t;
+
 // Display initialization
 void display_init(void);
 void display_driver_init(void);
 
+// Backlight brightness, 0 (off) to 100. Takes effect at the next PWM period.
+void display_set_backlight(uint8_t percent);
+
 // LVGL flush callback
 void display_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map);
 
+// Number of LVGL frames fully flushed to the panel since boot
+uint32_t display_get_frame_count(void);
+
+// Render/flush statistics; reset clears the counters and maxima
+void display_get_render_stats(display_render_stats_t *out);
+void display_reset_render_stats(void);
+
+// Frame timing statistics
+uint32_t display_get_expected_frame_us(void);
+void display_get_timing_stats(display_timing_stats_t *out);
+void display_reset_timing_stats(void);
+
 #endif // DISPLAY_DRIVER_H
@@ -0,0 +1,149 @@
+#include "display_stress.h"
+#include "display_driver.h"
+#include "wifi_manager.h"
+#include "lvgl.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lwip/sockets.h"
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "DISP_STRESS";
+
+// Datagram size close to the MTU, so each send is one full WiFi frame
+#define STRESS_UDP_PAYLOAD      1400
+// How long to wait for WiFi before running the test without network load
+#define STRESS_WIFI_WAIT_MS     30000
+// Allowed deviation of the measured frame rate / VSYNC period
+#define STRESS_MAX_RATE_ERR_PM  10    // per mille
+#define STRESS_MAX_JITTER_PCT   10
+
+static volatile bool stress_running = false;
+static volatile uint32_t stress_frames_rendered = 0;
+
+// LVGL timer: invalidate the whole screen on every tick so LVGL renders
+// (and reads/writes PSRAM) as fast as it can for the whole test
+static void stress_invalidate_cb(lv_timer_t *timer)
+{
+    if (!stress_running) {
+        lv_timer_del(timer);
+        lv_obj_invalidate(lv_scr_act());
+        return;
+    }
+    lv_obj_invalidate(lv_scr_act());
+    stress_frames_rendered++;
+}
+
+static uint64_t stress_udp_blast(int64_t end_us)
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (sock < 0) {
+        ESP_LOGE(TAG, "Failed to create UDP socket: errno %d", errno);
+        return 0;
+    }
+
+    struct sockaddr_in dest = {
+        .sin_family = AF_INET,
+        .sin_port = htons(CONFIG_DISPLAY_STRESS_TEST_UDP_PORT),
+        .sin_addr.s_addr = inet_addr(CONFIG_DISPLAY_STRESS_TEST_UDP_HOST),
+    };
+
+    static uint8_t payload[STRESS_UDP_PAYLOAD];
+    memset(payload, 0xA5, sizeof(payload));
+
+    uint64_t sent_bytes = 0;
+    while (esp_timer_get_time() < end_us) {
+        int n = sendto(sock, payload, sizeof(payload), 0, (struct sockaddr *)&dest, sizeof(dest));
+        if (n > 0) {
+            sent_bytes += n;
+        } else {
+            // TX queue full: back off one tick and keep the pressure on
+            vTaskDelay(1);
+        }
+    }
+
+    close(sock);
+    return sent_bytes;
+}
+
+static void display_stress_task(void *pvParameter)
+{
+    int64_t wait_start = esp_timer_get_time();
+    while (!wifi_is_connected() &&
+           esp_timer_get_time() - wait_start < (int64_t)STRESS_WIFI_WAIT_MS * 1000) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    bool with_wifi = wifi_is_connected();
+    if (!with_wifi) {
+        ESP_LOGW(TAG, "WiFi not connected, running without network load");
+    }
+
+    ESP_LOGI(TAG, "Starting %d s display stress test (pclk %d Hz, bounce buffers %s)",
+             CONFIG_DISPLAY_STRESS_TEST_DURATION_S, CONFIG_DISPLAY_PCLK_HZ,
+#if CONFIG_DISPLAY_BOUNCE_BUFFER
+             "on"
+#else
+             "off"
+#endif
+             );
+
+    display_reset_timing_stats();
+    int64_t start_us = esp_timer_get_time();
+    int64_t end_us = start_us + (int64_t)CONFIG_DISPLAY_STRESS_TEST_DURATION_S * 1000000;
+
+    uint64_t sent_bytes = 0;
+    if (with_wifi) {
+        sent_bytes = stress_udp_blast(end_us);
+    } else {
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_DISPLAY_STRESS_TEST_DURATION_S * 1000));
+    }
+
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+    stress_running = false;
+
+    display_timing_stats_t stats;
+    display_get_timing_stats(&stats);
+
+    uint32_t expected_us = display_get_expected_frame_us();
+    uint32_t expected_frames = (uint32_t)(elapsed_us / expected_us);
+    uint32_t rate_err_pm = expected_frames == 0 ? 0 :
+        (uint32_t)(1000LL * llabs((int64_t)stats.vsync_count - expected_frames) / expected_frames);
+    int64_t worst_over_us = (int64_t)stats.max_frame_us - expected_us;
+    uint32_t jitter_pct = worst_over_us > 0 ? (uint32_t)(100 * worst_over_us / expected_us) : 0;
+    uint32_t kbps = (uint32_t)(sent_bytes * 8 * 1000 / elapsed_us);
+
+    bool pass = rate_err_pm <= STRESS_MAX_RATE_ERR_PM && jitter_pct <= STRESS_MAX_JITTER_PCT;
+#if CONFIG_DISPLAY_BOUNCE_BUFFER
+    // Every started frame must have been completely fed by the bounce copy
+    uint32_t missed = stats.vsync_count > stats.bounce_frame_count + 1 ?
+                      stats.vsync_count - stats.bounce_frame_count - 1 : 0;
+    pass = pass && missed == 0;
+    ESP_LOGI(TAG, "Bounce frames: %" PRIu32 " (missed %" PRIu32 ")", stats.bounce_frame_count, missed);
+#endif
+
+    ESP_LOGI(TAG, "VSYNC: %" PRIu32 " frames (expected %" PRIu32 "), period min/max %" PRIu32 "/%" PRIu32
+             " us (nominal %" PRIu32 " us)",
+             stats.vsync_count, expected_frames, stats.min_frame_us, stats.max_frame_us, expected_us);
+    ESP_LOGI(TAG, "LVGL: %" PRIu32 " full-screen invalidations, WiFi TX: %" PRIu32 " kbit/s",
+             stress_frames_rendered, kbps);
+    if (pass) {
+        ESP_LOGI(TAG, "PASS: panel timing stable under load");
+    } else {
+        ESP_LOGE(TAG, "FAIL: frame rate error %" PRIu32 " per mille, worst period +%" PRIu32 "%%",
+                 rate_err_pm, jitter_pct);
+    }
+
+    vTaskDelete(NULL);
+}
+
+void display_stress_start(void)
+{
+    // Must run before the LVGL task starts: creates an LVGL timer
+    stress_running = true;
+    stress_frames_rendered = 0;
+    lv_timer_create(stress_invalidate_cb, 0, NULL);
+    xTaskCreatePinnedToCore(display_stress_task, "disp_stress", 4096, NULL, 4, NULL, 0);
+}
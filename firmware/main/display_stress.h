@@ -0,0 +1,8 @@
+#ifndef DISPLAY_STRESS_H
+#define DISPLAY_STRESS_H
+
+// Start the display stability stress test (CONFIG_DISPLAY_STRESS_TEST).
+// Call after ui_init() and before the LVGL task is created.
+void display_stress_start(void);
+
+#endif // DISPLAY_STRESS_H
@@ -0,0 +1,231 @@
+#include "i2c_bus.h"
+#include "driver/i2c.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <inttypes.h>
+#include <string.h>
+
+static const char *TAG = "I2C_BUS";
+
+// From: sensecap_indicator_board.c GPIO_I2C_* definitions
+#define I2C_BUS_NUM         I2C_NUM_0
+#define I2C_BUS_SDA_IO      39
+#define I2C_BUS_SCL_IO      40
+#define I2C_BUS_FREQ_HZ     400000
+
+#define I2C_BUS_TIMEOUT_TICKS   pdMS_TO_TICKS(CONFIG_I2C_BUS_TIMEOUT_MS)
+
+// Enough command slots for write-reg + repeated start + read (two
+// transactions of the recommended size, plus one of margin)
+#define I2C_BUS_LINK_SIZE   I2C_LINK_RECOMMENDED_SIZE(3)
+
+struct i2c_bus_device {
+    i2c_bus_device_stats_t stats;
+    uint8_t addr_wr;    // Pre-shifted address bytes, computed once
+    uint8_t addr_rd;
+};
+
+static struct i2c_bus_device devices[I2C_BUS_MAX_DEVICES];
+static size_t device_count = 0;
+static SemaphoreHandle_t bus_mutex = NULL;
+static StaticSemaphore_t bus_mutex_buf;
+
+// Command link storage, reused by every transaction while the mutex is held,
+// so building a transaction never touches the heap
+static uint8_t link_buf[I2C_BUS_LINK_SIZE];
+
+#if CONFIG_I2C_BUS_STATS_LOG_INTERVAL_S > 0
+static void i2c_bus_stats_timer_cb(void *arg)
+{
+    i2c_bus_log_stats();
+}
+#endif
+
+esp_err_t i2c_bus_init(void)
+{
+    if (bus_mutex != NULL) {
+        return ESP_OK;
+    }
+
+    i2c_config_t conf = {
+        .mode = I2C_MODE_MASTER,
+        .sda_io_num = I2C_BUS_SDA_IO,
+        .scl_io_num = I2C_BUS_SCL_IO,
+        .sda_pullup_en = GPIO_PULLUP_ENABLE,
+        .scl_pullup_en = GPIO_PULLUP_ENABLE,
+        .master.clk_speed = I2C_BUS_FREQ_HZ,
+    };
+    esp_err_t ret = i2c_param_config(I2C_BUS_NUM, &conf);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = i2c_driver_install(I2C_BUS_NUM, conf.mode, 0, 0, 0);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    bus_mutex = xSemaphoreCreateMutexStatic(&bus_mutex_buf);
+
+#if CONFIG_I2C_BUS_STATS_LOG_INTERVAL_S > 0
+    const esp_timer_create_args_t timer_args = {
+        .callback = i2c_bus_stats_timer_cb,
+        .name = "i2c_stats",
+    };
+    esp_timer_handle_t timer;
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(timer, CONFIG_I2C_BUS_STATS_LOG_INTERVAL_S * 1000000ULL));
+#endif
+
+    ESP_LOGI(TAG, "I2C bus ready (SDA %d, SCL %d, %d Hz, timeout %d ms)",
+             I2C_BUS_SDA_IO, I2C_BUS_SCL_IO, I2C_BUS_FREQ_HZ, CONFIG_I2C_BUS_TIMEOUT_MS);
+    return ESP_OK;
+}
+
+esp_err_t i2c_bus_add_device(const char *name, uint8_t addr, i2c_bus_device_handle_t *out)
+{
+    if (bus_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (device_count >= I2C_BUS_MAX_DEVICES) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    struct i2c_bus_device *dev = &devices[device_count++];
+    memset(dev, 0, sizeof(*dev));
+    dev->stats.name = name;
+    dev->stats.addr = addr;
+    dev->addr_wr = (addr << 1) | I2C_MASTER_WRITE;
+    dev->addr_rd = (addr << 1) | I2C_MASTER_READ;
+    *out = dev;
+    return ESP_OK;
+}
+
+// Run the transaction in link_buf and account it to dev. Called with the mutex held.
+static esp_err_t i2c_bus_execute(struct i2c_bus_device *dev, i2c_cmd_handle_t cmd, size_t bytes)
+{
+    int64_t start = esp_timer_get_time();
+    esp_err_t ret = i2c_master_cmd_begin(I2C_BUS_NUM, cmd, I2C_BUS_TIMEOUT_TICKS);
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+    i2c_cmd_link_delete_static(cmd);
+
+    dev->stats.transactions++;
+    dev->stats.last_us = elapsed;
+    dev->stats.total_us += elapsed;
+    if (elapsed > dev->stats.max_us) dev->stats.max_us = elapsed;
+    if (ret == ESP_OK) {
+        dev->stats.bytes += bytes;
+    } else {
+        dev->stats.errors++;
+    }
+    return ret;
+}
+
+static bool i2c_bus_lock(struct i2c_bus_device *dev)
+{
+    int64_t start = esp_timer_get_time();
+    if (xSemaphoreTake(bus_mutex, I2C_BUS_TIMEOUT_TICKS) != pdTRUE) {
+        ESP_LOGD(TAG, "%s: bus busy for %d ms", dev->stats.name, CONFIG_I2C_BUS_TIMEOUT_MS);
+        return false;
+    }
+    uint32_t waited = (uint32_t)(esp_timer_get_time() - start);
+    if (waited > dev->stats.max_wait_us) dev->stats.max_wait_us = waited;
+    return true;
+}
+
+esp_err_t i2c_bus_write(i2c_bus_device_handle_t dev, const uint8_t *reg, size_t reg_len,
+                        const uint8_t *data, size_t len)
+{
+    if (!i2c_bus_lock(dev)) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create_static(link_buf, sizeof(link_buf));
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, dev->addr_wr, true);
+    if (reg_len > 0) {
+        i2c_master_write(cmd, reg, reg_len, true);
+    }
+    if (len > 0) {
+        i2c_master_write(cmd, data, len, true);
+    }
+    i2c_master_stop(cmd);
+    esp_err_t ret = i2c_bus_execute(dev, cmd, len);
+
+    xSemaphoreGive(bus_mutex);
+    return ret;
+}
+
+esp_err_t i2c_bus_read(i2c_bus_device_handle_t dev, const uint8_t *reg, size_t reg_len,
+                       uint8_t *data, size_t len)
+{
+    if (len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!i2c_bus_lock(dev)) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create_static(link_buf, sizeof(link_buf));
+    if (reg_len > 0) {
+        i2c_master_start(cmd);
+        i2c_master_write_byte(cmd, dev->addr_wr, true);
+        i2c_master_write(cmd, reg, reg_len, true);
+    }
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, dev->addr_rd, true);
+    i2c_master_read(cmd, data, len, I2C_MASTER_LAST_NACK);
+    i2c_master_stop(cmd);
+    esp_err_t ret = i2c_bus_execute(dev, cmd, len);
+
+    xSemaphoreGive(bus_mutex);
+    return ret;
+}
+
+void i2c_bus_get_stats(i2c_bus_device_handle_t dev, i2c_bus_device_stats_t *out)
+{
+    // Copy under the lock so the counters are consistent with each other
+    if (xSemaphoreTake(bus_mutex, I2C_BUS_TIMEOUT_TICKS) == pdTRUE) {
+        *out = dev->stats;
+        xSemaphoreGive(bus_mutex);
+    } else {
+        *out = dev->stats;
+    }
+}
+
+size_t i2c_bus_get_device_count(void)
+{
+    return device_count;
+}
+
+i2c_bus_device_handle_t i2c_bus_get_device(size_t index)
+{
+    return index < device_count ? &devices[index] : NULL;
+}
+
+void i2c_bus_reset_stats(void)
+{
+    xSemaphoreTake(bus_mutex, portMAX_DELAY);
+    for (size_t i = 0; i < device_count; i++) {
+        const char *name = devices[i].stats.name;
+        uint8_t addr = devices[i].stats.addr;
+        memset(&devices[i].stats, 0, sizeof(devices[i].stats));
+        devices[i].stats.name = name;
+        devices[i].stats.addr = addr;
+    }
+    xSemaphoreGive(bus_mutex);
+}
+
+void i2c_bus_log_stats(void)
+{
+    for (size_t i = 0; i < device_count; i++) {
+        i2c_bus_device_stats_t s;
+        i2c_bus_get_stats(&devices[i], &s);
+        uint32_t avg_us = s.transactions ? (uint32_t)(s.total_us / s.transactions) : 0;
+        ESP_LOGI(TAG, "%s (0x%02X): %" PRIu32 " txn, %" PRIu32 " err, %" PRIu32 " B, "
+                 "avg/max %" PRIu32 "/%" PRIu32 " us, max wait %" PRIu32 " us",
+                 s.name, s.addr, s.transactions, s.errors, s.bytes,
+                 avg_us, s.max_us, s.max_wait_us);
+    }
+}
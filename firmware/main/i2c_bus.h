@@ -0,0 +1,51 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+// Shared I2C master bus (I2C_NUM_0, SDA 39 / SCL 40) for the TCA9535 IO
+// expander and the GT911 touch controller. The driver is installed once;
+// every transaction holds the bus mutex, so callers on different tasks
+// never interleave on the wire.
+
+#define I2C_BUS_MAX_DEVICES 4
+
+typedef struct i2c_bus_device *i2c_bus_device_handle_t;
+
+// Per-device transaction statistics
+typedef struct {
+    const char *name;
+    uint8_t addr;
+    uint32_t transactions;   // Completed or failed transactions
+    uint32_t errors;         // NACK or bus timeout
+    uint32_t bytes;          // Payload bytes moved (excluding register address)
+    uint32_t last_us;        // Duration of the last transfer on the wire
+    uint32_t max_us;         // Longest transfer
+    uint32_t max_wait_us;    // Longest wait for the bus mutex
+    uint64_t total_us;       // Sum of transfer times, for the average / bus load
+} i2c_bus_device_stats_t;
+
+// Install the I2C driver. Safe to call more than once.
+esp_err_t i2c_bus_init(void);
+
+// Register a 7-bit device address on the bus and get its handle
+esp_err_t i2c_bus_add_device(const char *name, uint8_t addr, i2c_bus_device_handle_t *out);
+
+// Write reg (register address bytes) followed by data, in one transaction
+esp_err_t i2c_bus_write(i2c_bus_device_handle_t dev, const uint8_t *reg, size_t reg_len,
+                        const uint8_t *data, size_t len);
+
+// Write reg, repeated start, then read len bytes into data
+esp_err_t i2c_bus_read(i2c_bus_device_handle_t dev, const uint8_t *reg, size_t reg_len,
+                       uint8_t *data, size_t len);
+
+// Statistics
+void i2c_bus_get_stats(i2c_bus_device_handle_t dev, i2c_bus_device_stats_t *out);
+size_t i2c_bus_get_device_count(void);
+i2c_bus_device_handle_t i2c_bus_get_device(size_t index);
+void i2c_bus_reset_stats(void);
+void i2c_bus_log_stats(void);
+
+#endif // I2C_BUS_H
@@ -0,0 +1,150 @@
+#include "idle_manager.h"
+#include "display_driver.h"
+#include "touch_driver.h"
+#include "lvgl.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "esp_pm.h"
+#include <stdatomic.h>
+
+static const char *TAG = "IDLE";
+
+// Backlight fade into idle; waking is immediate
+#define IDLE_FADE_MS        400
+
+static atomic_uint_least32_t activity_ms;   // Time of the last activity
+static atomic_uint_least32_t activity_seq;  // Bumped by every activity
+static uint32_t idle_seq;                   // activity_seq when idle was entered
+static bool idle = false;
+static int32_t backlight_pct = 100;
+#if CONFIG_PM_ENABLE
+// Held while awake; released, it lets DFS drop to min_freq_mhz
+static esp_pm_lock_handle_t cpu_lock = NULL;
+#endif
+
+static uint32_t now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static void backlight_anim_cb(void *var, int32_t value)
+{
+    backlight_pct = value;
+    display_set_backlight((uint8_t)value);
+}
+
+static void backlight_fade(int32_t target, uint32_t time_ms)
+{
+    lv_anim_del(&backlight_pct, backlight_anim_cb);
+    if (time_ms == 0) {
+        backlight_anim_cb(&backlight_pct, target);
+        return;
+    }
+
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, &backlight_pct);
+    lv_anim_set_exec_cb(&a, backlight_anim_cb);
+    lv_anim_set_values(&a, backlight_pct, target);
+    lv_anim_set_time(&a, time_ms);
+    lv_anim_start(&a);
+}
+
+static void idle_enter(uint32_t seq)
+{
+    idle = true;
+    idle_seq = seq;
+
+    backlight_fade(CONFIG_IDLE_BACKLIGHT_PERCENT, IDLE_FADE_MS);
+    // Anything that changes from here on is redrawn by idle_leave(); until
+    // then the refresh timer stays parked and nothing is flushed
+    lv_disp_enable_invalidation(lv_disp_get_default(), false);
+    // Fails harmlessly while WiFi is not started yet
+    esp_wifi_set_ps(WIFI_PS_MAX_MODEM);
+#if CONFIG_PM_ENABLE
+    esp_pm_lock_release(cpu_lock);
+#endif
+    ESP_LOGI(TAG, "Idle after %d s without input", CONFIG_IDLE_TIMEOUT_S);
+}
+
+static void idle_leave(void)
+{
+#if CONFIG_PM_ENABLE
+    // Full speed before the frame is drawn
+    esp_pm_lock_acquire(cpu_lock);
+#endif
+    idle = false;
+
+    lv_disp_enable_invalidation(lv_disp_get_default(), true);
+    lv_obj_invalidate(lv_scr_act());
+    backlight_fade(100, 0);
+    esp_wifi_set_ps(WIFI_PS_MIN_MODEM);
+
+    // The finger that woke the display is not meant for a widget
+    lv_indev_t *indev = touch_get_indev();
+    if (indev && touch_is_active()) {
+        lv_indev_wait_release(indev);
+    }
+    ESP_LOGI(TAG, "Awake");
+}
+
+void idle_manager_init(void)
+{
+    atomic_store(&activity_ms, now_ms());
+
+#if CONFIG_PM_ENABLE
+    // The RGB panel keeps APB at 80 MHz for as long as it scans out, so the
+    // CPU bottoms out at 80 MHz and light sleep only happens without it
+    esp_pm_config_esp32s3_t pm_config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = CONFIG_XTAL_FREQ,
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+        .light_sleep_enable = true,
+#endif
+    };
+    esp_err_t err = esp_pm_configure(&pm_config);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Power management not configured: %s", esp_err_to_name(err));
+    }
+    ESP_ERROR_CHECK(esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "ui_active", &cpu_lock));
+    ESP_ERROR_CHECK(esp_pm_lock_acquire(cpu_lock));
+#endif
+
+    if (CONFIG_IDLE_TIMEOUT_S > 0) {
+        ESP_LOGI(TAG, "Idle after %d s, backlight %d%%", CONFIG_IDLE_TIMEOUT_S, CONFIG_IDLE_BACKLIGHT_PERCENT);
+    }
+}
+
+void idle_manager_activity(void)
+{
+    atomic_store(&activity_ms, now_ms());
+    atomic_fetch_add(&activity_seq, 1);
+}
+
+uint32_t idle_manager_update(void)
+{
+    if (CONFIG_IDLE_TIMEOUT_S == 0) return LV_NO_TIMER_READY;
+
+    // Sequence before timestamp: activity after this read is seen by the
+    // next call, whichever way this one decides
+    uint32_t seq = atomic_load(&activity_seq);
+
+    if (idle) {
+        if (seq == idle_seq) return LV_NO_TIMER_READY;
+        idle_leave();
+    }
+
+    uint32_t quiet_ms = now_ms() - atomic_load(&activity_ms);
+    uint32_t timeout_ms = CONFIG_IDLE_TIMEOUT_S * 1000u;
+    if (quiet_ms >= timeout_ms) {
+        idle_enter(seq);
+        return LV_NO_TIMER_READY;
+    }
+    return timeout_ms - quiet_ms;
+}
+
+bool idle_manager_is_idle(void)
+{
+    return idle;
+}
@@ -0,0 +1,31 @@
+#ifndef IDLE_MANAGER_H
+#define IDLE_MANAGER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Power saving while nobody looks at the display.
+//
+// After IDLE_TIMEOUT_S without touch input the backlight fades down to
+// IDLE_BACKLIGHT_PERCENT, LVGL stops invalidating and flushing, the CPU
+// lock is released so power management may drop to the minimum frequency,
+// and WiFi goes to maximum modem sleep. A touch or, with
+// IDLE_WAKE_ON_MQTT, a value arriving for the UI brings everything back
+// before the next frame is drawn. The touch that wakes the device is not
+// passed on to the widgets.
+
+// Configure power management and take the CPU lock; call once, after
+// display_init() and before render_loop_start()
+void idle_manager_init(void);
+
+// Note user or remote activity. Safe from any task (not from ISRs); the
+// caller wakes the LVGL task.
+void idle_manager_activity(void);
+
+// Enter or leave idle as due. LVGL task only, once per loop iteration.
+// Returns the ms until the next transition is due, or LV_NO_TIMER_READY.
+uint32_t idle_manager_update(void);
+
+bool idle_manager_is_idle(void);
+
+#endif // IDLE_MANAGER_H
@@ -0,0 +1,232 @@
+#include "local_link.h"
+#include "sdkconfig.h"
+
+#if CONFIG_LOCAL_LINK
+#include <errno.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_mac.h"
+#include "esp_timer.h"
+#include "lwip/sockets.h"
+#include "lwip/inet.h"
+#include "backend.h"
+#include "state_store.h"
+#include "payload_codec.h"
+#include <inttypes.h>
+
+static const char *TAG = "LOCAL";
+
+// Sending is on the path of a tap: above touch input, on the core of the
+// network stack. Receiving only feeds the backend.
+#define LOCAL_TX_TASK_STACK 3072
+#define LOCAL_TX_TASK_PRIO  7
+#define LOCAL_RX_TASK_STACK 3072
+#define LOCAL_RX_TASK_PRIO  4
+#define LOCAL_TASK_CORE     0
+
+// Multicast has no acknowledgement; each light frame leaves
+// CONFIG_LOCAL_LINK_REPEATS more times, this far apart
+#define LOCAL_REPEAT_MS     10
+// Senders whose last sequence number is remembered
+#define LOCAL_PEERS         8
+
+typedef struct {
+    uint32_t node;
+    uint16_t seq;
+    bool used;
+} local_peer_t;
+
+static int sock = -1;
+static struct sockaddr_in group_addr;
+static uint32_t node_id;
+static TaskHandle_t tx_task = NULL;
+
+// Latest light state, handed from the state subscriber to the send task
+static portMUX_TYPE pending_lock = portMUX_INITIALIZER_UNLOCKED;
+static payload_light_state_t pending_light;
+static int64_t pending_us;
+
+static local_peer_t peers[LOCAL_PEERS];
+static size_t peer_next = 0;
+
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static local_link_stats_t stats;
+
+// Called with the state store's writer lock held: only hands over
+static void on_state_light(uint32_t changed, const backend_state_t *state, void *ctx)
+{
+    (void)changed;
+    (void)ctx;
+    portENTER_CRITICAL(&pending_lock);
+    pending_light.bright = state->bright;
+    pending_light.relax = state->relax;
+    pending_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&pending_lock);
+    if (tx_task != NULL) xTaskNotifyGive(tx_task);
+}
+
+static void send_frame(const uint8_t *frame, size_t len)
+{
+    if (sendto(sock, frame, len, 0, (const struct sockaddr *)&group_addr, sizeof(group_addr)) == (int)len) {
+        portENTER_CRITICAL(&stats_lock);
+        stats.tx_frames++;
+        portEXIT_CRITICAL(&stats_lock);
+    }
+}
+
+static void local_tx_task(void *arg)
+{
+    uint16_t seq = 0;
+    bool newer = false;
+
+    for (;;) {
+        if (!newer) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        newer = false;
+
+        payload_local_frame_t f = {
+            .node = node_id,
+            .seq = ++seq,
+            .kind = PAYLOAD_LOCAL_LIGHT_STATE,
+        };
+        portENTER_CRITICAL(&pending_lock);
+        f.light = pending_light;
+        int64_t changed_us = pending_us;
+        portEXIT_CRITICAL(&pending_lock);
+
+        uint8_t frame[PAYLOAD_LOCAL_FRAME_LEN];
+        int len = payload_encode_local_frame(&f, frame, sizeof(frame));
+        send_frame(frame, (size_t)len);
+        uint32_t send_us = (uint32_t)(esp_timer_get_time() - changed_us);
+        portENTER_CRITICAL(&stats_lock);
+        stats.send_us = send_us;
+        portEXIT_CRITICAL(&stats_lock);
+
+        for (int i = 0; i < CONFIG_LOCAL_LINK_REPEATS; i++) {
+            // A newer state replaces the repeats of this one
+            if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOCAL_REPEAT_MS)) > 0) {
+                newer = true;
+                break;
+            }
+            send_frame(frame, (size_t)len);
+        }
+    }
+}
+
+// Repeats carry the sequence number of the frame they repeat
+static bool peer_seen(uint32_t node, uint16_t seq)
+{
+    for (size_t i = 0; i < LOCAL_PEERS; i++) {
+        if (peers[i].used && peers[i].node == node) {
+            if (peers[i].seq == seq) return true;
+            peers[i].seq = seq;
+            return false;
+        }
+    }
+    peers[peer_next] = (local_peer_t){ .node = node, .seq = seq, .used = true };
+    peer_next = (peer_next + 1) % LOCAL_PEERS;
+    return false;
+}
+
+static void local_rx_task(void *arg)
+{
+    uint8_t buf[32];
+
+    for (;;) {
+        int n = recv(sock, buf, sizeof(buf), 0);
+        if (n < 0) {
+            ESP_LOGW(TAG, "Receive failed: errno %d", errno);
+            vTaskDelay(pdMS_TO_TICKS(1000));
+            continue;
+        }
+
+        payload_local_frame_t f;
+        if (!payload_decode_local_frame(buf, (size_t)n, &f)) {
+            portENTER_CRITICAL(&stats_lock);
+            stats.rx_errors++;
+            portEXIT_CRITICAL(&stats_lock);
+            continue;
+        }
+        if (f.node == node_id) continue;
+
+        bool repeat = peer_seen(f.node, f.seq);
+        portENTER_CRITICAL(&stats_lock);
+        if (repeat) stats.rx_repeats++;
+        else stats.rx_frames++;
+        portEXIT_CRITICAL(&stats_lock);
+        if (repeat) continue;
+
+        // Light frames are commands for the light controller; the state of
+        // this device is its own
+        if (f.kind == PAYLOAD_LOCAL_WATER_LEVEL) {
+            backend_update_tank_level_from(BACKEND_SOURCE_LOCAL, f.tank, f.level.level);
+        }
+    }
+}
+
+void local_link_init(void)
+{
+    uint8_t mac[6];
+    esp_efuse_mac_get_default(mac);
+    node_id = ((uint32_t)mac[2] << 24) | ((uint32_t)mac[3] << 16) | ((uint32_t)mac[4] << 8) | mac[5];
+
+    if (!state_store_subscribe(STATE_FIELD_BRIGHT | STATE_FIELD_RELAX, on_state_light, NULL)) {
+        ESP_LOGE(TAG, "No state subscriber slot left, light frames disabled");
+    }
+}
+
+void local_link_start(void)
+{
+    if (sock >= 0) return;
+
+    int s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s < 0) {
+        ESP_LOGE(TAG, "Failed to create UDP socket: errno %d", errno);
+        return;
+    }
+
+    int one = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in bind_addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(CONFIG_LOCAL_LINK_PORT),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    group_addr = (struct sockaddr_in){
+        .sin_family = AF_INET,
+        .sin_port = htons(CONFIG_LOCAL_LINK_PORT),
+        .sin_addr.s_addr = inet_addr(CONFIG_LOCAL_LINK_GROUP),
+    };
+    struct ip_mreq mreq = {
+        .imr_multiaddr.s_addr = group_addr.sin_addr.s_addr,
+        .imr_interface.s_addr = htonl(INADDR_ANY),
+    };
+    // One hop: the frames stay on the LAN; our own are not looped back
+    uint8_t ttl = 1;
+    uint8_t loop = 0;
+    if (bind(s, (struct sockaddr *)&bind_addr, sizeof(bind_addr)) != 0 ||
+        setsockopt(s, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0 ||
+        setsockopt(s, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) != 0 ||
+        setsockopt(s, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) != 0) {
+        ESP_LOGE(TAG, "Cannot join %s:%d: errno %d", CONFIG_LOCAL_LINK_GROUP, CONFIG_LOCAL_LINK_PORT, errno);
+        close(s);
+        return;
+    }
+    sock = s;
+
+    xTaskCreatePinnedToCore(local_tx_task, "local_tx", LOCAL_TX_TASK_STACK, NULL, LOCAL_TX_TASK_PRIO, &tx_task,
+                            LOCAL_TASK_CORE);
+    xTaskCreatePinnedToCore(local_rx_task, "local_rx", LOCAL_RX_TASK_STACK, NULL, LOCAL_RX_TASK_PRIO, NULL,
+                            LOCAL_TASK_CORE);
+    ESP_LOGI(TAG, "Node %08" PRIx32 " on %s:%d", node_id, CONFIG_LOCAL_LINK_GROUP, CONFIG_LOCAL_LINK_PORT);
+}
+
+void local_link_get_stats(local_link_stats_t *out)
+{
+    portENTER_CRITICAL(&stats_lock);
+    *out = stats;
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+#endif // CONFIG_LOCAL_LINK
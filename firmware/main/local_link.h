@@ -0,0 +1,28 @@
+#ifndef LOCAL_LINK_H
+#define LOCAL_LINK_H
+
+#include <stdint.h>
+
+// Local link: light state out, tank levels in, as fixed-size frames
+// (payload_encode_local_frame()) on a UDP multicast group of the LAN. It
+// runs next to the broker, which stays the authoritative sync channel;
+// levels that arrive on both paths are deduplicated by the backend.
+
+typedef struct {
+    uint32_t tx_frames;         // Repeats included
+    uint32_t rx_frames;         // New frames from peers
+    uint32_t rx_repeats;        // Repeats of frames already seen
+    uint32_t rx_errors;         // Not a local frame of this version
+    uint32_t send_us;           // State change to the first copy on the socket, last light frame
+} local_link_stats_t;
+
+// Subscribe to the light state; call after backend_init()
+void local_link_init(void);
+
+// Join the group and start sending and receiving; WiFi must be up. Later
+// calls do nothing.
+void local_link_start(void);
+
+void local_link_get_stats(local_link_stats_t *out);
+
+#endif // LOCAL_LINK_H
@@ -0,0 +1,253 @@
+#include "mqtt_manager.h"
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_mac.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "mqtt_client.h"
+#include "mqtt_tls.h"
+#include "mqtt_router.h"
+#include "publish_scheduler.h"
+#include "publish_journal.h"
+#include "dlog.h"
+
+static const char *TAG = "MQTT";
+
+static esp_mqtt_client_handle_t mqtt_client = NULL;
+static mqtt_status_cb_t s_status_cb = NULL;
+static bool mqtt_started = false;
+static volatile bool mqtt_connected = false;
+// Replays the offline journal after a reconnect, one batch per run
+static esp_timer_handle_t replay_timer = NULL;
+
+// Round-trip probe: send time of the last timed QoS 1 publish, cleared on PUBACK
+static volatile int pending_msg_id = -1;
+static volatile int64_t pending_sent_us = 0;
+static volatile uint32_t last_rtt_us = 0;
+
+// Broker connect timing, from MQTT_EVENT_BEFORE_CONNECT to CONNACK
+static int64_t connect_start_us = 0;
+static portMUX_TYPE connect_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static mqtt_connect_stats_t connect_stats;
+
+// Filters of the persistent session at the broker, by CRC. RTC memory: an
+// OTA update that changes the routed topics subscribes again after its
+// reboot, a power cycle once too many.
+static RTC_NOINIT_ATTR uint32_t session_filters_crc;
+
+static int mqtt_outbox_enqueue(const char *topic, const uint8_t *payload, size_t len, int qos, bool retain)
+{
+    // store=true: QoS 0 messages go through the outbox too, so this never
+    // waits for the socket
+    return esp_mqtt_client_enqueue(mqtt_client, topic, (const char *)payload, (int)len, qos, retain, true);
+}
+
+// Batches keep a reconnect from flooding the outbox and the link; the next
+// one waits until the outbox is back under its limit
+static void mqtt_replay_cb(void *arg)
+{
+    if (!mqtt_connected) return;
+
+    if (esp_mqtt_client_get_outbox_size(mqtt_client) <= CONFIG_MQTT_OUTBOX_LIMIT_BYTES) {
+        size_t sent = publish_journal_replay(mqtt_outbox_enqueue, CONFIG_PUBLISH_REPLAY_BATCH);
+        if (sent > 0) {
+            DLOGI(MQTT, "Replayed %u journaled messages, %u left", (unsigned)sent,
+                  (unsigned)publish_journal_count());
+        }
+    }
+    if (publish_journal_count() > 0) {
+        esp_timer_start_once(replay_timer, CONFIG_PUBLISH_REPLAY_INTERVAL_MS * 1000ULL);
+    }
+}
+
+static uint32_t router_filters_crc(void)
+{
+    uint32_t crc = 0;
+    for (size_t i = 0; i < mqtt_router_get_count(); i++) {
+        const char *filter = mqtt_router_get_filter(i);
+        // NUL included, so that filters cannot run into each other
+        crc = esp_rom_crc32_le(crc, (const uint8_t *)filter, strlen(filter) + 1);
+    }
+    return crc;
+}
+
+// MQTT event handler, on the MQTT task: logs are deferred to the dlog task
+static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data)
+{
+    esp_mqtt_event_handle_t event = event_data;
+    
+    switch ((esp_mqtt_event_id_t)event_id) {
+        case MQTT_EVENT_BEFORE_CONNECT:
+            connect_start_us = esp_timer_get_time();
+            break;
+
+        case MQTT_EVENT_CONNECTED: {
+            uint32_t connect_ms = (uint32_t)((esp_timer_get_time() - connect_start_us) / 1000);
+            uint32_t filters_crc = router_filters_crc();
+            bool kept = event->session_present && session_filters_crc == filters_crc;
+            DLOGI(MQTT, "MQTT connected in %u ms, session %s", (unsigned)connect_ms, kept ? "kept" : "new");
+            mqtt_connected = true;
+            portENTER_CRITICAL(&connect_stats_lock);
+            connect_stats.last_ms = connect_ms;
+            connect_stats.count++;
+            if (kept) connect_stats.sessions_kept++;
+            portEXIT_CRITICAL(&connect_stats_lock);
+
+            // The broker still holds the subscriptions of a kept session
+            if (!kept) {
+                for (size_t i = 0; i < mqtt_router_get_count(); i++) {
+                    esp_mqtt_client_subscribe(mqtt_client, mqtt_router_get_filter(i), 1);
+                }
+                session_filters_crc = filters_crc;
+            }
+            esp_timer_start_once(replay_timer, 0);
+            if (s_status_cb) s_status_cb(MQTT_STATUS_CONNECTED);
+            break;
+        }
+            
+        case MQTT_EVENT_DISCONNECTED:
+            DLOGI(MQTT, "MQTT disconnected");
+            mqtt_connected = false;
+            if (s_status_cb) s_status_cb(MQTT_STATUS_DISCONNECTED);
+            break;
+            
+        case MQTT_EVENT_PUBLISHED:
+            if (event->msg_id == pending_msg_id) {
+                last_rtt_us = (uint32_t)(esp_timer_get_time() - pending_sent_us);
+                pending_msg_id = -1;
+            }
+            break;
+            
+        case MQTT_EVENT_DATA:
+            // Topic is only set on the first chunk of a fragmented message
+            mqtt_router_dispatch(event->topic, event->topic_len,
+                                 event->data, event->data_len,
+                                 event->current_data_offset, event->total_data_len);
+            break;
+            
+        case MQTT_EVENT_ERROR:
+            DLOGE(MQTT, "MQTT error occurred");
+            break;
+            
+        default:
+            break;
+    }
+}
+
+// Initialize MQTT client
+void mqtt_manager_init(mqtt_status_cb_t cb)
+{
+    s_status_cb = cb;
+
+    // Stable per device: a persistent session is found again by its client
+    // ID, and two devices must not take over each other's
+    static char client_id[24];
+    uint8_t mac[6];
+    esp_efuse_mac_get_default(mac);
+    snprintf(client_id, sizeof(client_id), "sensecap-d1-%02x%02x%02x", mac[3], mac[4], mac[5]);
+
+    esp_mqtt_client_config_t mqtt_cfg = {
+        .broker.address.uri = CONFIG_MQTT_BROKER_URL,
+        .credentials.client_id = client_id,
+        .session.keepalive = 60,
+#if CONFIG_MQTT_PERSISTENT_SESSION
+        .session.disable_clean_session = true,
+#endif
+        .outbox.limit = CONFIG_MQTT_OUTBOX_LIMIT_BYTES,
+    };
+
+    // TLS through mqtt_tls, which resumes the last session instead of a
+    // full handshake on every reconnect
+    if (strncmp(CONFIG_MQTT_BROKER_URL, "mqtts://", 8) == 0) {
+        mqtt_cfg.network.transport = mqtt_tls_transport_create();
+    }
+    
+    // Add authentication if username is configured
+    if (strlen(CONFIG_MQTT_USERNAME) > 0) {
+        mqtt_cfg.credentials.username = CONFIG_MQTT_USERNAME;
+        mqtt_cfg.credentials.authentication.password = CONFIG_MQTT_PASSWORD;
+        ESP_LOGI(TAG, "MQTT using authentication with username: %s", CONFIG_MQTT_USERNAME);
+    }
+    
+    mqtt_client = esp_mqtt_client_init(&mqtt_cfg);
+    esp_mqtt_client_register_event(mqtt_client, ESP_EVENT_ANY_ID, mqtt_event_handler, NULL);
+
+    publish_journal_init();
+    const esp_timer_create_args_t replay_args = {
+        .callback = mqtt_replay_cb,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "mqtt_replay",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&replay_args, &replay_timer));
+
+    // Backend state topics are published through the coalescing scheduler
+    static const publish_sink_t sink = {
+        .enqueue = mqtt_manager_enqueue,
+        .outbox_size = mqtt_manager_get_outbox_size,
+    };
+    publish_scheduler_set_sink(&sink);
+}
+
+void mqtt_manager_start(void)
+{
+    if (mqtt_client == NULL || mqtt_started) return;
+
+    ESP_LOGI(TAG, "Connecting to broker %s", CONFIG_MQTT_BROKER_URL);
+    esp_mqtt_client_start(mqtt_client);
+    mqtt_started = true;
+}
+
+bool mqtt_manager_is_connected(void)
+{
+    return mqtt_connected;
+}
+
+int mqtt_manager_publish_timed(const char *topic, const uint8_t *payload, size_t len)
+{
+    if (mqtt_client == NULL || !mqtt_connected) return -1;
+
+    // The PUBACK can only be matched once the id is known, so an ack that
+    // beats the return of publish() costs one sample, nothing more
+    int64_t sent_us = esp_timer_get_time();
+    int msg_id = esp_mqtt_client_publish(mqtt_client, topic, (const char *)payload, (int)len, 1, 0);
+    if (msg_id > 0) {
+        pending_sent_us = sent_us;
+        pending_msg_id = msg_id;
+    }
+    return msg_id;
+}
+
+uint32_t mqtt_manager_get_rtt_us(void)
+{
+    return last_rtt_us;
+}
+
+void mqtt_manager_get_connect_stats(mqtt_connect_stats_t *out)
+{
+    portENTER_CRITICAL(&connect_stats_lock);
+    *out = connect_stats;
+    portEXIT_CRITICAL(&connect_stats_lock);
+}
+
+int mqtt_manager_enqueue(const char *topic, const uint8_t *payload, size_t len, int qos, bool retain)
+{
+    if (mqtt_client == NULL) return -1;
+
+    // Offline, and until older journaled messages are out, only the latest
+    // message per topic is kept; the outbox would hold every one of them
+    if (!mqtt_connected || publish_journal_count() > 0) {
+        if (publish_journal_put(topic, payload, len, qos, retain)) {
+            if (mqtt_connected) esp_timer_start_once(replay_timer, 0);
+            return 0;
+        }
+    }
+    return mqtt_outbox_enqueue(topic, payload, len, qos, retain);
+}
+
+int mqtt_manager_get_outbox_size(void)
+{
+    return mqtt_client ? esp_mqtt_client_get_outbox_size(mqtt_client) : 0;
+}
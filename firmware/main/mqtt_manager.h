@@ -0,0 +1,51 @@
+#ifndef MQTT_MANAGER_H
+#define MQTT_MANAGER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// Broker connection status changes, reported from the MQTT client task
+typedef enum {
+    MQTT_STATUS_CONNECTED,
+    MQTT_STATUS_DISCONNECTED,
+} mqtt_status_t;
+
+// Broker connections: transport connect (TLS handshake included) to CONNACK
+typedef struct {
+    uint32_t last_ms;           // Last connect; 0 until the first one
+    uint32_t count;             // Connects since boot
+    uint32_t sessions_kept;     // Of which found the persistent session with
+                                // its subscriptions at the broker
+} mqtt_connect_stats_t;
+
+typedef void (*mqtt_status_cb_t)(mqtt_status_t status);
+
+// Create the client (does not connect yet)
+void mqtt_manager_init(mqtt_status_cb_t cb);
+
+// Start connecting; the client reconnects on its own after that
+void mqtt_manager_start(void);
+
+bool mqtt_manager_is_connected(void);
+
+// Publish with QoS 1 and time the broker's PUBACK. Returns the message id,
+// or -1 when not connected.
+int mqtt_manager_publish_timed(const char *topic, const uint8_t *payload, size_t len);
+
+// Publish-to-PUBACK time of the last acknowledged timed publish, 0 if none yet
+uint32_t mqtt_manager_get_rtt_us(void);
+
+void mqtt_manager_get_connect_stats(mqtt_connect_stats_t *out);
+
+// Queue a message without waiting for the network. While the broker is
+// unreachable it goes to the publish journal, which keeps the latest
+// message per topic and replays them in batches after reconnecting (returns
+// 0); otherwise to the client outbox (returns the message id). Negative if
+// neither took it.
+int mqtt_manager_enqueue(const char *topic, const uint8_t *payload, size_t len, int qos, bool retain);
+
+// Bytes currently held in the client outbox (unsent or unacknowledged)
+int mqtt_manager_get_outbox_size(void);
+
+#endif // MQTT_MANAGER_H
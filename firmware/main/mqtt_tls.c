@@ -0,0 +1,466 @@
+#include "mqtt_tls.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "esp_crt_bundle.h"
+#include "lwip/sockets.h"
+#include "lwip/netdb.h"
+#include "mbedtls/ssl.h"
+#include "mbedtls/net_sockets.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/platform.h"
+#include "mbedtls/platform_util.h"
+#include <inttypes.h>
+
+static const char *TAG = "MQTT_TLS";
+
+#define TLS_DEFAULT_PORT    8883
+// Serialized session: parameters, ticket and, with
+// CONFIG_MBEDTLS_SSL_KEEP_PEER_CERTIFICATE, the server certificate
+#define TLS_SESSION_MAX     2048
+#define TLS_SESSION_MAGIC   0x544c5353  // "TLSS"
+
+// Last session of the broker, in RTC memory: kept over reconnects and soft
+// resets (panic, watchdog, esp_restart(), OTA reboot), lost on power-up,
+// when its magic and CRC no longer match
+typedef struct {
+    uint32_t magic;
+    uint32_t peer_crc;          // Of "host:port"
+    uint32_t len;
+    uint32_t crc;               // Of data[0..len)
+    uint8_t data[TLS_SESSION_MAX];
+} tls_session_cache_t;
+
+static RTC_NOINIT_ATTR tls_session_cache_t session_cache;
+
+typedef struct {
+    mbedtls_net_context net;
+    mbedtls_ssl_context ssl;
+    mbedtls_ssl_config conf;
+    bool open;
+} tls_conn_t;
+
+static mbedtls_entropy_context entropy;
+static mbedtls_ctr_drbg_context drbg;
+static bool drbg_ready = false;
+
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static mqtt_tls_stats_t stats;
+
+// ==================== mbedTLS heap accounting ====================
+
+#if defined(MBEDTLS_PLATFORM_MEMORY) && !defined(MBEDTLS_PLATFORM_CALLOC_MACRO)
+// Each block is prefixed by its size; 8 bytes keep the payload aligned
+#define TLS_ALLOC_HDR 8
+
+#if CONFIG_MBEDTLS_EXTERNAL_MEM_ALLOC
+#define TLS_ALLOC_CAPS (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#elif CONFIG_MBEDTLS_DEFAULT_MEM_ALLOC
+#define TLS_ALLOC_CAPS MALLOC_CAP_DEFAULT
+#else
+#define TLS_ALLOC_CAPS (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#endif
+
+static portMUX_TYPE heap_lock = portMUX_INITIALIZER_UNLOCKED;
+static size_t heap_in_use = 0;
+static size_t heap_peak = 0;
+
+static void *tls_calloc(size_t n, size_t size)
+{
+    if (size != 0 && n > (SIZE_MAX - TLS_ALLOC_HDR) / size) return NULL;
+    size_t bytes = n * size;
+    uint8_t *p = heap_caps_calloc(1, TLS_ALLOC_HDR + bytes, TLS_ALLOC_CAPS);
+    if (p == NULL) return NULL;
+    *(size_t *)p = bytes;
+
+    portENTER_CRITICAL(&heap_lock);
+    heap_in_use += bytes;
+    if (heap_in_use > heap_peak) heap_peak = heap_in_use;
+    portEXIT_CRITICAL(&heap_lock);
+    return p + TLS_ALLOC_HDR;
+}
+
+static void tls_free(void *ptr)
+{
+    if (ptr == NULL) return;
+    uint8_t *p = (uint8_t *)ptr - TLS_ALLOC_HDR;
+
+    portENTER_CRITICAL(&heap_lock);
+    heap_in_use -= *(size_t *)p;
+    portEXIT_CRITICAL(&heap_lock);
+    heap_caps_free(p);
+}
+
+// The peak from here on covers what the handshake adds to what is held
+// already (other TLS connections, the WiFi supplicant)
+static void heap_peak_reset(void)
+{
+    portENTER_CRITICAL(&heap_lock);
+    heap_peak = heap_in_use;
+    portEXIT_CRITICAL(&heap_lock);
+}
+
+static uint32_t heap_peak_get(void)
+{
+    portENTER_CRITICAL(&heap_lock);
+    size_t peak = heap_peak;
+    portEXIT_CRITICAL(&heap_lock);
+    return (uint32_t)peak;
+}
+
+void mqtt_tls_init(void)
+{
+    mbedtls_platform_set_calloc_free(tls_calloc, tls_free);
+}
+#else
+// Allocations are fixed at build time; the peak is not measured
+static void heap_peak_reset(void)
+{
+}
+
+static uint32_t heap_peak_get(void)
+{
+    return 0;
+}
+
+void mqtt_tls_init(void)
+{
+}
+#endif
+
+// ==================== Session cache ====================
+
+static uint32_t peer_crc(const char *host, int port)
+{
+    char peer[128];
+    int n = snprintf(peer, sizeof(peer), "%s:%d", host, port);
+    if (n < 0) n = 0;
+    if ((size_t)n >= sizeof(peer)) n = sizeof(peer) - 1;
+    return esp_rom_crc32_le(0, (const uint8_t *)peer, (uint32_t)n);
+}
+
+static bool cache_valid(uint32_t peer)
+{
+    return session_cache.magic == TLS_SESSION_MAGIC && session_cache.peer_crc == peer &&
+           session_cache.len > 0 && session_cache.len <= TLS_SESSION_MAX &&
+           session_cache.crc == esp_rom_crc32_le(0, session_cache.data, session_cache.len);
+}
+
+static void cache_clear(void)
+{
+    mbedtls_platform_zeroize(&session_cache, sizeof(session_cache));
+}
+
+static void cache_store(mbedtls_ssl_context *ssl, uint32_t peer)
+{
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+    size_t len = 0;
+    int ret = mbedtls_ssl_get_session(ssl, &session);
+    if (ret == 0) ret = mbedtls_ssl_session_save(&session, session_cache.data, TLS_SESSION_MAX, &len);
+    mbedtls_ssl_session_free(&session);
+
+    if (ret != 0) {
+        ESP_LOGW(TAG, "Session not cached: -0x%04x", (unsigned)-ret);
+        cache_clear();
+        return;
+    }
+    session_cache.magic = TLS_SESSION_MAGIC;
+    session_cache.peer_crc = peer;
+    session_cache.len = (uint32_t)len;
+    session_cache.crc = esp_rom_crc32_le(0, session_cache.data, (uint32_t)len);
+}
+
+// Offer the cached session; its master secret goes to *master so that
+// the handshake can be told apart from a full one afterwards
+static bool cache_offer(mbedtls_ssl_context *ssl, uint32_t peer, unsigned char master[48])
+{
+    if (!cache_valid(peer)) return false;
+
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+    int ret = mbedtls_ssl_session_load(&session, session_cache.data, session_cache.len);
+    if (ret == 0) ret = mbedtls_ssl_set_session(ssl, &session);
+    if (ret == 0) memcpy(master, session.MBEDTLS_PRIVATE(master), 48);
+    mbedtls_ssl_session_free(&session);
+
+    if (ret != 0) {
+        // From another mbedTLS build (OTA update) or configuration
+        cache_clear();
+        return false;
+    }
+    return true;
+}
+
+// A resumed handshake keeps the master secret of the session it resumed
+static bool session_resumed(mbedtls_ssl_context *ssl, const unsigned char master[48])
+{
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+    bool same = mbedtls_ssl_get_session(ssl, &session) == 0 &&
+                memcmp(session.MBEDTLS_PRIVATE(master), master, 48) == 0;
+    mbedtls_ssl_session_free(&session);
+    return same;
+}
+
+// ==================== Socket ====================
+
+static int wait_fd(int fd, bool write, int timeout_ms)
+{
+    fd_set set;
+    FD_ZERO(&set);
+    FD_SET(fd, &set);
+    struct timeval tv = {
+        .tv_sec = timeout_ms / 1000,
+        .tv_usec = (timeout_ms % 1000) * 1000,
+    };
+    return select(fd + 1, write ? NULL : &set, write ? &set : NULL, NULL, timeout_ms < 0 ? NULL : &tv);
+}
+
+// mbedtls_net_connect() cannot time out, so the socket is connected here
+// and handed over
+static int tcp_connect(const char *host, int port, int timeout_ms)
+{
+    char port_str[8];
+    snprintf(port_str, sizeof(port_str), "%d", port);
+    struct addrinfo hints = {
+        .ai_family = AF_UNSPEC,
+        .ai_socktype = SOCK_STREAM,
+    };
+    struct addrinfo *res = NULL;
+    if (getaddrinfo(host, port_str, &hints, &res) != 0 || res == NULL) {
+        ESP_LOGE(TAG, "Cannot resolve %s", host);
+        return -1;
+    }
+
+    int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (fd >= 0) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+        int ret = connect(fd, res->ai_addr, res->ai_addrlen);
+        if (ret != 0 && errno == EINPROGRESS && wait_fd(fd, true, timeout_ms) > 0) {
+            int err = 0;
+            socklen_t len = sizeof(err);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len);
+            ret = err == 0 ? 0 : -1;
+        }
+        if (ret == 0) {
+            fcntl(fd, F_SETFL, flags & ~O_NONBLOCK);
+        } else {
+            ESP_LOGE(TAG, "Cannot connect to %s:%d", host, port);
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+// ==================== Transport ====================
+
+static void tls_conn_free(tls_conn_t *c)
+{
+    if (!c->open) return;
+    mbedtls_ssl_free(&c->ssl);
+    mbedtls_ssl_config_free(&c->conf);
+    mbedtls_net_free(&c->net);
+    c->open = false;
+}
+
+static int tls_connect(esp_transport_handle_t t, const char *host, int port, int timeout_ms)
+{
+    tls_conn_t *c = esp_transport_get_context_data(t);
+    tls_conn_free(c);
+
+    mbedtls_net_init(&c->net);
+    mbedtls_ssl_init(&c->ssl);
+    mbedtls_ssl_config_init(&c->conf);
+    c->open = true;
+
+    int64_t start_us = esp_timer_get_time();
+    heap_peak_reset();
+
+    int ret = mbedtls_ssl_config_defaults(&c->conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                          MBEDTLS_SSL_PRESET_DEFAULT);
+    if (ret == 0) {
+        mbedtls_ssl_conf_authmode(&c->conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+        mbedtls_ssl_conf_rng(&c->conf, mbedtls_ctr_drbg_random, &drbg);
+        mbedtls_ssl_conf_read_timeout(&c->conf, timeout_ms);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+        mbedtls_ssl_conf_session_tickets(&c->conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+        ret = esp_crt_bundle_attach(&c->conf) == ESP_OK ? 0 : -1;
+    }
+    if (ret == 0) ret = mbedtls_ssl_setup(&c->ssl, &c->conf);
+    if (ret == 0) ret = mbedtls_ssl_set_hostname(&c->ssl, host);
+    if (ret != 0) {
+        ESP_LOGE(TAG, "Setup failed: -0x%04x", (unsigned)-ret);
+        tls_conn_free(c);
+        return -1;
+    }
+
+    c->net.fd = tcp_connect(host, port, timeout_ms);
+    if (c->net.fd < 0) {
+        tls_conn_free(c);
+        return -1;
+    }
+    mbedtls_ssl_set_bio(&c->ssl, &c->net, mbedtls_net_send, NULL, mbedtls_net_recv_timeout);
+
+    uint32_t peer = peer_crc(host, port);
+    unsigned char master[48];
+    bool offered = false;
+#if CONFIG_MQTT_TLS_SESSION_RESUME
+    offered = cache_offer(&c->ssl, peer, master);
+#endif
+
+    while ((ret = mbedtls_ssl_handshake(&c->ssl)) != 0) {
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) break;
+    }
+    if (ret != 0) {
+        ESP_LOGE(TAG, "Handshake with %s failed: -0x%04x", host, (unsigned)-ret);
+        if (offered) cache_clear();
+        tls_conn_free(c);
+        mbedtls_platform_zeroize(master, sizeof(master));
+        return -1;
+    }
+
+    bool resumed = offered && session_resumed(&c->ssl, master);
+    mbedtls_platform_zeroize(master, sizeof(master));
+#if CONFIG_MQTT_TLS_SESSION_RESUME
+    // Tickets are single-use at some servers; keep the one from this handshake
+    cache_store(&c->ssl, peer);
+#endif
+
+    uint32_t elapsed_ms = (uint32_t)((esp_timer_get_time() - start_us) / 1000);
+    portENTER_CRITICAL(&stats_lock);
+    stats.handshakes++;
+    if (resumed) stats.resumed++;
+    stats.last_ms = elapsed_ms;
+    stats.heap_peak = heap_peak_get();
+    portEXIT_CRITICAL(&stats_lock);
+
+    ESP_LOGI(TAG, "%s handshake with %s in %" PRIu32 " ms, %s", resumed ? "Resumed" : "Full", host, elapsed_ms,
+             mbedtls_ssl_get_ciphersuite(&c->ssl));
+    return 0;
+}
+
+static int tls_poll_read(esp_transport_handle_t t, int timeout_ms)
+{
+    tls_conn_t *c = esp_transport_get_context_data(t);
+    if (!c->open) return -1;
+    // Records already decrypted do not show on the socket
+    if (mbedtls_ssl_get_bytes_avail(&c->ssl) > 0) return 1;
+    return wait_fd(c->net.fd, false, timeout_ms);
+}
+
+static int tls_poll_write(esp_transport_handle_t t, int timeout_ms)
+{
+    tls_conn_t *c = esp_transport_get_context_data(t);
+    if (!c->open) return -1;
+    return wait_fd(c->net.fd, true, timeout_ms);
+}
+
+static int tls_read(esp_transport_handle_t t, char *buffer, int len, int timeout_ms)
+{
+    tls_conn_t *c = esp_transport_get_context_data(t);
+    if (!c->open) return ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+
+    int ready = tls_poll_read(t, timeout_ms);
+    if (ready == 0) return ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT;
+    if (ready < 0) return ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+
+    // The rest of a record that has started to arrive; 0 would block forever
+    mbedtls_ssl_conf_read_timeout(&c->conf, timeout_ms > 0 ? timeout_ms : 1);
+    int ret = mbedtls_ssl_read(&c->ssl, (unsigned char *)buffer, len);
+    if (ret > 0) return ret;
+    if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE || ret == MBEDTLS_ERR_SSL_TIMEOUT) {
+        return ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT;
+    }
+    if (ret == 0 || ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY) return ERR_TCP_TRANSPORT_CONNECTION_CLOSED_BY_FIN;
+    ESP_LOGE(TAG, "Read failed: -0x%04x", (unsigned)-ret);
+    return ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+}
+
+static int tls_write(esp_transport_handle_t t, const char *buffer, int len, int timeout_ms)
+{
+    tls_conn_t *c = esp_transport_get_context_data(t);
+    if (!c->open) return ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+
+    int ready = tls_poll_write(t, timeout_ms);
+    if (ready == 0) return ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT;
+    if (ready < 0) return ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+
+    int ret = mbedtls_ssl_write(&c->ssl, (const unsigned char *)buffer, len);
+    if (ret >= 0) return ret;
+    if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+        return ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT;
+    }
+    ESP_LOGE(TAG, "Write failed: -0x%04x", (unsigned)-ret);
+    return ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+}
+
+static int tls_close(esp_transport_handle_t t)
+{
+    tls_conn_t *c = esp_transport_get_context_data(t);
+    if (c->open) mbedtls_ssl_close_notify(&c->ssl);
+    tls_conn_free(c);
+    return 0;
+}
+
+static int tls_destroy(esp_transport_handle_t t)
+{
+    tls_close(t);
+    free(esp_transport_get_context_data(t));
+    return 0;
+}
+
+esp_transport_handle_t mqtt_tls_transport_create(void)
+{
+    if (!drbg_ready) {
+        mbedtls_entropy_init(&entropy);
+        mbedtls_ctr_drbg_init(&drbg);
+        int ret = mbedtls_ctr_drbg_seed(&drbg, mbedtls_entropy_func, &entropy, NULL, 0);
+        if (ret != 0) {
+            ESP_LOGE(TAG, "DRBG seed failed: -0x%04x", (unsigned)-ret);
+            return NULL;
+        }
+        drbg_ready = true;
+    }
+
+    tls_conn_t *c = calloc(1, sizeof(*c));
+    esp_transport_handle_t t = c ? esp_transport_init() : NULL;
+    if (t == NULL) {
+        free(c);
+        return NULL;
+    }
+    esp_transport_set_context_data(t, c);
+    esp_transport_set_func(t, tls_connect, tls_read, tls_write, tls_close, tls_poll_read, tls_poll_write,
+                           tls_destroy);
+    esp_transport_set_default_port(t, TLS_DEFAULT_PORT);
+
+#if CONFIG_MQTT_TLS_SESSION_RESUME
+    if (session_cache.magic == TLS_SESSION_MAGIC) {
+        ESP_LOGI(TAG, "Session of the last connection kept over the reset");
+    }
+#else
+    cache_clear();
+#endif
+    return t;
+}
+
+void mqtt_tls_get_stats(mqtt_tls_stats_t *out)
+{
+    portENTER_CRITICAL(&stats_lock);
+    *out = stats;
+    portEXIT_CRITICAL(&stats_lock);
+}
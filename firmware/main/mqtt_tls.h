@@ -0,0 +1,28 @@
+#ifndef MQTT_TLS_H
+#define MQTT_TLS_H
+
+#include <stdint.h>
+#include "esp_transport.h"
+
+// TLS handshakes of the MQTT transport
+typedef struct {
+    uint32_t handshakes;        // Since boot
+    uint32_t resumed;           // Of which resumed a cached session
+    uint32_t last_ms;           // TCP connect plus handshake, 0 until the first one
+    uint32_t heap_peak;         // mbedTLS heap high-water mark during the last one
+} mqtt_tls_stats_t;
+
+// Route mbedTLS allocations through the heap accounting of the
+// handshake statistics. Call first thing in app_main: memory allocated
+// by mbedTLS before this (the WiFi supplicant uses it) could not be
+// freed afterwards.
+void mqtt_tls_init(void);
+
+// Transport for mqtts:// brokers: mbedTLS verified against the
+// certificate bundle, resuming the last session through a cache in RTC
+// memory that survives reconnects and soft resets
+esp_transport_handle_t mqtt_tls_transport_create(void);
+
+void mqtt_tls_get_stats(mqtt_tls_stats_t *out);
+
+#endif // MQTT_TLS_H
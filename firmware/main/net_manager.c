@@ -0,0 +1,184 @@
+#include "net_manager.h"
+#include "wifi_manager.h"
+#include "mqtt_manager.h"
+#include "local_link.h"
+#include "ui.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "esp_sntp.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include <inttypes.h>
+
+static const char *TAG = "NET";
+
+#define NET_TASK_STACK      4096
+#define NET_TASK_PRIO       4
+#define NET_QUEUE_LEN       8
+
+// Events fed into the state machine by the WiFi and MQTT callbacks
+typedef enum {
+    NET_EVT_WIFI_UP,
+    NET_EVT_WIFI_DOWN,
+    NET_EVT_WIFI_FAILED,
+    NET_EVT_MQTT_UP,
+    NET_EVT_MQTT_DOWN,
+} net_event_t;
+
+static QueueHandle_t s_net_queue = NULL;
+static EventGroupHandle_t s_network_event_group = NULL;
+static volatile net_state_t s_state = NET_STATE_IDLE;
+static uint32_t s_backoff_round = 0;    // Failed rounds since WiFi was last up
+static uint32_t s_backoff_ms = 0;
+
+static void net_post(net_event_t evt)
+{
+    if (xQueueSend(s_net_queue, &evt, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "Event queue full, event %d dropped", evt);
+    }
+}
+
+static void net_on_wifi_status(wifi_status_t status)
+{
+    switch (status) {
+        case WIFI_STATUS_CONNECTED:    net_post(NET_EVT_WIFI_UP); break;
+        case WIFI_STATUS_DISCONNECTED: net_post(NET_EVT_WIFI_DOWN); break;
+        case WIFI_STATUS_FAILED:       net_post(NET_EVT_WIFI_FAILED); break;
+    }
+}
+
+static void net_on_mqtt_status(mqtt_status_t status)
+{
+    net_post(status == MQTT_STATUS_CONNECTED ? NET_EVT_MQTT_UP : NET_EVT_MQTT_DOWN);
+}
+
+static void net_set_state(net_state_t state)
+{
+    if (state == s_state) return;
+
+    ESP_LOGI(TAG, "%s -> %s (t=%" PRId64 " ms)", net_manager_state_name(s_state),
+             net_manager_state_name(state), esp_timer_get_time() / 1000);
+    s_state = state;
+
+    EventBits_t set = 0;
+    if (state == NET_STATE_MQTT_CONNECTING || state == NET_STATE_ONLINE) set |= NET_WIFI_CONNECTED_BIT;
+    if (state == NET_STATE_ONLINE) set |= NET_MQTT_CONNECTED_BIT;
+    xEventGroupClearBits(s_network_event_group, (NET_WIFI_CONNECTED_BIT | NET_MQTT_CONNECTED_BIT) & ~set);
+    xEventGroupSetBits(s_network_event_group, set);
+
+    ui_update_network_state_async((set & NET_WIFI_CONNECTED_BIT) != 0, (set & NET_MQTT_CONNECTED_BIT) != 0);
+}
+
+// Exponential from CONFIG_NET_RETRY_INTERVAL_S up to
+// CONFIG_NET_RETRY_MAX_INTERVAL_S, with "equal jitter": half the interval
+// is fixed, the other half random, so devices that lost the same AP do not
+// all come back in step
+static uint32_t net_backoff_ms(uint32_t round)
+{
+    uint32_t max_ms = CONFIG_NET_RETRY_MAX_INTERVAL_S * 1000u;
+    uint32_t ms = CONFIG_NET_RETRY_INTERVAL_S * 1000u;
+    for (uint32_t i = 0; i < round && ms < max_ms; i++) ms *= 2;
+    if (ms > max_ms) ms = max_ms;
+    return ms / 2 + esp_random() % (ms / 2 + 1);
+}
+
+// The level history is keyed on the wall clock. Started once; lwIP then
+// resynchronises by itself every CONFIG_LWIP_SNTP_UPDATE_DELAY.
+static void net_time_start(void)
+{
+    if (sntp_enabled()) return;
+    sntp_setoperatingmode(SNTP_OPMODE_POLL);
+    sntp_setservername(0, CONFIG_SNTP_SERVER);
+    sntp_init();
+    ESP_LOGI(TAG, "SNTP via %s", CONFIG_SNTP_SERVER);
+}
+
+static void net_task(void *pvParameter)
+{
+    // Bring-up that used to block app_main
+    wifi_init();
+    wifi_set_status_callback(net_on_wifi_status);
+    mqtt_manager_init(net_on_mqtt_status);
+
+    net_set_state(NET_STATE_WIFI_CONNECTING);
+    wifi_start(CONFIG_WIFI_SSID, CONFIG_WIFI_PASSWORD);
+
+    while (1) {
+        // Only the backoff state has a deadline; everything else is event driven
+        TickType_t wait = s_state == NET_STATE_WIFI_BACKOFF ? pdMS_TO_TICKS(s_backoff_ms) : portMAX_DELAY;
+        net_event_t evt;
+        if (xQueueReceive(s_net_queue, &evt, wait) != pdTRUE) {
+            // Backoff elapsed
+            net_set_state(NET_STATE_WIFI_CONNECTING);
+            wifi_retry();
+            continue;
+        }
+
+        switch (evt) {
+            case NET_EVT_WIFI_UP:
+                s_backoff_round = 0;
+                net_time_start();
+                net_set_state(mqtt_manager_is_connected() ? NET_STATE_ONLINE : NET_STATE_MQTT_CONNECTING);
+                // The client keeps reconnecting by itself once started
+                mqtt_manager_start();
+#if CONFIG_LOCAL_LINK
+                local_link_start();
+#endif
+                break;
+
+            case NET_EVT_WIFI_DOWN:
+                net_set_state(NET_STATE_WIFI_CONNECTING);
+                break;
+
+            case NET_EVT_WIFI_FAILED:
+                s_backoff_ms = net_backoff_ms(s_backoff_round++);
+                ESP_LOGW(TAG, "WiFi unavailable, retrying in %" PRIu32 " ms", s_backoff_ms);
+                net_set_state(NET_STATE_WIFI_BACKOFF);
+                break;
+
+            case NET_EVT_MQTT_UP:
+                if (s_state == NET_STATE_MQTT_CONNECTING) {
+                    net_set_state(NET_STATE_ONLINE);
+                }
+                break;
+
+            case NET_EVT_MQTT_DOWN:
+                if (s_state == NET_STATE_ONLINE) {
+                    net_set_state(NET_STATE_MQTT_CONNECTING);
+                }
+                break;
+        }
+    }
+}
+
+void net_manager_start(void)
+{
+    s_network_event_group = xEventGroupCreate();
+    s_net_queue = xQueueCreate(NET_QUEUE_LEN, sizeof(net_event_t));
+    assert(s_network_event_group && s_net_queue);
+
+    xTaskCreatePinnedToCore(net_task, "net_task", NET_TASK_STACK, NULL, NET_TASK_PRIO, NULL, 0);
+}
+
+EventGroupHandle_t net_manager_get_event_group(void)
+{
+    return s_network_event_group;
+}
+
+net_state_t net_manager_get_state(void)
+{
+    return s_state;
+}
+
+const char *net_manager_state_name(net_state_t state)
+{
+    switch (state) {
+        case NET_STATE_IDLE:            return "idle";
+        case NET_STATE_WIFI_CONNECTING: return "wifi-connecting";
+        case NET_STATE_WIFI_BACKOFF:    return "wifi-backoff";
+        case NET_STATE_MQTT_CONNECTING: return "mqtt-connecting";
+        case NET_STATE_ONLINE:          return "online";
+    }
+    return "?";
+}
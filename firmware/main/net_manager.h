@@ -0,0 +1,29 @@
+#ifndef NET_MANAGER_H
+#define NET_MANAGER_H
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+// Bits of the network event group
+#define NET_WIFI_CONNECTED_BIT  BIT0
+#define NET_MQTT_CONNECTED_BIT  BIT1
+
+typedef enum {
+    NET_STATE_IDLE,
+    NET_STATE_WIFI_CONNECTING,
+    NET_STATE_WIFI_BACKOFF,     // Retries exhausted, waiting before the next round
+    NET_STATE_MQTT_CONNECTING,  // WiFi up, broker not (yet) reachable
+    NET_STATE_ONLINE,           // WiFi and MQTT connected
+} net_state_t;
+
+// Create the connection task; WiFi and MQTT come up in the background.
+// Returns immediately.
+void net_manager_start(void);
+
+// Event group with NET_*_BIT, valid after net_manager_start()
+EventGroupHandle_t net_manager_get_event_group(void);
+
+net_state_t net_manager_get_state(void);
+const char *net_manager_state_name(net_state_t state);
+
+#endif // NET_MANAGER_H
@@ -0,0 +1,632 @@
+#include "ota_manager.h"
+#include "net_manager.h"
+#include "mqtt_manager.h"
+#include "mqtt_router.h"
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+#include "spi_flash_mmap.h"
+#include "esp_http_client.h"
+#include "esp_crt_bundle.h"
+#include "esp_rom_crc.h"
+#include "esp_system.h"
+#include "nvs.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/pk.h"
+#include "rom/miniz.h"
+#include "freertos/task.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static const char *TAG = "OTA";
+
+// Without server verification anyone on the path could serve the image
+#if CONFIG_ESP_TLS_SKIP_SERVER_CERT_VERIFY
+#error "OTA downloads need ESP_TLS_SKIP_SERVER_CERT_VERIFY disabled"
+#endif
+
+#define OTA_TOPIC           "sensecap/indicator/ota"
+#define OTA_STATUS_TOPIC    "sensecap/indicator/ota/status"
+
+#define OTA_TASK_STACK      8192
+#define OTA_TASK_PRIO       3
+#define OTA_VERIFY_STACK    3072
+
+#define OTA_MAGIC           0x544F3144u     // "D1OT"
+#define OTA_VERSION         2               // 1 was unsigned
+#define OTA_SIG_MAX         72              // DER ECDSA P-256 signature, at most
+#define OTA_MAX_BLOCKS      128
+#define OTA_URL_MAX         256
+#define OTA_READ_CHUNK      4096
+#define OTA_HTTP_TIMEOUT_MS 10000
+#define OTA_NVS_NAMESPACE   "ota"
+
+// File layout written by tools/mkota.py, little endian: header, block
+// table, signature, blocks
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t block_count;
+    uint32_t block_size;        // Image bytes per block, the last one may be shorter
+    uint32_t image_size;
+    uint8_t image_sha256[32];
+} ota_file_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t offset;            // Of the zlib stream in the file
+    uint32_t size;              // Compressed bytes
+    uint32_t crc32;             // Of the inflated block
+} ota_file_block_t;
+
+// ECDSA P-256 over the SHA-256 of header and block table. The header holds
+// the SHA-256 of the image, so this signs the image too.
+typedef struct __attribute__((packed)) {
+    uint8_t len;
+    uint8_t der[OTA_SIG_MAX];   // Zero padded
+} ota_file_signature_t;
+
+// Public half of the signing key, main/CMakeLists.txt embeds CONFIG_OTA_VERIFY_KEY
+extern const uint8_t ota_verify_key_start[] asm("_binary_ota_verify_key_pem_start");
+extern const uint8_t ota_verify_key_end[] asm("_binary_ota_verify_key_pem_end");
+
+// Progress of an unfinished download, in NVS
+typedef struct {
+    uint8_t image_sha256[32];
+    uint32_t target_address;
+    uint32_t next_block;
+} ota_journal_t;
+
+typedef struct {
+    esp_http_client_handle_t http;
+    uint32_t pos;               // File offset of the next byte read
+    int64_t range_start;        // First byte of the response's Content-Range, -1 if none
+} ota_stream_t;
+
+// Working memory of one download, allocated only while it runs
+typedef struct {
+    tinfl_decompressor inflator;
+    uint8_t dict[TINFL_LZ_DICT_SIZE];
+    uint8_t in[OTA_READ_CHUNK];
+} ota_buffers_t;
+
+static char ota_url[OTA_URL_MAX];
+static volatile bool ota_busy = false;
+static volatile bool ota_confirmed = true;
+
+static ota_file_header_t header;
+static ota_file_block_t blocks[OTA_MAX_BLOCKS];
+static ota_file_signature_t signature;
+
+// Errors worth another attempt; anything else means the file or the flash is bad
+#define OTA_ERR_NETWORK     ESP_FAIL
+
+static void publish_status(const char *state, int pct)
+{
+    char msg[48];
+    int len = snprintf(msg, sizeof(msg), "{\"state\":\"%s\",\"pct\":%d}", state, pct);
+    mqtt_manager_enqueue(OTA_STATUS_TOPIC, (const uint8_t *)msg, (size_t)len, 1, false);
+}
+
+// ============================================================================
+// NVS: URL and journal of the download in progress
+// ============================================================================
+
+static bool journal_load(ota_journal_t *journal)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(OTA_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) return false;
+    size_t len = sizeof(*journal);
+    esp_err_t err = nvs_get_blob(nvs, "journal", journal, &len);
+    nvs_close(nvs);
+    return err == ESP_OK && len == sizeof(*journal);
+}
+
+static void journal_save(const ota_journal_t *journal)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(OTA_NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) return;
+    if (nvs_set_blob(nvs, "journal", journal, sizeof(*journal)) == ESP_OK) nvs_commit(nvs);
+    nvs_close(nvs);
+}
+
+static void url_save(const char *url)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(OTA_NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) return;
+    if (nvs_set_str(nvs, "url", url) == ESP_OK) nvs_commit(nvs);
+    nvs_close(nvs);
+}
+
+static bool url_load(char *url, size_t size)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(OTA_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) return false;
+    esp_err_t err = nvs_get_str(nvs, "url", url, &size);
+    nvs_close(nvs);
+    return err == ESP_OK;
+}
+
+// The download is over, for better or worse: nothing left to resume
+static void ota_forget(void)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(OTA_NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) return;
+    nvs_erase_all(nvs);
+    nvs_commit(nvs);
+    nvs_close(nvs);
+}
+
+// ============================================================================
+// HTTP stream
+// ============================================================================
+
+static void stream_close(ota_stream_t *s)
+{
+    if (s->http == NULL) return;
+    esp_http_client_close(s->http);
+    esp_http_client_cleanup(s->http);
+    s->http = NULL;
+}
+
+// Read exactly len bytes
+static esp_err_t stream_read(ota_stream_t *s, void *buf, uint32_t len)
+{
+    uint8_t *p = buf;
+    while (len > 0) {
+        int n = esp_http_client_read(s->http, (char *)p, (int)len);
+        if (n <= 0) {
+            ESP_LOGW(TAG, "Connection lost at byte %" PRIu32, s->pos);
+            return OTA_ERR_NETWORK;
+        }
+        p += n;
+        len -= (uint32_t)n;
+        s->pos += (uint32_t)n;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t stream_skip(ota_stream_t *s, uint32_t to, uint8_t *scratch)
+{
+    while (s->pos < to) {
+        uint32_t n = to - s->pos < OTA_READ_CHUNK ? to - s->pos : OTA_READ_CHUNK;
+        esp_err_t err = stream_read(s, scratch, n);
+        if (err != ESP_OK) return err;
+    }
+    return ESP_OK;
+}
+
+// First byte of "bytes <first>-<last>/<size>", -1 if it is not that
+static int64_t content_range_start(const char *value)
+{
+    if (strncasecmp(value, "bytes ", 6) != 0 || value[6] < '0' || value[6] > '9') return -1;
+    char *end;
+    unsigned long long first = strtoull(value + 6, &end, 10);
+    return *end == '-' && first <= UINT32_MAX ? (int64_t)first : -1;
+}
+
+// The client only hands out response headers as events
+static esp_err_t stream_on_event(esp_http_client_event_t *evt)
+{
+    ota_stream_t *s = evt->user_data;
+    if (evt->event_id == HTTP_EVENT_ON_HEADER && strcasecmp(evt->header_key, "Content-Range") == 0) {
+        s->range_start = content_range_start(evt->header_value);
+    }
+    return ESP_OK;
+}
+
+// Send the request, with a range from `from` if it is not 0
+static esp_err_t stream_connect(ota_stream_t *s, uint32_t from, int *status)
+{
+    esp_http_client_config_t config = {
+        .url = ota_url,
+        .timeout_ms = OTA_HTTP_TIMEOUT_MS,
+        .crt_bundle_attach = esp_crt_bundle_attach,
+        .keep_alive_enable = true,
+        .disable_auto_redirect = true,
+        .event_handler = stream_on_event,
+        .user_data = s,
+    };
+    s->range_start = -1;
+    s->http = esp_http_client_init(&config);
+    if (s->http == NULL) return ESP_ERR_NO_MEM;
+
+    if (from > 0) {
+        char range[24];
+        snprintf(range, sizeof(range), "bytes=%" PRIu32 "-", from);
+        esp_http_client_set_header(s->http, "Range", range);
+    }
+    esp_err_t err = esp_http_client_open(s->http, 0);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Cannot connect: %s", esp_err_to_name(err));
+        stream_close(s);
+        return OTA_ERR_NETWORK;
+    }
+    esp_http_client_fetch_headers(s->http);
+    *status = esp_http_client_get_status_code(s->http);
+    return ESP_OK;
+}
+
+static esp_err_t stream_open(ota_stream_t *s, uint32_t from, uint8_t *scratch)
+{
+    int status = 0;
+    esp_err_t err = stream_connect(s, from, &status);
+    if (err != ESP_OK) return err;
+
+    // A range that starts past `from`, or none at all, cannot be used;
+    // ask for the whole file and read up to `from` as after a 200
+    if (status == 206 && (s->range_start < 0 || s->range_start > from)) {
+        ESP_LOGW(TAG, "Server sent range from %" PRId64 ", not %" PRIu32 ", reading from the start",
+                 s->range_start, from);
+        stream_close(s);
+        err = stream_connect(s, 0, &status);
+        if (err != ESP_OK) return err;
+        if (status == 206 && s->range_start != 0) {
+            ESP_LOGE(TAG, "Server sent range from %" PRId64 " for the whole file", s->range_start);
+            stream_close(s);
+            return OTA_ERR_NETWORK;
+        }
+    }
+    if (status == 206 || status == 200) {
+        // 200: the server ignored the range; 206 may start before `from`
+        s->pos = status == 206 ? (uint32_t)s->range_start : 0;
+        err = stream_skip(s, from, scratch);
+        if (err != ESP_OK) stream_close(s);
+        return err;
+    }
+    ESP_LOGE(TAG, "HTTP status %d", status);
+    stream_close(s);
+    return status >= 500 ? OTA_ERR_NETWORK : ESP_ERR_NOT_FOUND;
+}
+
+// ============================================================================
+// Download
+// ============================================================================
+
+static bool header_valid(const esp_partition_t *target)
+{
+    if (header.magic != OTA_MAGIC) {
+        ESP_LOGE(TAG, "Not an OTA file");
+        return false;
+    }
+    if (header.version != OTA_VERSION) {
+        ESP_LOGE(TAG, "OTA file version %u, need %u (signed)", header.version, OTA_VERSION);
+        return false;
+    }
+    if (header.image_size == 0 || header.image_size > target->size) {
+        ESP_LOGE(TAG, "Image of %" PRIu32 " bytes does not fit %s", header.image_size, target->label);
+        return false;
+    }
+    if (header.block_size == 0 || header.block_size % SPI_FLASH_SEC_SIZE != 0 ||
+        header.block_count > OTA_MAX_BLOCKS ||
+        header.block_count != (header.image_size + header.block_size - 1) / header.block_size) {
+        ESP_LOGE(TAG, "Bad block layout");
+        return false;
+    }
+    return true;
+}
+
+// Before anything is written: was this header issued by the key holder?
+static bool signature_valid(void)
+{
+    uint8_t digest[32];
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    mbedtls_sha256_update(&sha, (const uint8_t *)&header, sizeof(header));
+    mbedtls_sha256_update(&sha, (const uint8_t *)blocks, header.block_count * sizeof(blocks[0]));
+    mbedtls_sha256_finish(&sha, digest);
+    mbedtls_sha256_free(&sha);
+
+    mbedtls_pk_context key;
+    mbedtls_pk_init(&key);
+    int ret = mbedtls_pk_parse_public_key(&key, ota_verify_key_start,
+                                          (size_t)(ota_verify_key_end - ota_verify_key_start));
+    if (ret != 0 || !mbedtls_pk_can_do(&key, MBEDTLS_PK_ECDSA)) {
+        ESP_LOGE(TAG, "Built-in verification key unusable (-0x%04x)", (unsigned)-ret);
+        mbedtls_pk_free(&key);
+        return false;
+    }
+    ret = signature.len <= OTA_SIG_MAX
+              ? mbedtls_pk_verify(&key, MBEDTLS_MD_SHA256, digest, sizeof(digest), signature.der, signature.len)
+              : -1;
+    mbedtls_pk_free(&key);
+    if (ret != 0) {
+        ESP_LOGE(TAG, "Bad signature, not an image of ours");
+        return false;
+    }
+    return true;
+}
+
+static bool partition_sha_matches(const esp_partition_t *part, uint8_t *scratch)
+{
+    uint8_t digest[32];
+    mbedtls_sha256_context ctx;
+    mbedtls_sha256_init(&ctx);
+    mbedtls_sha256_starts(&ctx, 0);
+    for (uint32_t off = 0; off < header.image_size; off += OTA_READ_CHUNK) {
+        uint32_t n = header.image_size - off < OTA_READ_CHUNK ? header.image_size - off : OTA_READ_CHUNK;
+        if (esp_partition_read(part, off, scratch, n) != ESP_OK) {
+            mbedtls_sha256_free(&ctx);
+            return false;
+        }
+        mbedtls_sha256_update(&ctx, scratch, n);
+    }
+    mbedtls_sha256_finish(&ctx, digest);
+    mbedtls_sha256_free(&ctx);
+    return memcmp(digest, header.image_sha256, sizeof(digest)) == 0;
+}
+
+// Inflate block b from the stream into its place in the target slot
+static esp_err_t write_block(ota_stream_t *s, const esp_partition_t *target, uint32_t b, ota_buffers_t *buf)
+{
+    const ota_file_block_t *blk = &blocks[b];
+    uint32_t dest = b * header.block_size;
+    uint32_t raw_len = header.image_size - dest < header.block_size ? header.image_size - dest : header.block_size;
+
+    esp_err_t err = esp_partition_erase_range(target, dest,
+                                              (raw_len + SPI_FLASH_SEC_SIZE - 1) & ~(SPI_FLASH_SEC_SIZE - 1));
+    if (err != ESP_OK) return err;
+
+    tinfl_init(&buf->inflator);
+    uint32_t in_left = blk->size;
+    const uint8_t *in_next = buf->in;
+    size_t in_avail = 0;
+    uint32_t out_pos = 0;
+    uint32_t crc = 0;
+
+    for (;;) {
+        if (in_avail == 0 && in_left > 0) {
+            uint32_t n = in_left < OTA_READ_CHUNK ? in_left : OTA_READ_CHUNK;
+            err = stream_read(s, buf->in, n);
+            if (err != ESP_OK) return err;
+            in_next = buf->in;
+            in_avail = n;
+            in_left -= n;
+        }
+
+        // The dictionary doubles as a ring buffer for the output
+        size_t in_size = in_avail;
+        size_t dict_ofs = out_pos & (TINFL_LZ_DICT_SIZE - 1);
+        size_t out_size = TINFL_LZ_DICT_SIZE - dict_ofs;
+        tinfl_status status = tinfl_decompress(&buf->inflator, in_next, &in_size, buf->dict,
+                                               buf->dict + dict_ofs, &out_size,
+                                               TINFL_FLAG_PARSE_ZLIB_HEADER |
+                                               (in_left > 0 ? TINFL_FLAG_HAS_MORE_INPUT : 0));
+        in_next += in_size;
+        in_avail -= in_size;
+
+        if (out_size > 0) {
+            if (out_size > raw_len - out_pos) {
+                ESP_LOGE(TAG, "Block %" PRIu32 " inflates past its end", b);
+                return ESP_ERR_INVALID_SIZE;
+            }
+            err = esp_partition_write(target, dest + out_pos, buf->dict + dict_ofs, out_size);
+            if (err != ESP_OK) return err;
+            crc = esp_rom_crc32_le(crc, buf->dict + dict_ofs, out_size);
+            out_pos += out_size;
+        }
+
+        if (status == TINFL_STATUS_DONE) break;
+        if (status < TINFL_STATUS_DONE || (status == TINFL_STATUS_NEEDS_MORE_INPUT && in_avail == 0 && in_left == 0)) {
+            ESP_LOGE(TAG, "Block %" PRIu32 " is corrupt (%d)", b, (int)status);
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+    }
+
+    if (out_pos != raw_len || crc != blk->crc32) {
+        ESP_LOGE(TAG, "Block %" PRIu32 " fails its check", b);
+        return ESP_ERR_INVALID_CRC;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t ota_download(ota_buffers_t *buf)
+{
+    const esp_partition_t *target = esp_ota_get_next_update_partition(NULL);
+    if (target == NULL) {
+        ESP_LOGE(TAG, "No OTA slot to update");
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    ota_stream_t s = { 0 };
+    esp_err_t err = stream_open(&s, 0, buf->in);
+    if (err != ESP_OK) return err;
+    err = stream_read(&s, &header, sizeof(header));
+    if (err == ESP_OK && !header_valid(target)) err = ESP_ERR_INVALID_RESPONSE;
+    if (err == ESP_OK) err = stream_read(&s, blocks, header.block_count * sizeof(blocks[0]));
+    if (err == ESP_OK) err = stream_read(&s, &signature, sizeof(signature));
+    if (err == ESP_OK && !signature_valid()) err = ESP_ERR_INVALID_RESPONSE;
+    if (err == ESP_OK && partition_sha_matches(esp_ota_get_running_partition(), buf->in)) {
+        ESP_LOGI(TAG, "Already running this image");
+        err = ESP_ERR_INVALID_VERSION;
+    }
+    if (err != ESP_OK) {
+        stream_close(&s);
+        return err;
+    }
+
+    // Pick up where an earlier attempt at the same image into the same slot stopped
+    ota_journal_t journal;
+    uint32_t first = 0;
+    if (journal_load(&journal) && memcmp(journal.image_sha256, header.image_sha256, sizeof(header.image_sha256)) == 0 &&
+        journal.target_address == target->address && journal.next_block <= header.block_count) {
+        first = journal.next_block;
+        ESP_LOGI(TAG, "Resuming at block %" PRIu32 " of %u", first, header.block_count);
+    } else {
+        memcpy(journal.image_sha256, header.image_sha256, sizeof(journal.image_sha256));
+        journal.target_address = target->address;
+        journal.next_block = 0;
+        journal_save(&journal);
+    }
+    ESP_LOGI(TAG, "Writing %" PRIu32 " bytes to %s", header.image_size, target->label);
+
+    if (first < header.block_count && blocks[first].offset > s.pos + OTA_READ_CHUNK) {
+        stream_close(&s);
+        err = stream_open(&s, blocks[first].offset, buf->in);
+        if (err != ESP_OK) return err;
+    }
+
+    int last_pct = -1;
+    for (uint32_t b = first; b < header.block_count; b++) {
+        if (blocks[b].offset < s.pos) {
+            ESP_LOGE(TAG, "Bad block table");
+            err = ESP_ERR_INVALID_RESPONSE;
+            break;
+        }
+        err = stream_skip(&s, blocks[b].offset, buf->in);
+        if (err != ESP_OK) break;
+        err = write_block(&s, target, b, buf);
+        if (err != ESP_OK) break;
+
+        journal.next_block = b + 1;
+        journal_save(&journal);
+
+        int pct = (int)((b + 1) * 100 / header.block_count);
+        if (pct / 10 != last_pct / 10) {
+            publish_status("downloading", pct);
+            last_pct = pct;
+        }
+    }
+    stream_close(&s);
+    if (err != ESP_OK) return err;
+
+    // The signed header vouches for this digest, and so for the image
+    if (!partition_sha_matches(target, buf->in)) {
+        ESP_LOGE(TAG, "Image SHA-256 mismatch");
+        return ESP_ERR_INVALID_CRC;
+    }
+    // Checks the image once more, as the bootloader will (with
+    // CONFIG_SECURE_SIGNED_APPS_*, its secure boot signature as well)
+    err = esp_ota_set_boot_partition(target);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Image rejected: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+static void ota_task(void *arg)
+{
+    (void)arg;
+    esp_err_t err = ESP_ERR_NO_MEM;
+    ota_buffers_t *buf = malloc(sizeof(*buf));
+
+    for (int attempt = 0; buf != NULL && attempt <= CONFIG_OTA_DOWNLOAD_RETRIES; attempt++) {
+        if (attempt > 0) {
+            ESP_LOGW(TAG, "Retrying (%d/%d)", attempt, CONFIG_OTA_DOWNLOAD_RETRIES);
+            vTaskDelay(pdMS_TO_TICKS(5000 * attempt));
+        }
+        xEventGroupWaitBits(net_manager_get_event_group(), NET_WIFI_CONNECTED_BIT, pdFALSE, pdTRUE, portMAX_DELAY);
+        err = ota_download(buf);
+        if (err != OTA_ERR_NETWORK) break;
+    }
+    free(buf);
+
+    if (err == ESP_OK) {
+        ota_forget();
+        publish_status("rebooting", 100);
+        ESP_LOGI(TAG, "Update written, rebooting");
+        vTaskDelay(pdMS_TO_TICKS(1000));
+        esp_restart();
+    }
+
+    // Network trouble keeps the journal for the next boot or request
+    if (err != OTA_ERR_NETWORK) ota_forget();
+    publish_status(err == ESP_ERR_INVALID_VERSION ? "current" : "failed", 0);
+    ESP_LOGE(TAG, "Update stopped: %s", esp_err_to_name(err));
+    ota_busy = false;
+    vTaskDelete(NULL);
+}
+
+static void ota_run(void)
+{
+    ota_busy = true;
+    if (xTaskCreatePinnedToCore(ota_task, "ota", OTA_TASK_STACK, NULL, OTA_TASK_PRIO, NULL, 0) != pdPASS) {
+        ESP_LOGE(TAG, "Cannot create the OTA task");
+        ota_busy = false;
+    }
+}
+
+// ============================================================================
+// Trigger and image confirmation
+// ============================================================================
+
+// Only certificate-checked servers; the file's own signature is checked later
+static bool url_allowed(const char *url)
+{
+    if (strncmp(url, "https://", 8) == 0) return true;
+    ESP_LOGE(TAG, "Refusing %s: OTA files are only fetched over https://", url);
+    return false;
+}
+
+// MQTT task: the payload is the URL of the OTA file
+static void on_ota_request(const char *topic, size_t topic_len, const char *data, size_t len, void *ctx)
+{
+    (void)topic;
+    (void)topic_len;
+    (void)ctx;
+    if (len == 0 || len >= sizeof(ota_url)) {
+        ESP_LOGW(TAG, "Ignoring an OTA URL of %u bytes", (unsigned)len);
+        return;
+    }
+    if (ota_busy || !ota_confirmed) {
+        ESP_LOGW(TAG, "Update already in progress");
+        return;
+    }
+    memcpy(ota_url, data, len);
+    ota_url[len] = '\0';
+    if (strlen(ota_url) != len || !url_allowed(ota_url)) {
+        publish_status("failed", 0);
+        return;
+    }
+    url_save(ota_url);
+    ESP_LOGI(TAG, "Update from %s", ota_url);
+    ota_run();
+}
+
+static void ota_verify_task(void *arg)
+{
+    (void)arg;
+    ESP_LOGW(TAG, "New image, confirming once MQTT connects (%d s)", CONFIG_OTA_ROLLBACK_TIMEOUT_S);
+    EventBits_t bits = xEventGroupWaitBits(net_manager_get_event_group(), NET_MQTT_CONNECTED_BIT, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(CONFIG_OTA_ROLLBACK_TIMEOUT_S * 1000));
+    if (!(bits & NET_MQTT_CONNECTED_BIT)) {
+        ESP_LOGE(TAG, "New image never came online, rolling back");
+        esp_ota_mark_app_invalid_rollback_and_reboot();
+    }
+    esp_ota_mark_app_valid_cancel_rollback();
+    ota_confirmed = true;
+    publish_status("confirmed", 100);
+    ESP_LOGI(TAG, "New image confirmed");
+    vTaskDelete(NULL);
+}
+
+void ota_manager_init(void)
+{
+    if (!mqtt_router_add(OTA_TOPIC, on_ota_request, NULL)) {
+        ESP_LOGE(TAG, "Cannot route %s", OTA_TOPIC);
+    }
+}
+
+void ota_manager_start(void)
+{
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    esp_ota_img_states_t state;
+    if (esp_ota_get_state_partition(running, &state) == ESP_OK && state == ESP_OTA_IMG_PENDING_VERIFY) {
+        ota_confirmed = false;
+        xTaskCreatePinnedToCore(ota_verify_task, "ota_verify", OTA_VERIFY_STACK, NULL, OTA_TASK_PRIO, NULL, 0);
+        return;
+    }
+
+    if (url_load(ota_url, sizeof(ota_url))) {
+        // Saved by an older image, which took http:// too
+        if (!url_allowed(ota_url)) {
+            ota_forget();
+            return;
+        }
+        ESP_LOGI(TAG, "Resuming the update from %s", ota_url);
+        ota_run();
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef OTA_MANAGER_H
+#define OTA_MANAGER_H
+
+// Over-the-air updates into the other app slot.
+//
+// Publishing the https:// URL of a file made by tools/mkota.py to
+// sensecap/indicator/ota starts a download. The server's certificate is
+// checked against the certificate bundle, and the file must be signed
+// with the key whose public half is built in (CONFIG_OTA_VERIFY_KEY):
+// nothing is written to flash before the signature checks out, and the
+// slot is only made bootable once the image matches the signed SHA-256.
+//
+// The file is made of independently compressed blocks that are inflated
+// straight into flash, so no copy of the image is held in RAM, and the
+// last block written is kept in NVS: a download cut short (network loss,
+// power cycle) resumes with an HTTP Range request at the next block. Bytes
+// before it that the server sends anyway (no range, or an earlier
+// Content-Range start) are skipped.
+// Progress is published to sensecap/indicator/ota/status.
+//
+// A new image boots in the bootloader's pending-verify state and is only
+// confirmed once it has reached the MQTT broker. If it crashes first, or
+// stays offline for OTA_ROLLBACK_TIMEOUT_S, the previous image comes back.
+
+// Route the OTA topic; call before net_manager_start()
+void ota_manager_init(void);
+
+// Confirm (or roll back) a freshly updated image and resume an interrupted
+// download; call after net_manager_start()
+void ota_manager_start(void);
+
+#endif // OTA_MANAGER_H
@@ -0,0 +1,152 @@
+#include "publish_journal.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "JOURNAL";
+
+typedef struct {
+    uint32_t seq;               // Order of the last put; 0 marks a free slot
+    uint16_t len;
+    uint8_t qos;
+    bool retain;
+    char topic[PUBLISH_JOURNAL_TOPIC_MAX];
+    uint8_t payload[CONFIG_PUBLISH_JOURNAL_MAX_PAYLOAD];
+} journal_entry_t;
+
+static journal_entry_t *entries = NULL;
+static SemaphoreHandle_t lock = NULL;
+static uint32_t next_seq = 1;
+static publish_journal_stats_t stats;
+// Copy of the message being replayed. A slot can be up to 4 KB, too much
+// for the esp_timer task's stack; there is one replayer, the timer.
+static journal_entry_t replay_msg;
+
+// Slot holding topic, else a free slot, else the one written longest ago
+static journal_entry_t *journal_slot_for(const char *topic)
+{
+    journal_entry_t *free_slot = NULL;
+    journal_entry_t *oldest = &entries[0];
+
+    for (size_t i = 0; i < CONFIG_PUBLISH_JOURNAL_ENTRIES; i++) {
+        journal_entry_t *e = &entries[i];
+        if (e->seq == 0) {
+            if (free_slot == NULL) free_slot = e;
+            continue;
+        }
+        if (strcmp(e->topic, topic) == 0) return e;
+        if (e->seq < oldest->seq) oldest = e;
+    }
+    return free_slot ? free_slot : oldest;
+}
+
+static journal_entry_t *journal_oldest(void)
+{
+    journal_entry_t *oldest = NULL;
+    for (size_t i = 0; i < CONFIG_PUBLISH_JOURNAL_ENTRIES; i++) {
+        journal_entry_t *e = &entries[i];
+        if (e->seq != 0 && (oldest == NULL || e->seq < oldest->seq)) oldest = e;
+    }
+    return oldest;
+}
+
+bool publish_journal_init(void)
+{
+    if (entries != NULL) return true;
+
+    size_t size = CONFIG_PUBLISH_JOURNAL_ENTRIES * sizeof(journal_entry_t);
+    entries = heap_caps_calloc_prefer(1, size, 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT,
+                                      MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (entries == NULL) {
+        ESP_LOGW(TAG, "No memory for %u byte journal, offline publishes go to the outbox", (unsigned)size);
+        return false;
+    }
+    lock = xSemaphoreCreateMutex();
+    assert(lock);
+
+    ESP_LOGI(TAG, "%d topics x %d bytes (%u bytes)", CONFIG_PUBLISH_JOURNAL_ENTRIES,
+             CONFIG_PUBLISH_JOURNAL_MAX_PAYLOAD, (unsigned)size);
+    return true;
+}
+
+bool publish_journal_put(const char *topic, const uint8_t *payload, size_t len, int qos, bool retain)
+{
+    if (entries == NULL) return false;
+
+    size_t topic_len = strlen(topic);
+    if (topic_len >= PUBLISH_JOURNAL_TOPIC_MAX || len > CONFIG_PUBLISH_JOURNAL_MAX_PAYLOAD) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        stats.rejected++;
+        xSemaphoreGive(lock);
+        return false;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    journal_entry_t *e = journal_slot_for(topic);
+    if (e->seq == 0) {
+        stats.entries++;
+    } else if (strcmp(e->topic, topic) == 0) {
+        stats.replaced++;
+    } else {
+        stats.evicted++;
+        ESP_LOGW(TAG, "Journal full, dropping unsent message of %s", e->topic);
+    }
+
+    memcpy(e->topic, topic, topic_len + 1);
+    memcpy(e->payload, payload, len);
+    e->len = (uint16_t)len;
+    e->qos = (uint8_t)qos;
+    e->retain = retain;
+    e->seq = next_seq++;
+    stats.stored++;
+    xSemaphoreGive(lock);
+    return true;
+}
+
+size_t publish_journal_count(void)
+{
+    // A torn read only delays the caller's decision by one message
+    return entries ? stats.entries : 0;
+}
+
+size_t publish_journal_replay(publish_journal_send_fn_t send, size_t max)
+{
+    if (entries == NULL) return 0;
+
+    journal_entry_t *msg = &replay_msg;
+    size_t sent = 0;
+
+    while (sent < max) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        journal_entry_t *e = journal_oldest();
+        if (e != NULL) memcpy(msg, e, sizeof(*msg));
+        xSemaphoreGive(lock);
+        if (e == NULL) break;
+
+        if (send(msg->topic, msg->payload, msg->len, msg->qos, msg->retain) < 0) break;
+
+        xSemaphoreTake(lock, portMAX_DELAY);
+        // Unless a newer message of the topic came in while sending
+        if (e->seq == msg->seq) {
+            e->seq = 0;
+            stats.entries--;
+        }
+        stats.replayed++;
+        xSemaphoreGive(lock);
+        sent++;
+    }
+    return sent;
+}
+
+void publish_journal_get_stats(publish_journal_stats_t *out)
+{
+    if (lock == NULL) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    *out = stats;
+    xSemaphoreGive(lock);
+}
@@ -0,0 +1,50 @@
+#ifndef PUBLISH_JOURNAL_H
+#define PUBLISH_JOURNAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// Messages published while the broker is unreachable.
+//
+// A fixed table of PUBLISH_JOURNAL_ENTRIES slots in PSRAM (internal RAM
+// without it) that keeps only the latest message of each topic: a put for
+// a topic already held replaces the older message. However long an outage
+// lasts, the journal never grows and a reconnect replays at most one
+// message per topic. When every slot holds another topic, the topic
+// written longest ago is dropped.
+
+#define PUBLISH_JOURNAL_TOPIC_MAX   64
+
+// Transport for replay; returns the message id or a negative value
+typedef int (*publish_journal_send_fn_t)(const char *topic, const uint8_t *payload, size_t len,
+                                         int qos, bool retain);
+
+typedef struct {
+    uint32_t stored;        // Messages put
+    uint32_t replaced;      // Of which overwrote an unsent message of their topic
+    uint32_t evicted;       // Dropped because every slot was taken
+    uint32_t rejected;      // Topic or payload too long to journal
+    uint32_t replayed;      // Handed to the transport
+    uint32_t entries;       // Held now
+} publish_journal_stats_t;
+
+// Allocate the table; false if there is no memory (put then fails)
+bool publish_journal_init(void);
+
+// Store the latest message of a topic. Safe from any task. Returns false if
+// the journal is not available or the message does not fit a slot.
+bool publish_journal_put(const char *topic, const uint8_t *payload, size_t len, int qos, bool retain);
+
+// Messages waiting for replay
+size_t publish_journal_count(void);
+
+// Hand up to max messages to send, oldest first. A message leaves the
+// journal once send accepts it; replay stops at the first refusal. send is
+// called without the journal lock held. Not reentrant: one replayer at a
+// time. Returns the number sent.
+size_t publish_journal_replay(publish_journal_send_fn_t send, size_t max);
+
+void publish_journal_get_stats(publish_journal_stats_t *out);
+
+#endif // PUBLISH_JOURNAL_H
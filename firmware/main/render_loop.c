@@ -0,0 +1,139 @@
+#include "render_loop.h"
+#include "display_driver.h"
+#include "touch_driver.h"
+#include "idle_manager.h"
+#include "ui_queue.h"
+#include "lvgl.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <inttypes.h>
+#include <stdatomic.h>
+
+static const char *TAG = "RENDER";
+
+#define RENDER_TASK_STACK   4096
+#define RENDER_TASK_PRIO    5
+// Length of the FPS / idle measurement window
+#define RENDER_STATS_WINDOW_US  1000000
+
+static TaskHandle_t render_task_handle = NULL;
+static atomic_bool input_pending = false;
+static render_loop_stats_t stats;
+
+static void render_on_input(void)
+{
+    idle_manager_activity();
+    atomic_store(&input_pending, true);
+    render_loop_wake();
+}
+
+// Park the timers whose work is known to be done, so lv_timer_handler()
+// reports no deadline and the task can block until something happens.
+// Both are resumed by LVGL itself (invalidation) or by render_on_input().
+static void render_park_idle_timers(lv_disp_t *disp, lv_timer_t *indev_timer)
+{
+    if (disp->inv_p == 0) {
+        lv_timer_pause(disp->refr_timer);
+    }
+    if (indev_timer && !touch_is_active()) {
+        lv_timer_pause(indev_timer);
+    }
+}
+
+static void render_task(void *pvParameter)
+{
+    ESP_LOGI(TAG, "LVGL task started");
+
+    lv_disp_t *disp = lv_disp_get_default();
+    lv_indev_t *indev = touch_get_indev();
+    lv_timer_t *indev_timer = indev ? lv_indev_get_read_timer(indev) : NULL;
+
+    // Render the first frame right away instead of waiting for the refresh
+    // timer, with any state queued during boot (e.g. restored from NVS)
+    ui_queue_drain();
+    lv_refr_now(NULL);
+    ESP_LOGI(TAG, "Time to interactive: %" PRId64 " ms since boot", esp_timer_get_time() / 1000);
+
+    int64_t window_start = esp_timer_get_time();
+    int64_t window_idle = 0;
+    uint32_t window_frames = display_get_frame_count();
+    uint32_t window_wakeups = 0;
+#if CONFIG_RENDER_LOOP_STATS_INTERVAL_S > 0
+    int64_t next_log = window_start + CONFIG_RENDER_LOOP_STATS_INTERVAL_S * 1000000LL;
+#endif
+
+    while (1) {
+        if (atomic_exchange(&input_pending, false) && indev_timer) {
+            lv_timer_resume(indev_timer);
+            lv_timer_ready(indev_timer);
+        }
+
+#if CONFIG_IDLE_WAKE_ON_MQTT
+        // Values from the broker wake the display, connection state does not
+        if (ui_queue_pending() & ~(1u << UI_FIELD_NETWORK_STATE)) {
+            idle_manager_activity();
+        }
+#endif
+        // Wake up before anything is drawn, or go idle
+        uint32_t idle_due = idle_manager_update();
+
+        // Apply updates posted by other tasks, coalesced per field
+        ui_queue_drain();
+        uint32_t time_till_next = lv_timer_handler();
+        if (idle_due < time_till_next) time_till_next = idle_due;
+        // The returned deadline may still belong to a timer parked here; that
+        // costs one early wakeup, after which lv_timer_handler() skips it.
+        render_park_idle_timers(disp, indev_timer);
+
+        TickType_t wait = time_till_next == LV_NO_TIMER_READY ? portMAX_DELAY : pdMS_TO_TICKS(time_till_next);
+        int64_t sleep_start = esp_timer_get_time();
+        ulTaskNotifyTake(pdTRUE, wait > 0 ? wait : 1);
+        int64_t now = esp_timer_get_time();
+        window_idle += now - sleep_start;
+        window_wakeups++;
+
+        if (now - window_start >= RENDER_STATS_WINDOW_US) {
+            uint32_t frames = display_get_frame_count();
+            int64_t elapsed = now - window_start;
+            stats.fps_x10 = (uint32_t)((int64_t)(frames - window_frames) * 10000000LL / elapsed);
+            stats.idle_pct = (uint32_t)(window_idle * 100 / elapsed);
+            stats.wakeups = window_wakeups;
+            stats.frames = frames;
+
+            window_start = now;
+            window_idle = 0;
+            window_frames = frames;
+            window_wakeups = 0;
+        }
+
+#if CONFIG_RENDER_LOOP_STATS_INTERVAL_S > 0
+        if (now >= next_log) {
+            next_log = now + CONFIG_RENDER_LOOP_STATS_INTERVAL_S * 1000000LL;
+            ESP_LOGI(TAG, "%" PRIu32 ".%" PRIu32 " FPS, %" PRIu32 "%% idle, %" PRIu32 " wakeups/s",
+                     stats.fps_x10 / 10, stats.fps_x10 % 10, stats.idle_pct, stats.wakeups);
+        }
+#endif
+    }
+}
+
+void render_loop_start(void)
+{
+    xTaskCreatePinnedToCore(render_task, "lvgl_task", RENDER_TASK_STACK, NULL,
+                            RENDER_TASK_PRIO, &render_task_handle, 1);
+    ui_queue_set_wake_cb(render_loop_wake);
+    touch_set_input_cb(render_on_input);
+}
+
+void render_loop_wake(void)
+{
+    if (render_task_handle) {
+        xTaskNotifyGive(render_task_handle);
+    }
+}
+
+void render_loop_get_stats(render_loop_stats_t *out)
+{
+    *out = stats;
+}
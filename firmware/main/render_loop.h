@@ -0,0 +1,23 @@
+#ifndef RENDER_LOOP_H
+#define RENDER_LOOP_H
+
+#include <stdint.h>
+
+// Render loop statistics over the last reporting window
+typedef struct {
+    uint32_t fps_x10;        // Completed frames per second, times 10
+    uint32_t idle_pct;       // Share of the window the LVGL task spent blocked
+    uint32_t wakeups;        // Loop iterations in the window
+    uint32_t frames;         // Frames completed since boot
+} render_loop_stats_t;
+
+// Create the LVGL task. Call once LVGL, the drivers and the UI are set up.
+void render_loop_start(void);
+
+// Wake the LVGL task early, e.g. after input or a UI queue post.
+// Safe from any task (not from ISRs).
+void render_loop_wake(void);
+
+void render_loop_get_stats(render_loop_stats_t *out);
+
+#endif // RENDER_LOOP_H
@@ -0,0 +1,63 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+
+// Lock-free single-producer / single-consumer ring of fixed-size elements.
+// One task (or ISR) may push, one other task may pop, without any locking.
+// Capacity must be a power of two; all slots are usable because head and
+// tail are free-running counters.
+
+typedef struct {
+    uint8_t *storage;
+    size_t elem_size;
+    uint32_t mask;
+    atomic_uint_fast32_t head;  // Written by the producer only
+    atomic_uint_fast32_t tail;  // Written by the consumer only
+} spsc_ring_t;
+
+// Define a ring together with its backing storage
+#define SPSC_RING_DEFINE(name, type, capacity)                                  \
+    _Static_assert(((capacity) & ((capacity) - 1)) == 0, "capacity must be a power of two"); \
+    static type name##_storage[(capacity)];                                     \
+    static spsc_ring_t name = {                                                 \
+        .storage = (uint8_t *)name##_storage,                                   \
+        .elem_size = sizeof(type),                                              \
+        .mask = (capacity) - 1,                                                 \
+    }
+
+static inline bool spsc_ring_push(spsc_ring_t *ring, const void *elem)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail > ring->mask) {
+        return false;  // Full
+    }
+    memcpy(ring->storage + (head & ring->mask) * ring->elem_size, elem, ring->elem_size);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return true;
+}
+
+static inline bool spsc_ring_pop(spsc_ring_t *ring, void *elem)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (head == tail) {
+        return false;  // Empty
+    }
+    memcpy(elem, ring->storage + (tail & ring->mask) * ring->elem_size, ring->elem_size);
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+static inline bool spsc_ring_is_empty(spsc_ring_t *ring)
+{
+    return atomic_load_explicit(&ring->head, memory_order_acquire) ==
+           atomic_load_explicit(&ring->tail, memory_order_acquire);
+}
+
+#endif // SPSC_RING_H
@@ -0,0 +1,423 @@
+#include "telemetry.h"
+#include "render_loop.h"
+#include "display_driver.h"
+#include "touch_driver.h"
+#include "touch_gesture.h"
+#include "i2c_bus.h"
+#include "mqtt_manager.h"
+#include "mqtt_tls.h"
+#include "local_link.h"
+#include "copro_link.h"
+#include "backend.h"
+#include "wifi_manager.h"
+#include "payload_codec.h"
+#include "state_persist.h"
+#include "lvgl_mem.h"
+#include "lvgl.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+static const char *TAG = "TELEMETRY";
+
+#define MQTT_TOPIC_TELEMETRY "sensecap/indicator/telemetry"
+
+#define TELEMETRY_TASK_STACK    4096
+#define TELEMETRY_TASK_PRIO     2
+#define TELEMETRY_SAMPLE_MS     1000
+// Upper bound on tasks tracked for CPU load
+#define TELEMETRY_MAX_TASKS     24
+
+static telemetry_snapshot_t snapshot;
+static portMUX_TYPE snapshot_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static lv_obj_t *hud_label = NULL;
+static lv_timer_t *hud_timer = NULL;
+
+// ==================== CPU load ====================
+
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+typedef struct {
+    UBaseType_t number;
+    uint32_t runtime;
+} task_runtime_t;
+
+static TaskStatus_t task_status[TELEMETRY_MAX_TASKS];
+static task_runtime_t prev_runtime[TELEMETRY_MAX_TASKS];
+static size_t prev_count = 0;
+static uint32_t prev_total = 0;
+
+static uint32_t prev_runtime_of(UBaseType_t number)
+{
+    for (size_t i = 0; i < prev_count; i++) {
+        if (prev_runtime[i].number == number) return prev_runtime[i].runtime;
+    }
+    return 0;
+}
+
+// Load over the last sample period: each task as a share of one core, each
+// core as 100 minus its idle task. Only the busiest tasks are kept.
+static void sample_cpu(telemetry_snapshot_t *s)
+{
+    uint32_t total;
+    UBaseType_t n = uxTaskGetSystemState(task_status, TELEMETRY_MAX_TASKS, &total);
+    uint32_t elapsed = total - prev_total;
+
+    s->task_count = 0;
+    if (n == 0 || prev_total == 0 || elapsed == 0) {
+        goto remember;
+    }
+
+    for (int core = 0; core < portNUM_PROCESSORS && core < 2; core++) {
+        TaskHandle_t idle = xTaskGetIdleTaskHandleForCore(core);
+        for (UBaseType_t i = 0; i < n; i++) {
+            if (task_status[i].xHandle == idle) {
+                uint32_t d = task_status[i].ulRunTimeCounter - prev_runtime_of(task_status[i].xTaskNumber);
+                uint32_t idle_pct = (uint32_t)((uint64_t)d * 100 / elapsed);
+                s->core_load_pct[core] = idle_pct >= 100 ? 0 : 100 - idle_pct;
+            }
+        }
+    }
+
+    for (UBaseType_t i = 0; i < n; i++) {
+        const TaskStatus_t *t = &task_status[i];
+        if (strncmp(t->pcTaskName, "IDLE", 4) == 0) continue;
+
+        uint32_t d = t->ulRunTimeCounter - prev_runtime_of(t->xTaskNumber);
+        uint64_t load = (uint64_t)d * 100 / elapsed;
+        uint8_t pct = (uint8_t)(load > 100 ? 100 : load);
+
+        // Insertion into the small sorted top list
+        int pos = s->task_count;
+        while (pos > 0 && s->tasks[pos - 1].cpu_pct < pct) pos--;
+        if (pos >= TELEMETRY_TOP_TASKS) continue;
+        int last = s->task_count < TELEMETRY_TOP_TASKS ? s->task_count : TELEMETRY_TOP_TASKS - 1;
+        memmove(&s->tasks[pos + 1], &s->tasks[pos], (last - pos) * sizeof(s->tasks[0]));
+        strlcpy(s->tasks[pos].name, t->pcTaskName, sizeof(s->tasks[pos].name));
+        s->tasks[pos].cpu_pct = pct;
+        if (s->task_count < TELEMETRY_TOP_TASKS) s->task_count++;
+    }
+
+remember:
+    prev_count = n;
+    for (UBaseType_t i = 0; i < n; i++) {
+        prev_runtime[i].number = task_status[i].xTaskNumber;
+        prev_runtime[i].runtime = task_status[i].ulRunTimeCounter;
+    }
+    prev_total = total;
+}
+#else
+static void sample_cpu(telemetry_snapshot_t *s)
+{
+    // Needs CONFIG_FREERTOS_USE_TRACE_FACILITY and
+    // CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    s->task_count = 0;
+}
+#endif
+
+// ==================== Sampling ====================
+
+static void sample_touch_i2c(telemetry_snapshot_t *s)
+{
+    for (size_t i = 0; i < i2c_bus_get_device_count(); i++) {
+        i2c_bus_device_stats_t st;
+        i2c_bus_get_stats(i2c_bus_get_device(i), &st);
+        if (strcmp(st.name, "gt911") != 0) continue;
+
+        s->touch_i2c_avg_us = st.transactions ? (uint32_t)(st.total_us / st.transactions) : 0;
+        s->touch_i2c_max_us = st.max_us;
+        s->touch_i2c_errors = st.errors;
+    }
+}
+
+static void sample(telemetry_snapshot_t *s)
+{
+    render_loop_stats_t rl;
+    render_loop_get_stats(&rl);
+    display_render_stats_t rs;
+    display_get_render_stats(&rs);
+
+    s->uptime_s = (uint32_t)(esp_timer_get_time() / 1000000);
+    s->fps_x10 = rl.fps_x10;
+    s->lvgl_idle_pct = (uint8_t)rl.idle_pct;
+    s->render_ms = rs.last_render_ms;
+    s->render_max_ms = rs.max_render_ms;
+    s->flush_us = rs.last_flush_us;
+    s->flush_max_us = rs.max_flush_us;
+    s->flush_copy_us = rs.last_copy_us;
+    s->flush_wait_us = rs.last_wait_us;
+    s->flush_overlap_pct = rs.last_overlap_pct;
+
+    sample_cpu(s);
+
+    s->internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    s->internal_min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+    s->psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    s->psram_min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM);
+
+    lvgl_mem_stats_t ms;
+    lvgl_mem_get_stats(&ms);
+    s->lvgl_sram_used = ms.pools[LVGL_MEM_POOL_SRAM].used;
+    s->lvgl_sram_peak = ms.pools[LVGL_MEM_POOL_SRAM].peak;
+    s->lvgl_sram_frag_pct = ms.pools[LVGL_MEM_POOL_SRAM].frag_pct;
+    s->lvgl_psram_used = ms.pools[LVGL_MEM_POOL_PSRAM].used;
+    s->lvgl_psram_peak = ms.pools[LVGL_MEM_POOL_PSRAM].peak;
+    s->lvgl_psram_frag_pct = ms.pools[LVGL_MEM_POOL_PSRAM].frag_pct;
+    s->lvgl_mem_fallbacks = ms.fallbacks;
+
+    sample_touch_i2c(s);
+
+    s->mqtt_rtt_ms = (mqtt_manager_get_rtt_us() + 500) / 1000;
+
+    wifi_reconnect_stats_t ws;
+    wifi_get_reconnect_stats(&ws);
+    s->wifi_reconnect_ms = ws.last_ms;
+    s->wifi_reconnects = ws.count;
+    s->wifi_fast_reconnects = ws.fast_count;
+
+    mqtt_connect_stats_t cs;
+    mqtt_manager_get_connect_stats(&cs);
+    s->mqtt_connect_ms = cs.last_ms;
+    s->mqtt_connects = cs.count;
+    s->mqtt_sessions_kept = cs.sessions_kept;
+
+    mqtt_tls_stats_t ts;
+    mqtt_tls_get_stats(&ts);
+    s->tls_handshake_ms = ts.last_ms;
+    s->tls_resumed = ts.resumed;
+    s->tls_heap_peak = ts.heap_peak;
+
+#if CONFIG_LOCAL_LINK
+    local_link_stats_t ls;
+    local_link_get_stats(&ls);
+    s->local_tx_frames = ls.tx_frames;
+    s->local_rx_frames = ls.rx_frames;
+    s->local_send_us = ls.send_us;
+#endif
+#if CONFIG_COPRO_LINK
+    copro_link_stats_t co;
+    copro_link_get_stats(&co);
+    s->copro_frames = co.proto.frames;
+    s->copro_bytes = co.proto.bytes;
+    s->copro_crc_errors = co.proto.crc_errors;
+    s->copro_framing_errors = co.proto.framing_errors + co.proto.overruns;
+    s->copro_overruns = co.uart_overruns;
+    s->copro_parse_kbs = co.parse_kbs;
+#endif
+    s->level_duplicates = backend_get_duplicate_count();
+
+    state_persist_stats_t ps;
+    state_persist_get_stats(&ps);
+    s->nvs_writes = ps.writes;
+    s->nvs_writes_per_hour = ps.writes_per_hour;
+}
+
+// ==================== Publishing ====================
+
+static int encode_summary(const telemetry_snapshot_t *s, uint8_t *buf, size_t size)
+{
+    payload_telemetry_t t = {
+        .uptime_s = s->uptime_s,
+        .fps_x10 = (uint16_t)s->fps_x10,
+        .lvgl_idle_pct = s->lvgl_idle_pct,
+        .render_max_ms = s->render_max_ms > UINT16_MAX ? UINT16_MAX : (uint16_t)s->render_max_ms,
+        .flush_max_us = s->flush_max_us,
+        .core_load_pct = {s->core_load_pct[0], s->core_load_pct[1]},
+        .internal_free = s->internal_free,
+        .internal_min_free = s->internal_min_free,
+        .psram_free = s->psram_free,
+        .psram_min_free = s->psram_min_free,
+        .touch_i2c_avg_us = s->touch_i2c_avg_us > UINT16_MAX ? UINT16_MAX : (uint16_t)s->touch_i2c_avg_us,
+        .touch_i2c_max_us = s->touch_i2c_max_us > UINT16_MAX ? UINT16_MAX : (uint16_t)s->touch_i2c_max_us,
+        .touch_i2c_errors = s->touch_i2c_errors > UINT16_MAX ? UINT16_MAX : (uint16_t)s->touch_i2c_errors,
+        .mqtt_rtt_ms = s->mqtt_rtt_ms > UINT16_MAX ? UINT16_MAX : (uint16_t)s->mqtt_rtt_ms,
+        .nvs_writes_per_hour = s->nvs_writes_per_hour > UINT16_MAX ? UINT16_MAX : (uint16_t)s->nvs_writes_per_hour,
+        .task_count = s->task_count,
+        .lvgl_sram_used = s->lvgl_sram_used,
+        .lvgl_sram_peak = s->lvgl_sram_peak,
+        .lvgl_psram_used = s->lvgl_psram_used,
+        .lvgl_psram_peak = s->lvgl_psram_peak,
+        .lvgl_sram_frag_pct = s->lvgl_sram_frag_pct,
+        .lvgl_psram_frag_pct = s->lvgl_psram_frag_pct,
+        .lvgl_mem_fallbacks = s->lvgl_mem_fallbacks > UINT16_MAX ? UINT16_MAX : (uint16_t)s->lvgl_mem_fallbacks,
+        .wifi_reconnect_ms = s->wifi_reconnect_ms,
+        .wifi_reconnects = s->wifi_reconnects > UINT16_MAX ? UINT16_MAX : (uint16_t)s->wifi_reconnects,
+        .wifi_fast_reconnects = s->wifi_fast_reconnects > UINT16_MAX ? UINT16_MAX : (uint16_t)s->wifi_fast_reconnects,
+        .mqtt_connect_ms = s->mqtt_connect_ms,
+        .tls_heap_peak = s->tls_heap_peak,
+        .tls_handshake_ms = s->tls_handshake_ms > UINT16_MAX ? UINT16_MAX : (uint16_t)s->tls_handshake_ms,
+        .mqtt_connects = s->mqtt_connects > UINT16_MAX ? UINT16_MAX : (uint16_t)s->mqtt_connects,
+        .mqtt_sessions_kept = s->mqtt_sessions_kept > UINT16_MAX ? UINT16_MAX : (uint16_t)s->mqtt_sessions_kept,
+        .tls_resumed = s->tls_resumed > UINT16_MAX ? UINT16_MAX : (uint16_t)s->tls_resumed,
+        .copro_frames = s->copro_frames,
+        .copro_bytes = s->copro_bytes,
+        .copro_crc_errors = s->copro_crc_errors > UINT16_MAX ? UINT16_MAX : (uint16_t)s->copro_crc_errors,
+        .copro_framing_errors = s->copro_framing_errors > UINT16_MAX ? UINT16_MAX : (uint16_t)s->copro_framing_errors,
+        .copro_overruns = s->copro_overruns > UINT16_MAX ? UINT16_MAX : (uint16_t)s->copro_overruns,
+        .copro_parse_kbs = s->copro_parse_kbs > UINT16_MAX ? UINT16_MAX : (uint16_t)s->copro_parse_kbs,
+    };
+    for (int i = 0; i < s->task_count && i < PAYLOAD_TELEMETRY_MAX_TASKS; i++) {
+        memcpy(t.tasks[i].name, s->tasks[i].name, sizeof(t.tasks[i].name));
+        t.tasks[i].cpu_pct = s->tasks[i].cpu_pct;
+    }
+
+#if CONFIG_PAYLOAD_TELEMETRY_BINARY
+    return payload_encode_telemetry(PAYLOAD_FORMAT_BINARY, &t, buf, size);
+#else
+    return payload_encode_telemetry(PAYLOAD_FORMAT_JSON, &t, buf, size);
+#endif
+}
+
+static void telemetry_task(void *pvParameter)
+{
+    // Static: worst-case JSON is close to 700 bytes, too much for the stack
+    static uint8_t payload[768];
+#if CONFIG_TELEMETRY_PUBLISH_INTERVAL_S > 0
+    uint32_t samples_until_publish = CONFIG_TELEMETRY_PUBLISH_INTERVAL_S;
+#endif
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (1) {
+        xTaskDelayUntil(&last_wake, pdMS_TO_TICKS(TELEMETRY_SAMPLE_MS));
+
+        telemetry_snapshot_t s = {0};
+        sample(&s);
+        taskENTER_CRITICAL(&snapshot_lock);
+        snapshot = s;
+        taskEXIT_CRITICAL(&snapshot_lock);
+
+#if CONFIG_TELEMETRY_PUBLISH_INTERVAL_S > 0
+        if (--samples_until_publish == 0) {
+            samples_until_publish = CONFIG_TELEMETRY_PUBLISH_INTERVAL_S;
+
+            int len = encode_summary(&s, payload, sizeof(payload));
+            if (len > 0) {
+                mqtt_manager_publish_timed(MQTT_TOPIC_TELEMETRY, payload, (size_t)len);
+            } else {
+                ESP_LOGW(TAG, "Summary truncated, not published");
+            }
+            // Maxima cover one publish window
+            display_reset_render_stats();
+        }
+#else
+        (void)payload;
+        (void)encode_summary;
+#endif
+    }
+}
+
+void telemetry_start(void)
+{
+    xTaskCreatePinnedToCore(telemetry_task, "telemetry", TELEMETRY_TASK_STACK, NULL,
+                            TELEMETRY_TASK_PRIO, NULL, 0);
+}
+
+void telemetry_get_snapshot(telemetry_snapshot_t *out)
+{
+    taskENTER_CRITICAL(&snapshot_lock);
+    *out = snapshot;
+    taskEXIT_CRITICAL(&snapshot_lock);
+}
+
+// ==================== On-device overlay ====================
+
+static void hud_update_cb(lv_timer_t *timer)
+{
+    telemetry_snapshot_t s;
+    telemetry_get_snapshot(&s);
+
+    // Static: the LVGL task's stack has no room to spare
+    static char text[768];
+    int n = snprintf(text, sizeof(text),
+        "%" PRIu32 ".%" PRIu32 " FPS  idle %u%%\n"
+        "render %" PRIu32 "/%" PRIu32 " ms  flush %" PRIu32 "/%" PRIu32 " us\n"
+#if CONFIG_DISPLAY_MODE_ASYNC_FLUSH
+        "gdma copy %" PRIu32 " us  wait %" PRIu32 " us  overlap %u%%\n"
+#endif
+        "CPU %u%% / %u%%\n"
+        "heap %" PRIu32 "K (min %" PRIu32 "K)  psram %" PRIu32 "K (min %" PRIu32 "K)\n"
+        "lvgl sram %" PRIu32 "/%" PRIu32 "K %u%%  psram %" PRIu32 "/%" PRIu32 "K %u%%  fb %" PRIu32 "\n"
+        "touch i2c %" PRIu32 "/%" PRIu32 " us  err %" PRIu32 "\n"
+        "mqtt rtt %" PRIu32 " ms  nvs %" PRIu32 " writes (%" PRIu32 "/h)\n"
+        "wifi reconnect %" PRIu32 " ms  %" PRIu32 "x (%" PRIu32 " cached)\n"
+        "mqtt connect %" PRIu32 " ms  %" PRIu32 "x (%" PRIu32 " kept)\n"
+#if CONFIG_LOCAL_LINK
+        "local tx %" PRIu32 " rx %" PRIu32 "  send %" PRIu32 " us  dup %" PRIu32 "\n"
+#endif
+#if CONFIG_COPRO_LINK
+        "copro %" PRIu32 " frames  err %" PRIu32 "/%" PRIu32 "  ovf %" PRIu32 "  %" PRIu32 " KB/s\n"
+#endif
+        "tls %" PRIu32 " ms  %" PRIu32 " resumed  heap peak %" PRIu32 "K",
+        s.fps_x10 / 10, s.fps_x10 % 10, s.lvgl_idle_pct,
+        s.render_ms, s.render_max_ms, s.flush_us, s.flush_max_us,
+#if CONFIG_DISPLAY_MODE_ASYNC_FLUSH
+        s.flush_copy_us, s.flush_wait_us, s.flush_overlap_pct,
+#endif
+        s.core_load_pct[0], s.core_load_pct[1],
+        s.internal_free / 1024, s.internal_min_free / 1024,
+        s.psram_free / 1024, s.psram_min_free / 1024,
+        s.lvgl_sram_used / 1024, s.lvgl_sram_peak / 1024, s.lvgl_sram_frag_pct,
+        s.lvgl_psram_used / 1024, s.lvgl_psram_peak / 1024, s.lvgl_psram_frag_pct,
+        s.lvgl_mem_fallbacks,
+        s.touch_i2c_avg_us, s.touch_i2c_max_us, s.touch_i2c_errors,
+        s.mqtt_rtt_ms, s.nvs_writes, s.nvs_writes_per_hour,
+        s.wifi_reconnect_ms, s.wifi_reconnects, s.wifi_fast_reconnects,
+        s.mqtt_connect_ms, s.mqtt_connects, s.mqtt_sessions_kept,
+#if CONFIG_LOCAL_LINK
+        s.local_tx_frames, s.local_rx_frames, s.local_send_us, s.level_duplicates,
+#endif
+#if CONFIG_COPRO_LINK
+        s.copro_frames, s.copro_crc_errors, s.copro_framing_errors, s.copro_overruns, s.copro_parse_kbs,
+#endif
+        s.tls_handshake_ms, s.tls_resumed, s.tls_heap_peak / 1024);
+    for (int i = 0; i < s.task_count && n > 0 && (size_t)n < sizeof(text); i++) {
+        n += snprintf(text + n, sizeof(text) - n, "\n%-12s %3u%%", s.tasks[i].name, s.tasks[i].cpu_pct);
+    }
+    lv_label_set_text(hud_label, text);
+}
+
+static void hud_gesture_cb(lv_event_t *e)
+{
+    const touch_gesture_t *gesture = lv_event_get_param(e);
+    if (gesture->type == TOUCH_GESTURE_TWO_FINGER_TAP) {
+        telemetry_hud_set_visible(lv_obj_has_flag(hud_label, LV_OBJ_FLAG_HIDDEN));
+    }
+}
+
+void telemetry_hud_init(void)
+{
+    hud_label = lv_label_create(lv_layer_top());
+    lv_obj_set_style_text_font(hud_label, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(hud_label, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_color(hud_label, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(hud_label, LV_OPA_70, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_all(hud_label, 6, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_align(hud_label, LV_ALIGN_TOP_LEFT, 8, 8);
+    lv_obj_add_flag(hud_label, LV_OBJ_FLAG_HIDDEN);
+    lv_label_set_text(hud_label, "");
+
+    // Only runs while the overlay is shown
+    hud_timer = lv_timer_create(hud_update_cb, TELEMETRY_SAMPLE_MS, NULL);
+    lv_timer_pause(hud_timer);
+
+    lv_obj_add_event_cb(lv_scr_act(), hud_gesture_cb, touch_get_gesture_event(), NULL);
+}
+
+void telemetry_hud_set_visible(bool visible)
+{
+    if (hud_label == NULL) return;
+
+    if (visible) {
+        hud_update_cb(hud_timer);
+        lv_obj_clear_flag(hud_label, LV_OBJ_FLAG_HIDDEN);
+        lv_timer_resume(hud_timer);
+    } else {
+        lv_obj_add_flag(hud_label, LV_OBJ_FLAG_HIDDEN);
+        lv_timer_pause(hud_timer);
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Runtime performance metrics, sampled once per second by the telemetry
+// task, shown on a toggleable on-device overlay and published as a compact
+// JSON summary on sensecap/indicator/telemetry.
+
+#define TELEMETRY_TOP_TASKS 4
+
+typedef struct {
+    char name[16];
+    uint8_t cpu_pct;            // Share of one core over the last second
+} telemetry_task_load_t;
+
+typedef struct {
+    uint32_t uptime_s;
+
+    // Rendering (render_loop / display_driver)
+    uint32_t fps_x10;
+    uint8_t lvgl_idle_pct;
+    uint32_t render_ms;         // Last refresh, drawing only
+    uint32_t render_max_ms;     // Worst refresh in the current window
+    uint32_t flush_us;
+    uint32_t flush_max_us;
+    uint32_t flush_copy_us;     // DISPLAY_MODE_ASYNC_FLUSH: GDMA copy time, last refresh
+    uint32_t flush_wait_us;     // ... of which LVGL waited for
+    uint8_t flush_overlap_pct;  // ... and the share hidden behind drawing
+
+    // CPU (requires FreeRTOS run time stats, otherwise all zero)
+    uint8_t core_load_pct[2];
+    telemetry_task_load_t tasks[TELEMETRY_TOP_TASKS];
+    uint8_t task_count;
+
+    // Heap: current free and lowest free since boot
+    uint32_t internal_free;
+    uint32_t internal_min_free;
+    uint32_t psram_free;
+    uint32_t psram_min_free;
+
+    // LVGL's own pools (lvgl_mem): used and peak bytes, fragmentation
+    uint32_t lvgl_sram_used;
+    uint32_t lvgl_sram_peak;
+    uint8_t lvgl_sram_frag_pct;
+    uint32_t lvgl_psram_used;
+    uint32_t lvgl_psram_peak;
+    uint8_t lvgl_psram_frag_pct;
+    uint32_t lvgl_mem_fallbacks;
+
+    // GT911 transfers on the shared I2C bus
+    uint32_t touch_i2c_avg_us;
+    uint32_t touch_i2c_max_us;
+    uint32_t touch_i2c_errors;
+
+    // MQTT publish-to-PUBACK time, 0 until measured
+    uint32_t mqtt_rtt_ms;
+
+    // WiFi link loss to IP address: last time, 0 until it happened, and
+    // how many reconnects went straight to the cached AP
+    uint32_t wifi_reconnect_ms;
+    uint32_t wifi_reconnects;
+    uint32_t wifi_fast_reconnects;
+
+    // Broker connect (TLS handshake included) to CONNACK: last time, 0
+    // until it happened, connects that found the persistent session, and
+    // of the TLS handshakes the last time, the resumed ones and the
+    // mbedTLS heap peak of the last one
+    uint32_t mqtt_connect_ms;
+    uint32_t mqtt_connects;
+    uint32_t mqtt_sessions_kept;
+    uint32_t tls_handshake_ms;
+    uint32_t tls_resumed;
+    uint32_t tls_heap_peak;
+
+    // Local link (CONFIG_LOCAL_LINK): frames sent, new frames received,
+    // light state change to the first copy on the socket, and levels
+    // dropped because the other path had delivered them already
+    uint32_t local_tx_frames;
+    uint32_t local_rx_frames;
+    uint32_t local_send_us;
+    uint32_t level_duplicates;
+
+    // Co-processor link (CONFIG_COPRO_LINK): good frames, bytes, rejected
+    // frames (bad CRC; broken COBS, too short or too long), UART overruns
+    // and parse speed in KB per second of task time
+    uint32_t copro_frames;
+    uint32_t copro_bytes;
+    uint32_t copro_crc_errors;
+    uint32_t copro_framing_errors;
+    uint32_t copro_overruns;
+    uint32_t copro_parse_kbs;
+
+    // State persistence flash writes (endurance check)
+    uint32_t nvs_writes;
+    uint32_t nvs_writes_per_hour;
+} telemetry_snapshot_t;
+
+// Start the sampling/publishing task. Call after display, touch and MQTT
+// managers are set up.
+void telemetry_start(void);
+
+// Create the overlay on lv_layer_top() (hidden) and toggle it with a
+// two-finger tap. LVGL context only.
+void telemetry_hud_init(void);
+void telemetry_hud_set_visible(bool visible);
+
+void telemetry_get_snapshot(telemetry_snapshot_t *out);
+
+#endif // TELEMETRY_H
@@ -1,146 +1,240 @@
 #include "touch_driver.h"
 #include "lvgl.h"
-#include "driver/i2c.h"
 #include "driver/gpio.h"
+#include "esp_attr.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "i2c_bus.h"
+#include "spsc_ring.h"
+#include "touch_gesture.h"
 
 static const char *TAG = "TOUCH";
 
 // Touch controller pins (GT911 for SenseCAP Indicator D1)
 // From official SDK: sensecap_indicator_board.c
-#define TOUCH_I2C_NUM       I2C_NUM_0
-#define TOUCH_PIN_NUM_SDA   39  // GPIO_I2C_SDA
-#define TOUCH_PIN_NUM_SCL   40  // GPIO_I2C_SCL
+// SDA/SCL are on the shared bus, see i2c_bus.c
 #define TOUCH_PIN_NUM_INT   3
 #define TOUCH_PIN_NUM_RST   2
 
+#define GT911_I2C_ADDR      0x5D
+
 // GT911 registers
-#define GT911_REG_X_LOW     0x8140
-#define GT911_REG_X_HIGH    0x8141
-#define GT911_REG_Y_LOW     0x8142
-#define GT911_REG_Y_HIGH    0x8143
 #define GT911_REG_STATUS    0x814E
 #define GT911_REG_POINTS    0x814F
 
+// Status register layout
+#define GT911_STATUS_READY  0x80  // Coordinate buffer holds a new report
+#define GT911_STATUS_COUNT  0x0F  // Number of touch points in the report
+
+// Each point record: track id, x (LE16), y (LE16), size (LE16), reserved
+#define GT911_POINT_SIZE    8
+
+// While a finger is down, re-read at this period even without an interrupt
+// so a lost release edge cannot leave LVGL with a stuck press
+#define TOUCH_PRESSED_POLL_MS     50
+
+#define TOUCH_TASK_STACK    3072
+#define TOUCH_TASK_PRIO     6
+
+// Touch task -> touch_read_cb() (LVGL task)
+SPSC_RING_DEFINE(touch_ring, touch_frame_t, 16);
+SPSC_RING_DEFINE(gesture_ring, touch_gesture_t, 8);
+
 static lv_indev_drv_t indev_drv;
-static int16_t last_x = 0;
-static int16_t last_y = 0;
+static lv_indev_t *indev = NULL;
+static touch_input_cb_t input_cb = NULL;
+static TaskHandle_t touch_task_handle = NULL;
+static i2c_bus_device_handle_t gt911 = NULL;
+static touch_point_t last_point = {0};
 static bool last_pressed = false;
+static uint32_t gesture_event_code = 0;
 
-// I2C read function
 static esp_err_t gt911_read(uint16_t reg, uint8_t *data, size_t len)
 {
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (0x5D << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(cmd, reg >> 8, true);
-    i2c_master_write_byte(cmd, reg & 0xFF, true);
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (0x5D << 1) | I2C_MASTER_READ, true);
-    if (len > 1) {
-        i2c_master_read(cmd, data, len - 1, I2C_MASTER_ACK);
+    uint8_t addr[2] = { reg >> 8, reg & 0xFF };
+    return i2c_bus_read(gt911, addr, sizeof(addr), data, len);
+}
+
+static esp_err_t gt911_write_byte(uint16_t reg, uint8_t value)
+{
+    uint8_t addr[2] = { reg >> 8, reg & 0xFF };
+    return i2c_bus_write(gt911, addr, sizeof(addr), &value, 1);
+}
+
+static void IRAM_ATTR touch_int_isr(void *arg)
+{
+    BaseType_t need_yield = pdFALSE;
+    vTaskNotifyGiveFromISR(touch_task_handle, &need_yield);
+    if (need_yield) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// Read one report from the controller. Returns false if there was no new report.
+// The status register is immediately followed by the point records
+// (GT911_REG_POINTS), so a single transaction fetches every point.
+static bool gt911_read_frame(touch_frame_t *frame)
+{
+    uint8_t buf[1 + TOUCH_MAX_POINTS * GT911_POINT_SIZE];
+
+    if (gt911_read(GT911_REG_STATUS, buf, sizeof(buf)) != ESP_OK) {
+        return false;
+    }
+    if (!(buf[0] & GT911_STATUS_READY)) {
+        return false;
+    }
+
+    uint8_t count = buf[0] & GT911_STATUS_COUNT;
+    if (count > TOUCH_MAX_POINTS) {
+        count = TOUCH_MAX_POINTS;
+    }
+
+    frame->timestamp_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    frame->count = count;
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t *pt = &buf[1 + i * GT911_POINT_SIZE];
+        frame->points[i].id = pt[0];
+        frame->points[i].x = pt[1] | (pt[2] << 8);
+        frame->points[i].y = pt[3] | (pt[4] << 8);
+    }
+
+    // Hand the coordinate buffer back to the controller
+    gt911_write_byte(GT911_REG_STATUS, 0);
+    return true;
+}
+
+static void touch_task(void *pvParameter)
+{
+    touch_frame_t frame = {0};
+    touch_gesture_t gesture;
+    touch_gesture_state_t gesture_state;
+
+    touch_gesture_reset(&gesture_state);
+
+    while (1) {
+        TickType_t wait = frame.count > 0 ? pdMS_TO_TICKS(TOUCH_PRESSED_POLL_MS) : portMAX_DELAY;
+        ulTaskNotifyTake(pdTRUE, wait);
+
+        if (!gt911_read_frame(&frame)) {
+            continue;
+        }
+
+        // Recognition runs here, so the LVGL read callback only drains queues
+        // and its cost does not depend on how many gestures we detect
+        touch_gesture_filter(&gesture_state, &frame);
+        if (touch_gesture_process(&gesture_state, &frame, &gesture)) {
+            if (!spsc_ring_push(&gesture_ring, &gesture)) {
+                ESP_LOGD(TAG, "Gesture ring full, gesture dropped");
+            }
+        }
+
+        if (!spsc_ring_push(&touch_ring, &frame)) {
+            ESP_LOGD(TAG, "Touch ring full, frame dropped");
+        }
+        if (input_cb) {
+            input_cb();
+        }
     }
-    i2c_master_read_byte(cmd, data + len - 1, I2C_MASTER_NACK);
-    i2c_master_stop(cmd);
-    esp_err_t ret = i2c_master_cmd_begin(TOUCH_I2C_NUM, cmd, pdMS_TO_TICKS(1000));
-    i2c_cmd_link_delete(cmd);
-    return ret;
 }
 
 void touch_init(void)
 {
     ESP_LOGI(TAG, "Initializing touch hardware");
-    
+
     // Configure reset and interrupt GPIOs
     gpio_config_t rst_gpio_config = {
         .mode = GPIO_MODE_OUTPUT,
         .pin_bit_mask = 1ULL << TOUCH_PIN_NUM_RST
     };
     ESP_ERROR_CHECK(gpio_config(&rst_gpio_config));
-    
+
     gpio_config_t int_gpio_config = {
         .mode = GPIO_MODE_INPUT,
         .pin_bit_mask = 1ULL << TOUCH_PIN_NUM_INT,
-        .pull_up_en = GPIO_PULLUP_ENABLE
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .intr_type = GPIO_INTR_NEGEDGE,
     };
     ESP_ERROR_CHECK(gpio_config(&int_gpio_config));
-    
+
     // Reset touch controller
     gpio_set_level(TOUCH_PIN_NUM_RST, 0);
     vTaskDelay(pdMS_TO_TICKS(10));
     gpio_set_level(TOUCH_PIN_NUM_RST, 1);
     vTaskDelay(pdMS_TO_TICKS(100));
-    
-    // Initialize I2C
-    i2c_config_t i2c_conf = {
-        .mode = I2C_MODE_MASTER,
-        .sda_io_num = TOUCH_PIN_NUM_SDA,
-        .scl_io_num = TOUCH_PIN_NUM_SCL,
-        .sda_pullup_en = GPIO_PULLUP_ENABLE,
-        .scl_pullup_en = GPIO_PULLUP_ENABLE,
-        .master.clk_speed = 400000,
-    };
-    
-    ESP_ERROR_CHECK(i2c_param_config(TOUCH_I2C_NUM, &i2c_conf));
-    ESP_ERROR_CHECK(i2c_driver_install(TOUCH_I2C_NUM, I2C_MODE_MASTER, 0, 0, 0));
-    
+
+    // Shared with the IO expander; installed by whichever driver comes first
+    ESP_ERROR_CHECK(i2c_bus_init());
+    ESP_ERROR_CHECK(i2c_bus_add_device("gt911", GT911_I2C_ADDR, &gt911));
+
+    // Reader task on core 0, away from lvgl_task; woken by the INT line
+    xTaskCreatePinnedToCore(touch_task, "touch_task", TOUCH_TASK_STACK, NULL,
+                            TOUCH_TASK_PRIO, &touch_task_handle, 0);
+
+    esp_err_t ret = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        ESP_ERROR_CHECK(ret);
+    }
+    ESP_ERROR_CHECK(gpio_isr_handler_add(TOUCH_PIN_NUM_INT, touch_int_isr, NULL));
+
     ESP_LOGI(TAG, "Touch hardware initialized");
 }
 
 void touch_read_cb(lv_indev_drv_t *drv, lv_indev_data_t *data)
 {
-    uint8_t status = 0;
-    
-    // Read touch status
-    if (gt911_read(GT911_REG_STATUS, &status, 1) != ESP_OK) {
-        data->state = LV_INDEV_STATE_RELEASED;
-        return;
-    }
-    
-    // Check if touch is detected
-    if (status & 0x80) {
-        uint8_t buf[4];
-        if (gt911_read(GT911_REG_X_LOW, buf, 4) == ESP_OK) {
-            int16_t x = buf[0] | (buf[1] << 8);
-            int16_t y = buf[2] | (buf[3] << 8);
-            
-            // Transform coordinates (display is 480x480)
-            last_x = x;
-            last_y = y;
-            last_pressed = true;
-            
-            data->point.x = last_x;
-            data->point.y = last_y;
-            data->state = LV_INDEV_STATE_PRESSED;
-        } else {
-            data->state = LV_INDEV_STATE_RELEASED;
+    // Never touches the bus: replay queued frames in order so no press or
+    // release is lost, and report the last known state when none are queued.
+    // The pointer follows the first finger; extra fingers only feed gestures.
+    touch_frame_t frame;
+    if (spsc_ring_pop(&touch_ring, &frame)) {
+        last_pressed = frame.count > 0;
+        if (last_pressed) {
+            last_point = frame.points[0];
         }
-        
-        // Clear status
-        uint8_t clear = 0;
-        i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-        i2c_master_start(cmd);
-        i2c_master_write_byte(cmd, (0x5D << 1) | I2C_MASTER_WRITE, true);
-        i2c_master_write_byte(cmd, GT911_REG_STATUS >> 8, true);
-        i2c_master_write_byte(cmd, GT911_REG_STATUS & 0xFF, true);
-        i2c_master_write_byte(cmd, clear, true);
-        i2c_master_stop(cmd);
-        i2c_master_cmd_begin(TOUCH_I2C_NUM, cmd, pdMS_TO_TICKS(1000));
-        i2c_cmd_link_delete(cmd);
-    } else {
-        last_pressed = false;
-        data->state = LV_INDEV_STATE_RELEASED;
+        data->continue_reading = !spsc_ring_is_empty(&touch_ring);
+    }
+
+    data->point.x = last_point.x;
+    data->point.y = last_point.y;
+    data->state = last_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+
+    touch_gesture_t gesture;
+    while (spsc_ring_pop(&gesture_ring, &gesture)) {
+        lv_event_send(lv_scr_act(), gesture_event_code, &gesture);
     }
 }
 
+uint32_t touch_get_gesture_event(void)
+{
+    return gesture_event_code;
+}
+
+lv_indev_t *touch_get_indev(void)
+{
+    return indev;
+}
+
+bool touch_is_active(void)
+{
+    return last_pressed || !spsc_ring_is_empty(&touch_ring) || !spsc_ring_is_empty(&gesture_ring);
+}
+
+void touch_set_input_cb(touch_input_cb_t cb)
+{
+    input_cb = cb;
+}
+
 void touch_driver_init(void)
 {
     ESP_LOGI(TAG, "Initializing LVGL touch driver");
-    
+
     lv_indev_drv_init(&indev_drv);
     indev_drv.type = LV_INDEV_TYPE_POINTER;
     indev_drv.read_cb = touch_read_cb;
-    lv_indev_drv_register(&indev_drv);
-    
+    indev = lv_indev_drv_register(&indev_drv);
+
+    gesture_event_code = lv_event_register_id();
+
     ESP_LOGI(TAG, "LVGL touch driver initialized");
 }
@@ -12,4 +12,20 @@ void touch_driver_init(void);
 // Touch read callback for LVGL
 void touch_read_cb(lv_indev_drv_t *drv, lv_indev_data_t *data);
 
+// LVGL event code sent to the active screen for each recognised gesture.
+// The event parameter is a const touch_gesture_t * (see touch_gesture.h);
+// valid after touch_driver_init().
+uint32_t touch_get_gesture_event(void);
+
+// Input device registered by touch_driver_init()
+lv_indev_t *touch_get_indev(void);
+
+// True while a finger is down or queued frames/gestures are waiting to be
+// read, i.e. while LVGL still needs to poll the input device
+bool touch_is_active(void);
+
+// Called from the touch task after each new frame is queued
+typedef void (*touch_input_cb_t)(void);
+void touch_set_input_cb(touch_input_cb_t cb);
+
 #endif // TOUCH_DRIVER_H
@@ -0,0 +1,148 @@
+#include "touch_gesture.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Movement below this is treated as sensor jitter (px)
+#define GESTURE_JITTER_PX        3
+// A finger that stays within this radius is "not moving" (px)
+#define GESTURE_TOUCH_SLOP_PX    12
+// Minimum travel and maximum duration of a swipe
+#define GESTURE_SWIPE_MIN_PX     80
+#define GESTURE_SWIPE_MAX_MS     600
+// Hold time for a long press
+#define GESTURE_LONG_PRESS_MS    600
+// Two fingers released within this time without pinching count as a tap
+#define GESTURE_TWO_TAP_MAX_MS   350
+// Change of finger distance that makes a two-finger touch a pinch (px)
+#define GESTURE_PINCH_MIN_PX     40
+
+static const touch_point_t *find_point(const touch_frame_t *frame, uint8_t id)
+{
+    for (uint8_t i = 0; i < frame->count; i++) {
+        if (frame->points[i].id == id) return &frame->points[i];
+    }
+    return NULL;
+}
+
+// Cheap distance estimate (octagonal norm, within ~8% of euclidean)
+static int32_t point_distance(const touch_point_t *a, const touch_point_t *b)
+{
+    int32_t dx = abs(a->x - b->x);
+    int32_t dy = abs(a->y - b->y);
+    return dx > dy ? dx + dy / 2 : dy + dx / 2;
+}
+
+void touch_gesture_reset(touch_gesture_state_t *state)
+{
+    memset(state, 0, sizeof(*state));
+}
+
+void touch_gesture_filter(touch_gesture_state_t *state, touch_frame_t *frame)
+{
+    for (uint8_t i = 0; i < frame->count; i++) {
+        touch_point_t *pt = &frame->points[i];
+        const touch_point_t *prev = find_point(&state->filtered, pt->id);
+        if (prev == NULL) continue;
+
+        if (abs(pt->x - prev->x) < GESTURE_JITTER_PX && abs(pt->y - prev->y) < GESTURE_JITTER_PX) {
+            pt->x = prev->x;
+            pt->y = prev->y;
+        }
+    }
+    state->filtered = *frame;
+}
+
+static bool finish_gesture(touch_gesture_state_t *state, uint32_t now_ms, touch_gesture_t *gesture)
+{
+    uint32_t duration = now_ms - state->start_ms;
+    int16_t dx = state->last_x - state->start_x;
+    int16_t dy = state->last_y - state->start_y;
+
+    gesture->x = state->start_x;
+    gesture->y = state->start_y;
+    gesture->duration_ms = duration > UINT16_MAX ? UINT16_MAX : (uint16_t)duration;
+
+    if (state->max_fingers >= 2) {
+        int32_t pinch = state->pinch_last_dist - state->pinch_start_dist;
+        if (abs(pinch) >= GESTURE_PINCH_MIN_PX) {
+            gesture->type = pinch > 0 ? TOUCH_GESTURE_PINCH_OUT : TOUCH_GESTURE_PINCH_IN;
+            gesture->dx = (int16_t)pinch;
+            gesture->dy = 0;
+            return true;
+        }
+        if (duration <= GESTURE_TWO_TAP_MAX_MS) {
+            gesture->type = TOUCH_GESTURE_TWO_FINGER_TAP;
+            gesture->dx = dx;
+            gesture->dy = dy;
+            return true;
+        }
+        return false;
+    }
+
+    if (state->long_press_sent || duration > GESTURE_SWIPE_MAX_MS) {
+        return false;
+    }
+
+    gesture->dx = dx;
+    gesture->dy = dy;
+    if (abs(dx) >= abs(dy) && abs(dx) >= GESTURE_SWIPE_MIN_PX) {
+        gesture->type = dx > 0 ? TOUCH_GESTURE_SWIPE_RIGHT : TOUCH_GESTURE_SWIPE_LEFT;
+        return true;
+    }
+    if (abs(dy) > abs(dx) && abs(dy) >= GESTURE_SWIPE_MIN_PX) {
+        gesture->type = dy > 0 ? TOUCH_GESTURE_SWIPE_DOWN : TOUCH_GESTURE_SWIPE_UP;
+        return true;
+    }
+    return false;
+}
+
+bool touch_gesture_process(touch_gesture_state_t *state, const touch_frame_t *frame,
+                           touch_gesture_t *gesture)
+{
+    if (frame->count == 0) {
+        if (!state->active) return false;
+        state->active = false;
+        return finish_gesture(state, frame->timestamp_ms, gesture);
+    }
+
+    const touch_point_t *first = &frame->points[0];
+
+    if (!state->active) {
+        state->active = true;
+        state->long_press_sent = false;
+        state->max_fingers = 0;
+        state->start_ms = frame->timestamp_ms;
+        state->start_x = first->x;
+        state->start_y = first->y;
+    }
+    state->last_x = first->x;
+    state->last_y = first->y;
+
+    if (frame->count >= 2) {
+        int32_t dist = point_distance(&frame->points[0], &frame->points[1]);
+        if (state->max_fingers < 2) {
+            state->pinch_start_dist = dist;
+        }
+        state->pinch_last_dist = dist;
+    }
+    if (frame->count > state->max_fingers) {
+        state->max_fingers = frame->count;
+    }
+
+    // Long press fires while the finger is still down
+    if (state->max_fingers == 1 && !state->long_press_sent &&
+        frame->timestamp_ms - state->start_ms >= GESTURE_LONG_PRESS_MS &&
+        abs(state->last_x - state->start_x) <= GESTURE_TOUCH_SLOP_PX &&
+        abs(state->last_y - state->start_y) <= GESTURE_TOUCH_SLOP_PX) {
+        state->long_press_sent = true;
+        gesture->type = TOUCH_GESTURE_LONG_PRESS;
+        gesture->x = state->start_x;
+        gesture->y = state->start_y;
+        gesture->dx = 0;
+        gesture->dy = 0;
+        gesture->duration_ms = (uint16_t)(frame->timestamp_ms - state->start_ms);
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,70 @@
+#ifndef TOUCH_GESTURE_H
+#define TOUCH_GESTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// GT911 reports at most 5 simultaneous points
+#define TOUCH_MAX_POINTS 5
+
+typedef struct {
+    uint8_t id;   // Controller track id, stable while the finger stays down
+    int16_t x;
+    int16_t y;
+} touch_point_t;
+
+// One decoded controller report
+typedef struct {
+    uint32_t timestamp_ms;
+    uint8_t count;
+    touch_point_t points[TOUCH_MAX_POINTS];
+} touch_frame_t;
+
+typedef enum {
+    TOUCH_GESTURE_SWIPE_LEFT,
+    TOUCH_GESTURE_SWIPE_RIGHT,
+    TOUCH_GESTURE_SWIPE_UP,
+    TOUCH_GESTURE_SWIPE_DOWN,
+    TOUCH_GESTURE_LONG_PRESS,
+    TOUCH_GESTURE_TWO_FINGER_TAP,
+    TOUCH_GESTURE_PINCH_IN,
+    TOUCH_GESTURE_PINCH_OUT,
+} touch_gesture_type_t;
+
+// Recognised gesture, delivered to LVGL as the parameter of the gesture event
+typedef struct {
+    touch_gesture_type_t type;
+    int16_t x;              // Start position of the (first) finger
+    int16_t y;
+    int16_t dx;             // Total movement, or change of finger distance for pinches
+    int16_t dy;
+    uint16_t duration_ms;
+} touch_gesture_t;
+
+// Recogniser state, owned by the touch task
+typedef struct {
+    touch_frame_t filtered;     // Last jitter-filtered frame
+    bool active;                // At least one finger down
+    bool long_press_sent;
+    uint8_t max_fingers;
+    uint32_t start_ms;
+    int16_t start_x;
+    int16_t start_y;
+    int16_t last_x;
+    int16_t last_y;
+    int32_t pinch_start_dist;
+    int32_t pinch_last_dist;
+} touch_gesture_state_t;
+
+void touch_gesture_reset(touch_gesture_state_t *state);
+
+// Filter a raw frame in place against the previous one: points that moved
+// less than the jitter threshold keep their previous coordinates.
+void touch_gesture_filter(touch_gesture_state_t *state, touch_frame_t *frame);
+
+// Feed a filtered frame. Returns true and fills *gesture when a gesture
+// completes (or a long press is held long enough).
+bool touch_gesture_process(touch_gesture_state_t *state, const touch_frame_t *frame,
+                           touch_gesture_t *gesture);
+
+#endif // TOUCH_GESTURE_H
@@ -7,42 +7,165 @@
 #include "esp_event.h"
 #include "esp_log.h"
 #include "esp_system.h"
+#include "esp_timer.h"
+#include "esp_rom_crc.h"
+#include "nvs.h"
+#include <inttypes.h>
 
 static const char *TAG = "WIFI";
 
 #define WIFI_CONNECTED_BIT BIT0
 #define WIFI_FAIL_BIT      BIT1
 
+#define WIFI_NVS_NAMESPACE "wifi"
+// Attempts aimed at the cached AP before falling back to a full scan
+#define WIFI_FAST_TRIES    2
+
+// AP of the last connection that got an address, in NVS. Connecting to a
+// known BSSID on a known channel skips the scan of every channel, which is
+// most of the reconnect time. Only written when it changes.
+typedef struct {
+    uint32_t ssid_crc;          // Of the SSID it belongs to
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t reserved;
+} wifi_link_cache_t;
+
 static EventGroupHandle_t s_wifi_event_group;
 static esp_netif_t *sta_netif = NULL;
 static bool wifi_connected = false;
 static char ip_addr[16] = {0};
 static int s_retry_num = 0;
+static wifi_status_cb_t s_status_cb = NULL;
+
+static wifi_config_t s_config;
+static wifi_link_cache_t s_cache;
+static bool s_cache_valid = false;
+static int s_fast_left = 0;             // Attempts left on the cached AP
+static bool s_attempt_fast = false;     // The attempt in progress uses it
+static int64_t s_link_lost_us = 0;      // 0 while connected or never connected
+static wifi_reconnect_stats_t s_reconnect_stats;
+
+static void wifi_report(wifi_status_t status)
+{
+    if (s_status_cb) {
+        s_status_cb(status);
+    }
+}
+
+// ==================== Link cache ====================
+
+static uint32_t ssid_crc(const char *ssid)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)ssid, strlen(ssid));
+}
+
+static void cache_load(const char *ssid)
+{
+    s_cache_valid = false;
+    nvs_handle_t nvs;
+    if (nvs_open(WIFI_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) return;
+    size_t len = sizeof(s_cache);
+    esp_err_t err = nvs_get_blob(nvs, "link", &s_cache, &len);
+    nvs_close(nvs);
+
+    s_cache_valid = err == ESP_OK && len == sizeof(s_cache) && s_cache.ssid_crc == ssid_crc(ssid) &&
+                    s_cache.channel >= 1 && s_cache.channel <= 14;
+    if (s_cache_valid) {
+        ESP_LOGI(TAG, "Cached AP " MACSTR " on channel %u", MAC2STR(s_cache.bssid), s_cache.channel);
+    }
+}
+
+static void cache_store(void)
+{
+    wifi_ap_record_t ap;
+    if (esp_wifi_sta_get_ap_info(&ap) != ESP_OK) return;
+
+    wifi_link_cache_t cache = {
+        .ssid_crc = ssid_crc((const char *)s_config.sta.ssid),
+        .channel = ap.primary,
+    };
+    memcpy(cache.bssid, ap.bssid, sizeof(cache.bssid));
+    if (s_cache_valid && memcmp(&cache, &s_cache, sizeof(cache)) == 0) return;
+
+    nvs_handle_t nvs;
+    if (nvs_open(WIFI_NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) return;
+    if (nvs_set_blob(nvs, "link", &cache, sizeof(cache)) == ESP_OK) nvs_commit(nvs);
+    nvs_close(nvs);
+
+    s_cache = cache;
+    s_cache_valid = true;
+    ESP_LOGI(TAG, "AP " MACSTR " on channel %u cached", MAC2STR(cache.bssid), cache.channel);
+}
+
+// ==================== Connection attempts ====================
+
+// Aim the next attempt at the cached AP while fast tries are left, else
+// scan every channel and take the strongest AP with our SSID
+static void wifi_attempt(void)
+{
+    bool fast = s_cache_valid && s_fast_left > 0;
+    if (fast) {
+        s_fast_left--;
+        memcpy(s_config.sta.bssid, s_cache.bssid, sizeof(s_config.sta.bssid));
+        s_config.sta.bssid_set = true;
+        s_config.sta.channel = s_cache.channel;
+        s_config.sta.scan_method = WIFI_FAST_SCAN;
+    } else {
+        if (s_attempt_fast) ESP_LOGI(TAG, "Cached AP not answering, scanning all channels");
+        s_config.sta.bssid_set = false;
+        s_config.sta.channel = 0;
+        s_config.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+    }
+    s_attempt_fast = fast;
+
+    esp_wifi_set_config(WIFI_IF_STA, &s_config);
+    esp_wifi_connect();
+}
 
 static void wifi_event_handler(void *arg, esp_event_base_t event_base,
                                int32_t event_id, void *event_data)
 {
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
-        esp_wifi_connect();
+        wifi_attempt();
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
         wifi_event_sta_disconnected_t *event = (wifi_event_sta_disconnected_t *)event_data;
         ESP_LOGI(TAG, "WiFi disconnected, reason: %d", event->reason);
+        if (wifi_connected) {
+            // Link lost: the AP we were on is the best guess for the next one
+            s_link_lost_us = esp_timer_get_time();
+            s_fast_left = WIFI_FAST_TRIES;
+        }
         wifi_connected = false;
+        xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
         
         if (s_retry_num < CONFIG_WIFI_MAXIMUM_RETRY) {
-            esp_wifi_connect();
+            wifi_attempt();
             s_retry_num++;
             ESP_LOGI(TAG, "Retry connecting to WiFi...");
+            wifi_report(WIFI_STATUS_DISCONNECTED);
         } else {
             xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
+            wifi_report(WIFI_STATUS_FAILED);
         }
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t *event = (ip_event_got_ip_t *)event_data;
         snprintf(ip_addr, sizeof(ip_addr), IPSTR, IP2STR(&event->ip_info.ip));
         ESP_LOGI(TAG, "Got IP: %s", ip_addr);
+        if (s_link_lost_us != 0) {
+            s_reconnect_stats.last_ms = (uint32_t)((esp_timer_get_time() - s_link_lost_us) / 1000);
+            s_reconnect_stats.count++;
+            if (s_attempt_fast) s_reconnect_stats.fast_count++;
+            s_link_lost_us = 0;
+            ESP_LOGI(TAG, "Reconnected in %" PRIu32 " ms (%s)", s_reconnect_stats.last_ms,
+                     s_attempt_fast ? "cached AP" : "full scan");
+        }
+        cache_store();
         s_retry_num = 0;
         wifi_connected = true;
+        xEventGroupClearBits(s_wifi_event_group, WIFI_FAIL_BIT);
         xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+        wifi_report(WIFI_STATUS_CONNECTED);
     }
 }
 
@@ -60,6 +183,9 @@ void wifi_init(void)
     
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
+    // The config changes with every attempt (cached AP or full scan) and
+    // is rebuilt from Kconfig at boot; keep the driver from saving it
+    ESP_ERROR_CHECK(esp_wifi_set_storage(WIFI_STORAGE_RAM));
     
     esp_event_handler_instance_t instance_any_id;
     esp_event_handler_instance_t instance_got_ip;
@@ -78,13 +204,19 @@ void wifi_init(void)
     ESP_LOGI(TAG, "WiFi initialized");
 }
 
-void wifi_connect(const char *ssid, const char *password)
+void wifi_set_status_callback(wifi_status_cb_t cb)
+{
+    s_status_cb = cb;
+}
+
+void wifi_start(const char *ssid, const char *password)
 {
     ESP_LOGI(TAG, "Connecting to WiFi SSID: %s", ssid);
     
-    wifi_config_t wifi_config = {
+    s_config = (wifi_config_t) {
         .sta = {
             .threshold.authmode = WIFI_AUTH_WPA2_PSK,
+            .sort_method = WIFI_CONNECT_AP_BY_SIGNAL,
             .pmf_cfg = {
                 .capable = true,
                 .required = false
@@ -92,12 +224,30 @@ void wifi_connect(const char *ssid, const char *password)
         },
     };
     
-    strncpy((char *)wifi_config.sta.ssid, ssid, sizeof(wifi_config.sta.ssid));
-    strncpy((char *)wifi_config.sta.password, password, sizeof(wifi_config.sta.password));
+    strncpy((char *)s_config.sta.ssid, ssid, sizeof(s_config.sta.ssid));
+    strncpy((char *)s_config.sta.password, password, sizeof(s_config.sta.password));
+
+    cache_load(ssid);
+    s_fast_left = WIFI_FAST_TRIES;
     
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
+    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &s_config));
     ESP_ERROR_CHECK(esp_wifi_start());
+}
+
+void wifi_retry(void)
+{
+    ESP_LOGI(TAG, "Restarting WiFi connection attempts");
+    s_retry_num = 0;
+    // After an outage the old AP is usually back first
+    s_fast_left = WIFI_FAST_TRIES;
+    xEventGroupClearBits(s_wifi_event_group, WIFI_FAIL_BIT);
+    wifi_attempt();
+}
+
+void wifi_connect(const char *ssid, const char *password)
+{
+    wifi_start(ssid, password);
     
     ESP_LOGI(TAG, "WiFi started, waiting for connection...");
     
@@ -125,3 +275,8 @@ const char* wifi_get_ip(void)
 {
     return wifi_connected ? ip_addr : NULL;
 }
+
+void wifi_get_reconnect_stats(wifi_reconnect_stats_t *out)
+{
+    *out = s_reconnect_stats;
+}
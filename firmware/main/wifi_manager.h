@@ -2,11 +2,39 @@
 #define WIFI_MANAGER_H
 
 #include <stdbool.h>
+#include <stdint.h>
+
+// Connection status changes, reported from the default event loop task
+typedef enum {
+    WIFI_STATUS_CONNECTED,      // Associated and got an IP address
+    WIFI_STATUS_DISCONNECTED,   // Link lost, automatic retries in progress
+    WIFI_STATUS_FAILED,         // CONFIG_WIFI_MAXIMUM_RETRY retries exhausted
+} wifi_status_t;
+
+// Time from losing the link to having an address again
+typedef struct {
+    uint32_t last_ms;           // Last reconnect; 0 until the first one
+    uint32_t count;             // Reconnects since boot
+    uint32_t fast_count;        // Of which connected straight to the cached AP
+} wifi_reconnect_stats_t;
+
+typedef void (*wifi_status_cb_t)(wifi_status_t status);
 
 // WiFi initialization
 void wifi_init(void);
 
-// Connect to WiFi network
+// Register the status callback; call before wifi_start()
+void wifi_set_status_callback(wifi_status_cb_t cb);
+
+// Start connecting and return immediately; progress is reported through
+// the status callback
+void wifi_start(const char *ssid, const char *password);
+
+// Start a new round of connection attempts after WIFI_STATUS_FAILED. Every
+// round, like every link loss, first tries the AP cached in NVS.
+void wifi_retry(void);
+
+// Connect to WiFi network, blocking until connected or failed
 void wifi_connect(const char *ssid, const char *password);
 
 // Get WiFi connection status
@@ -15,4 +43,6 @@ bool wifi_is_connected(void);
 // Get IP address as string
 const char* wifi_get_ip(void);
 
+void wifi_get_reconnect_stats(wifi_reconnect_stats_t *out);
+
 #endif // WIFI_MANAGER_H
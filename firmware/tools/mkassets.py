@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+r"""Build the asset pack for the assets partition.
+
+Every input image becomes one asset named after the file (without the
+extension), shown on the device with lv_img_set_src(img, ASSET_SRC("name")).
+The layout is described in components/asset_store/asset_pack.h.
+
+    mkassets.py -o build/assets.bin [--codec auto|none|rle] [--max-size N]
+                [--fonts fonts.txt --font-dir lvgl/src/font] images...
+
+Images with any transparent pixel are stored as RGB565 plus an alpha byte,
+all others as plain RGB565. With --codec auto an image is RLE-compressed
+only if that at least halves it: uncompressed assets are drawn straight
+from flash, compressed ones cost a decode and RAM in the decode cache.
+
+Fonts are listed in a manifest, one per line:
+
+    <asset name> <LVGL font> <characters>
+
+e.g. "font_level montserrat_30 0123456789". The glyphs of the characters
+(and of the space) are cut out of LVGL's own lv_font_<LVGL font>.c, so they
+look exactly like the built-in font; \uXXXX adds a code point such as an
+LV_SYMBOL_*. Kerning is not carried over.
+
+Reading images needs Pillow (pip install pillow); with no images an empty
+pack is written without it.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+PACK_MAGIC = 0x50413144  # "D1AP"
+PACK_VERSION = 1
+NAME_LEN = 24
+
+CF_RGB565 = 0
+CF_RGB565A8 = 1
+
+CF_FONT = 2
+
+CODEC_NONE = 0
+CODEC_RLE = 1
+
+HEADER = struct.Struct("<IHHII")
+ENTRY = struct.Struct("<%dsIIHHBBH" % NAME_LEN)
+
+FONT_HEADER = struct.Struct("<HhhHHBB")
+FONT_GLYPH = struct.Struct("<IIHBBbbH")
+
+NAME_RE = re.compile(r"^[A-Za-z0-9_]+$")
+
+
+def load_pixels(path):
+    """Return (width, height, cf, pixel bytes) in LVGL's memory layout."""
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit("mkassets: reading %s needs Pillow (pip install pillow)" % path)
+
+    img = Image.open(path).convert("RGBA")
+    width, height = img.size
+    rgba = img.tobytes()
+    has_alpha = any(a != 0xFF for a in rgba[3::4])
+
+    out = bytearray()
+    for i in range(0, len(rgba), 4):
+        r, g, b, a = rgba[i:i + 4]
+        out += struct.pack("<H", ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3))
+        if has_alpha:
+            out.append(a)
+    return width, height, CF_RGB565A8 if has_alpha else CF_RGB565, bytes(out)
+
+
+def c_field(src, name, path):
+    m = re.search(r"\.%s\s*=\s*(-?\d+)" % name, src)
+    if not m:
+        sys.exit("mkassets: %s: no .%s" % (path, name))
+    return int(m.group(1))
+
+
+def c_array(src, name, path):
+    m = re.search(r"\b%s\[\]\s*=\s*\{(.*?)\n\};" % name, src, re.S)
+    if not m:
+        sys.exit("mkassets: %s: no %s[]" % (path, name))
+    return m.group(1)
+
+
+def load_font(path, chars):
+    """Cut the glyphs of chars out of an lv_font_conv C font.
+
+    Return the font asset blob (see asset_pack.h).
+    """
+    with open(path, encoding="utf-8", errors="replace") as f:
+        src = f.read()
+    bpp = c_field(src, "bpp", path)
+    if c_field(src, "bitmap_format", path) != 0:
+        sys.exit("mkassets: %s: compressed fonts are not supported" % path)
+
+    # Bitmaps are listed glyph by glyph, each after a /* U+XXXX "c" */ comment
+    bitmap_src = c_array(src, "glyph_bitmap", path)
+    codepoints = [int(cp, 16) for cp in re.findall(r"/\* U\+([0-9A-Fa-f]+) ", bitmap_src)]
+    bitmap = bytes(int(b, 16) for b in
+                   re.findall(r"0x([0-9a-fA-F]{1,2})\b", re.sub(r"/\*.*?\*/", "", bitmap_src, flags=re.S)))
+
+    # Glyph id 0 is reserved, id n is the n-th bitmap
+    dsc_re = (r"\{\.bitmap_index = (\d+), \.adv_w = (\d+), \.box_w = (\d+), \.box_h = (\d+), "
+              r"\.ofs_x = (-?\d+), \.ofs_y = (-?\d+)\}")
+    dscs = [tuple(int(v) for v in d) for d in re.findall(dsc_re, c_array(src, "glyph_dsc", path))]
+    if len(dscs) != len(codepoints) + 1:
+        sys.exit("mkassets: %s: %d glyphs but %d bitmaps" % (path, len(dscs) - 1, len(codepoints)))
+    glyphs = dict(zip(codepoints, dscs[1:]))
+
+    wanted = sorted(set(chars) | {0x20})
+    missing = [cp for cp in wanted if cp not in glyphs]
+    if missing:
+        sys.exit("mkassets: %s has no %s" % (path, ", ".join("U+%04X" % cp for cp in missing)))
+
+    table = bytearray()
+    bitmaps = bytearray()
+    data_start = FONT_HEADER.size + FONT_GLYPH.size * len(wanted)
+    for cp in wanted:
+        index, adv_w, box_w, box_h, ofs_x, ofs_y = glyphs[cp]
+        size = (box_w * box_h * bpp + 7) // 8
+        table += FONT_GLYPH.pack(cp, data_start + len(bitmaps), adv_w, box_w, box_h, ofs_x, ofs_y, 0)
+        bitmaps += bitmap[index:index + size]
+
+    header = FONT_HEADER.pack(c_field(src, "line_height", path), c_field(src, "base_line", path),
+                              c_field(src, "underline_position", path),
+                              c_field(src, "underline_thickness", path), len(wanted), bpp, 0)
+    return header + table + bitmaps
+
+
+def load_font_manifest(path, font_dir):
+    """Return {asset name: font blob} for every line of the manifest."""
+    fonts = {}
+    with open(path, encoding="utf-8") as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.rstrip("\n")
+            if not line.strip() or line.lstrip().startswith("#"):
+                continue
+            fields = line.split(None, 2)
+            if len(fields) != 3:
+                sys.exit("mkassets: %s:%d: expected <asset name> <LVGL font> <characters>" % (path, lineno))
+            name, lvgl_font, chars = fields
+            chars = re.sub(r"\\u([0-9A-Fa-f]{4,6})", lambda m: chr(int(m.group(1), 16)), chars)
+            fonts[name] = load_font(os.path.join(font_dir, "lv_font_%s.c" % lvgl_font),
+                                    [ord(c) for c in chars])
+    return fonts
+
+
+def rle_encode(data, px):
+    """Packets of a control byte: bit 7 set = run of one pixel, else literals."""
+    pixels = [data[i:i + px] for i in range(0, len(data), px)]
+    out = bytearray()
+    i = 0
+    while i < len(pixels):
+        run = 1
+        while i + run < len(pixels) and run < 128 and pixels[i + run] == pixels[i]:
+            run += 1
+        if run >= 2:
+            out.append(0x80 | (run - 1))
+            out += pixels[i]
+            i += run
+            continue
+
+        start = i
+        while i < len(pixels) and i - start < 128:
+            if i + 1 < len(pixels) and pixels[i + 1] == pixels[i]:
+                break
+            i += 1
+        out.append(i - start - 1)
+        for p in pixels[start:i]:
+            out += p
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("-o", "--output", required=True, help="pack to write")
+    parser.add_argument("--codec", choices=("auto", "none", "rle"), default="auto")
+    parser.add_argument("--max-size", type=lambda s: int(s, 0), default=0,
+                        help="fail if the pack is larger (the partition size)")
+    parser.add_argument("--fonts", help="font manifest")
+    parser.add_argument("--font-dir", default=".", help="where LVGL's lv_font_*.c are")
+    parser.add_argument("images", nargs="*")
+    args = parser.parse_args()
+
+    assets = {}
+    for path in args.images:
+        name = os.path.splitext(os.path.basename(path))[0]
+        if not NAME_RE.match(name) or len(name) >= NAME_LEN:
+            sys.exit("mkassets: %s: names are up to %d letters, digits or _" % (path, NAME_LEN - 1))
+        if name in assets:
+            sys.exit("mkassets: %s: there is already an asset called %s" % (path, name))
+        assets[name] = load_pixels(path)
+
+    fonts = load_font_manifest(args.fonts, args.font_dir) if args.fonts else {}
+    for name in fonts:
+        if not NAME_RE.match(name) or len(name) >= NAME_LEN or name in assets:
+            sys.exit("mkassets: %s: bad or duplicate font name %s" % (args.fonts, name))
+
+    # The device looks names up by binary search
+    names = sorted(list(assets) + list(fonts), key=lambda n: n.encode())
+    offset = HEADER.size + ENTRY.size * len(names)
+    table = bytearray()
+    data = bytearray()
+    for name in names:
+        pad = -(offset + len(data)) % 4
+        data += b"\0" * pad
+        if name in fonts:
+            table += ENTRY.pack(name.encode(), offset + len(data), len(fonts[name]), 0, 0, CF_FONT, CODEC_NONE, 0)
+            data += fonts[name]
+            print("mkassets: %-23s font      %7d bytes" % (name, len(fonts[name])))
+            continue
+
+        width, height, cf, raw = assets[name]
+        codec, stored = CODEC_NONE, raw
+        if args.codec != "none":
+            rle = rle_encode(raw, 3 if cf == CF_RGB565A8 else 2)
+            if args.codec == "rle" or len(rle) * 2 <= len(raw):
+                codec, stored = CODEC_RLE, rle
+
+        table += ENTRY.pack(name.encode(), offset + len(data), len(stored),
+                            width, height, cf, codec, 0)
+        data += stored
+        print("mkassets: %-23s %4dx%-4d %s %7d bytes" % (
+            name, width, height, "rle" if codec == CODEC_RLE else "raw", len(stored)))
+
+    size = offset + len(data)
+    if args.max_size and size > args.max_size:
+        sys.exit("mkassets: pack is %d bytes, the partition only %d" % (size, args.max_size))
+
+    with open(args.output, "wb") as f:
+        f.write(HEADER.pack(PACK_MAGIC, PACK_VERSION, len(names), size, 0))
+        f.write(table)
+        f.write(data)
+    print("mkassets: %d assets, %d bytes -> %s" % (len(names), size, args.output))
+
+
+if __name__ == "__main__":
+    main()
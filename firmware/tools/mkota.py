@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""Build a signed OTA update file from the app image.
+
+    mkota.py build/sensecap-indicator-fw.bin -o build/sensecap-indicator-fw.ota \
+             --key ota_signing_key.pem
+    mkota.py --genkey ota_signing_key.pem ota_verify_key.pem
+
+The image is cut into blocks of --block-size bytes (a multiple of the 4 KiB
+flash sector) and every block is zlib-compressed on its own, so the device
+can inflate it with the ROM's miniz straight into flash and, after an
+interruption, resume with an HTTP Range request at the first block it has
+not written yet. Layout (little endian, see main/ota_manager.c):
+
+    header      magic "D1OT", version, block count, block size,
+                image size, SHA-256 of the image
+    block table per block: file offset, compressed size, CRC-32 of the data
+    signature   length, DER ECDSA P-256 signature of the SHA-256 of header
+                and block table, zero padded to 72 bytes
+    blocks      zlib streams
+
+The device only installs files signed with the private key whose public
+half it was built with (CONFIG_OTA_VERIFY_KEY). --genkey creates such a
+pair; keep the private key off the update server and out of version
+control.
+
+Serve the file from any HTTPS server that supports Range requests and
+publish its URL to sensecap/indicator/ota.
+"""
+
+import argparse
+import hashlib
+import os
+import struct
+import sys
+import zlib
+
+OTA_MAGIC = 0x544F3144  # "D1OT"
+OTA_VERSION = 2
+SECTOR = 4096
+SIG_MAX = 72
+
+HEADER = struct.Struct("<IHHII32s")
+BLOCK = struct.Struct("<III")
+SIGNATURE = struct.Struct("<B%ds" % SIG_MAX)
+
+
+def crypto():
+    """The cryptography package, which comes with the ESP-IDF Python environment."""
+    try:
+        from cryptography.hazmat.primitives import hashes, serialization
+        from cryptography.hazmat.primitives.asymmetric import ec
+    except ImportError:
+        sys.exit("mkota: needs the cryptography package (pip install cryptography)")
+    return hashes, serialization, ec
+
+
+def genkey(private_path, public_path):
+    hashes, serialization, ec = crypto()
+    if os.path.exists(private_path):
+        sys.exit("mkota: %s exists; a new key would lock out devices built with the old one" % private_path)
+    key = ec.generate_private_key(ec.SECP256R1())
+    with open(private_path, "xb") as f:
+        f.write(key.private_bytes(serialization.Encoding.PEM, serialization.PrivateFormat.PKCS8,
+                                  serialization.NoEncryption()))
+    with open(public_path, "wb") as f:
+        f.write(key.public_key().public_bytes(serialization.Encoding.PEM,
+                                              serialization.PublicFormat.SubjectPublicKeyInfo))
+    print("mkota: signing key %s (keep it secret), verification key %s" % (private_path, public_path))
+
+
+def sign(key_path, data):
+    hashes, serialization, ec = crypto()
+    with open(key_path, "rb") as f:
+        key = serialization.load_pem_private_key(f.read(), password=None)
+    if not isinstance(key, ec.EllipticCurvePrivateKey) or key.curve.name != "secp256r1":
+        sys.exit("mkota: %s is not an ECDSA P-256 key" % key_path)
+    der = key.sign(data, ec.ECDSA(hashes.SHA256()))
+    return SIGNATURE.pack(len(der), der)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("image", nargs="?", help="app image (.bin)")
+    parser.add_argument("-o", "--output")
+    parser.add_argument("--key", help="signing key (PEM, ECDSA P-256)")
+    parser.add_argument("--block-size", type=lambda s: int(s, 0), default=64 * 1024)
+    parser.add_argument("--genkey", nargs=2, metavar=("PRIVATE", "PUBLIC"),
+                        help="create a signing key pair and exit")
+    args = parser.parse_args()
+
+    if args.genkey:
+        genkey(*args.genkey)
+        return
+    if not args.image or not args.output or not args.key:
+        parser.error("the image, -o and --key are required")
+
+    if args.block_size <= 0 or args.block_size % SECTOR:
+        sys.exit("mkota: the block size must be a multiple of %d" % SECTOR)
+    with open(args.image, "rb") as f:
+        image = f.read()
+    if not image:
+        sys.exit("mkota: %s is empty" % args.image)
+
+    chunks = [image[i:i + args.block_size] for i in range(0, len(image), args.block_size)]
+    blocks = [zlib.compress(chunk, 9) for chunk in chunks]
+
+    offset = HEADER.size + BLOCK.size * len(blocks) + SIGNATURE.size
+    table = bytearray()
+    for chunk, block in zip(chunks, blocks):
+        table += BLOCK.pack(offset, len(block), zlib.crc32(chunk))
+        offset += len(block)
+
+    header = HEADER.pack(OTA_MAGIC, OTA_VERSION, len(blocks), args.block_size, len(image),
+                         hashlib.sha256(image).digest())
+    signature = sign(args.key, header + table)
+    with open(args.output, "wb") as f:
+        f.write(header)
+        f.write(table)
+        f.write(signature)
+        for block in blocks:
+            f.write(block)
+    print("mkota: %d bytes -> %d bytes in %d blocks (%.0f%%) -> %s" % (
+        len(image), offset, len(blocks), 100.0 * offset / len(image), args.output))
+
+
+if __name__ == "__main__":
+    main()
@@ -21,6 +21,10 @@
 /*Enable features to draw on transparent background.*/
 #define LV_COLOR_SCREEN_TRANSP 0
 
+/*Adjust color mix functions rounding. 0: round down (the fast RGB565 path of lv_color_mix(),
+ *which components/lvgl_blend reproduces)*/
+#define LV_COLOR_MIX_ROUND_OFS 0
+
 /*Images pixels with this color will not be drawn if they are chroma keyed)*/
 #define LV_COLOR_CHROMA_KEY lv_color_hex(0x00ff00)
 
@@ -30,10 +34,11 @@
 
 /*1: use custom malloc/free, 0: use the built-in `lv_mem_alloc()` and `lv_mem_free()`*/
 #define LV_MEM_CUSTOM 1
-#define LV_MEM_CUSTOM_INCLUDE <stdlib.h>
-#define LV_MEM_CUSTOM_ALLOC   malloc
-#define LV_MEM_CUSTOM_FREE    free
-#define LV_MEM_CUSTOM_REALLOC realloc
+/*SRAM and PSRAM TLSF pools, see components/lvgl_mem*/
+#define LV_MEM_CUSTOM_INCLUDE "lvgl_mem.h"
+#define LV_MEM_CUSTOM_ALLOC   lvgl_mem_alloc
+#define LV_MEM_CUSTOM_FREE    lvgl_mem_free
+#define LV_MEM_CUSTOM_REALLOC lvgl_mem_realloc
 
 /*Number of the intermediate memory buffer used during rendering*/
 #define LV_MEM_BUF_MAX_NUM 16
@@ -51,6 +56,14 @@
 /*Input device read period in milliseconds*/
 #define LV_INDEV_DEF_READ_PERIOD 30
 
+/*Use a custom tick source that tells the elapsed time in milliseconds.
+ *It removes the need to manually update the tick with `lv_tick_inc()`)*/
+#define LV_TICK_CUSTOM 1
+#if LV_TICK_CUSTOM
+    #define LV_TICK_CUSTOM_INCLUDE "esp_timer.h"         /*Header for the system time function*/
+    #define LV_TICK_CUSTOM_SYS_TIME_EXPR ((uint32_t)(esp_timer_get_time() / 1000))    /*Expression evaluating to current system time in ms*/
+#endif   /*LV_TICK_CUSTOM*/
+
 /*Default Dot Per Inch*/
 #define LV_DPI_DEF 130
 
@@ -64,7 +77,9 @@
 #define LV_CIRCLE_CACHE_SIZE 4
 #define LV_USE_DRAW_MASKS 1
 #define LV_DRAW_TRANSFORM_USE_MATRIX 0
-#define LV_IMG_CACHE_DEF_SIZE       1
+/* Open images kept by LVGL; compressed assets each pin their decoded
+ * pixels in the asset_store cache while open here */
+#define LV_IMG_CACHE_DEF_SIZE       8
 #define LV_GRADIENT_MAX_STOPS 2
 #define LV_GRAD_CACHE_DEF_SIZE      256
 #define LV_DITHER_GRADIENT 0
@@ -114,15 +129,17 @@
 #define LV_FONT_MONTSERRAT_8  0
 #define LV_FONT_MONTSERRAT_10 0
 #define LV_FONT_MONTSERRAT_12 0
+/* Only the default font is linked; the screens' fonts come from the assets
+ * partition (ui_fonts.h) */
 #define LV_FONT_MONTSERRAT_14 1
 #define LV_FONT_MONTSERRAT_16 0
 #define LV_FONT_MONTSERRAT_18 0
 #define LV_FONT_MONTSERRAT_20 0
-#define LV_FONT_MONTSERRAT_22 1
-#define LV_FONT_MONTSERRAT_24 1
+#define LV_FONT_MONTSERRAT_22 0
+#define LV_FONT_MONTSERRAT_24 0
 #define LV_FONT_MONTSERRAT_26 0
 #define LV_FONT_MONTSERRAT_28 0
-#define LV_FONT_MONTSERRAT_30 1
+#define LV_FONT_MONTSERRAT_30 0
 #define LV_FONT_MONTSERRAT_32 0
 #define LV_FONT_MONTSERRAT_34 0
 #define LV_FONT_MONTSERRAT_36 0
@@ -261,7 +278,7 @@
 #define LV_USE_TINY_TTF 0
 #define LV_USE_RLOTTIE 0
 #define LV_USE_FFMPEG 0
-#define LV_USE_SNAPSHOT 0
+#define LV_USE_SNAPSHOT 1
 #define LV_USE_MONKEY   0
 #define LV_USE_GRIDNAV  0
 #define LV_USE_FRAGMENT 0
@@ -3,9 +3,9 @@
 // LVGL version: 8.3.11
 // Project name: SquareLine_Project
 
-#include <stdio.h>
 #include "../ui.h"
 #include "backend.h"
+#include "dlog.h"
 
 // Backend function declarations
 // Using backend_* functions instead of Rust FFI
@@ -36,6 +36,7 @@ lv_obj_t * ui_Panel6 = NULL;
 lv_obj_t * ui_Panel7 = NULL;
 lv_obj_t * ui_RelaxSwitch = NULL;
 lv_obj_t * ui_BrightSwitch = NULL;
+lv_obj_t * ui_NetStatus = NULL;
 // event funtions
 void ui_event_RelaxSwitch(lv_event_t * e)
 {
@@ -44,7 +45,7 @@ void ui_event_RelaxSwitch(lv_event_t * e)
 
     if(event_code == LV_EVENT_VALUE_CHANGED) {
         uint8_t state = lv_obj_has_state(target, LV_STATE_CHECKED) ? 1 : 0;
-        printf("[UI] Relax switch changed: %d\n", state);
+        DLOGI(UI, "Relax switch changed: %d", state);
         
         // Update UI mutual exclusion
         if(state) {
@@ -63,7 +64,7 @@ void ui_event_BrightSwitch(lv_event_t * e)
 
     if(event_code == LV_EVENT_VALUE_CHANGED) {
         uint8_t state = lv_obj_has_state(target, LV_STATE_CHECKED) ? 1 : 0;
-        printf("[UI] Bright switch changed: %d\n", state);
+        DLOGI(UI, "Bright switch changed: %d", state);
         
         // Update UI mutual exclusion
         if(state) {
@@ -92,12 +93,8 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_y(ui_ArcContainer, 119);
     lv_obj_set_align(ui_ArcContainer, LV_ALIGN_CENTER);
     lv_obj_clear_flag(ui_ArcContainer, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);      /// Flags
-    lv_obj_set_style_radius(ui_ArcContainer, 20, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui_ArcContainer, lv_color_hex(0x282828), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_ArcContainer, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    ui_styles_add(ui_ArcContainer, &ui_style_container, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_border_color(ui_ArcContainer, lv_color_hex(0x0087C8), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui_ArcContainer, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_width(ui_ArcContainer, 3, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_LightContainer = lv_obj_create(ui_Screen_1);
     lv_obj_remove_style_all(ui_LightContainer);
@@ -107,12 +104,8 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_y(ui_LightContainer, -127);
     lv_obj_set_align(ui_LightContainer, LV_ALIGN_CENTER);
     lv_obj_clear_flag(ui_LightContainer, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);      /// Flags
-    lv_obj_set_style_radius(ui_LightContainer, 20, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui_LightContainer, lv_color_hex(0x282828), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_LightContainer, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    ui_styles_add(ui_LightContainer, &ui_style_container, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_border_color(ui_LightContainer, lv_color_hex(0xF1E144), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui_LightContainer, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_width(ui_LightContainer, 3, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_WaterTankArc = lv_arc_create(ui_Screen_1);
     lv_obj_set_width(ui_WaterTankArc, 618);
@@ -149,17 +142,8 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_align(ui_LightsText, LV_ALIGN_CENTER);
     lv_textarea_set_text(ui_LightsText, "Lights mode");
     lv_textarea_set_placeholder_text(ui_LightsText, "Placeholder...");
+    ui_styles_add(ui_LightsText, &ui_style_title, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_text_color(ui_LightsText, lv_color_hex(0xFFF526), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui_LightsText, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui_LightsText, 6, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui_LightsText, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui_LightsText, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_decor(ui_LightsText, LV_TEXT_DECOR_NONE, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui_LightsText, &lv_font_montserrat_22, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui_LightsText, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_LightsText, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui_LightsText, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui_LightsText, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_LightsText2 = lv_textarea_create(ui_Screen_1);
     lv_obj_set_width(ui_LightsText2, 224);
@@ -169,17 +153,8 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_align(ui_LightsText2, LV_ALIGN_CENTER);
     lv_textarea_set_text(ui_LightsText2, "Water level");
     lv_textarea_set_placeholder_text(ui_LightsText2, "Placeholder...");
+    ui_styles_add(ui_LightsText2, &ui_style_title, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_text_color(ui_LightsText2, lv_color_hex(0x00B6D1), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui_LightsText2, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui_LightsText2, 6, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui_LightsText2, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui_LightsText2, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_decor(ui_LightsText2, LV_TEXT_DECOR_NONE, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui_LightsText2, &lv_font_montserrat_22, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui_LightsText2, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_LightsText2, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui_LightsText2, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui_LightsText2, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_Image1 = lv_img_create(ui_Screen_1);
     lv_obj_set_width(ui_Image1, LV_SIZE_CONTENT);   /// 408
@@ -199,10 +174,7 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_align(ui_Panel1, LV_ALIGN_CENTER);
     lv_obj_clear_flag(ui_Panel1, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
     lv_obj_set_style_radius(ui_Panel1, 120, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui_Panel1, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_Panel1, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui_Panel1, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui_Panel1, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    ui_styles_add(ui_Panel1, &ui_style_panel, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_WaterLevel = lv_label_create(ui_Screen_1);
     lv_obj_set_width(ui_WaterLevel, LV_SIZE_CONTENT);   /// 1
@@ -215,7 +187,7 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_style_text_opa(ui_WaterLevel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_text_letter_space(ui_WaterLevel, 3, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_text_line_space(ui_WaterLevel, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui_WaterLevel, &lv_font_montserrat_30, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_WaterLevel, &ui_font_level, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_BrightButtonPanel = lv_obj_create(ui_Screen_1);
     lv_obj_set_width(ui_BrightButtonPanel, 124);
@@ -225,10 +197,7 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_align(ui_BrightButtonPanel, LV_ALIGN_CENTER);
     lv_obj_clear_flag(ui_BrightButtonPanel, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
     lv_obj_set_style_radius(ui_BrightButtonPanel, 10, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui_BrightButtonPanel, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_BrightButtonPanel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui_BrightButtonPanel, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui_BrightButtonPanel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    ui_styles_add(ui_BrightButtonPanel, &ui_style_panel, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_RelaxButtonPanel = lv_obj_create(ui_Screen_1);
     lv_obj_set_width(ui_RelaxButtonPanel, 124);
@@ -238,10 +207,7 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_align(ui_RelaxButtonPanel, LV_ALIGN_CENTER);
     lv_obj_clear_flag(ui_RelaxButtonPanel, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
     lv_obj_set_style_radius(ui_RelaxButtonPanel, 10, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui_RelaxButtonPanel, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_RelaxButtonPanel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui_RelaxButtonPanel, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui_RelaxButtonPanel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    ui_styles_add(ui_RelaxButtonPanel, &ui_style_panel, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_Panel3 = lv_obj_create(ui_Screen_1);
     lv_obj_set_width(ui_Panel3, 100);
@@ -250,10 +216,7 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_y(ui_Panel3, -151);
     lv_obj_set_align(ui_Panel3, LV_ALIGN_CENTER);
     lv_obj_clear_flag(ui_Panel3, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
-    lv_obj_set_style_bg_color(ui_Panel3, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_Panel3, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui_Panel3, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui_Panel3, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    ui_styles_add(ui_Panel3, &ui_style_panel, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_Label4 = lv_label_create(ui_Screen_1);
     lv_obj_set_width(ui_Label4, LV_SIZE_CONTENT);   /// 1
@@ -262,9 +225,7 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_y(ui_Label4, -153);
     lv_obj_set_align(ui_Label4, LV_ALIGN_CENTER);
     lv_label_set_text(ui_Label4, "Bright");
-    lv_obj_set_style_text_color(ui_Label4, lv_color_hex(0xF1E144), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui_Label4, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui_Label4, &lv_font_montserrat_24, LV_PART_MAIN | LV_STATE_DEFAULT);
+    ui_styles_add(ui_Label4, &ui_style_caption, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_Panel4 = lv_obj_create(ui_Screen_1);
     lv_obj_set_width(ui_Panel4, 100);
@@ -273,10 +234,7 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_y(ui_Panel4, -151);
     lv_obj_set_align(ui_Panel4, LV_ALIGN_CENTER);
     lv_obj_clear_flag(ui_Panel4, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
-    lv_obj_set_style_bg_color(ui_Panel4, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_Panel4, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui_Panel4, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui_Panel4, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    ui_styles_add(ui_Panel4, &ui_style_panel, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_Label2 = lv_label_create(ui_Screen_1);
     lv_obj_set_width(ui_Label2, LV_SIZE_CONTENT);   /// 1
@@ -285,9 +243,7 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_y(ui_Label2, -153);
     lv_obj_set_align(ui_Label2, LV_ALIGN_CENTER);
     lv_label_set_text(ui_Label2, "Relax");
-    lv_obj_set_style_text_color(ui_Label2, lv_color_hex(0xF1E144), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui_Label2, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui_Label2, &lv_font_montserrat_24, LV_PART_MAIN | LV_STATE_DEFAULT);
+    ui_styles_add(ui_Label2, &ui_style_caption, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_Panel5 = lv_obj_create(ui_Screen_1);
     lv_obj_set_width(ui_Panel5, 7);
@@ -296,10 +252,8 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_y(ui_Panel5, -99);
     lv_obj_set_align(ui_Panel5, LV_ALIGN_CENTER);
     lv_obj_clear_flag(ui_Panel5, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
+    ui_styles_add(ui_Panel5, &ui_style_divider, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_bg_color(ui_Panel5, lv_color_hex(0xFFEE25), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_Panel5, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui_Panel5, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui_Panel5, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_Panel6 = lv_obj_create(ui_Screen_1);
     lv_obj_set_width(ui_Panel6, 8);
@@ -308,10 +262,8 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_y(ui_Panel6, 124);
     lv_obj_set_align(ui_Panel6, LV_ALIGN_CENTER);
     lv_obj_clear_flag(ui_Panel6, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
+    ui_styles_add(ui_Panel6, &ui_style_divider, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_bg_color(ui_Panel6, lv_color_hex(0x0087C8), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_Panel6, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui_Panel6, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui_Panel6, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_Panel7 = lv_obj_create(ui_Screen_1);
     lv_obj_set_width(ui_Panel7, 8);
@@ -320,10 +272,8 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_y(ui_Panel7, 124);
     lv_obj_set_align(ui_Panel7, LV_ALIGN_CENTER);
     lv_obj_clear_flag(ui_Panel7, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
+    ui_styles_add(ui_Panel7, &ui_style_divider, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_bg_color(ui_Panel7, lv_color_hex(0x0087C8), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_Panel7, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui_Panel7, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui_Panel7, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_RelaxSwitch = lv_switch_create(ui_Screen_1);
     lv_obj_set_width(ui_RelaxSwitch, 93);
@@ -331,14 +281,9 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_x(ui_RelaxSwitch, 139);
     lv_obj_set_y(ui_RelaxSwitch, -76);
     lv_obj_set_align(ui_RelaxSwitch, LV_ALIGN_CENTER);
-    lv_obj_set_style_bg_color(ui_RelaxSwitch, lv_color_hex(0xAAAAAA), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_RelaxSwitch, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-
-    lv_obj_set_style_bg_color(ui_RelaxSwitch, lv_color_hex(0xFFF800), LV_PART_INDICATOR | LV_STATE_CHECKED);
-    lv_obj_set_style_bg_opa(ui_RelaxSwitch, 255, LV_PART_INDICATOR | LV_STATE_CHECKED);
-
-    lv_obj_set_style_bg_color(ui_RelaxSwitch, lv_color_hex(0x000000), LV_PART_KNOB | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_RelaxSwitch, 255, LV_PART_KNOB | LV_STATE_DEFAULT);
+    ui_styles_add(ui_RelaxSwitch, &ui_style_switch_track, LV_PART_MAIN | LV_STATE_DEFAULT);
+    ui_styles_add(ui_RelaxSwitch, &ui_style_switch_indicator, LV_PART_INDICATOR | LV_STATE_CHECKED);
+    ui_styles_add(ui_RelaxSwitch, &ui_style_switch_knob, LV_PART_KNOB | LV_STATE_DEFAULT);
 
     ui_BrightSwitch = lv_switch_create(ui_Screen_1);
     lv_obj_set_width(ui_BrightSwitch, 93);
@@ -346,14 +291,21 @@ void ui_Screen_1_screen_init(void)
     lv_obj_set_x(ui_BrightSwitch, -134);
     lv_obj_set_y(ui_BrightSwitch, -76);
     lv_obj_set_align(ui_BrightSwitch, LV_ALIGN_CENTER);
-    lv_obj_set_style_bg_color(ui_BrightSwitch, lv_color_hex(0xAAAAAA), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_BrightSwitch, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-
-    lv_obj_set_style_bg_color(ui_BrightSwitch, lv_color_hex(0xFFF800), LV_PART_INDICATOR | LV_STATE_CHECKED);
-    lv_obj_set_style_bg_opa(ui_BrightSwitch, 255, LV_PART_INDICATOR | LV_STATE_CHECKED);
-
-    lv_obj_set_style_bg_color(ui_BrightSwitch, lv_color_hex(0x000000), LV_PART_KNOB | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui_BrightSwitch, 255, LV_PART_KNOB | LV_STATE_DEFAULT);
+    ui_styles_add(ui_BrightSwitch, &ui_style_switch_track, LV_PART_MAIN | LV_STATE_DEFAULT);
+    ui_styles_add(ui_BrightSwitch, &ui_style_switch_indicator, LV_PART_INDICATOR | LV_STATE_CHECKED);
+    ui_styles_add(ui_BrightSwitch, &ui_style_switch_knob, LV_PART_KNOB | LV_STATE_DEFAULT);
+
+    // Connectivity indicator, updated by ui_set_network_state()
+    ui_NetStatus = lv_label_create(ui_Screen_1);
+    lv_obj_set_width(ui_NetStatus, LV_SIZE_CONTENT);
+    lv_obj_set_height(ui_NetStatus, LV_SIZE_CONTENT);
+    lv_obj_set_x(ui_NetStatus, -26);
+    lv_obj_set_y(ui_NetStatus, 20);
+    lv_obj_set_align(ui_NetStatus, LV_ALIGN_TOP_RIGHT);
+    lv_label_set_text(ui_NetStatus, LV_SYMBOL_WIFI);
+    lv_obj_set_style_text_color(ui_NetStatus, lv_color_hex(0x555555), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_opa(ui_NetStatus, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_NetStatus, &ui_font_title, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     lv_obj_add_event_cb(ui_RelaxSwitch, ui_event_RelaxSwitch, LV_EVENT_ALL, NULL);
     lv_obj_add_event_cb(ui_BrightSwitch, ui_event_BrightSwitch, LV_EVENT_ALL, NULL);
@@ -397,5 +349,6 @@ void ui_Screen_1_screen_destroy(void)
     ui_Panel7 = NULL;
     ui_RelaxSwitch = NULL;
     ui_BrightSwitch = NULL;
+    ui_NetStatus = NULL;
 
 }
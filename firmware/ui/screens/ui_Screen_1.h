@@ -35,6 +35,7 @@ extern void ui_event_RelaxSwitch(lv_event_t * e);
 extern lv_obj_t * ui_RelaxSwitch;
 extern void ui_event_BrightSwitch(lv_event_t * e);
 extern lv_obj_t * ui_BrightSwitch;
+extern lv_obj_t * ui_NetStatus;
 // CUSTOM VARIABLES
 extern lv_obj_t * uic_Screen_1;
 extern lv_obj_t * uic_ArcContainer;
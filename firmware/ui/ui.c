@@ -4,9 +4,15 @@
 // Project name: SquareLine_Project
 
 #include <stdio.h>
+#include <string.h>
 #include "ui.h"
 #include "ui_helpers.h"
 #include "screens/ui_Screen_1.h"
+#include "ui_queue.h"
+#include "ui_render_cache.h"
+#include "ui_history.h"
+#include "ui_tanks.h"
+#include "dlog.h"
 
 ///////////////////// VARIABLES ////////////////////
 
@@ -25,6 +31,16 @@ lv_obj_t * ui____initial_actions0;
 
 ///////////////////// ANIMATIONS ////////////////////
 
+// Level changes sweep the indicator instead of jumping. Each step moves the
+// arc's end angle, and LVGL only invalidates the sector between the old and
+// the new angle.
+#define WATER_LEVEL_ANIM_MS 300
+
+static void water_level_anim_cb(void * arc, int32_t value)
+{
+    lv_arc_set_value((lv_obj_t *)arc, (int16_t)value);
+}
+
 ///////////////////// FUNCTIONS ////////////////////
 
 // Backend declarations - using C backend instead of Rust
@@ -38,68 +54,142 @@ void ui_init(void)
     lv_theme_t * theme = lv_theme_default_init(dispp, lv_palette_main(LV_PALETTE_BLUE), lv_palette_main(LV_PALETTE_RED),
                                                false, LV_FONT_DEFAULT);
     lv_disp_set_theme(dispp, theme);
+    ui_fonts_init();
     ui_Screen_1_screen_init();
+
+    // Widgets that never change after init are drawn once into the cache
+    const ui_render_cache_layer_t static_layers[] = {
+        { ui_ArcContainer, UI_RENDER_CACHE_WHOLE },
+        { ui_LightContainer, UI_RENDER_CACHE_WHOLE },
+        { ui_WaterTankArc, UI_RENDER_CACHE_ARC_BACKGROUND },
+        { ui_Image1, UI_RENDER_CACHE_WHOLE },
+    };
+    ui_render_cache_build(ui_Screen_1, static_layers, sizeof(static_layers) / sizeof(static_layers[0]));
+    // Live widgets, created after the cache so they are not baked; the
+    // history panel last, so it covers the tank tiles
+    ui_tanks_init(ui_Screen_1);
+    // Tapping the level readout swaps the tank for its history
+    ui_history_init(ui_Screen_1, ui_ArcContainer, ui_Panel1);
+
     ui____initial_actions0 = lv_obj_create(NULL);
     lv_disp_load_scr(ui_Screen_1);
 }
 
 void ui_destroy(void)
 {
+    ui_history_destroy();
+    ui_tanks_destroy();
+    ui_render_cache_drop();
     ui_Screen_1_screen_destroy();
 }
 
 // Backend Functions - called by C backend
 // These update the UI elements when data changes
 
+// Thread-safe variants: callable from any task. They only record the new
+// value in the UI queue; lvgl_task applies it on its next iteration.
+
 void ui_update_water_level_async(int level)
 {
-    // This function is called from backend (non-LVGL thread)
-    // Use lv_async_call to safely update UI from main thread
-    printf("[UI] Async water level update received: %d%%\n", level);
-    ui_set_water_level(level);
+    ui_queue_post(UI_FIELD_WATER_LEVEL, level);
+}
+
+void ui_update_tank_level_async(int tank, int level)
+{
+    if (tank < 0 || tank >= BACKEND_TANK_MAX) return;
+    ui_queue_post((ui_field_t)(UI_FIELD_TANK_LEVEL + tank), level);
+}
+
+void ui_update_bright_state_async(int state)
+{
+    ui_queue_post(UI_FIELD_BRIGHT_STATE, state);
+}
+
+void ui_update_relax_state_async(int state)
+{
+    ui_queue_post(UI_FIELD_RELAX_STATE, state);
+}
+
+void ui_update_network_state_async(int wifi_connected, int mqtt_connected)
+{
+    ui_queue_post(UI_FIELD_NETWORK_STATE, (wifi_connected ? UI_NETWORK_WIFI : 0) |
+                                          (mqtt_connected ? UI_NETWORK_MQTT : 0));
 }
 
 void ui_set_water_level(int level)
 {
     // This function should be called from LVGL thread only
     // Updates the water level display
-    printf("[UI] Updating water level display: %d%%\n", level);
+    DLOGI(UI, "Updating water level display: %d%%", level);
     
     // Clamp level to 0-100
     if (level < 0) level = 0;
     if (level > 100) level = 100;
     
-    // Update the arc value
+    // Sweep the arc from wherever it is now, even mid-animation
     if (ui_WaterTankArc != NULL) {
-        lv_arc_set_value(ui_WaterTankArc, level);
+        int from = lv_arc_get_value(ui_WaterTankArc);
+        lv_anim_del(ui_WaterTankArc, water_level_anim_cb);
+        if (from != level) {
+            lv_anim_t anim;
+            lv_anim_init(&anim);
+            lv_anim_set_var(&anim, ui_WaterTankArc);
+            lv_anim_set_exec_cb(&anim, water_level_anim_cb);
+            lv_anim_set_values(&anim, from, level);
+            lv_anim_set_time(&anim, WATER_LEVEL_ANIM_MS);
+            lv_anim_set_path_cb(&anim, lv_anim_path_ease_out);
+            lv_anim_start(&anim);
+        }
     }
     
-    // Update the label text
+    // Update the label text; setting the same text would still redraw it
     if (ui_WaterLevel != NULL) {
         char buf[8];
         snprintf(buf, sizeof(buf), "%d", level);
-        lv_label_set_text(ui_WaterLevel, buf);
+        if (strcmp(lv_label_get_text(ui_WaterLevel), buf) != 0) {
+            lv_label_set_text(ui_WaterLevel, buf);
+        }
     }
     
-    // Change arc color based on level
+    // Change arc color based on level. A new color redraws the whole arc,
+    // so only touch it when the level crosses a threshold.
     if (ui_WaterTankArc != NULL) {
-        if (level < 10) {
-            // Critical - red
-            lv_obj_set_style_arc_color(ui_WaterTankArc, lv_color_hex(0xFF0000), LV_PART_INDICATOR | LV_STATE_DEFAULT);
-        } else if (level < 20) {
-            // Low - orange
-            lv_obj_set_style_arc_color(ui_WaterTankArc, lv_color_hex(0xFFA500), LV_PART_INDICATOR | LV_STATE_DEFAULT);
-        } else {
-            // Normal - blue
-            lv_obj_set_style_arc_color(ui_WaterTankArc, lv_color_hex(0x1F84D8), LV_PART_INDICATOR | LV_STATE_DEFAULT);
+        lv_color_t color = ui_level_color(level);
+        if (!lv_color_eq(lv_obj_get_style_arc_color(ui_WaterTankArc, LV_PART_INDICATOR), color)) {
+            lv_obj_set_style_arc_color(ui_WaterTankArc, color, LV_PART_INDICATOR | LV_STATE_DEFAULT);
         }
     }
+
+    ui_history_refresh();
+}
+
+lv_color_t ui_level_color(int level)
+{
+    if (level < 10) {
+        // Critical - red
+        return lv_color_hex(0xFF0000);
+    } else if (level < 20) {
+        // Low - orange
+        return lv_color_hex(0xFFA500);
+    }
+    // Normal - blue
+    return lv_color_hex(0x1F84D8);
+}
+
+void ui_set_tank_level(int tank, int level)
+{
+    // This function should be called from LVGL thread only
+    // The main tank also drives the arc
+    if (tank == 0) {
+        ui_set_water_level(level);
+    }
+    ui_tanks_set_level(tank, level);
 }
 
 void ui_set_bright_state(int state)
 {
     // Updates bright switch state from Rust/backend
-    printf("[UI] Setting bright state: %d\n", state);
+    DLOGI(UI, "Setting bright state: %d", state);
     if (ui_BrightSwitch != NULL) {
         if (state) {
             lv_obj_add_state(ui_BrightSwitch, LV_STATE_CHECKED);
@@ -112,7 +202,7 @@ void ui_set_bright_state(int state)
 void ui_set_relax_state(int state)
 {
     // Updates relax switch state from Rust/backend
-    printf("[UI] Setting relax state: %d\n", state);
+    DLOGI(UI, "Setting relax state: %d", state);
     if (ui_RelaxSwitch != NULL) {
         if (state) {
             lv_obj_add_state(ui_RelaxSwitch, LV_STATE_CHECKED);
@@ -121,3 +211,18 @@ void ui_set_relax_state(int state)
         }
     }
 }
+
+void ui_set_network_state(int wifi_connected, int mqtt_connected)
+{
+    // Offline: grey, WiFi only: orange, WiFi and MQTT: green
+    // This function should be called from LVGL thread only
+    if (ui_NetStatus == NULL) return;
+
+    uint32_t color = 0x555555;
+    if (wifi_connected && mqtt_connected) {
+        color = 0x3CD070;
+    } else if (wifi_connected) {
+        color = 0xFFA500;
+    }
+    lv_obj_set_style_text_color(ui_NetStatus, lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+}
@@ -14,6 +14,7 @@ extern "C" {
 #include "lvgl/lvgl.h"
 
 #include "ui_helpers.h"
+#include "ui_styles.h"
 #include "ui_events.h"
 #include "ui_theme_manager.h"
 #include "ui_themes.h"
@@ -34,11 +35,21 @@ extern lv_obj_t * ui____initial_actions0;
 void ui_init(void);
 void ui_destroy(void);
 
-// FFI Functions - called by Rust backend
+// Backend functions. The *_async variants may be called from any task;
+// the others must run in the LVGL task.
 void ui_update_water_level_async(int level);
+void ui_update_tank_level_async(int tank, int level);
+void ui_update_bright_state_async(int state);
+void ui_update_relax_state_async(int state);
+void ui_update_network_state_async(int wifi_connected, int mqtt_connected);
 void ui_set_water_level(int level);
+void ui_set_tank_level(int tank, int level);
 void ui_set_bright_state(int state);
 void ui_set_relax_state(int state);
+void ui_set_network_state(int wifi_connected, int mqtt_connected);
+
+// Arc and tank bar color for a level: red when critical, orange when low
+lv_color_t ui_level_color(int level);
 
 #ifdef __cplusplus
 } /*extern "C"*/
@@ -0,0 +1,43 @@
+// Text fonts of the screens, see ui_fonts.h
+
+#include <stdio.h>
+#include "ui_fonts.h"
+
+#ifdef ESP_PLATFORM
+#include "asset_store.h"
+#endif
+
+lv_font_t ui_font_title;
+lv_font_t ui_font_caption;
+lv_font_t ui_font_level;
+
+#ifdef ESP_PLATFORM
+
+static void load(lv_font_t * font, const char * name)
+{
+    if (asset_store_font_load(name, font)) {
+        // Characters left out of the subset still show, if smaller
+        font->fallback = LV_FONT_DEFAULT;
+    } else {
+        printf("[UI] Font %s not in the assets partition, using the default font\n", name);
+        *font = *LV_FONT_DEFAULT;
+    }
+}
+
+void ui_fonts_init(void)
+{
+    load(&ui_font_title, "font_title");
+    load(&ui_font_caption, "font_caption");
+    load(&ui_font_level, "font_level");
+}
+
+#else
+
+void ui_fonts_init(void)
+{
+    ui_font_title = lv_font_montserrat_22;
+    ui_font_caption = lv_font_montserrat_24;
+    ui_font_level = lv_font_montserrat_30;
+}
+
+#endif
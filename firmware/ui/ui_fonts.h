@@ -0,0 +1,30 @@
+// Text fonts of the screens
+//
+// On the device they are subsets of Montserrat cut to the characters the UI
+// shows (firmware/assets/fonts.txt) and read from the assets partition, so
+// no font but LV_FONT_DEFAULT is linked into the app. The simulator, and a
+// device whose assets partition was not flashed, use LVGL's fonts instead.
+//
+// The objects have fixed addresses so that constant styles can refer to
+// them; ui_fonts_init() fills them in before any screen is created.
+
+#ifndef _UI_FONTS_H
+#define _UI_FONTS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl/lvgl.h"
+
+extern lv_font_t ui_font_title;     // 22 px: section titles, network status symbol
+extern lv_font_t ui_font_caption;   // 24 px: switch labels
+extern lv_font_t ui_font_level;     // 30 px: water level digits
+
+void ui_fonts_init(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
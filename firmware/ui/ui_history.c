@@ -0,0 +1,154 @@
+// Water level history chart, see ui_history.h
+
+#include "ui_history.h"
+#include "ui_styles.h"
+#include "level_history.h"
+#include "dlog.h"
+
+#if LV_USE_CHART == 0
+    #error "ui_history needs LV_USE_CHART 1 in lv_conf.h"
+#endif
+
+// The newest bucket changes at most once a minute in any view
+#define HISTORY_REFRESH_MS  60000
+
+// The screen fonts only hold the glyphs of fonts.txt; captions use the
+// built-in default font
+static const char * const view_titles[LEVEL_HISTORY_VIEWS] = {
+    [LEVEL_HISTORY_HOUR] = "Water level, last hour",
+    [LEVEL_HISTORY_DAY] = "Water level, last 24 hours",
+    [LEVEL_HISTORY_WEEK] = "Water level, last 7 days",
+};
+
+static lv_obj_t * history_panel;
+static lv_obj_t * history_title;
+static lv_obj_t * history_chart;
+static lv_chart_series_t * max_series;
+static lv_chart_series_t * min_series;
+static lv_timer_t * history_timer;
+static level_history_view_t history_view;
+
+// The chart draws straight from these, no per-point copies inside LVGL
+static lv_coord_t max_values[LEVEL_HISTORY_POINTS];
+static lv_coord_t min_values[LEVEL_HISTORY_POINTS];
+
+static void history_load(void)
+{
+    level_history_point_t points[LEVEL_HISTORY_POINTS];
+    size_t filled = level_history_read(history_view, points);
+
+    for (size_t i = 0; i < LEVEL_HISTORY_POINTS; i++) {
+        if (points[i].min == LEVEL_HISTORY_NONE) {
+            max_values[i] = LV_CHART_POINT_NONE;
+            min_values[i] = LV_CHART_POINT_NONE;
+        } else {
+            max_values[i] = points[i].max;
+            min_values[i] = points[i].min;
+        }
+    }
+    lv_chart_refresh(history_chart);
+    DLOGI(UI, "History: %s, %u of %u buckets", view_titles[history_view], (unsigned)filled,
+          (unsigned)LEVEL_HISTORY_POINTS);
+}
+
+static void history_timer_cb(lv_timer_t * timer)
+{
+    (void)timer;
+    history_load();
+}
+
+static void history_show(level_history_view_t view)
+{
+    history_view = view;
+    lv_label_set_text_static(history_title, view_titles[view]);
+    history_load();
+    lv_obj_clear_flag(history_panel, LV_OBJ_FLAG_HIDDEN);
+    lv_timer_reset(history_timer);
+    lv_timer_resume(history_timer);
+}
+
+static void history_hide(void)
+{
+    lv_obj_add_flag(history_panel, LV_OBJ_FLAG_HIDDEN);
+    lv_timer_pause(history_timer);
+}
+
+static void opener_event_cb(lv_event_t * e)
+{
+    (void)e;
+    history_show(LEVEL_HISTORY_HOUR);
+}
+
+static void panel_event_cb(lv_event_t * e)
+{
+    (void)e;
+    if (history_view + 1 < LEVEL_HISTORY_VIEWS) {
+        history_show((level_history_view_t)(history_view + 1));
+    } else {
+        history_hide();
+    }
+}
+
+void ui_history_init(lv_obj_t * screen, lv_obj_t * cover, lv_obj_t * opener)
+{
+    lv_obj_update_layout(cover);
+
+    history_panel = lv_obj_create(screen);
+    lv_obj_remove_style_all(history_panel);
+    lv_obj_set_size(history_panel, lv_obj_get_width(cover), lv_obj_get_height(cover));
+    lv_obj_set_pos(history_panel, lv_obj_get_x(cover), lv_obj_get_y(cover));
+    lv_obj_clear_flag(history_panel, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(history_panel, LV_OBJ_FLAG_HIDDEN);
+    ui_styles_add(history_panel, &ui_style_container, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_color(history_panel, lv_color_hex(0x0087C8), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_event_cb(history_panel, panel_event_cb, LV_EVENT_CLICKED, NULL);
+
+    history_title = lv_label_create(history_panel);
+    lv_obj_align(history_title, LV_ALIGN_TOP_MID, 0, 10);
+    lv_obj_set_style_text_color(history_title, lv_color_hex(0x00B6D1), LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    history_chart = lv_chart_create(history_panel);
+    lv_obj_set_size(history_chart, lv_obj_get_width(cover) - 40, lv_obj_get_height(cover) - 54);
+    lv_obj_align(history_chart, LV_ALIGN_BOTTOM_MID, 0, -12);
+    // Clicks go to the panel
+    lv_obj_clear_flag(history_chart, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_chart_set_type(history_chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_point_count(history_chart, LEVEL_HISTORY_POINTS);
+    lv_chart_set_range(history_chart, LV_CHART_AXIS_PRIMARY_Y, 0, 100);
+    lv_chart_set_div_line_count(history_chart, 5, 0);
+    lv_obj_set_style_bg_color(history_chart, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_width(history_chart, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_line_color(history_chart, lv_color_hex(0x303030), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_line_width(history_chart, 2, LV_PART_ITEMS | LV_STATE_DEFAULT);
+    // No point markers: lines only
+    lv_obj_set_style_size(history_chart, 0, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+
+    max_series = lv_chart_add_series(history_chart, lv_color_hex(0x1F84D8), LV_CHART_AXIS_PRIMARY_Y);
+    min_series = lv_chart_add_series(history_chart, lv_color_hex(0x00C7EF), LV_CHART_AXIS_PRIMARY_Y);
+    lv_chart_set_ext_y_array(history_chart, max_series, max_values);
+    lv_chart_set_ext_y_array(history_chart, min_series, min_values);
+
+    history_timer = lv_timer_create(history_timer_cb, HISTORY_REFRESH_MS, NULL);
+    lv_timer_pause(history_timer);
+
+    lv_obj_add_event_cb(opener, opener_event_cb, LV_EVENT_CLICKED, NULL);
+}
+
+void ui_history_refresh(void)
+{
+    if (history_panel != NULL && !lv_obj_has_flag(history_panel, LV_OBJ_FLAG_HIDDEN)) {
+        history_load();
+    }
+}
+
+void ui_history_destroy(void)
+{
+    if (history_timer != NULL) {
+        lv_timer_del(history_timer);
+        history_timer = NULL;
+    }
+    // The widgets go with the screen
+    history_panel = NULL;
+    history_title = NULL;
+    history_chart = NULL;
+}
@@ -0,0 +1,33 @@
+// Water level history chart
+//
+// A panel over the water tank container with a min/max line chart of the
+// level history (level_history.h). Tapping the opener shows the last hour;
+// each tap on the chart steps to the last day, the last week, and back to
+// the tank. Every view is LEVEL_HISTORY_POINTS precomputed buckets, so a
+// week draws as fast as an hour. While shown, the chart follows new
+// samples and the passing of time; hidden, it costs nothing.
+
+#ifndef _UI_HISTORY_H
+#define _UI_HISTORY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl/lvgl.h"
+
+// Build the hidden panel on screen, over the area of cover; a click on
+// opener shows it. Call after the render cache is built, so it stays live.
+void ui_history_init(lv_obj_t * screen, lv_obj_t * cover, lv_obj_t * opener);
+
+// Reload the chart if it is shown. LVGL task only.
+void ui_history_refresh(void);
+
+// Before the screen is deleted
+void ui_history_destroy(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
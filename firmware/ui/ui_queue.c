@@ -0,0 +1,71 @@
+#include "ui_queue.h"
+#include "ui.h"
+#include <stdatomic.h>
+#include <stddef.h>
+
+_Static_assert(UI_FIELD_COUNT <= 32, "dirty mask is 32 bits");
+
+static atomic_int_least32_t field_values[UI_FIELD_COUNT];
+static atomic_uint_least32_t dirty_mask;
+static void (*wake_cb)(void) = NULL;
+
+void ui_queue_post(ui_field_t field, int32_t value)
+{
+    if (field >= UI_FIELD_COUNT) return;
+
+    // Value first, then the dirty bit (release), so a drain that sees the
+    // bit also sees this value or a newer one
+    atomic_store_explicit(&field_values[field], value, memory_order_relaxed);
+    uint32_t prev = atomic_fetch_or_explicit(&dirty_mask, 1u << field, memory_order_release);
+
+    // Only the first post since the last drain needs to wake the consumer
+    if (prev == 0 && wake_cb) {
+        wake_cb();
+    }
+}
+
+static void ui_queue_apply(ui_field_t field, int32_t value)
+{
+    if (field >= UI_FIELD_TANK_LEVEL) {
+        ui_set_tank_level(field - UI_FIELD_TANK_LEVEL, value);
+        return;
+    }
+
+    switch (field) {
+        case UI_FIELD_BRIGHT_STATE:
+            ui_set_bright_state(value);
+            break;
+        case UI_FIELD_RELAX_STATE:
+            ui_set_relax_state(value);
+            break;
+        case UI_FIELD_NETWORK_STATE:
+            ui_set_network_state((value & UI_NETWORK_WIFI) != 0, (value & UI_NETWORK_MQTT) != 0);
+            break;
+        default:
+            break;
+    }
+}
+
+uint32_t ui_queue_drain(void)
+{
+    uint32_t pending = atomic_exchange_explicit(&dirty_mask, 0, memory_order_acquire);
+    uint32_t applied = 0;
+
+    while (pending) {
+        ui_field_t field = (ui_field_t)__builtin_ctz(pending);
+        pending &= pending - 1;
+        ui_queue_apply(field, atomic_load_explicit(&field_values[field], memory_order_relaxed));
+        applied++;
+    }
+    return applied;
+}
+
+uint32_t ui_queue_pending(void)
+{
+    return atomic_load_explicit(&dirty_mask, memory_order_relaxed);
+}
+
+void ui_queue_set_wake_cb(void (*cb)(void))
+{
+    wake_cb = cb;
+}
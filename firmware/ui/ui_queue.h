@@ -0,0 +1,49 @@
+#ifndef UI_QUEUE_H
+#define UI_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "backend.h"
+
+// Lock-free, allocation-free UI command queue.
+//
+// Any task may post; only the LVGL task drains. Each field has one slot
+// holding its latest value plus a bit in a shared dirty mask, so posting
+// the same field again before the next drain simply replaces the value:
+// a burst of updates turns into a single widget update and redraw.
+
+typedef enum {
+    UI_FIELD_BRIGHT_STATE,
+    UI_FIELD_RELAX_STATE,
+    UI_FIELD_NETWORK_STATE,
+    UI_FIELD_TANK_LEVEL,    // Tank 0, the main tank; tank i is UI_FIELD_TANK_LEVEL + i
+    UI_FIELD_COUNT = UI_FIELD_TANK_LEVEL + BACKEND_TANK_MAX
+} ui_field_t;
+
+#define UI_FIELD_WATER_LEVEL UI_FIELD_TANK_LEVEL
+
+// Network state value: bit 0 WiFi connected, bit 1 MQTT connected
+#define UI_NETWORK_WIFI     0x1
+#define UI_NETWORK_MQTT     0x2
+
+// Store the latest value of a field and mark it dirty. Safe from any task.
+void ui_queue_post(ui_field_t field, int32_t value);
+
+// Apply all pending fields to the widgets. LVGL task only, once per
+// lv_timer_handler() iteration. Returns the number of fields applied.
+uint32_t ui_queue_drain(void);
+
+// Bit mask (1 << field) of the fields posted since the last drain
+uint32_t ui_queue_pending(void);
+
+// Optional hook called after each post, e.g. to wake a sleeping LVGL task
+void ui_queue_set_wake_cb(void (*cb)(void));
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
@@ -0,0 +1,252 @@
+// Render cache for the static parts of a screen, see ui_render_cache.h
+
+#include <stdio.h>
+#include <string.h>
+#include "ui_render_cache.h"
+
+#if LV_USE_SNAPSHOT == 0
+    #error "ui_render_cache needs LV_USE_SNAPSHOT 1 in lv_conf.h"
+#endif
+
+// A full 480x480 RGB565 snapshot is 450 KiB: PSRAM or nothing on the device
+#ifdef ESP_PLATFORM
+#include "esp_heap_caps.h"
+#define CACHE_ALLOC(size) heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#define CACHE_FREE(p)     heap_caps_free(p)
+#else
+#define CACHE_ALLOC(size) lv_mem_alloc(size)
+#define CACHE_FREE(p)     lv_mem_free(p)
+#endif
+
+#define UI_RENDER_CACHE_MAX_LAYERS   8
+#define UI_RENDER_CACHE_MAX_CHILDREN 48
+
+typedef struct {
+    ui_render_cache_layer_t layer;
+    bool baked;
+    // Arc background: the track's styles before it was made transparent
+    lv_opa_t arc_opa;
+    lv_opa_t bg_opa;
+    lv_opa_t border_opa;
+} cache_entry_t;
+
+static lv_obj_t * cache_screen;
+static cache_entry_t entries[UI_RENDER_CACHE_MAX_LAYERS];
+static size_t entry_count;
+
+static lv_obj_t * cache_img;
+static lv_img_dsc_t cache_dsc;
+static void * cache_buf;
+
+static cache_entry_t * find_entry(const lv_obj_t * obj)
+{
+    for (size_t i = 0; i < entry_count; i++) {
+        if (entries[i].layer.obj == obj) return &entries[i];
+    }
+    return NULL;
+}
+
+static void get_draw_area(lv_obj_t * obj, lv_area_t * area)
+{
+    lv_coord_t ext = _lv_obj_get_ext_draw_size(obj);
+    lv_obj_get_coords(obj, area);
+    lv_area_increase(area, ext, ext);
+}
+
+// Walk the screen in drawing order. A layer can only be baked if nothing
+// live is drawn underneath it, otherwise moving it into the bottom image
+// would change what covers what.
+static void select_layers(void)
+{
+    lv_area_t live[UI_RENDER_CACHE_MAX_CHILDREN];
+    size_t live_count = 0;
+    uint32_t child_count = lv_obj_get_child_cnt(cache_screen);
+
+    for (uint32_t i = 0; i < child_count; i++) {
+        lv_obj_t * obj = lv_obj_get_child(cache_screen, i);
+        if (lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)) continue;
+
+        lv_area_t area;
+        get_draw_area(obj, &area);
+
+        cache_entry_t * entry = find_entry(obj);
+        if (entry) {
+            entry->baked = true;
+            for (size_t j = 0; j < live_count && entry->baked; j++) {
+                lv_area_t common;
+                if (_lv_area_intersect(&common, &area, &live[j])) entry->baked = false;
+            }
+            // Hidden widgets take no input
+            if (entry->layer.kind == UI_RENDER_CACHE_WHOLE && lv_obj_has_flag(obj, LV_OBJ_FLAG_CLICKABLE)) {
+                entry->baked = false;
+            }
+            if (!entry->baked) {
+                printf("[UI] Render cache: layer %u stays live\n", (unsigned)(entry - entries));
+            }
+        }
+
+        // The indicator of a baked arc is still drawn at the arc's depth
+        if (!entry || !entry->baked || entry->layer.kind == UI_RENDER_CACHE_ARC_BACKGROUND) {
+            live[live_count++] = area;
+        }
+    }
+}
+
+// Show only the baked parts, render them, then put everything back
+static lv_res_t take_snapshot(uint32_t size)
+{
+    lv_obj_t * hidden[UI_RENDER_CACHE_MAX_CHILDREN];
+    size_t hidden_count = 0;
+    uint32_t child_count = lv_obj_get_child_cnt(cache_screen);
+
+    for (uint32_t i = 0; i < child_count; i++) {
+        lv_obj_t * obj = lv_obj_get_child(cache_screen, i);
+        cache_entry_t * entry = find_entry(obj);
+        if (entry && entry->baked) continue;
+        if (lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)) continue;
+        lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+        hidden[hidden_count++] = obj;
+    }
+
+    lv_opa_t indic_opa[UI_RENDER_CACHE_MAX_LAYERS];
+    lv_opa_t knob_opa[UI_RENDER_CACHE_MAX_LAYERS];
+    for (size_t i = 0; i < entry_count; i++) {
+        if (!entries[i].baked || entries[i].layer.kind != UI_RENDER_CACHE_ARC_BACKGROUND) continue;
+        lv_obj_t * arc = entries[i].layer.obj;
+        indic_opa[i] = lv_obj_get_style_opa(arc, LV_PART_INDICATOR);
+        knob_opa[i] = lv_obj_get_style_opa(arc, LV_PART_KNOB);
+        lv_obj_set_style_opa(arc, LV_OPA_TRANSP, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+        lv_obj_set_style_opa(arc, LV_OPA_TRANSP, LV_PART_KNOB | LV_STATE_DEFAULT);
+    }
+
+    lv_res_t res = lv_snapshot_take_to_buf(cache_screen, LV_IMG_CF_TRUE_COLOR, &cache_dsc, cache_buf, size);
+
+    for (size_t i = 0; i < entry_count; i++) {
+        if (!entries[i].baked || entries[i].layer.kind != UI_RENDER_CACHE_ARC_BACKGROUND) continue;
+        lv_obj_t * arc = entries[i].layer.obj;
+        lv_obj_set_style_opa(arc, indic_opa[i], LV_PART_INDICATOR | LV_STATE_DEFAULT);
+        lv_obj_set_style_opa(arc, knob_opa[i], LV_PART_KNOB | LV_STATE_DEFAULT);
+    }
+    for (size_t i = 0; i < hidden_count; i++) {
+        lv_obj_clear_flag(hidden[i], LV_OBJ_FLAG_HIDDEN);
+    }
+    return res;
+}
+
+static void hide_baked(void)
+{
+    for (size_t i = 0; i < entry_count; i++) {
+        cache_entry_t * entry = &entries[i];
+        if (!entry->baked) continue;
+        lv_obj_t * obj = entry->layer.obj;
+
+        if (entry->layer.kind == UI_RENDER_CACHE_WHOLE) {
+            lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+            continue;
+        }
+        entry->arc_opa = lv_obj_get_style_arc_opa(obj, LV_PART_MAIN);
+        entry->bg_opa = lv_obj_get_style_bg_opa(obj, LV_PART_MAIN);
+        entry->border_opa = lv_obj_get_style_border_opa(obj, LV_PART_MAIN);
+        lv_obj_set_style_arc_opa(obj, LV_OPA_TRANSP, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_bg_opa(obj, LV_OPA_TRANSP, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_border_opa(obj, LV_OPA_TRANSP, LV_PART_MAIN | LV_STATE_DEFAULT);
+    }
+}
+
+// After a failed bake nothing was hidden, so there is nothing to restore
+static void forget_layers(void)
+{
+    for (size_t i = 0; i < entry_count; i++) entries[i].baked = false;
+}
+
+static bool bake(void)
+{
+    if (lv_obj_get_child_cnt(cache_screen) > UI_RENDER_CACHE_MAX_CHILDREN) {
+        printf("[UI] Render cache: screen has too many children\n");
+        return false;
+    }
+
+    lv_obj_update_layout(cache_screen);
+    select_layers();
+
+    uint32_t size = lv_snapshot_buf_size_needed(cache_screen, LV_IMG_CF_TRUE_COLOR);
+    cache_buf = CACHE_ALLOC(size);
+    if (cache_buf == NULL) {
+        printf("[UI] Render cache: no memory for a %u byte snapshot, drawing live\n", (unsigned)size);
+        forget_layers();
+        return false;
+    }
+
+    if (take_snapshot(size) != LV_RES_OK) {
+        printf("[UI] Render cache: snapshot failed, drawing live\n");
+        CACHE_FREE(cache_buf);
+        cache_buf = NULL;
+        forget_layers();
+        return false;
+    }
+
+    // The snapshot covers the screen's draw area, which may extend past it
+    lv_coord_t ext = _lv_obj_get_ext_draw_size(cache_screen);
+    cache_img = lv_img_create(cache_screen);
+    lv_img_set_src(cache_img, &cache_dsc);
+    lv_obj_set_pos(cache_img, -ext, -ext);
+    lv_obj_clear_flag(cache_img, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_move_background(cache_img);
+
+    hide_baked();
+    printf("[UI] Render cache: %ux%u snapshot, %u bytes\n",
+           (unsigned)cache_dsc.header.w, (unsigned)cache_dsc.header.h, (unsigned)size);
+    return true;
+}
+
+bool ui_render_cache_build(lv_obj_t * screen, const ui_render_cache_layer_t * layers, size_t count)
+{
+    ui_render_cache_drop();
+
+    if (count > UI_RENDER_CACHE_MAX_LAYERS) {
+        printf("[UI] Render cache: only the first %d layers are cached\n", UI_RENDER_CACHE_MAX_LAYERS);
+        count = UI_RENDER_CACHE_MAX_LAYERS;
+    }
+    cache_screen = screen;
+    entry_count = count;
+    for (size_t i = 0; i < count; i++) {
+        memset(&entries[i], 0, sizeof(entries[i]));
+        entries[i].layer = layers[i];
+    }
+    return bake();
+}
+
+bool ui_render_cache_rebuild(void)
+{
+    if (cache_screen == NULL) return false;
+    ui_render_cache_drop();
+    return bake();
+}
+
+void ui_render_cache_drop(void)
+{
+    if (cache_img != NULL) {
+        lv_obj_del(cache_img);
+        cache_img = NULL;
+    }
+
+    for (size_t i = 0; i < entry_count; i++) {
+        cache_entry_t * entry = &entries[i];
+        if (!entry->baked) continue;
+        lv_obj_t * obj = entry->layer.obj;
+
+        if (entry->layer.kind == UI_RENDER_CACHE_WHOLE) {
+            lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_set_style_arc_opa(obj, entry->arc_opa, LV_PART_MAIN | LV_STATE_DEFAULT);
+            lv_obj_set_style_bg_opa(obj, entry->bg_opa, LV_PART_MAIN | LV_STATE_DEFAULT);
+            lv_obj_set_style_border_opa(obj, entry->border_opa, LV_PART_MAIN | LV_STATE_DEFAULT);
+        }
+        entry->baked = false;
+    }
+
+    if (cache_buf != NULL) {
+        CACHE_FREE(cache_buf);
+        cache_buf = NULL;
+    }
+}
@@ -0,0 +1,51 @@
+// Render cache for the static parts of a screen
+//
+// The widgets that never change after ui_init (panels, container frames,
+// the track of an arc) are rendered once into a snapshot image that sits
+// at the bottom of the screen; the originals are then hidden. A redraw of
+// any area becomes a plain copy of the cached pixels plus whatever live
+// widgets overlap it, instead of re-rasterising anti-aliased arcs and
+// rounded borders on every frame.
+//
+// A widget is only baked when no live widget below it in drawing order
+// overlaps it, so the composed result is pixel-identical to the uncached
+// screen. Anything that fails the check stays live.
+
+#ifndef _UI_RENDER_CACHE_H
+#define _UI_RENDER_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl/lvgl.h"
+
+typedef enum {
+    UI_RENDER_CACHE_WHOLE,          // The widget and its children
+    UI_RENDER_CACHE_ARC_BACKGROUND, // Only the track; indicator and knob stay live
+} ui_render_cache_kind_t;
+
+typedef struct {
+    lv_obj_t * obj;                 // A direct child of the cached screen
+    ui_render_cache_kind_t kind;
+} ui_render_cache_layer_t;
+
+// Bake the given layers of screen. The layer list is copied. Returns false
+// (and leaves the screen fully live) if the snapshot buffer cannot be
+// allocated; on the ESP32 it lives in PSRAM.
+bool ui_render_cache_build(lv_obj_t * screen, const ui_render_cache_layer_t * layers, size_t count);
+
+// Call after changing a baked widget: re-renders the snapshot from the
+// current widget state
+bool ui_render_cache_rebuild(void);
+
+// Restore the original widgets and free the snapshot
+void ui_render_cache_drop(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
@@ -0,0 +1,112 @@
+// Shared style sheets for the screens, see ui_styles.h
+
+#include "ui_styles.h"
+
+static const lv_style_const_prop_t container_props[] = {
+    LV_STYLE_CONST_RADIUS(20),
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x28, 0x28, 0x28)),
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_BORDER_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_BORDER_WIDTH(3),
+    LV_STYLE_PROP_INV,
+};
+LV_STYLE_CONST_INIT(ui_style_container, container_props);
+
+static const lv_style_const_prop_t title_props[] = {
+    LV_STYLE_CONST_TEXT_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_TEXT_LETTER_SPACE(6),
+    LV_STYLE_CONST_TEXT_LINE_SPACE(2),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_CENTER),
+    LV_STYLE_CONST_TEXT_DECOR(LV_TEXT_DECOR_NONE),
+    LV_STYLE_CONST_TEXT_FONT(&ui_font_title),
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x00, 0x00, 0x00)),
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_BORDER_COLOR(LV_COLOR_MAKE(0x00, 0x00, 0x00)),
+    LV_STYLE_CONST_BORDER_OPA(LV_OPA_COVER),
+    LV_STYLE_PROP_INV,
+};
+LV_STYLE_CONST_INIT(ui_style_title, title_props);
+
+static const lv_style_const_prop_t caption_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xF1, 0xE1, 0x44)),
+    LV_STYLE_CONST_TEXT_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_TEXT_FONT(&ui_font_caption),
+    LV_STYLE_PROP_INV,
+};
+LV_STYLE_CONST_INIT(ui_style_caption, caption_props);
+
+static const lv_style_const_prop_t panel_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x00, 0x00, 0x00)),
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_BORDER_COLOR(LV_COLOR_MAKE(0x00, 0x00, 0x00)),
+    LV_STYLE_CONST_BORDER_OPA(LV_OPA_COVER),
+    LV_STYLE_PROP_INV,
+};
+LV_STYLE_CONST_INIT(ui_style_panel, panel_props);
+
+static const lv_style_const_prop_t divider_props[] = {
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_BORDER_COLOR(LV_COLOR_MAKE(0x00, 0x00, 0x00)),
+    LV_STYLE_CONST_BORDER_OPA(LV_OPA_COVER),
+    LV_STYLE_PROP_INV,
+};
+LV_STYLE_CONST_INIT(ui_style_divider, divider_props);
+
+static const lv_style_const_prop_t switch_track_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0xAA, 0xAA, 0xAA)),
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_PROP_INV,
+};
+LV_STYLE_CONST_INIT(ui_style_switch_track, switch_track_props);
+
+static const lv_style_const_prop_t switch_indicator_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0xFF, 0xF8, 0x00)),
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_PROP_INV,
+};
+LV_STYLE_CONST_INIT(ui_style_switch_indicator, switch_indicator_props);
+
+static const lv_style_const_prop_t switch_knob_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x00, 0x00, 0x00)),
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_PROP_INV,
+};
+LV_STYLE_CONST_INIT(ui_style_switch_knob, switch_knob_props);
+
+static const lv_style_const_prop_t tank_tile_props[] = {
+    LV_STYLE_CONST_RADIUS(8),
+    LV_STYLE_CONST_PAD_TOP(3),
+    LV_STYLE_CONST_PAD_BOTTOM(4),
+    LV_STYLE_CONST_PAD_LEFT(6),
+    LV_STYLE_CONST_PAD_RIGHT(6),
+    LV_STYLE_PROP_INV,
+};
+LV_STYLE_CONST_INIT(ui_style_tank_tile, tank_tile_props);
+
+static const lv_style_const_prop_t tank_text_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0x00, 0xC7, 0xEF)),
+    LV_STYLE_CONST_TEXT_OPA(LV_OPA_COVER),
+    LV_STYLE_PROP_INV,
+};
+LV_STYLE_CONST_INIT(ui_style_tank_text, tank_text_props);
+
+static const lv_style_const_prop_t tank_bar_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x28, 0x28, 0x28)),
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_RADIUS(3),
+    LV_STYLE_PROP_INV,
+};
+LV_STYLE_CONST_INIT(ui_style_tank_bar, tank_bar_props);
+
+static const lv_style_const_prop_t tank_bar_indicator_props[] = {
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_RADIUS(3),
+    LV_STYLE_PROP_INV,
+};
+LV_STYLE_CONST_INIT(ui_style_tank_bar_indicator, tank_bar_indicator_props);
+
+void ui_styles_add(lv_obj_t * obj, const lv_style_t * style, lv_style_selector_t selector)
+{
+    // LVGL 8 takes a mutable pointer but never writes to a constant style
+    lv_obj_add_style(obj, (lv_style_t *)style, selector);
+}
@@ -0,0 +1,39 @@
+// Shared style sheets for the screens
+//
+// Properties that several widgets have in common live here as constant
+// styles in flash, one per class of widget, instead of as local style
+// properties: every local property costs a heap allocation per object and
+// one more entry to search whenever the object is drawn. Only what is
+// specific to a single widget (position, size, accent color) stays local.
+
+#ifndef _UI_STYLES_H
+#define _UI_STYLES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl/lvgl.h"
+#include "ui_fonts.h"
+
+extern const lv_style_t ui_style_container;         // Rounded frame; border color per container
+extern const lv_style_t ui_style_title;             // Section title text areas; text color per title
+extern const lv_style_t ui_style_caption;           // Labels above the switches
+extern const lv_style_t ui_style_panel;             // Black boxes behind switches and labels
+extern const lv_style_t ui_style_divider;           // Colored bars; fill color per bar
+extern const lv_style_t ui_style_switch_track;      // LV_PART_MAIN
+extern const lv_style_t ui_style_switch_indicator;  // LV_PART_INDICATOR | LV_STATE_CHECKED
+extern const lv_style_t ui_style_switch_knob;       // LV_PART_KNOB
+extern const lv_style_t ui_style_tank_tile;         // Tank tiles, over ui_style_panel
+extern const lv_style_t ui_style_tank_text;         // Tank names and levels
+extern const lv_style_t ui_style_tank_bar;          // LV_PART_MAIN of the tank bars
+extern const lv_style_t ui_style_tank_bar_indicator; // LV_PART_INDICATOR; color per level
+
+// lv_obj_add_style() for the constant styles above
+void ui_styles_add(lv_obj_t * obj, const lv_style_t * style, lv_style_selector_t selector);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
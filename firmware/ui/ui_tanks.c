@@ -0,0 +1,110 @@
+// Tank tiles, see ui_tanks.h
+
+#include <stdio.h>
+#include <string.h>
+#include "ui.h"
+#include "ui_tanks.h"
+#include "ui_styles.h"
+#include "backend.h"
+
+// Two columns of up to four tiles at the left of the water section
+#define TANK_TILE_W     80
+#define TANK_TILE_H     34
+#define TANK_GAP        4
+#define TANK_COLUMNS    2
+
+typedef struct {
+    lv_obj_t * bar;
+    lv_obj_t * value;
+    int16_t level;          // Shown level, -1 before the first update
+} ui_tank_t;
+
+static lv_obj_t * tank_grid;
+static ui_tank_t tanks[BACKEND_TANK_MAX];
+static size_t tank_count;
+
+// The template: the same objects and constant styles for every tank
+static void tank_tile_create(ui_tank_t * tank, const char * name)
+{
+    lv_obj_t * tile = lv_obj_create(tank_grid);
+    lv_obj_remove_style_all(tile);
+    lv_obj_set_size(tile, TANK_TILE_W, TANK_TILE_H);
+    lv_obj_clear_flag(tile, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    ui_styles_add(tile, &ui_style_panel, LV_PART_MAIN | LV_STATE_DEFAULT);
+    ui_styles_add(tile, &ui_style_tank_tile, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    // The screen fonts only hold the glyphs of fonts.txt, names may need others
+    lv_obj_t * label = lv_label_create(tile);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_DOT);
+    lv_obj_set_width(label, TANK_TILE_W - 12 - 30);
+    lv_label_set_text_static(label, name);
+    lv_obj_align(label, LV_ALIGN_TOP_LEFT, 0, 0);
+    ui_styles_add(label, &ui_style_tank_text, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    tank->value = lv_label_create(tile);
+    lv_label_set_text(tank->value, "");
+    lv_obj_align(tank->value, LV_ALIGN_TOP_RIGHT, 0, 0);
+    ui_styles_add(tank->value, &ui_style_tank_text, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    tank->bar = lv_bar_create(tile);
+    lv_obj_remove_style_all(tank->bar);
+    lv_obj_set_size(tank->bar, TANK_TILE_W - 12, 6);
+    lv_obj_align(tank->bar, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_bar_set_range(tank->bar, 0, 100);
+    ui_styles_add(tank->bar, &ui_style_tank_bar, LV_PART_MAIN | LV_STATE_DEFAULT);
+    ui_styles_add(tank->bar, &ui_style_tank_bar_indicator, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+
+    tank->level = -1;
+}
+
+void ui_tanks_init(lv_obj_t * screen)
+{
+    size_t count = backend_get_tank_count();
+    if (count < 2) return;
+
+    size_t rows = (count + TANK_COLUMNS - 1) / TANK_COLUMNS;
+    tank_grid = lv_obj_create(screen);
+    lv_obj_remove_style_all(tank_grid);
+    lv_obj_set_size(tank_grid, TANK_COLUMNS * TANK_TILE_W + (TANK_COLUMNS - 1) * TANK_GAP,
+                    (lv_coord_t)(rows * TANK_TILE_H + (rows - 1) * TANK_GAP));
+    lv_obj_align(tank_grid, LV_ALIGN_CENTER, -135, 135);
+    lv_obj_clear_flag(tank_grid, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_flex_flow(tank_grid, LV_FLEX_FLOW_ROW_WRAP);
+    lv_obj_set_style_pad_row(tank_grid, TANK_GAP, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_column(tank_grid, TANK_GAP, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    for (size_t i = 0; i < count; i++) {
+        tank_tile_create(&tanks[i], backend_get_tank_name(i));
+    }
+    tank_count = count;
+}
+
+void ui_tanks_set_level(int tank, int level)
+{
+    if (tank < 0 || (size_t)tank >= tank_count) return;
+    ui_tank_t * t = &tanks[tank];
+
+    if (level < 0) level = 0;
+    if (level > 100) level = 100;
+    if (t->level == level) return;
+
+    // Only the bar color is a local style: replaced on a threshold crossing
+    lv_color_t color = ui_level_color(level);
+    if (t->level < 0 || !lv_color_eq(ui_level_color(t->level), color)) {
+        lv_obj_set_style_bg_color(t->bar, color, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+    }
+    lv_bar_set_value(t->bar, level, LV_ANIM_OFF);
+
+    char buf[8];
+    snprintf(buf, sizeof(buf), "%d%%", level);
+    lv_label_set_text(t->value, buf);
+    t->level = (int16_t)level;
+}
+
+void ui_tanks_destroy(void)
+{
+    // The widgets go with the screen
+    tank_grid = NULL;
+    memset(tanks, 0, sizeof(tanks));
+    tank_count = 0;
+}
@@ -0,0 +1,33 @@
+// Tank tiles
+//
+// With more than one tank in CONFIG_WATER_TANKS, each tank gets a small
+// tile in the water section: name, level and a bar. The arc keeps showing
+// the main tank (tank 0). Tiles are built from one template on the shared
+// constant styles, so a tank costs a fixed handful of objects and one
+// local style property (the bar color), and a level update only redraws
+// the tile of that tank, and only if what it shows changed.
+
+#ifndef _UI_TANKS_H
+#define _UI_TANKS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl/lvgl.h"
+
+// Create the tiles of the configured tanks, if there are several. Call
+// after the render cache is built, so they stay live.
+void ui_tanks_init(lv_obj_t * screen);
+
+// Show a tank's level on its tile. LVGL task only.
+void ui_tanks_set_level(int tank, int level);
+
+// Before the screen is deleted
+void ui_tanks_destroy(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
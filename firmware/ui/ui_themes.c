@@ -4,16 +4,23 @@
 // Project name: SquareLine_Project
 
 #include "ui.h"
+#include "ui_render_cache.h"
 
 
-const ui_theme_variable_t _ui_theme_color_dark_mode[2] = {0x051C2D, 0x051C2D};
-const ui_theme_variable_t _ui_theme_alpha_dark_mode[2] = {255, 255};
+const ui_theme_variable_t ui_theme_table[UI_THEME_VARIABLE_COUNT][UI_THEME_COUNT] = {
+    [UI_THEME_COLOR_DARK_MODE] = {0x051C2D, 0x051C2D},
+    [UI_THEME_ALPHA_DARK_MODE] = {255, 255},
+};
 uint8_t ui_theme_idx = UI_THEME_BACKGROUND;
 
 
 void ui_theme_set(uint8_t theme_idx)
 {
+    if (theme_idx >= UI_THEME_COUNT) return;
     ui_theme_idx = theme_idx;
-    _ui_theme_set_variable_styles(UI_VARIABLE_STYLES_MODE_FOLLOW);
+    // A themed widget may be baked into the render cache
+    if (_ui_theme_set_variable_styles(UI_VARIABLE_STYLES_MODE_FOLLOW) > 0) {
+        ui_render_cache_rebuild();
+    }
 }
 
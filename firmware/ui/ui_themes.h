@@ -10,14 +10,24 @@
 extern "C" {
 #endif
 
-#define UI_THEME_COLOR_DARK_MODE 0
-
 #define UI_THEME_DEFAULT 0
 
 #define UI_THEME_BACKGROUND 1
 
-extern const ui_theme_variable_t _ui_theme_color_dark_mode[2];
-extern const ui_theme_variable_t _ui_theme_alpha_dark_mode[2];
+#define UI_THEME_COUNT 2
+
+// Theme variables: the rows of ui_theme_table
+#define UI_THEME_COLOR_DARK_MODE 0
+#define UI_THEME_ALPHA_DARK_MODE 1
+
+#define UI_THEME_VARIABLE_COUNT 2
+
+// Value of every variable in every theme, fixed at compile time. The theme
+// manager compares two columns to find what a switch has to change.
+extern const ui_theme_variable_t ui_theme_table[UI_THEME_VARIABLE_COUNT][UI_THEME_COUNT];
+
+#define _ui_theme_color_dark_mode (ui_theme_table[UI_THEME_COLOR_DARK_MODE])
+#define _ui_theme_alpha_dark_mode (ui_theme_table[UI_THEME_ALPHA_DARK_MODE])
 
 extern const uint32_t * ui_theme_colors[2];
 extern const uint8_t * ui_theme_alphas[2];
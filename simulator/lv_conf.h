@@ -23,6 +23,10 @@
  *Can be also used by the user to draw something with transparent background.*/
 #define LV_COLOR_SCREEN_TRANSP 0
 
+/*Adjust color mix functions rounding. 0: round down (the fast RGB565 path of lv_color_mix(),
+ *which components/lvgl_blend reproduces)*/
+#define LV_COLOR_MIX_ROUND_OFS 0
+
 /*Images pixels with this color will not be drawn if they are chroma keyed)*/
 #define LV_COLOR_CHROMA_KEY lv_color_hex(0x00ff00)
 
@@ -46,10 +50,11 @@
     #endif
 
 #else       /*LV_MEM_CUSTOM*/
-    #define LV_MEM_CUSTOM_INCLUDE <stdlib.h>
-    #define LV_MEM_CUSTOM_ALLOC   malloc
-    #define LV_MEM_CUSTOM_FREE    free
-    #define LV_MEM_CUSTOM_REALLOC realloc
+    /*Counting wrappers around malloc/free, reported by the headless benchmark*/
+    #define LV_MEM_CUSTOM_INCLUDE "src/sim_alloc.h"
+    #define LV_MEM_CUSTOM_ALLOC   sim_malloc
+    #define LV_MEM_CUSTOM_FREE    sim_free
+    #define LV_MEM_CUSTOM_REALLOC sim_realloc
 #endif     /*LV_MEM_CUSTOM*/
 
 /*Number of the intermediate memory buffer used during rendering and other internal processing mechanisms.
@@ -555,7 +560,7 @@
  *==================*/
 
 /*1: Enable API to take snapshot for object*/
-#define LV_USE_SNAPSHOT 0
+#define LV_USE_SNAPSHOT 1
 
 /*1: Enable Monkey test*/
 #define LV_USE_MONKEY   0
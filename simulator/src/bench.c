@@ -0,0 +1,396 @@
+/**
+ * Headless benchmark mode for the simulator
+ *
+ * Trace format, one event per line, times in virtual milliseconds and in
+ * non-decreasing order ('#' starts a comment):
+ *
+ *   <ms> touch <x> <y> down|up
+ *   <ms> mqtt <topic> <payload>       payload is the rest of the line
+ *   <ms> mqtt <topic> hex:<bytes>     binary payload, e.g. hex:D1122A (42%)
+ *
+ * In every --display-mode the flushed columns count the pixels that reach
+ * the screen, which in direct mode is the dirty areas, not the whole buffer.
+ *
+ * Touch state is sampled by LVGL every LV_INDEV_DEF_READ_PERIOD ms, so a
+ * press shorter than that may not be seen; keep taps at 50 ms or more.
+ */
+
+#include "bench.h"
+#include "sim_alloc.h"
+#include "sim_display.h"
+#include "lvgl/lvgl.h"
+#include "ui.h"
+#include "ui_queue.h"
+#include "backend.h"
+#include "core_hal_host.h"
+#include "sim_broker.h"
+#include "dlog.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*Fixed wall clock at t=0, so stored timestamps repeat between runs*/
+#define BENCH_WALL_EPOCH_S 1700000000
+
+#define TRACE_MAX_LINE 512
+
+typedef enum {
+    TRACE_TOUCH,
+    TRACE_MQTT,
+} trace_type_t;
+
+typedef struct {
+    uint32_t time_ms;
+    trace_type_t type;
+    int16_t x, y;
+    bool pressed;
+    char *topic;
+    uint8_t *payload;
+    size_t payload_len;
+} trace_event_t;
+
+/*Offscreen stand-in for the SDL texture*/
+static lv_color_t framebuffer[SIM_DISP_HOR_RES * SIM_DISP_VER_RES];
+
+/*Per-frame counters, reset before each lv_timer_handler() call*/
+static uint32_t frame_inv_areas;
+static uint64_t frame_inv_px;
+static uint32_t frame_flushes;
+static uint64_t frame_flush_px;
+
+/*Virtual time seen by LVGL (through lv_tick_inc) and by the core HAL*/
+static int64_t virtual_now_us;
+
+/*Virtual pointer driven by the trace*/
+static lv_point_t touch_point;
+static bool touch_pressed;
+
+static void bench_copy_area(const lv_area_t *area, const lv_color_t *src, lv_coord_t stride, void *ctx)
+{
+    (void)ctx;
+    lv_coord_t w = lv_area_get_width(area);
+
+    for(lv_coord_t y = area->y1; y <= area->y2; y++) {
+        memcpy(&framebuffer[y * SIM_DISP_HOR_RES + area->x1], src, w * sizeof(lv_color_t));
+        src += stride;
+    }
+    frame_flushes++;
+    frame_flush_px += lv_area_get_size(area);
+}
+
+static void bench_flush_cb(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    sim_display_flush_areas(disp_drv, area, color_p, bench_copy_area, NULL);
+    lv_disp_flush_ready(disp_drv);
+}
+
+/*Called by LVGL for every invalidation, before areas are merged*/
+static void bench_rounder_cb(lv_disp_drv_t *disp_drv, lv_area_t *area)
+{
+    (void)disp_drv;
+    frame_inv_areas++;
+    frame_inv_px += lv_area_get_size(area);
+}
+
+static void bench_touch_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
+{
+    (void)indev_drv;
+    data->point = touch_point;
+    data->state = touch_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+static int hex_nibble(char c)
+{
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool parse_payload(const char *text, trace_event_t *ev)
+{
+    size_t len = strlen(text);
+
+    if(strncmp(text, "hex:", 4) == 0) {
+        text += 4;
+        len -= 4;
+        if(len % 2) return false;
+        ev->payload = malloc(len / 2 + 1);
+        if(!ev->payload) return false;
+        for(size_t i = 0; i < len / 2; i++) {
+            int hi = hex_nibble(text[2 * i]);
+            int lo = hex_nibble(text[2 * i + 1]);
+            if(hi < 0 || lo < 0) return false;
+            ev->payload[i] = (uint8_t)(hi << 4 | lo);
+        }
+        ev->payload_len = len / 2;
+        return true;
+    }
+
+    ev->payload = malloc(len + 1);
+    if(!ev->payload) return false;
+    memcpy(ev->payload, text, len + 1);
+    ev->payload_len = len;
+    return true;
+}
+
+static bool parse_line(char *line, trace_event_t *ev)
+{
+    char kind[8];
+    int n = 0;
+
+    memset(ev, 0, sizeof(*ev));
+    if(sscanf(line, "%" SCNu32 " %7s %n", &ev->time_ms, kind, &n) != 2) return false;
+    char *rest = line + n;
+
+    if(strcmp(kind, "touch") == 0) {
+        int x, y;
+        char state[8];
+        if(sscanf(rest, "%d %d %7s", &x, &y, state) != 3) return false;
+        ev->type = TRACE_TOUCH;
+        ev->x = (int16_t)x;
+        ev->y = (int16_t)y;
+        if(strcmp(state, "down") == 0) ev->pressed = true;
+        else if(strcmp(state, "up") != 0) return false;
+        return true;
+    }
+
+    if(strcmp(kind, "mqtt") == 0) {
+        char *payload = strchr(rest, ' ');
+        if(!payload) return false;
+        *payload++ = '\0';
+        ev->type = TRACE_MQTT;
+        ev->topic = strdup(rest);
+        return ev->topic && parse_payload(payload, ev);
+    }
+
+    return false;
+}
+
+static void trace_free(trace_event_t *events, size_t count)
+{
+    for(size_t i = 0; i < count; i++) {
+        free(events[i].topic);
+        free(events[i].payload);
+    }
+    free(events);
+}
+
+/*Loads the whole trace up front so file I/O never lands inside a frame*/
+static int trace_load(const char *path, trace_event_t **out, size_t *out_count)
+{
+    FILE *f = fopen(path, "r");
+    if(!f) {
+        fprintf(stderr, "bench: cannot open trace %s\n", path);
+        return -1;
+    }
+
+    trace_event_t *events = NULL;
+    size_t count = 0, cap = 0;
+    char line[TRACE_MAX_LINE];
+    int lineno = 0;
+    int err = 0;
+
+    while(fgets(line, sizeof(line), f)) {
+        lineno++;
+        line[strcspn(line, "\r\n")] = '\0';
+        char *p = line + strspn(line, " \t");
+        if(*p == '\0' || *p == '#') continue;
+
+        if(count == cap) {
+            cap = cap ? cap * 2 : 64;
+            trace_event_t *grown = realloc(events, cap * sizeof(*events));
+            if(!grown) {
+                err = -1;
+                break;
+            }
+            events = grown;
+        }
+
+        trace_event_t *ev = &events[count];
+        if(!parse_line(p, ev)) {
+            fprintf(stderr, "bench: %s:%d: bad trace line\n", path, lineno);
+            free(ev->topic);
+            free(ev->payload);
+            err = -1;
+            break;
+        }
+        count++;
+        if(count > 1 && ev->time_ms < events[count - 2].time_ms) {
+            fprintf(stderr, "bench: %s:%d: time goes backwards\n", path, lineno);
+            err = -1;
+            break;
+        }
+    }
+    fclose(f);
+
+    if(err) {
+        trace_free(events, count);
+        return err;
+    }
+    *out = events;
+    *out_count = count;
+    return 0;
+}
+
+static int64_t virtual_clock_us(void)
+{
+    return virtual_now_us;
+}
+
+/*Through the core's router and backend, as MQTT_EVENT_DATA on the device*/
+static void apply_mqtt(const trace_event_t *ev)
+{
+    if(sim_broker_deliver(ev->topic, ev->payload, ev->payload_len) == 0) {
+        fprintf(stderr, "bench: t=%" PRIu32 " no route for %s\n", ev->time_ms, ev->topic);
+    }
+}
+
+static void apply_event(const trace_event_t *ev)
+{
+    switch(ev->type) {
+        case TRACE_TOUCH:
+            touch_point.x = ev->x;
+            touch_point.y = ev->y;
+            touch_pressed = ev->pressed;
+            break;
+        case TRACE_MQTT:
+            apply_mqtt(ev);
+            break;
+    }
+}
+
+static int cmp_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+int bench_run(const bench_config_t *cfg)
+{
+    trace_event_t *events = NULL;
+    size_t event_count = 0;
+
+    if(cfg->trace_path && trace_load(cfg->trace_path, &events, &event_count) != 0) {
+        return 1;
+    }
+
+    FILE *csv = cfg->csv_path ? fopen(cfg->csv_path, "w") : stdout;
+    if(!csv) {
+        fprintf(stderr, "bench: cannot write %s\n", cfg->csv_path);
+        trace_free(events, event_count);
+        return 1;
+    }
+
+    int64_t *render_us = malloc(cfg->frames * sizeof(*render_us));
+    if(!render_us) {
+        if(csv != stdout) fclose(csv);
+        trace_free(events, event_count);
+        return 1;
+    }
+
+    lv_init();
+
+    static lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    if(!sim_display_setup(&disp_drv, cfg->display_mode)) {
+        fprintf(stderr, "bench: cannot allocate display buffers\n");
+        free(render_us);
+        if(csv != stdout) fclose(csv);
+        trace_free(events, event_count);
+        return 1;
+    }
+    disp_drv.flush_cb = bench_flush_cb;
+    disp_drv.rounder_cb = bench_rounder_cb;
+    lv_disp_drv_register(&disp_drv);
+
+    static lv_indev_drv_t indev_drv;
+    lv_indev_drv_init(&indev_drv);
+    indev_drv.type = LV_INDEV_TYPE_POINTER;
+    indev_drv.read_cb = bench_touch_read;
+    lv_indev_drv_register(&indev_drv);
+
+    /*Same backend as the firmware, on the virtual clock with in-memory storage;
+     *the trace is its only input*/
+    virtual_now_us = 0;
+    core_hal_host_set_clock(virtual_clock_us, BENCH_WALL_EPOCH_S);
+    backend_init();
+    sim_broker_attach(false);
+    ui_update_network_state_async(1, 1);
+
+    /*What the screens cost to build, mostly widgets and their styles*/
+    sim_alloc_stats_t init_before, init_after;
+    sim_alloc_get_stats(&init_before);
+    ui_init();
+    sim_alloc_get_stats(&init_after);
+    fprintf(stderr, "bench: ui_init made %" PRIu32 " allocations, %" PRIu64 " bytes in use\n",
+            (init_after.allocs - init_before.allocs) + (init_after.reallocs - init_before.reallocs),
+            init_after.in_use - init_before.in_use);
+
+    fprintf(csv, "frame,time_ms,render_us,inv_areas,inv_px,flushes,flush_px,allocs,frees,alloc_bytes,publishes\n");
+
+    size_t next_event = 0;
+    uint32_t now_ms = 0;
+
+    for(uint32_t frame = 0; frame < cfg->frames; frame++) {
+        virtual_now_us = (int64_t)now_ms * 1000;
+        while(next_event < event_count && events[next_event].time_ms <= now_ms) {
+            apply_event(&events[next_event++]);
+        }
+        uint32_t publishes = sim_broker_get_publish_count();
+        core_hal_host_run_timers();
+        publishes = sim_broker_get_publish_count() - publishes;
+
+        sim_alloc_stats_t before, after;
+        sim_alloc_get_stats(&before);
+
+        /*What the firmware's render task does per iteration*/
+        int64_t start = cfg->clock_us();
+        ui_queue_drain();
+        lv_timer_handler();
+        render_us[frame] = cfg->clock_us() - start;
+
+        sim_alloc_get_stats(&after);
+        /*Deferred logs are written outside the timed part, as on the device*/
+        dlog_flush();
+
+        fprintf(csv, "%" PRIu32 ",%" PRIu32 ",%" PRId64 ",%" PRIu32 ",%" PRIu64 ",%" PRIu32 ",%" PRIu64
+                ",%" PRIu32 ",%" PRIu32 ",%" PRIu64 ",%" PRIu32 "\n",
+                frame, now_ms, render_us[frame],
+                frame_inv_areas, frame_inv_px, frame_flushes, frame_flush_px,
+                (after.allocs - before.allocs) + (after.reallocs - before.reallocs),
+                after.frees - before.frees, after.bytes - before.bytes, publishes);
+
+        /*Invalidations made while applying the next events count towards the next frame*/
+        frame_inv_areas = 0;
+        frame_inv_px = 0;
+        frame_flushes = 0;
+        frame_flush_px = 0;
+
+        lv_tick_inc(cfg->frame_ms);
+        now_ms += cfg->frame_ms;
+    }
+
+    if(next_event < event_count) {
+        fprintf(stderr, "bench: %zu trace events after the last frame were not replayed\n",
+                event_count - next_event);
+    }
+
+    if(cfg->frames > 0) {
+        int64_t total = 0;
+        for(uint32_t i = 0; i < cfg->frames; i++) total += render_us[i];
+        qsort(render_us, cfg->frames, sizeof(*render_us), cmp_i64);
+        fprintf(stderr, "bench: %" PRIu32 " frames of %" PRIu32 " ms, render us mean %" PRId64
+                " p50 %" PRId64 " p99 %" PRId64 " max %" PRId64 "\n",
+                cfg->frames, cfg->frame_ms, total / cfg->frames,
+                render_us[cfg->frames / 2], render_us[(uint64_t)cfg->frames * 99 / 100],
+                render_us[cfg->frames - 1]);
+    }
+
+    free(render_us);
+    if(csv != stdout) fclose(csv);
+    trace_free(events, event_count);
+    ui_destroy();
+    return 0;
+}
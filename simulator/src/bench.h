@@ -0,0 +1,28 @@
+/**
+ * Headless benchmark mode for the simulator
+ *
+ * Renders the UI into an offscreen buffer on a virtual clock, replays a
+ * trace of MQTT messages and touch events, and writes one CSV row per frame.
+ * Nothing depends on wall time except the measured render time, so two runs
+ * of the same trace draw the same frames.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include "sim_display.h"
+
+typedef struct {
+    uint32_t frames;            /*Number of frames to run*/
+    uint32_t frame_ms;          /*Virtual time per frame*/
+    const char *trace_path;     /*Trace to replay, NULL for none*/
+    const char *csv_path;       /*CSV output, NULL for stdout*/
+    sim_display_mode_t display_mode;    /*Draw buffer layout, mirrors the firmware modes*/
+    int64_t (*clock_us)(void);  /*Host clock used to time rendering*/
+} bench_config_t;
+
+/*Returns 0 on success, non-zero if the trace or CSV file cannot be used*/
+int bench_run(const bench_config_t *cfg);
+
+#endif /*BENCH_H*/
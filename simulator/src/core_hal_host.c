@@ -0,0 +1,326 @@
+/**
+ * core_hal.h on the PC: pthread mutexes, polled timers, file or memory storage
+ * and log region
+ */
+
+#include "core_hal_host.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define HOST_STORAGE_MAX_KEYS   8
+#define HOST_STORAGE_MAX_BLOB   256
+#define HOST_STORAGE_KEY_LEN    16
+/*Same geometry as the storage partition*/
+#define HOST_REGION_SIZE        (128 * 1024)
+#define HOST_REGION_SECTOR      4096
+
+struct core_hal_timer {
+    core_hal_timer_cb_t cb;
+    void *arg;
+    const char *name;
+    bool armed;
+    int64_t deadline_us;
+    struct core_hal_timer *next;
+};
+
+struct core_hal_lock {
+    pthread_mutex_t mutex;
+};
+
+typedef struct {
+    char key[HOST_STORAGE_KEY_LEN];
+    uint8_t data[HOST_STORAGE_MAX_BLOB];
+    size_t len;
+} host_blob_t;
+
+static int64_t monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int64_t (*clock_now_us)(void) = monotonic_us;
+static int64_t clock_start_us;
+static bool clock_started;
+static int64_t wall_epoch = -1;
+
+static struct core_hal_timer *timers;
+static pthread_mutex_t timers_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *storage_dir;
+static host_blob_t blobs[HOST_STORAGE_MAX_KEYS];
+static uint8_t region[HOST_REGION_SIZE];
+static bool region_loaded;
+
+/*=====================
+ * Clock
+ *====================*/
+
+void core_hal_host_set_clock(int64_t (*now_us)(void), int64_t wall_epoch_s)
+{
+    clock_now_us = now_us;
+    clock_start_us = now_us();
+    clock_started = true;
+    wall_epoch = wall_epoch_s;
+}
+
+int64_t core_hal_time_us(void)
+{
+    if(!clock_started) {
+        clock_start_us = clock_now_us();
+        clock_started = true;
+    }
+    return clock_now_us() - clock_start_us;
+}
+
+int64_t core_hal_wall_time(void)
+{
+    if(wall_epoch < 0) return (int64_t)time(NULL);
+    return wall_epoch + core_hal_time_us() / 1000000;
+}
+
+/*=====================
+ * Locks
+ *====================*/
+
+core_hal_lock_t *core_hal_lock_create(void)
+{
+    core_hal_lock_t *lock = malloc(sizeof(*lock));
+    if(!lock) abort();
+    pthread_mutex_init(&lock->mutex, NULL);
+    return lock;
+}
+
+void core_hal_lock_take(core_hal_lock_t *lock)
+{
+    pthread_mutex_lock(&lock->mutex);
+}
+
+void core_hal_lock_give(core_hal_lock_t *lock)
+{
+    pthread_mutex_unlock(&lock->mutex);
+}
+
+/*=====================
+ * Timers
+ *====================*/
+
+core_hal_timer_t *core_hal_timer_create(const char *name, core_hal_timer_cb_t cb, void *arg)
+{
+    core_hal_timer_t *t = calloc(1, sizeof(*t));
+    if(!t) return NULL;
+    t->cb = cb;
+    t->arg = arg;
+    t->name = name;
+
+    pthread_mutex_lock(&timers_lock);
+    t->next = timers;
+    timers = t;
+    pthread_mutex_unlock(&timers_lock);
+    return t;
+}
+
+bool core_hal_timer_start_once(core_hal_timer_t *timer, uint64_t delay_us)
+{
+    bool started = false;
+
+    pthread_mutex_lock(&timers_lock);
+    if(!timer->armed) {
+        timer->armed = true;
+        timer->deadline_us = core_hal_time_us() + (int64_t)delay_us;
+        started = true;
+    }
+    pthread_mutex_unlock(&timers_lock);
+    return started;
+}
+
+/*All timers are polled from the main loop, which has nothing more urgent to
+ *run, so background timers are plain timers here*/
+core_hal_timer_t *core_hal_timer_create_background(const char *name, core_hal_timer_cb_t cb, void *arg)
+{
+    return core_hal_timer_create(name, cb, arg);
+}
+
+void core_hal_timer_stop(core_hal_timer_t *timer)
+{
+    pthread_mutex_lock(&timers_lock);
+    timer->armed = false;
+    pthread_mutex_unlock(&timers_lock);
+}
+
+void core_hal_host_run_timers(void)
+{
+    int64_t now = core_hal_time_us();
+
+    for(;;) {
+        core_hal_timer_t *due = NULL;
+
+        pthread_mutex_lock(&timers_lock);
+        for(core_hal_timer_t *t = timers; t; t = t->next) {
+            if(t->armed && t->deadline_us <= now && (!due || t->deadline_us < due->deadline_us)) {
+                due = t;
+            }
+        }
+        if(due) due->armed = false;
+        pthread_mutex_unlock(&timers_lock);
+
+        if(!due) return;
+        /*Unlocked: the callback may re-arm its own or any other timer*/
+        due->cb(due->arg);
+    }
+}
+
+/*=====================
+ * Storage
+ *====================*/
+
+void core_hal_host_set_storage_dir(const char *dir)
+{
+    storage_dir = dir;
+    if(dir) mkdir(dir, 0755);
+}
+
+static void storage_path(char *path, size_t size, const char *key)
+{
+    snprintf(path, size, "%s/%s.bin", storage_dir, key);
+}
+
+static host_blob_t *blob_find(const char *key, bool create)
+{
+    for(size_t i = 0; i < HOST_STORAGE_MAX_KEYS; i++) {
+        if(strcmp(blobs[i].key, key) == 0) return &blobs[i];
+    }
+    if(!create || strlen(key) >= HOST_STORAGE_KEY_LEN) return NULL;
+    for(size_t i = 0; i < HOST_STORAGE_MAX_KEYS; i++) {
+        if(blobs[i].key[0] == '\0') {
+            strcpy(blobs[i].key, key);
+            return &blobs[i];
+        }
+    }
+    return NULL;
+}
+
+bool core_hal_storage_load(const char *key, void *buf, size_t *len)
+{
+    if(storage_dir) {
+        char path[256];
+        storage_path(path, sizeof(path), key);
+        FILE *f = fopen(path, "rb");
+        if(!f) return false;
+        size_t n = fread(buf, 1, *len, f);
+        /*Anything left means the stored blob is larger than the buffer*/
+        bool fits = fgetc(f) == EOF;
+        fclose(f);
+        if(!fits) return false;
+        *len = n;
+        return true;
+    }
+
+    host_blob_t *b = blob_find(key, false);
+    if(!b || b->len > *len) return false;
+    memcpy(buf, b->data, b->len);
+    *len = b->len;
+    return true;
+}
+
+bool core_hal_storage_save(const char *key, const void *buf, size_t len)
+{
+    if(storage_dir) {
+        char path[256], tmp[260];
+        storage_path(path, sizeof(path), key);
+        snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+        FILE *f = fopen(tmp, "wb");
+        if(!f) return false;
+        bool ok = fwrite(buf, 1, len, f) == len;
+        ok = fclose(f) == 0 && ok;
+        /*Replace in one step, as an NVS commit would*/
+        return ok && rename(tmp, path) == 0;
+    }
+
+    host_blob_t *b = blob_find(key, true);
+    if(!b || len > HOST_STORAGE_MAX_BLOB) return false;
+    memcpy(b->data, buf, len);
+    b->len = len;
+    return true;
+}
+
+/*=====================
+ * Log region
+ *====================*/
+
+/*The region lives in memory; with a storage dir every change is also
+ *written through to region.bin there*/
+static FILE *region_file(const char *mode)
+{
+    char path[256];
+    storage_path(path, sizeof(path), "region");
+    return fopen(path, mode);
+}
+
+static void region_load(void)
+{
+    if(region_loaded) return;
+    region_loaded = true;
+    memset(region, 0xFF, sizeof(region));
+    if(!storage_dir) return;
+
+    FILE *f = region_file("rb");
+    if(f) {
+        if(fread(region, 1, sizeof(region), f) != sizeof(region)) memset(region, 0xFF, sizeof(region));
+        fclose(f);
+    }
+}
+
+static bool region_sync(size_t offset, size_t len)
+{
+    if(!storage_dir) return true;
+
+    FILE *f = region_file("r+b");
+    if(!f) {
+        /*First write: create the whole image*/
+        f = region_file("wb");
+        if(!f) return false;
+        bool ok = fwrite(region, 1, sizeof(region), f) == sizeof(region);
+        return fclose(f) == 0 && ok;
+    }
+    bool ok = fseek(f, (long)offset, SEEK_SET) == 0 && fwrite(region + offset, 1, len, f) == len;
+    return fclose(f) == 0 && ok;
+}
+
+bool core_hal_region_info(size_t *size, size_t *sector_size)
+{
+    *size = HOST_REGION_SIZE;
+    *sector_size = HOST_REGION_SECTOR;
+    return true;
+}
+
+bool core_hal_region_read(size_t offset, void *buf, size_t len)
+{
+    if(offset > HOST_REGION_SIZE || len > HOST_REGION_SIZE - offset) return false;
+    region_load();
+    memcpy(buf, region + offset, len);
+    return true;
+}
+
+bool core_hal_region_write(size_t offset, const void *buf, size_t len)
+{
+    if(offset > HOST_REGION_SIZE || len > HOST_REGION_SIZE - offset) return false;
+    region_load();
+    /*Flash can only clear bits*/
+    const uint8_t *src = buf;
+    for(size_t i = 0; i < len; i++) region[offset + i] &= src[i];
+    return region_sync(offset, len);
+}
+
+bool core_hal_region_erase(size_t offset)
+{
+    if(offset % HOST_REGION_SECTOR || offset >= HOST_REGION_SIZE) return false;
+    region_load();
+    memset(region + offset, 0xFF, HOST_REGION_SECTOR);
+    return region_sync(offset, HOST_REGION_SECTOR);
+}
@@ -0,0 +1,26 @@
+/**
+ * core_hal.h on the PC
+ *
+ * Timers do not run on their own: the main loop calls
+ * core_hal_host_run_timers() once per iteration, so every core callback
+ * runs on the LVGL thread, and the headless benchmark can drive all of
+ * them from its virtual clock.
+ */
+
+#ifndef CORE_HAL_HOST_H
+#define CORE_HAL_HOST_H
+
+#include <stdint.h>
+#include "core_hal.h"
+
+/*Replace the monotonic clock, e.g. with a virtual one; wall time becomes
+ *wall_epoch_s plus the clock's seconds*/
+void core_hal_host_set_clock(int64_t (*now_us)(void), int64_t wall_epoch_s);
+
+/*Keep storage in files under dir (created if missing); NULL keeps it in memory*/
+void core_hal_host_set_storage_dir(const char *dir);
+
+/*Fire every timer whose deadline has passed, earliest first*/
+void core_hal_host_run_timers(void);
+
+#endif /*CORE_HAL_HOST_H*/
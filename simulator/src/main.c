@@ -7,35 +7,44 @@
 #include <SDL2/SDL.h>
 #include "lvgl/lvgl.h"
 #include "ui.h"
-#include "backend/backend.h"
-
-/*Screen dimensions matching SenseCap Indicator D1 display (480x480 circular display)*/
-#define DISP_HOR_RES 480
-#define DISP_VER_RES 480
+#include "ui_queue.h"
+#include "backend.h"
+#include "payload_codec.h"
+#include "lvgl_blend.h"
+#include "core_hal_host.h"
+#include "bench.h"
+#include "sim_broker.h"
+#include "sim_display.h"
+#include "dlog.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 /*SDL window and renderer*/
 static SDL_Window *window = NULL;
 static SDL_Renderer *renderer = NULL;
 static SDL_Texture *texture = NULL;
 
-/*LVGL display buffer*/
-static lv_color_t buf1[DISP_HOR_RES * DISP_VER_RES / 10];
-static lv_color_t buf2[DISP_HOR_RES * DISP_VER_RES / 10];
+/*Upload one redrawn area into the streaming texture*/
+static void sdl_upload_area(const lv_area_t *area, const lv_color_t *src, lv_coord_t stride, void *ctx)
+{
+    (void)ctx;
+    SDL_UpdateTexture(texture,
+                      &(SDL_Rect){area->x1, area->y1, lv_area_get_width(area), lv_area_get_height(area)},
+                      src, stride * sizeof(lv_color_t));
+}
 
 /*Flush function for LVGL*/
 static void sdl_flush_cb(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
 {
-    lv_coord_t w = area->x2 - area->x1 + 1;
-    lv_coord_t h = area->y2 - area->y1 + 1;
+    /*Only dirty areas reach the texture; the texture always holds the whole screen*/
+    sim_display_flush_areas(disp_drv, area, color_p, sdl_upload_area, NULL);
     
-    /*Update SDL texture with the rendered area*/
-    SDL_UpdateTexture(texture, &(SDL_Rect){area->x1, area->y1, w, h}, 
-                      color_p, w * sizeof(lv_color_t));
-    
-    /*Render to screen*/
-    SDL_RenderClear(renderer);
-    SDL_RenderCopy(renderer, texture, NULL, NULL);
-    SDL_RenderPresent(renderer);
+    /*Present once per frame: with vsync on, presenting every strip waits for a vsync each*/
+    if(lv_disp_flush_is_last(disp_drv)) {
+        SDL_RenderCopy(renderer, texture, NULL, NULL);
+        SDL_RenderPresent(renderer);
+    }
     
     lv_disp_flush_ready(disp_drv);
 }
@@ -57,10 +66,111 @@ static void sdl_mouse_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
     }
 }
 
+static int64_t host_clock_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/*Stand-in for a sensor on the broker: sweep the water level every 5 s*/
+#define MOCK_LEVEL_PERIOD_US 5000000
+
+static core_hal_timer_t *mock_level_timer;
+
+static void mock_level_cb(void *arg)
+{
+    (void)arg;
+    static int level = 75;
+    static int direction = -5;
+    char payload[16];
+
+    level += direction;
+    if(level <= 10 || level >= 95) direction = -direction;
+    int len = snprintf(payload, sizeof(payload), "{\"level\":%d}", level);
+    sim_broker_deliver("sensecap/indicator/water/level", (const uint8_t *)payload, (size_t)len);
+
+    /*Any further tanks of -DCONFIG_WATER_TANKS=... follow at an offset*/
+    for(size_t i = 1; i < backend_get_tank_count(); i++) {
+        char topic[64];
+        int tank_level = (level + 17 * (int)i) % 100;
+        snprintf(topic, sizeof(topic), "sensecap/indicator/water/%s/level", backend_get_tank_name(i));
+        len = snprintf(payload, sizeof(payload), "{\"level\":%d}", tank_level);
+        sim_broker_deliver(topic, (const uint8_t *)payload, (size_t)len);
+    }
+    core_hal_timer_start_once(mock_level_timer, MOCK_LEVEL_PERIOD_US);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [--bench-codec | --bench-blend] [--display-mode partial|full|direct]\n"
+            "          [--blend lvgl|generic|swar]\n"
+            "       %s --headless --bench [--frames N] [--frame-ms MS] [--trace FILE] [--csv FILE|-]\n"
+            "          [--display-mode partial|full|direct] [--blend lvgl|generic|swar]\n",
+            prog, prog);
+}
+
+/*--blend: the kernels behind LVGL's blend step; "lvgl" leaves it to LVGL alone*/
+static bool parse_blend(const char *name)
+{
+    if(strcmp(name, "lvgl") == 0) lvgl_blend_set_kernels(NULL);
+    else if(strcmp(name, "generic") == 0) lvgl_blend_set_kernels(&lvgl_blend_kernels_generic);
+    else if(strcmp(name, "swar") == 0) lvgl_blend_set_kernels(&lvgl_blend_kernels_swar);
+    else return false;
+    return true;
+}
+
 int main(int argc, char **argv)
 {
-    (void)argc; /*Unused*/
-    (void)argv; /*Unused*/
+    /*--bench-codec: compare the JSON and binary payload paths, then exit*/
+    if(argc > 1 && strcmp(argv[1], "--bench-codec") == 0) {
+        payload_codec_bench_run(1000000, host_clock_us);
+        return 0;
+    }
+
+    /*--bench-blend: time the blend kernels against the generic ones, then exit*/
+    if(argc > 1 && strcmp(argv[1], "--bench-blend") == 0) {
+        lvgl_blend_bench_run(20000, host_clock_us);
+        return 0;
+    }
+
+    /*Options; --headless --bench renders offscreen on a virtual clock and writes per-frame CSV*/
+    bool headless = false, bench = false;
+    bench_config_t cfg = {
+        .frames = 600,
+        .frame_ms = 16,
+        .trace_path = NULL,
+        .csv_path = "bench.csv",
+        .display_mode = SIM_DISPLAY_PARTIAL,
+        .clock_us = host_clock_us,
+    };
+    for(int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        if(strcmp(arg, "--headless") == 0) headless = true;
+        else if(strcmp(arg, "--bench") == 0) bench = true;
+        else if(strcmp(arg, "--frames") == 0 && val) cfg.frames = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if(strcmp(arg, "--frame-ms") == 0 && val) cfg.frame_ms = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if(strcmp(arg, "--trace") == 0 && val) cfg.trace_path = argv[++i];
+        else if(strcmp(arg, "--display-mode") == 0 && val && sim_display_parse_mode(val, &cfg.display_mode)) i++;
+        else if(strcmp(arg, "--blend") == 0 && val && parse_blend(val)) i++;
+        else if(strcmp(arg, "--csv") == 0 && val) {
+            /*LVGL and the UI log to stdout, so "-" is only clean with logging off*/
+            cfg.csv_path = strcmp(val, "-") == 0 ? NULL : val;
+            i++;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if(headless != bench || cfg.frame_ms == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    if(bench) {
+        return bench_run(&cfg);
+    }
     
     /*Initialize SDL*/
     if(SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_EVENTS) != 0) {
@@ -73,8 +183,8 @@ int main(int argc, char **argv)
         "SenseCap Indicator Simulator",
         SDL_WINDOWPOS_CENTERED,
         SDL_WINDOWPOS_CENTERED,
-        DISP_HOR_RES,
-        DISP_VER_RES,
+        SIM_DISP_HOR_RES,
+        SIM_DISP_VER_RES,
         SDL_WINDOW_SHOWN
     );
     
@@ -91,7 +201,7 @@ int main(int argc, char **argv)
     }
     
     /*Create texture for LVGL rendering*/
-    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGB565, SDL_TEXTUREACCESS_STREAMING, DISP_HOR_RES, DISP_VER_RES);
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGB565, SDL_TEXTUREACCESS_STREAMING, SIM_DISP_HOR_RES, SIM_DISP_VER_RES);
     if(!texture) {
         fprintf(stderr, "Failed to create texture: %s\n", SDL_GetError());
         return 1;
@@ -100,17 +210,14 @@ int main(int argc, char **argv)
     /*Initialize LVGL*/
     lv_init();
     
-    /*Initialize display buffer*/
-    static lv_disp_draw_buf_t draw_buf;
-    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, DISP_HOR_RES * DISP_VER_RES / 10);
-    
-    /*Initialize display driver*/
+    /*Initialize display driver and its buffers for the selected mode*/
     static lv_disp_drv_t disp_drv;
     lv_disp_drv_init(&disp_drv);
-    disp_drv.hor_res = DISP_HOR_RES;
-    disp_drv.ver_res = DISP_VER_RES;
+    if(!sim_display_setup(&disp_drv, cfg.display_mode)) {
+        fprintf(stderr, "Failed to allocate display buffers\n");
+        return 1;
+    }
     disp_drv.flush_cb = sdl_flush_cb;
-    disp_drv.draw_buf = &draw_buf;
     lv_disp_drv_register(&disp_drv);
     
     /*Initialize mouse input device*/
@@ -120,25 +227,31 @@ int main(int argc, char **argv)
     indev_drv.read_cb = sdl_mouse_read;
     lv_indev_drv_register(&indev_drv);
     
-/*Initialize C Backend + Mock MQTT*/
+    /*Initialize the firmware backend on the host HAL, with a loopback broker*/
     printf("========================================\n");
     printf("SenseCap Simulator with C Backend\n");
     printf("========================================\n");
-    printf("Initializing backend...\n");
+    core_hal_host_set_storage_dir("sim_storage");
     backend_init();
-    printf("Backend initialized! Mock running (water level every 5s)\n");
+    sim_broker_attach(true);
+    ui_update_network_state_async(1, 1);
+    mock_level_timer = core_hal_timer_create("mock_level", mock_level_cb, NULL);
+    core_hal_timer_start_once(mock_level_timer, MOCK_LEVEL_PERIOD_US);
+    printf("Backend initialized! Mock broker sends a water level every 5s\n");
+    printf("State is kept in ./sim_storage\n");
     printf("========================================\n\n");
     
     /*Initialize the UI - this calls ui_init() which loads Screen_1*/
     ui_init();
     
-    printf("Window size: %dx%d\n", DISP_HOR_RES, DISP_VER_RES);
-    printf("Click buttons to test Rust integration!\n");
+    printf("Window size: %dx%d\n", SIM_DISP_HOR_RES, SIM_DISP_VER_RES);
+    printf("Click the switches to publish the light state.\n");
     printf("Close window to exit.\n");
     
     /*Main loop*/
     int running = 1;
     SDL_Event event;
+    uint32_t last_tick = SDL_GetTicks();
     
     while(running) {
         /*Handle SDL events*/
@@ -148,11 +261,19 @@ int main(int argc, char **argv)
             }
         }
         
+        /*Core timers (publish windows, persistence), then queued UI updates,
+         *in the order the firmware's tasks would run them*/
+        core_hal_host_run_timers();
+        ui_queue_drain();
+        
         /*Handle LVGL tasks*/
         lv_timer_handler();
+        dlog_flush();
         
-        /*Increment LVGL tick*/
-        lv_tick_inc(5);
+        /*Advance the LVGL tick by the real elapsed time, not the nominal delay*/
+        uint32_t now = SDL_GetTicks();
+        lv_tick_inc(now - last_tick);
+        last_tick = now;
         
         /*Small delay to prevent 100% CPU usage*/
         SDL_Delay(5);
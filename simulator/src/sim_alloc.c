@@ -0,0 +1,56 @@
+/**
+ * Counting allocator behind LV_MEM_CUSTOM
+ */
+
+#include "sim_alloc.h"
+#include <stddef.h>
+#include <stdlib.h>
+
+/*Each block is prefixed with its size so frees can be taken off in_use*/
+typedef union {
+    size_t size;
+    max_align_t align;
+} block_header_t;
+
+/*LVGL only allocates from its own thread, so plain counters are enough*/
+static sim_alloc_stats_t stats;
+
+void *sim_malloc(size_t size)
+{
+    stats.allocs++;
+    stats.bytes += size;
+
+    block_header_t *h = malloc(sizeof(*h) + size);
+    if(!h) return NULL;
+    h->size = size;
+    stats.in_use += size;
+    return h + 1;
+}
+
+void *sim_realloc(void *ptr, size_t size)
+{
+    stats.reallocs++;
+    stats.bytes += size;
+
+    block_header_t *old = ptr ? (block_header_t *)ptr - 1 : NULL;
+    size_t old_size = old ? old->size : 0;
+    block_header_t *h = realloc(old, sizeof(*h) + size);
+    if(!h) return NULL;
+    h->size = size;
+    stats.in_use = stats.in_use - old_size + size;
+    return h + 1;
+}
+
+void sim_free(void *ptr)
+{
+    if(!ptr) return;
+    block_header_t *h = (block_header_t *)ptr - 1;
+    stats.frees++;
+    stats.in_use -= h->size;
+    free(h);
+}
+
+void sim_alloc_get_stats(sim_alloc_stats_t *out)
+{
+    *out = stats;
+}
@@ -0,0 +1,29 @@
+/**
+ * Counting allocator behind LV_MEM_CUSTOM
+ *
+ * lv_conf.h routes LVGL's allocations through these wrappers so the
+ * headless benchmark can report allocations per frame.
+ */
+
+#ifndef SIM_ALLOC_H
+#define SIM_ALLOC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    uint32_t allocs;        /*malloc calls*/
+    uint32_t reallocs;      /*realloc calls*/
+    uint32_t frees;         /*free calls with a non-NULL pointer*/
+    uint64_t bytes;         /*Bytes requested by malloc and realloc*/
+    uint64_t in_use;        /*Bytes currently allocated*/
+} sim_alloc_stats_t;
+
+void *sim_malloc(size_t size);
+void *sim_realloc(void *ptr, size_t size);
+void sim_free(void *ptr);
+
+/*Totals since start; callers diff two snapshots for a per-frame count*/
+void sim_alloc_get_stats(sim_alloc_stats_t *stats);
+
+#endif /*SIM_ALLOC_H*/
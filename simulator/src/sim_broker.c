@@ -0,0 +1,49 @@
+/**
+ * Loopback MQTT transport for the simulator
+ */
+
+#include "sim_broker.h"
+#include "mqtt_router.h"
+#include "publish_scheduler.h"
+#include "payload_codec.h"
+#include <stdio.h>
+#include <string.h>
+
+static bool broker_verbose;
+static uint32_t publish_count;
+
+static int sim_broker_enqueue(const char *topic, const uint8_t *payload, size_t len, int qos, bool retain)
+{
+    publish_count++;
+    if(broker_verbose) {
+        if(payload_detect_format(payload, len) == PAYLOAD_FORMAT_BINARY) {
+            printf("[BROKER] %s: %u byte binary frame (qos %d%s)\n", topic, (unsigned)len, qos,
+                   retain ? ", retained" : "");
+        } else {
+            printf("[BROKER] %s: %.*s (qos %d%s)\n", topic, (int)len, (const char *)payload, qos,
+                   retain ? ", retained" : "");
+        }
+    }
+    return (int)publish_count;
+}
+
+void sim_broker_attach(bool verbose)
+{
+    /*No outbox: loopback publishes complete at once*/
+    static const publish_sink_t sink = {
+        .enqueue = sim_broker_enqueue,
+        .outbox_size = NULL,
+    };
+    broker_verbose = verbose;
+    publish_scheduler_set_sink(&sink);
+}
+
+int sim_broker_deliver(const char *topic, const uint8_t *payload, size_t len)
+{
+    return mqtt_router_dispatch(topic, strlen(topic), (const char *)payload, len, 0, len);
+}
+
+uint32_t sim_broker_get_publish_count(void)
+{
+    return publish_count;
+}
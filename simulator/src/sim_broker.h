@@ -0,0 +1,25 @@
+/**
+ * Loopback MQTT transport for the simulator
+ *
+ * Stands in for mqtt_manager: publishes from the core's scheduler end up
+ * here, and messages "from the broker" enter through the core's router,
+ * the same path MQTT_EVENT_DATA takes on the device.
+ */
+
+#ifndef SIM_BROKER_H
+#define SIM_BROKER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*Attach as the publish scheduler's sink; verbose prints every publish*/
+void sim_broker_attach(bool verbose);
+
+/*Deliver one message to the subscribed handlers; returns how many ran*/
+int sim_broker_deliver(const char *topic, const uint8_t *payload, size_t len);
+
+/*Messages published by the core so far*/
+uint32_t sim_broker_get_publish_count(void);
+
+#endif /*SIM_BROKER_H*/
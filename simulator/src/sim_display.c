@@ -0,0 +1,91 @@
+/**
+ * Display buffer modes shared by the SDL window and the headless benchmark
+ */
+
+#include "sim_display.h"
+#include "lvgl_blend.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define STRIP_PX (SIM_DISP_HOR_RES * SIM_DISP_VER_RES / 10)
+#define SCREEN_PX (SIM_DISP_HOR_RES * SIM_DISP_VER_RES)
+
+static lv_disp_draw_buf_t draw_buf;
+static sim_display_mode_t active_mode;
+
+bool sim_display_parse_mode(const char *name, sim_display_mode_t *mode)
+{
+    if(strcmp(name, "partial") == 0) *mode = SIM_DISPLAY_PARTIAL;
+    else if(strcmp(name, "full") == 0) *mode = SIM_DISPLAY_FULL;
+    else if(strcmp(name, "direct") == 0) *mode = SIM_DISPLAY_DIRECT;
+    else return false;
+    return true;
+}
+
+bool sim_display_setup(lv_disp_drv_t *drv, sim_display_mode_t mode)
+{
+    lv_color_t *buf1 = NULL, *buf2 = NULL;
+    uint32_t px = 0;
+
+    switch(mode) {
+        case SIM_DISPLAY_PARTIAL:
+            px = STRIP_PX;
+            buf1 = malloc(px * sizeof(lv_color_t));
+            buf2 = malloc(px * sizeof(lv_color_t));
+            break;
+        case SIM_DISPLAY_FULL:
+            px = SCREEN_PX;
+            buf1 = malloc(px * sizeof(lv_color_t));
+            break;
+        case SIM_DISPLAY_DIRECT:
+            /*Zeroed, so the areas never drawn match in both framebuffers*/
+            px = SCREEN_PX;
+            buf1 = calloc(px, sizeof(lv_color_t));
+            buf2 = calloc(px, sizeof(lv_color_t));
+            break;
+    }
+    if(!buf1 || (mode != SIM_DISPLAY_FULL && !buf2)) {
+        free(buf1);
+        free(buf2);
+        return false;
+    }
+
+    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, px);
+    drv->hor_res = SIM_DISP_HOR_RES;
+    drv->ver_res = SIM_DISP_VER_RES;
+    drv->draw_buf = &draw_buf;
+    drv->full_refresh = mode == SIM_DISPLAY_FULL;
+    drv->direct_mode = mode == SIM_DISPLAY_DIRECT;
+    /*Same blend step as the firmware with CONFIG_LVGL_BLEND_ACCEL*/
+    lvgl_blend_install(drv);
+    active_mode = mode;
+    return true;
+}
+
+void sim_display_flush_areas(lv_disp_drv_t *drv, const lv_area_t *area, const lv_color_t *color_p,
+                             sim_display_area_cb_t cb, void *ctx)
+{
+    if(active_mode != SIM_DISPLAY_DIRECT) {
+        cb(area, color_p, lv_area_get_width(area), ctx);
+        return;
+    }
+
+    if(!lv_disp_flush_is_last(drv)) return;
+
+    lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+    lv_color_t *back = (color_p == draw_buf.buf1) ? draw_buf.buf2 : draw_buf.buf1;
+
+    for(uint16_t i = 0; i < disp->inv_p; i++) {
+        if(disp->inv_area_joined[i]) continue;
+
+        const lv_area_t *a = &disp->inv_areas[i];
+        size_t offset = (size_t)a->y1 * SIM_DISP_HOR_RES + a->x1;
+        size_t line_bytes = lv_area_get_width(a) * sizeof(lv_color_t);
+
+        cb(a, color_p + offset, SIM_DISP_HOR_RES, ctx);
+        for(lv_coord_t y = a->y1; y <= a->y2; y++) {
+            memcpy(back + offset, color_p + offset, line_bytes);
+            offset += SIM_DISP_HOR_RES;
+        }
+    }
+}
@@ -0,0 +1,46 @@
+/**
+ * Display buffer modes shared by the SDL window and the headless benchmark
+ *
+ * Each mode mirrors a firmware configuration, so frame timings taken in the
+ * simulator follow the same render path as the device.
+ */
+
+#ifndef SIM_DISPLAY_H
+#define SIM_DISPLAY_H
+
+#include <stdbool.h>
+#include "lvgl/lvgl.h"
+
+/*Screen dimensions matching SenseCap Indicator D1 display (480x480 circular display)*/
+#define SIM_DISP_HOR_RES 480
+#define SIM_DISP_VER_RES 480
+
+typedef enum {
+    SIM_DISPLAY_PARTIAL,    /*Two 1/10 screen strip buffers (simulator default)*/
+    SIM_DISPLAY_FULL,       /*CONFIG_DISPLAY_MODE_FULL_REFRESH: one full-screen buffer, full redraw*/
+    SIM_DISPLAY_DIRECT,     /*CONFIG_DISPLAY_MODE_DIRECT_DOUBLE_FB: two framebuffers, dirty areas only*/
+} sim_display_mode_t;
+
+/*Called once per redrawn area; src points at the area's first pixel, stride is in pixels*/
+typedef void (*sim_display_area_cb_t)(const lv_area_t *area, const lv_color_t *src,
+                                      lv_coord_t stride, void *ctx);
+
+/*Returns false for an unknown name ("partial", "full" or "direct")*/
+bool sim_display_parse_mode(const char *name, sim_display_mode_t *mode);
+
+/*Allocates the draw buffers, sets draw_buf, full_refresh and direct_mode on drv and
+ *installs the lvgl_blend draw context*/
+bool sim_display_setup(lv_disp_drv_t *drv, sim_display_mode_t mode);
+
+/**
+ * Hands the pixels of one flush to cb, area by area.
+ *
+ * In direct mode LVGL passes the whole framebuffer on every flush, so this
+ * waits for the last flush of the frame, reports each invalidated area, and
+ * copies those areas into the other framebuffer, as the firmware does after
+ * a swap. Does not call lv_disp_flush_ready().
+ */
+void sim_display_flush_areas(lv_disp_drv_t *drv, const lv_area_t *area, const lv_color_t *color_p,
+                             sim_display_area_cb_t cb, void *ctx);
+
+#endif /*SIM_DISPLAY_H*/
@@ -0,0 +1,619 @@
+/**
+ * Host benchmark suite for the code shared with the firmware
+ *
+ * Times the hot paths of the UI, the backend, the MQTT router and the
+ * co-processor link parser, built from the same sources as the firmware
+ * and rendering into an offscreen buffer. LVGL and the core run on a
+ * virtual clock, so animations and publish windows take the same number of
+ * steps on every run; only the measured sections read the host clock.
+ *
+ *   sensecap-bench [--json <file>] [--baseline <file>] [--threshold <pct>]
+ *                  [--filter <text>] [--iterations <n>] [--display-mode <mode>]
+ *
+ * Results are written as JSON, one result object per line, after the host,
+ * CPU, compiler and build flags they were measured with. With --baseline, the
+ * median of every case is compared with the one stored in that file (an
+ * earlier --json output), and the exit status is 2 if any case is slower
+ * by more than --threshold percent (default 10). A missing baseline is an
+ * error, not a pass.
+ *
+ * Deferred logs are never flushed: what a log statement costs its caller
+ * is measured, their formatting is not, as on the device.
+ */
+
+#include "sim_display.h"
+#include "lvgl/lvgl.h"
+#include "ui.h"
+#include "ui_queue.h"
+#include "backend.h"
+#include "mqtt_router.h"
+#include "payload_codec.h"
+#include "copro_proto.h"
+#include "core_config.h"
+#include "core_hal_host.h"
+#include "sim_broker.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/utsname.h>
+
+#define SUITE_NAME          "sensecap-bench"
+/*Build type and C flags, set by CMakeLists.txt*/
+#ifndef SUITE_BUILD_FLAGS
+#define SUITE_BUILD_FLAGS   "unknown"
+#endif
+#ifdef __VERSION__
+#define SUITE_COMPILER      __VERSION__
+#else
+#define SUITE_COMPILER      "unknown"
+#endif
+/*Fixed wall clock at t=0, as in the headless benchmark*/
+#define SUITE_WALL_EPOCH_S  1700000000
+/*Virtual time per LVGL frame, the display refresh period*/
+#define SUITE_FRAME_MS      LV_DISP_DEF_REFR_PERIOD
+/*Frames that cover a water level animation (300 ms) and its last redraw*/
+#define SUITE_LEVEL_FRAMES  (300 / SUITE_FRAME_MS + 2)
+/*Synthetic MQTT stream: messages, and messages timed as one sample*/
+#define SUITE_STREAM_LEN    4096
+#define SUITE_STREAM_BATCH  256
+#define SUITE_MAX_LINE      256
+/*Synthetic co-processor UART stream: frames, frames timed as one sample,
+ *and the chunk size the UART driver hands over*/
+#define SUITE_COPRO_FRAMES  4096
+#define SUITE_COPRO_BATCH   256
+#define SUITE_COPRO_CHUNK   64
+
+#define WATER_LEVEL_TOPIC   "sensecap/indicator/water/level"
+
+typedef struct {
+    const char *name;
+    const char *unit;           /*What one sample times*/
+    uint32_t iterations;
+    /*Runs the case, storing one duration in ns per iteration; false on failure*/
+    bool (*run)(uint32_t iterations, int64_t *samples_ns);
+} suite_case_t;
+
+typedef struct {
+    char *topic;
+    uint8_t *payload;
+    size_t len;
+    bool split;                 /*Delivered in two chunks, as a fragmented MQTT message*/
+} stream_msg_t;
+
+static lv_color_t framebuffer[SIM_DISP_HOR_RES * SIM_DISP_VER_RES];
+static int64_t virtual_now_us;
+static stream_msg_t stream[SUITE_STREAM_LEN];
+static uint8_t copro_stream[SUITE_COPRO_FRAMES * COPRO_WIRE_MAX];
+static size_t copro_frame_at[SUITE_COPRO_FRAMES + 1];
+
+static int64_t host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int64_t virtual_clock_us(void)
+{
+    return virtual_now_us;
+}
+
+static void suite_copy_area(const lv_area_t *area, const lv_color_t *src, lv_coord_t stride, void *ctx)
+{
+    (void)ctx;
+    lv_coord_t w = lv_area_get_width(area);
+
+    for(lv_coord_t y = area->y1; y <= area->y2; y++) {
+        memcpy(&framebuffer[y * SIM_DISP_HOR_RES + area->x1], src, w * sizeof(lv_color_t));
+        src += stride;
+    }
+}
+
+static void suite_flush_cb(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    sim_display_flush_areas(disp_drv, area, color_p, suite_copy_area, NULL);
+    lv_disp_flush_ready(disp_drv);
+}
+
+/*Advance both clocks and fire the core timers that came due*/
+static void suite_advance(uint32_t ms)
+{
+    virtual_now_us += (int64_t)ms * 1000;
+    lv_tick_inc(ms);
+    core_hal_host_run_timers();
+}
+
+/*One iteration of the firmware's render task*/
+static void suite_frame(void)
+{
+    suite_advance(SUITE_FRAME_MS);
+    ui_queue_drain();
+    lv_timer_handler();
+}
+
+/*A cold start of a case: nothing pending, nothing left to draw*/
+static void suite_settle(void)
+{
+    for(int i = 0; i < 50; i++) suite_frame();
+}
+
+/*Update of the main tank as it arrives from MQTT, then every frame of
+ *the arc animation it starts*/
+static bool case_water_level(uint32_t iterations, int64_t *samples_ns)
+{
+    for(uint32_t i = 0; i < iterations; i++) {
+        uint8_t level = (uint8_t)(5 + (i * 37) % 91);
+        int64_t start = host_now_ns();
+        backend_update_water_level(level);
+        for(int f = 0; f < SUITE_LEVEL_FRAMES; f++) suite_frame();
+        samples_ns[i] = host_now_ns() - start;
+    }
+    return true;
+}
+
+/*A tap on the bright switch up to the light state message leaving through
+ *the publish scheduler, coalescing window included; no render*/
+static bool case_light_publish(uint32_t iterations, int64_t *samples_ns)
+{
+    for(uint32_t i = 0; i < iterations; i++) {
+        uint32_t published = sim_broker_get_publish_count();
+        int64_t start = host_now_ns();
+        if(lv_obj_has_state(ui_BrightSwitch, LV_STATE_CHECKED)) {
+            lv_obj_clear_state(ui_BrightSwitch, LV_STATE_CHECKED);
+        } else {
+            lv_obj_add_state(ui_BrightSwitch, LV_STATE_CHECKED);
+        }
+        lv_event_send(ui_BrightSwitch, LV_EVENT_VALUE_CHANGED, NULL);
+        suite_advance(CONFIG_PUBLISH_COALESCE_MS + 1);
+        samples_ns[i] = host_now_ns() - start;
+
+        if(sim_broker_get_publish_count() == published) {
+            fprintf(stderr, "%s: light_publish: switch change not published\n", SUITE_NAME);
+            return false;
+        }
+        /*Outside the timing: the widgets follow the new state*/
+        ui_queue_drain();
+    }
+    return true;
+}
+
+static char *dup_string(const char *s)
+{
+    size_t len = strlen(s) + 1;
+    char *copy = malloc(len);
+    if(copy) memcpy(copy, s, len);
+    return copy;
+}
+
+/*Mostly main tank levels in JSON and binary, some bare numbers, some
+ *topics nobody subscribed to, and every 16th message fragmented*/
+static bool stream_build(void)
+{
+    uint32_t seed = 12345;
+
+    for(size_t i = 0; i < SUITE_STREAM_LEN; i++) {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t r = seed >> 8;
+        payload_water_level_t level = {(uint8_t)(r % 101)};
+        uint8_t buf[32];
+        int len;
+        const char *topic = WATER_LEVEL_TOPIC;
+
+        switch(r % 8) {
+            case 0:
+            case 1:
+                len = payload_encode_water_level(PAYLOAD_FORMAT_BINARY, &level, buf, sizeof(buf));
+                break;
+            case 2:
+                len = snprintf((char *)buf, sizeof(buf), "%u", level.level);
+                break;
+            case 3:
+                topic = (r & 0x100) ? "sensecap/indicator/water/north/level" : "sensecap/indicator/telemetry";
+                len = payload_encode_water_level(PAYLOAD_FORMAT_JSON, &level, buf, sizeof(buf));
+                break;
+            default:
+                len = payload_encode_water_level(PAYLOAD_FORMAT_JSON, &level, buf, sizeof(buf));
+                break;
+        }
+        if(len <= 0) return false;
+
+        stream[i].topic = dup_string(topic);
+        stream[i].payload = malloc((size_t)len);
+        if(!stream[i].topic || !stream[i].payload) return false;
+        memcpy(stream[i].payload, buf, (size_t)len);
+        stream[i].len = (size_t)len;
+        stream[i].split = i % 16 == 15 && len > 1;
+    }
+    return true;
+}
+
+static void stream_free(void)
+{
+    for(size_t i = 0; i < SUITE_STREAM_LEN; i++) {
+        free(stream[i].topic);
+        free(stream[i].payload);
+        stream[i].topic = NULL;
+        stream[i].payload = NULL;
+    }
+}
+
+/*The MQTT_EVENT_DATA path: topic match, reassembly, decode, backend and
+ *state store, up to the UI queue. One sample is the mean per message of a
+ *batch; the UI is brought up to date between batches, untimed.*/
+static bool case_mqtt_route(uint32_t iterations, int64_t *samples_ns)
+{
+    size_t next = 0;
+
+    for(uint32_t i = 0; i < iterations; i++) {
+        int64_t start = host_now_ns();
+        for(int m = 0; m < SUITE_STREAM_BATCH; m++) {
+            const stream_msg_t *msg = &stream[next];
+            next = (next + 1) % SUITE_STREAM_LEN;
+            size_t topic_len = strlen(msg->topic);
+            const char *data = (const char *)msg->payload;
+
+            if(msg->split) {
+                size_t first = msg->len / 2;
+                mqtt_router_dispatch(msg->topic, topic_len, data, first, 0, msg->len);
+                mqtt_router_dispatch(NULL, 0, data + first, msg->len - first, first, msg->len);
+            } else {
+                mqtt_router_dispatch(msg->topic, topic_len, data, msg->len, 0, msg->len);
+            }
+        }
+        samples_ns[i] = (host_now_ns() - start) / SUITE_STREAM_BATCH;
+        ui_queue_drain();
+    }
+    return true;
+}
+
+/*Tank levels and GPIO reports, every 64th with a flipped bit*/
+static bool copro_stream_build(void)
+{
+    uint32_t seed = 54321;
+    size_t len = 0;
+
+    for(size_t i = 0; i < SUITE_COPRO_FRAMES; i++) {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t r = seed >> 8;
+        uint8_t payload[4];
+        size_t n;
+
+        copro_frame_at[i] = len;
+        if(r % 4 == 0) {
+            payload[0] = (uint8_t)r;
+            payload[1] = (uint8_t)(r >> 8);
+            payload[2] = (uint8_t)(r >> 16);
+            payload[3] = 0;
+            n = copro_encode(COPRO_MSG_GPIO, payload, 4, copro_stream + len, sizeof(copro_stream) - len);
+        } else {
+            payload[0] = 0;
+            payload[1] = (uint8_t)((r >> 4) % 101);
+            n = copro_encode(COPRO_MSG_TANK_LEVEL, payload, 2, copro_stream + len, sizeof(copro_stream) - len);
+        }
+        if(n == 0) return false;
+        if(i % 64 == 63) copro_stream[len + 1] ^= 0x10;
+        len += n;
+    }
+    copro_frame_at[SUITE_COPRO_FRAMES] = len;
+    return true;
+}
+
+static void copro_route(uint8_t type, const uint8_t *payload, size_t len, void *ctx)
+{
+    (void)ctx;
+    if(type == COPRO_MSG_TANK_LEVEL && len == 2) {
+        backend_update_tank_level_from(BACKEND_SOURCE_COPRO, payload[0], payload[1]);
+    }
+}
+
+/*The co-processor receive path: COBS decode, CRC and routing into the
+ *backend and state store, fed in UART-sized chunks. One sample is the
+ *mean per frame of a batch; the UI is brought up to date between batches,
+ *untimed.*/
+static bool case_copro_parse(uint32_t iterations, int64_t *samples_ns)
+{
+    copro_parser_t parser;
+    size_t next = 0;
+
+    copro_parser_init(&parser);
+    for(uint32_t i = 0; i < iterations; i++) {
+        const uint8_t *data = copro_stream + copro_frame_at[next];
+        size_t len = copro_frame_at[next + SUITE_COPRO_BATCH] - copro_frame_at[next];
+        next = (next + SUITE_COPRO_BATCH) % SUITE_COPRO_FRAMES;
+
+        int64_t start = host_now_ns();
+        for(size_t off = 0; off < len; off += SUITE_COPRO_CHUNK) {
+            size_t n = len - off < SUITE_COPRO_CHUNK ? len - off : SUITE_COPRO_CHUNK;
+            copro_parser_feed(&parser, data + off, n, copro_route, NULL);
+        }
+        samples_ns[i] = (host_now_ns() - start) / SUITE_COPRO_BATCH;
+        ui_queue_drain();
+    }
+
+    if(parser.stats.frames == 0 || parser.stats.framing_errors != 0 || parser.stats.overruns != 0) {
+        fprintf(stderr, "%s: copro_parse_route: %" PRIu32 " frames, %" PRIu32 " framing errors, %" PRIu32
+                " overruns\n", SUITE_NAME, parser.stats.frames, parser.stats.framing_errors,
+                parser.stats.overruns);
+        return false;
+    }
+    return true;
+}
+
+/*Switch between the two themes and draw the result*/
+static bool case_theme_switch(uint32_t iterations, int64_t *samples_ns)
+{
+    for(uint32_t i = 0; i < iterations; i++) {
+        uint8_t theme = ui_theme_idx == UI_THEME_DEFAULT ? UI_THEME_BACKGROUND : UI_THEME_DEFAULT;
+        int64_t start = host_now_ns();
+        ui_theme_set(theme);
+        suite_frame();
+        samples_ns[i] = host_now_ns() - start;
+    }
+    return true;
+}
+
+static const suite_case_t suite_cases[] = {
+    {"water_level_render", "update", 40, case_water_level},
+    {"light_toggle_publish", "toggle", 500, case_light_publish},
+    {"mqtt_route_decode", "message", 200, case_mqtt_route},
+    {"copro_parse_route", "frame", 200, case_copro_parse},
+    {"theme_switch", "switch", 100, case_theme_switch},
+};
+
+#define CASE_COUNT (sizeof(suite_cases) / sizeof(suite_cases[0]))
+
+typedef struct {
+    const char *name;
+    const char *unit;
+    uint32_t iterations;
+    int64_t mean_ns, p50_ns, p99_ns, min_ns, max_ns;
+} suite_result_t;
+
+static int cmp_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void summarize(const suite_case_t *c, int64_t *samples, uint32_t n, suite_result_t *out)
+{
+    int64_t total = 0;
+    for(uint32_t i = 0; i < n; i++) total += samples[i];
+    qsort(samples, n, sizeof(*samples), cmp_i64);
+
+    out->name = c->name;
+    out->unit = c->unit;
+    out->iterations = n;
+    out->mean_ns = total / n;
+    out->p50_ns = samples[n / 2];
+    out->p99_ns = samples[(uint64_t)n * 99 / 100];
+    out->min_ns = samples[0];
+    out->max_ns = samples[n - 1];
+}
+
+/*s as a JSON string, quotes and backslashes escaped*/
+static void write_json_string(FILE *f, const char *s)
+{
+    fputc('"', f);
+    for(; *s; s++) {
+        if(*s == '"' || *s == '\\') fputc('\\', f);
+        fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+/*CPU model from /proc/cpuinfo where there is one*/
+static const char *host_cpu(void)
+{
+    static char cpu[128] = "unknown";
+    char line[SUITE_MAX_LINE];
+    FILE *f = fopen("/proc/cpuinfo", "r");
+    if(!f) return cpu;
+    while(fgets(line, sizeof(line), f)) {
+        const char *colon = strchr(line, ':');
+        if(strncmp(line, "model name", 10) != 0 || !colon) continue;
+        snprintf(cpu, sizeof(cpu), "%s", colon + 1 + strspn(colon + 1, " "));
+        cpu[strcspn(cpu, "\n")] = '\0';
+        break;
+    }
+    fclose(f);
+    return cpu;
+}
+
+static void write_json(FILE *f, const char *display_mode, const suite_result_t *results, size_t count)
+{
+    struct utsname host;
+    char host_name[256] = "unknown";
+    if(uname(&host) == 0) snprintf(host_name, sizeof(host_name), "%s %s %s", host.sysname, host.release, host.machine);
+
+    fprintf(f, "{\n  \"suite\": \"%s\",\n  \"display_mode\": \"%s\",\n  \"host\": ", SUITE_NAME, display_mode);
+    write_json_string(f, host_name);
+    fprintf(f, ",\n  \"cpu\": ");
+    write_json_string(f, host_cpu());
+    fprintf(f, ",\n  \"compiler\": ");
+    write_json_string(f, SUITE_COMPILER);
+    fprintf(f, ",\n  \"build\": ");
+    write_json_string(f, SUITE_BUILD_FLAGS);
+    fprintf(f, ",\n  \"results\": [\n");
+    for(size_t i = 0; i < count; i++) {
+        const suite_result_t *r = &results[i];
+        fprintf(f, "    {\"name\": \"%s\", \"unit\": \"%s\", \"iterations\": %" PRIu32 ", \"mean_ns\": %" PRId64
+                ", \"p50_ns\": %" PRId64 ", \"p99_ns\": %" PRId64 ", \"min_ns\": %" PRId64 ", \"max_ns\": %" PRId64
+                "}%s\n",
+                r->name, r->unit, r->iterations, r->mean_ns, r->p50_ns, r->p99_ns, r->min_ns, r->max_ns,
+                i + 1 < count ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+/*Median of a case in a file written by write_json(), -1 if absent*/
+static int64_t baseline_p50(FILE *f, const char *name)
+{
+    char line[SUITE_MAX_LINE];
+    char key[96];
+    snprintf(key, sizeof(key), "\"name\": \"%s\"", name);
+
+    rewind(f);
+    while(fgets(line, sizeof(line), f)) {
+        if(!strstr(line, key)) continue;
+        const char *p50 = strstr(line, "\"p50_ns\": ");
+        if(p50) return strtoll(p50 + strlen("\"p50_ns\": "), NULL, 10);
+    }
+    return -1;
+}
+
+/*Returns the number of cases slower than the baseline by more than threshold_pct*/
+static int compare_baseline(FILE *f, const suite_result_t *results, size_t count, double threshold_pct)
+{
+    int regressions = 0;
+    char line[SUITE_MAX_LINE];
+
+    /*Medians only compare on the same host and build*/
+    rewind(f);
+    while(fgets(line, sizeof(line), f)) {
+        if(strstr(line, "\"host\": ") || strstr(line, "\"cpu\": ") || strstr(line, "\"compiler\": ") ||
+           strstr(line, "\"build\": ")) {
+            fprintf(stderr, "baseline %s", line + strspn(line, " "));
+        }
+    }
+    fprintf(stderr, "%-22s %12s %12s %8s\n", "case", "baseline ns", "now ns", "change");
+    for(size_t i = 0; i < count; i++) {
+        const suite_result_t *r = &results[i];
+        int64_t base = baseline_p50(f, r->name);
+        if(base <= 0) {
+            fprintf(stderr, "%-22s %12s %12" PRId64 " %8s\n", r->name, "-", r->p50_ns, "new");
+            continue;
+        }
+        double change = 100.0 * (double)(r->p50_ns - base) / (double)base;
+        bool slower = change > threshold_pct;
+        fprintf(stderr, "%-22s %12" PRId64 " %12" PRId64 " %+7.1f%%%s\n", r->name, base, r->p50_ns, change,
+                slower ? "  REGRESSION" : "");
+        if(slower) regressions++;
+    }
+    return regressions;
+}
+
+static int usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--json <file>] [--baseline <file>] [--threshold <pct>]\n"
+            "          [--filter <text>] [--iterations <n>] [--display-mode partial|full|direct]\n",
+            argv0);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    const char *json_path = NULL;
+    const char *baseline_path = NULL;
+    const char *filter = NULL;
+    const char *mode_name = "partial";
+    double threshold_pct = 10.0;
+    uint32_t iterations = 0;
+
+    for(int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if(strcmp(arg, "--json") == 0 && value) json_path = argv[++i];
+        else if(strcmp(arg, "--baseline") == 0 && value) baseline_path = argv[++i];
+        else if(strcmp(arg, "--threshold") == 0 && value) threshold_pct = atof(argv[++i]);
+        else if(strcmp(arg, "--filter") == 0 && value) filter = argv[++i];
+        else if(strcmp(arg, "--iterations") == 0 && value) iterations = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if(strcmp(arg, "--display-mode") == 0 && value) mode_name = argv[++i];
+        else return usage(argv[0]);
+    }
+
+    sim_display_mode_t mode;
+    if(!sim_display_parse_mode(mode_name, &mode)) return usage(argv[0]);
+
+    /*Read the baseline before anything is written, it may be the same file*/
+    FILE *baseline = NULL;
+    if(baseline_path) {
+        baseline = fopen(baseline_path, "r");
+        if(!baseline && errno == ENOENT) {
+            fprintf(stderr, "%s: no baseline at %s; record one on the reference machine with "
+                    "`make bench-baseline`\n", SUITE_NAME, baseline_path);
+            return 1;
+        }
+        if(!baseline) {
+            fprintf(stderr, "%s: cannot open baseline %s\n", SUITE_NAME, baseline_path);
+            return 1;
+        }
+    }
+
+    lv_init();
+    static lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    if(!sim_display_setup(&disp_drv, mode)) {
+        fprintf(stderr, "%s: cannot allocate display buffers\n", SUITE_NAME);
+        return 1;
+    }
+    disp_drv.flush_cb = suite_flush_cb;
+    lv_disp_drv_register(&disp_drv);
+
+    core_hal_host_set_clock(virtual_clock_us, SUITE_WALL_EPOCH_S);
+    backend_init();
+    sim_broker_attach(false);
+    ui_update_network_state_async(1, 1);
+    ui_init();
+    if(!stream_build()) {
+        fprintf(stderr, "%s: cannot build the MQTT stream\n", SUITE_NAME);
+        return 1;
+    }
+    if(!copro_stream_build()) {
+        fprintf(stderr, "%s: cannot build the co-processor stream\n", SUITE_NAME);
+        return 1;
+    }
+
+    suite_result_t results[CASE_COUNT];
+    size_t result_count = 0;
+    int status = 0;
+
+    for(size_t c = 0; c < CASE_COUNT; c++) {
+        const suite_case_t *sc = &suite_cases[c];
+        if(filter && !strstr(sc->name, filter)) continue;
+
+        uint32_t n = iterations ? iterations : sc->iterations;
+        int64_t *samples = malloc(n * sizeof(*samples));
+        if(!samples) {
+            status = 1;
+            break;
+        }
+        suite_settle();
+        if(!sc->run(n, samples)) {
+            free(samples);
+            status = 1;
+            continue;
+        }
+        summarize(sc, samples, n, &results[result_count]);
+        fprintf(stderr, "%s: %-22s p50 %10" PRId64 " ns/%s\n", SUITE_NAME, sc->name, results[result_count].p50_ns,
+                sc->unit);
+        result_count++;
+        free(samples);
+    }
+
+    if(baseline) {
+        int regressions = compare_baseline(baseline, results, result_count, threshold_pct);
+        fclose(baseline);
+        if(regressions > 0 && status == 0) {
+            fprintf(stderr, "%s: %d case(s) over the %.1f%% threshold\n", SUITE_NAME, regressions, threshold_pct);
+            status = 2;
+        }
+    }
+
+    FILE *json = json_path ? fopen(json_path, "w") : stdout;
+    if(!json) {
+        fprintf(stderr, "%s: cannot write %s\n", SUITE_NAME, json_path);
+        status = 1;
+    } else {
+        write_json(json, mode_name, results, result_count);
+        if(json != stdout) fclose(json);
+    }
+
+    stream_free();
+    ui_destroy();
+    return status;
+}
@@ -1,47 +0,0 @@
-// This file was generated by SquareLine Studio
-// SquareLine Studio version: SquareLine Studio 1.6.0
-// LVGL version: 8.3.11
-// Project name: SquareLine_Project
-
-#ifndef _SQUARELINE_PROJECT_UI_H
-#define _SQUARELINE_PROJECT_UI_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-#include <stdint.h>
-#include "lvgl/lvgl.h"
-
-#include "ui_helpers.h"
-#include "ui_events.h"
-#include "ui_theme_manager.h"
-#include "ui_themes.h"
-
-
-///////////////////// SCREENS ////////////////////
-
-#include "screens/ui_Screen_1.h"
-
-///////////////////// VARIABLES ////////////////////
-
-
-// EVENTS
-
-extern lv_obj_t * ui____initial_actions0;
-
-// UI INIT
-void ui_init(void);
-void ui_destroy(void);
-
-// FFI Functions - called by Rust backend
-void ui_update_water_level_async(int level);
-void ui_set_water_level(int level);
-void ui_set_bright_state(int state);
-void ui_set_relax_state(int state);
-
-#ifdef __cplusplus
-} /*extern "C"*/
-#endif
-
-#endif